@@ -47,6 +47,9 @@ typedef __m128i fipv; // fixed point vector type
 #define fi_abs_epi8 _mm_abs_epi8
 #define fi_sign_epi8 _mm_sign_epi8
 
+#define fi_cmpeq_epi8 _mm_cmpeq_epi8
+#define fi_andnot _mm_andnot_si128
+
 
 #else
 #define BITSPERVECTOR 256
@@ -78,6 +81,9 @@ typedef __m256i fipv; // fixed point vector type
 #define fi_abs_epi8 _mm256_abs_epi8
 #define fi_sign_epi8 _mm256_sign_epi8
 
+#define fi_cmpeq_epi8 _mm256_cmpeq_epi8
+#define fi_andnot _mm256_andnot_si256
+
 #endif
 
 
@@ -288,6 +288,16 @@ public:
     void getSoftInformation(void* pData);
 
     char* data(); ///< Get a pointer to the container's memory.
+
+    /*!
+     * \brief Move the container to another external storage.
+     *
+     * The lookup tables of the code are kept, so this is cheap enough to be
+     * done for every code word. Previously owned memory is freed.
+     * \param external Memory of at least max(size(), BITSPERVECTOR) / 8 bytes,
+     *                 aligned to BYTESPERVECTOR.
+     */
+    void setData(char* external);
 };
 
 } // namespace PolarCode
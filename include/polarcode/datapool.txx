@@ -9,11 +9,12 @@
 #ifndef PC_DATAPOOL_TXX
 #define PC_DATAPOOL_TXX
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <cstring>
-#include <iostream>
-#include <map>
-#include <stack>
+#include <new>
+#include <vector>
 
 #include <polarcode/avxconvenience.h>
 
@@ -24,71 +25,141 @@ struct Block {
     size_t useCount;
     size_t size;
     mT* data;
+    Block<mT>* next; ///< Next free block of the same size class.
 };
 
 /*!
  * \brief A class that saves complexity in memory allocation, if blocks of few
  * distinct sizes are heavily re-used.
+ *
+ * Blocks are grouped into size classes by the binary logarithm of their
+ * capacity. Each class keeps its free blocks in a singly linked list, threaded
+ * through the blocks themselves, so allocating and releasing a block is a
+ * constant-time list operation. Memory is taken from the heap in slabs holding
+ * many blocks. Decoders reserve their peak usage with reserve() once, so that
+ * decoding itself never has to allocate.
+ *
+ * Slabs are only returned to the heap by the destructor, which frees the
+ * memory of all blocks, whether they were released or not. Owners therefore
+ * have to release every block, e.g. by deleting the decoding tree, before
+ * they delete the pool. Debug builds assert this.
  */
 template <typename T, size_t alignment>
 class DataPool
 {
-    std::map<size_t, std::stack<Block<T>*>> freeBlocks;
+    static const unsigned CLASSCOUNT = 8 * sizeof(size_t);
+
+    Block<T>* mFreeList[CLASSCOUNT]; ///< Free blocks, indexed by size class
+    size_t mFreeCount[CLASSCOUNT];   ///< Length of each free list
+    std::vector<Block<T>*> mSlabs;   ///< Block headers of each slab
+    size_t mBlockCount;              ///< Number of blocks in all slabs
+
+    static unsigned sizeClass(size_t size)
+    {
+        return size <= 1 ? 0 : 8 * sizeof(size_t) - __builtin_clzl(size - 1);
+    }
+
+    /*!
+     * \brief Allocate a slab and append its blocks to a free list.
+     * \param sizeClass Binary logarithm of the block capacity.
+     * \param count Number of blocks in the slab.
+     */
+    void grow(unsigned sizeClass, size_t count)
+    {
+        const size_t capacity = size_t(1) << sizeClass;
+        void* ptr = _mm_malloc(sizeof(T) * capacity * count, alignment);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        memset(ptr, 0, sizeof(T) * capacity * count);
+
+        Block<T>* slab = new Block<T>[count];
+        for (size_t i = 0; i < count; ++i) {
+            slab[i].data = reinterpret_cast<T*>(ptr) + i * capacity;
+            slab[i].next = mFreeList[sizeClass];
+            mFreeList[sizeClass] = slab + i;
+        }
+        mFreeCount[sizeClass] += count;
+        mBlockCount += count;
+        mSlabs.push_back(slab);
+    }
 
 public:
-    DataPool() {}
+    DataPool() : mBlockCount(0)
+    {
+        for (unsigned i = 0; i < CLASSCOUNT; ++i) {
+            mFreeList[i] = nullptr;
+            mFreeCount[i] = 0;
+        }
+    }
 
     ~DataPool()
     {
-        for (auto& stack : freeBlocks) {
-            while (!stack.second.empty()) {
-                _mm_free(stack.second.top()->data);
-                delete stack.second.top();
-                stack.second.pop();
-            }
+        // Blocks still in use would point into freed memory
+        assert(outstandingBlocks() == 0);
+        for (Block<T>* slab : mSlabs) {
+            _mm_free(slab[0].data);
+            delete[] slab;
         }
     }
 
+    DataPool(const DataPool&) = delete;
+    DataPool& operator=(const DataPool&) = delete;
+
+    /*!
+     * \brief Make sure that _count_ blocks of _size_ elements can be allocated
+     *        without accessing the heap.
+     * \param size Number of elements per block.
+     * \param count Number of blocks.
+     */
+    void reserve(size_t size, size_t count)
+    {
+        unsigned sizeClass = DataPool::sizeClass(std::max(alignment / sizeof(T), size));
+        if (mFreeCount[sizeClass] < count) {
+            grow(sizeClass, count - mFreeCount[sizeClass]);
+        }
+    }
+
+    /*!
+     * \brief Get the number of heap allocations done by this pool so far.
+     */
+    size_t heapAllocations() const { return mSlabs.size(); }
+
+    /*!
+     * \brief Get the number of blocks which have been allocated, but not released.
+     */
+    size_t outstandingBlocks() const
+    {
+        size_t freeBlocks = 0;
+        for (unsigned i = 0; i < CLASSCOUNT; ++i) {
+            freeBlocks += mFreeCount[i];
+        }
+        return mBlockCount - freeBlocks;
+    }
+
     /*!
      * \brief Get a pointer to a data block of _size_ elements.
      *
-     * This function either allocates a new block or recalls a previously freed
-     * block from the stack of available blocks.
+     * This function takes a block from the free list of the matching size
+     * class. Only if that list is empty, a new block is allocated.
      *
      * \param size Number of elements to allocate.
      * \return Pointer to a new data block.
      */
     Block<T>* allocate(size_t size)
     {
-        Block<T>* block;
-
         size = std::max(alignment / sizeof(T), size);
+        unsigned sizeClass = DataPool::sizeClass(size);
 
-        /* This change improves performance only slightly, but looks nice:
-         * Instead of searching the key, we simply try to access it and when failing,
-         * create a new element.
-         */
-        try {
-            (void)freeBlocks[size];
-        } catch (...) {
-            freeBlocks.insert({ size, std::stack<Block<T>*>() });
+        if (mFreeList[sizeClass] == nullptr) {
+            grow(sizeClass, 1);
         }
 
-        if (freeBlocks[size].empty()) {
-            block = new Block<T>();
-            void* ptr = _mm_malloc(sizeof(T) * size, alignment);
-            if (ptr == nullptr) {
-                std::cerr << "Can't allocate aligned memory." << std::endl;
-            }
-            memset(ptr, 0, sizeof(T) * size);
-            block->data = reinterpret_cast<T*>(ptr);
-            block->useCount = 1;
-            block->size = size;
-        } else {
-            block = freeBlocks[size].top();
-            block->useCount = 1;
-            freeBlocks[size].pop();
-        }
+        Block<T>* block = mFreeList[sizeClass];
+        mFreeList[sizeClass] = block->next;
+        --mFreeCount[sizeClass];
+        block->useCount = 1;
+        block->size = size;
         return block;
     }
 
@@ -139,7 +210,10 @@ public:
             return;
         }
         if (--block->useCount == 0) {
-            freeBlocks[block->size].push(block);
+            unsigned sizeClass = DataPool::sizeClass(block->size);
+            block->next = mFreeList[sizeClass];
+            mFreeList[sizeClass] = block;
+            ++mFreeCount[sizeClass];
         }
         block = nullptr;
     }
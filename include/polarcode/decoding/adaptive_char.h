@@ -11,6 +11,7 @@
 
 #include <polarcode/decoding/fastssc_fip_char.h>
 #include <polarcode/decoding/scl_fip_char.h>
+#include <vector>
 
 namespace PolarCode {
 namespace Decoding {
@@ -21,19 +22,27 @@ namespace Decoding {
  * The list decoder has a high latency, but achieves up to around 2 dB
  * Eb/N0 more than the fast decoder. As the Fast-SSC decoder indeed is fast,
  * it tries to decode the given signal and only upon failure, the signal is
- * decoded a second time, using the list decoder.
+ * decoded again by list decoders of increasing size, for example 2, 4, 8
+ * and 32 paths, until the error detector accepts the result. The LLRs are
+ * only handed to a list decoder when it is needed.
  */
 class AdaptiveChar : public Decoder
 {
     FastSscFipChar* mFastDecoder;
-    SclFipChar* mListDecoder;
+    std::vector<SclFipChar*> mListDecoders; ///< One per list size
+    std::vector<size_t> mListSizes;
     size_t mListSize;
+    size_t mLastListSize;
+
+    void clearListDecoders();
 
 public:
     /*!
      * \brief Create an adaptive decoder.
+     *
+     * The list size doubles from two paths up to listSize.
      * \param blockLength Block length of the Polar Code.
-     * \param listSize Path limit of the list decoder.
+     * \param listSize Path limit of the largest list decoder.
      * \param frozenBits The set of frozen bits.
      */
     AdaptiveChar(size_t blockLength,
@@ -45,6 +54,30 @@ public:
     void setSystematic(bool sys);
     void setErrorDetection(ErrorDetection::Detector* pDetector);
     void setSignal(const float* pLlr);
+
+    /*!
+     * \brief Get decoder list size
+     * \return size_t with Decoder List size.
+     */
+    size_t getListSize() { return mListSize; }
+
+    /*!
+     * \brief Set the path limits of the list decoders.
+     * \param listSizes Strictly increasing list sizes of at least two paths.
+     *                  An empty list disables list decoding.
+     */
+    void setListSizes(const std::vector<size_t>& listSizes);
+
+    /*!
+     * \brief Get the path limits of the list decoders, in the order of use.
+     */
+    const std::vector<size_t>& listSizes() const { return mListSizes; }
+
+    /*!
+     * \brief Get the list size which produced the last result.
+     * \return One, if the Fast-SSC decoder sufficed.
+     */
+    size_t lastListSize() const { return mLastListSize; }
 };
 
 
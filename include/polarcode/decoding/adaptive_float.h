@@ -12,6 +12,7 @@
 #include <polarcode/decoding/fastssc_avx_float.h>
 #include <polarcode/decoding/scl_avx_float.h>
 #include <memory>
+#include <vector>
 
 namespace PolarCode {
 namespace Decoding {
@@ -22,26 +23,52 @@ namespace Decoding {
  * The list decoder has a high latency, but achieves up to around 2 dB
  * Eb/N0 more than the fast decoder. As the Fast-SSC decoder indeed is fast,
  * it tries to decode the given signal and only upon failure, the signal is
- * decoded a second time, using the list decoder.
+ * decoded again by list decoders of increasing size, for example 2, 4, 8
+ * and 32 paths, until the error detector accepts the result. The LLRs are
+ * only handed to a list decoder when it is needed.
  */
 class AdaptiveFloat : public Decoder
 {
     std::unique_ptr<FastSscAvxFloat> mFastDecoder;
-    std::unique_ptr<SclAvxFloat> mListDecoder;
+    std::vector<std::unique_ptr<SclAvxFloat>> mListDecoders; ///< One per list size
+    std::vector<size_t> mListSizes;
+    plan_t mListPlan;
     size_t mListSize;
+    size_t mLastListSize;
+
+    void createListDecoders();
 
 public:
     /*!
      * \brief Create an adaptive decoder.
+     *
+     * The list size doubles from two paths up to listSize.
      * \param blockLength Block length of the Polar Code.
-     * \param listSize Path limit of the list decoder.
+     * \param listSize Path limit of the largest list decoder.
      * \param frozenBits The set of frozen bits.
      */
     AdaptiveFloat(size_t blockLength,
                   size_t listSize,
                   const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create an adaptive decoder from existing decoding plans.
+     * \param fastPlan A plan created by FastSscAvxFloat::makePlan().
+     * \param listPlan A plan created by SclAvxFloat::makePlan().
+     * \param listSize Path limit of the largest list decoder.
+     */
+    AdaptiveFloat(plan_t fastPlan, plan_t listPlan, size_t listSize);
+
+    /*!
+     * \brief Create an adaptive decoder with the given list sizes.
+     * \param fastPlan A plan created by FastSscAvxFloat::makePlan().
+     * \param listPlan A plan created by SclAvxFloat::makePlan().
+     * \param listSizes Path limits of the list decoders, in the order of use.
+     */
+    AdaptiveFloat(plan_t fastPlan, plan_t listPlan, const std::vector<size_t>& listSizes);
     ~AdaptiveFloat();
     bool decode();
+    Decoder* clone() const;
 
     void setSystematic(bool sys);
     void setErrorDetection(ErrorDetection::Detector* pDetector);
@@ -52,6 +79,24 @@ public:
      * \return size_t with Decoder List size.
      */
     size_t getListSize() { return mListSize; }
+
+    /*!
+     * \brief Set the path limits of the list decoders.
+     * \param listSizes Strictly increasing list sizes of at least two paths.
+     *                  An empty list disables list decoding.
+     */
+    void setListSizes(const std::vector<size_t>& listSizes);
+
+    /*!
+     * \brief Get the path limits of the list decoders, in the order of use.
+     */
+    const std::vector<size_t>& listSizes() const { return mListSizes; }
+
+    /*!
+     * \brief Get the list size which produced the last result.
+     * \return One, if the Fast-SSC decoder sufficed.
+     */
+    size_t lastListSize() const { return mLastListSize; }
 };
 
 
@@ -13,6 +13,7 @@
 #include <polarcode/decoding/templatized_float.h>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 
 namespace PolarCode {
@@ -235,6 +236,123 @@ CombineBitsLong(float* Left, float* Right, float* Out, const unsigned subBlockLe
     }
 }
 
+/*
+ * Packed hard decisions take one bit each, bit i % 8 of byte i / 8, which is
+ * set for a negative sign. This is the lane order of _mm256_movemask_ps(), and
+ * a byte expands to a vector of sign masks in a register. Codes shorter than
+ * eight bits use the lowest bits of a single byte.
+ */
+
+/*!
+ * \brief Expand eight packed decisions to a vector with their signs.
+ *
+ * Only the sign bits of the result are meaningful.
+ */
+inline __m256 unpackSigns(unsigned bits)
+{
+    const __m256i shifts = _mm256_setr_epi32(31, 30, 29, 28, 27, 26, 25, 24);
+    return _mm256_castsi256_ps(_mm256_sllv_epi32(_mm256_set1_epi32(bits), shifts));
+}
+
+/*!
+ * \brief Pack the signs of _blockLength_ floats.
+ */
+inline void packSigns(const float* in, uint8_t* out, const unsigned blockLength)
+{
+    if (blockLength < 8) {
+        out[0] = _mm256_movemask_ps(_mm256_load_ps(in)) & ((1 << blockLength) - 1);
+        return;
+    }
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        out[i / 8] = _mm256_movemask_ps(_mm256_load_ps(in + i));
+    }
+}
+
+/*!
+ * \brief Expand packed decisions to floats of magnitude one.
+ */
+inline void unpackBits(const uint8_t* in, float* out, const unsigned blockLength)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    unsigned i = 0;
+    for (; i + 8 <= blockLength; i += 8) {
+        const __m256 signs = _mm256_and_ps(unpackSigns(in[i / 8]), SIGN_MASK);
+        _mm256_storeu_ps(out + i, _mm256_or_ps(one, signs));
+    }
+    for (; i < blockLength; ++i) {
+        out[i] = (in[i / 8] >> (i % 8) & 1) ? -1.0f : 1.0f;
+    }
+}
+
+/*!
+ * \brief Flip a single packed decision.
+ */
+inline void flipBit(uint8_t* bits, const unsigned index)
+{
+    bits[index / 8] ^= 1 << (index % 8);
+}
+
+/*!
+ * \brief G-function with the left child's decisions in packed form.
+ */
+inline void G_function_packed(float* LLRin,
+                              float* LLRout,
+                              const uint8_t* BitsIn,
+                              unsigned subBlockLength)
+{
+    __m256 Left, Right, Bits;
+    if (subBlockLength < 8) {
+        Left = _mm256_load_ps(LLRin);
+        Right = _mm256_subVectorShift_ps(Left, subBlockLength);
+        Bits = unpackSigns(BitsIn[0]);
+        G_function_calc(Left, Right, Bits, LLRout);
+    } else {
+        for (unsigned i = 0; i < subBlockLength; i += 8) {
+            Left = _mm256_load_ps(LLRin + i);
+            Right = _mm256_load_ps(LLRin + i + subBlockLength);
+            Bits = unpackSigns(BitsIn[i / 8]);
+            G_function_calc(Left, Right, Bits, LLRout + i);
+        }
+    }
+}
+
+/*!
+ * \brief Combine packed child decisions into those of their parent.
+ *
+ * Like CombineBitsShort() and CombineBitsLong(), the left half of _Out_
+ * receives _Left_ xor _Right_, the right half a copy of _Right_.
+ */
+inline void CombineBitsPacked(const uint8_t* Left,
+                              const uint8_t* Right,
+                              uint8_t* Out,
+                              const unsigned subBlockLength)
+{
+    if (subBlockLength < 8) {
+        const unsigned mask = (1 << subBlockLength) - 1;
+        const unsigned right = Right[0] & mask;
+        Out[0] = ((Left[0] & mask) ^ right) | (right << subBlockLength);
+        return;
+    }
+
+    const unsigned byteCount = subBlockLength / 8;
+    if (byteCount < 32) {
+        for (unsigned i = 0; i < byteCount; ++i) {
+            Out[i] = Left[i] ^ Right[i];
+            Out[i + byteCount] = Right[i];
+        }
+        return;
+    }
+    for (unsigned i = 0; i < byteCount; i += 32) {
+        const __m256i LeftV =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(Left + i));
+        const __m256i RightV =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(Right + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(Out + i),
+                           _mm256_xor_si256(LeftV, RightV));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(Out + i + byteCount), RightV);
+    }
+}
+
 inline void RepetitionPrepare(float* x, const unsigned codeLength)
 {
     for (unsigned i = codeLength; i < 8; ++i) {
@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_BP_AVX_FLOAT_H
+#define PC_DEC_BP_AVX_FLOAT_H
+
+#include <polarcode/datapool.txx>
+#include <polarcode/decoding/decoder.h>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace BpAvx {
+typedef DataPool<float, 32> datapool_t;
+typedef Block<float> block_t;
+
+/*!
+ * \brief Update the messages of one stage of the factor graph.
+ *
+ * Each butterfly connects the bits a = i and b = i + distance, where a is
+ * the one which gets the sum of both. Depending on the direction, _in_ holds
+ * the messages arriving from the other side of the stage and _prior_ the
+ * messages of the side to be updated, from the previous sweep:
+ *
+ *   out[a] = f(in[a], in[b] + prior[b])
+ *   out[b] = f(in[a], prior[a]) + in[b]
+ *
+ * \param out Updated messages.
+ * \param in Messages arriving at the stage.
+ * \param prior Messages of the updated side.
+ * \param distance Butterfly distance, a power of two.
+ * \param blockLength Length of the code, at least eight.
+ */
+void updateStage(float* out,
+                 const float* in,
+                 const float* prior,
+                 unsigned distance,
+                 unsigned blockLength);
+
+} // namespace BpAvx
+
+/*!
+ * \brief Vectorized belief propagation decoder.
+ *
+ * Messages are passed over the factor graph of the polar transform, which
+ * has the information bits u on its left side and the code bits x on its
+ * right side. Each iteration sweeps the L messages from right to left and
+ * then the R messages from left to right, with the scaled min-sum rule.
+ * All N/2 butterflies of a stage are updated eight at a time.
+ *
+ * Decoding stops early, as soon as the hard decisions on both sides are
+ * consistent, i.e. the re-encoded u equal x, and the error detector accepts
+ * the information bits.
+ */
+class BpAvxFloat : public Decoder
+{
+    unsigned mIterationLimit;
+    unsigned mIterationCount;
+    unsigned mStageCount;
+
+    BpAvx::datapool_t* mDataPool;
+    BpAvx::block_t* mLeft;     ///< L messages of all n+1 columns, x side last
+    BpAvx::block_t* mRight;    ///< R messages of all n+1 columns, u side first
+    BpAvx::block_t* mInfoLlr;  ///< Soft decisions on u
+    BpAvx::block_t* mCodeLlr;  ///< Soft decisions on x
+    BpAvx::block_t* mReencode; ///< Hard decisions on u, encoded
+    FloatContainer* mInfoContainer;
+
+    void clear();
+    void makeDecisions();
+    bool consistent();
+    bool evaluateOutput();
+
+public:
+    /*!
+     * \brief Create a belief propagation decoder.
+     * \param blockLength Length of the Polar Code, at least eight.
+     * \param iterationLimit Maximum number of iterations per frame.
+     * \param frozenBits Set of frozen bits in the code word.
+     */
+    BpAvxFloat(size_t blockLength,
+               unsigned iterationLimit,
+               const std::vector<unsigned>& frozenBits);
+    ~BpAvxFloat();
+
+    bool decode();
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Set the maximum number of iterations per frame.
+     */
+    void setIterationLimit(unsigned iterationLimit);
+
+    /*!
+     * \brief Get the maximum number of iterations per frame.
+     */
+    size_t getListSize() { return mIterationLimit; }
+
+    /*!
+     * \brief Get the number of iterations of the last decode() call.
+     */
+    unsigned iterationCount() const { return mIterationCount; }
+
+    /*!
+     * \brief Copy the extrinsic LLRs of the code bits into eLlr.
+     * \param eLlr Memory for blockLength() values.
+     */
+    void getExtrinsicChannelInformation(float* eLlr);
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_BP_AVX_FLOAT_H
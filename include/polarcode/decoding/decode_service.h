@@ -0,0 +1,180 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_DECODE_SERVICE_H
+#define PC_DEC_DECODE_SERVICE_H
+
+#include <polarcode/decoding/decoder.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief Outcome of a single decoding job.
+ */
+struct DecodeResult {
+    std::vector<unsigned char> information; ///< Packed information bits
+    bool success;          ///< True, if no errors were detected after decoding
+    size_t queueDuration;  ///< Nanoseconds between submission and start of decoding
+    size_t decodeDuration; ///< Nanoseconds spent in the decoder
+};
+
+/*!
+ * \brief Counters of a DecodeService, see DecodeService::statistics().
+ */
+struct DecodeServiceStatistics {
+    size_t queueDepth;    ///< Number of jobs currently waiting
+    size_t maxQueueDepth; ///< Highest number of waiting jobs since the last reset
+    size_t completed;     ///< Number of finished jobs since the last reset
+    size_t stolen;        ///< Number of jobs run by a worker other than their owner
+    size_t meanLatency;   ///< Mean nanoseconds from submission to completion
+    size_t maxLatency;    ///< Highest nanoseconds from submission to completion
+};
+
+/*!
+ * \brief Asynchronous decoding on a fixed team of worker threads.
+ *
+ * Codes are registered once and referred to by their ID afterwards. Every
+ * worker lazily creates its own decoder for each code it encounters, so no
+ * decoder object is ever shared between threads. Decoders which support
+ * Decoder::clone() share their decoding plan.
+ *
+ * Each worker owns a queue of jobs. Submitted jobs are distributed over the
+ * queues round-robin. A worker whose queue runs empty steals the oldest job
+ * from another queue, so that expensive jobs, e.g. list decoding after a
+ * failed Fast-SSC attempt, do not hold back the cheap ones queued behind them.
+ */
+class DecodeService
+{
+public:
+    /*!
+     * \brief A function creating a new decoder, owned by the caller.
+     */
+    typedef std::function<Decoder*()> factory_t;
+
+    /*!
+     * \brief Start the worker threads.
+     * \param threadCount Number of workers. Zero selects one per hardware thread.
+     */
+    DecodeService(size_t threadCount = 0);
+
+    /*!
+     * \brief Finish all pending jobs and stop the worker threads.
+     */
+    ~DecodeService();
+
+    DecodeService(const DecodeService&) = delete;
+    DecodeService& operator=(const DecodeService&) = delete;
+
+    /*!
+     * \brief Register a code by a function that creates its decoders.
+     * \param factory Called once per worker which decodes this code.
+     * \return The ID to pass to submit().
+     */
+    unsigned registerCode(factory_t factory);
+
+    /*!
+     * \brief Register a code by a decoder whose clones are used by the workers.
+     *
+     * Throws std::invalid_argument, if the decoder does not support clone().
+     * \param prototype A configured decoder. It is not used after this call.
+     * \return The ID to pass to submit().
+     */
+    unsigned registerCode(const Decoder& prototype);
+
+    /*!
+     * \brief Queue a frame for decoding.
+     * \param pLlr blockLength() LLRs, copied before this function returns.
+     * \param codeId ID returned by registerCode().
+     * \return A future which receives the decoding result.
+     */
+    std::future<DecodeResult> submit(const float* pLlr, unsigned codeId);
+
+    /*!
+     * \brief Queue several consecutive frames for decoding.
+     * \param pLlr frames * blockLength() LLRs, copied before this function returns.
+     * \param frames Number of frames.
+     * \param codeId ID returned by registerCode().
+     * \return One future per frame.
+     */
+    std::vector<std::future<DecodeResult>>
+    submit(const float* pLlr, size_t frames, unsigned codeId);
+
+    size_t threadCount() const; ///< Number of worker threads.
+    size_t queueDepth() const;  ///< Number of jobs waiting to be decoded.
+
+    /*!
+     * \brief Get a snapshot of the service counters.
+     */
+    DecodeServiceStatistics statistics() const;
+
+    /*!
+     * \brief Reset all counters except the current queue depth.
+     */
+    void resetStatistics();
+
+private:
+    typedef std::chrono::steady_clock clock_t;
+
+    struct Job {
+        unsigned codeId;
+        std::vector<float> llr;
+        std::promise<DecodeResult> promise;
+        clock_t::time_point submitted;
+    };
+
+    struct Code {
+        factory_t factory;
+        size_t blockLength;
+        size_t infoBytes;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::vector<std::unique_ptr<Decoder>> decoders; ///< Indexed by code ID
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::vector<Code> mCodes;
+    mutable std::mutex mCodeMutex;
+
+    std::mutex mWaitMutex;
+    std::condition_variable mWakeup;
+    bool mStop;
+
+    std::atomic<size_t> mNextWorker;
+    std::atomic<size_t> mPending;
+    std::atomic<size_t> mMaxPending;
+    std::atomic<size_t> mCompleted;
+    std::atomic<size_t> mStolen;
+    std::atomic<size_t> mLatencySum;
+    std::atomic<size_t> mMaxLatency;
+
+    Code code(unsigned codeId) const;
+    bool takeJob(size_t workerIndex, Job& job);
+    void run(size_t workerIndex);
+    void execute(Worker& worker, Job& job);
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_DECODE_SERVICE_H
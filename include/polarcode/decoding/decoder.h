@@ -30,7 +30,15 @@ struct CodingScheme {
 // scheme.
 extern std::vector<CodingScheme> codeRegistry;
 
-enum DecoderType { tFlexible, tFixed, tDepthFirst, tScan, tFastSscan };
+/*!
+ * \brief Look up a code in the registry of fixed decoders.
+ * \param blockLength Length of the code.
+ * \param frozenBits The set of frozen bits, in any order.
+ * \return The index of the coding scheme, or -1 if the code is not registered.
+ */
+int findCodingScheme(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+enum DecoderType { tFlexible, tFixed, tDepthFirst, tScan, tFastSscan, tDscf, tBp };
 
 /*!
  * \brief The Decoder skeleton-class.
@@ -53,6 +61,24 @@ protected:
     std::vector<unsigned> mFrozenBits; ///< Indices for frozen bits
     bool mExternalContainers;          ///< On destruction, do not delete containers
 
+    /*!
+     * \brief Decode from and into caller-owned memory.
+     *
+     * Called by decode_vector(const float*, size_t, void*, size_t) after the
+     * buffer sizes have been checked. The default implementation copies the
+     * data through the containers.
+     * \param pLlr Pointer to blockLength() LLRs.
+     * \param pData Destination of (infoLength() + 7) / 8 bytes.
+     * \return True, if no errors detected after decoding.
+     */
+    virtual bool decodeExternal(const float* pLlr, unsigned char* pData);
+
+    /*!
+     * \brief Decode eight-bit integer LLRs from caller-owned memory.
+     * \sa decodeExternal(const float*, unsigned char*)
+     */
+    virtual bool decodeExternal(const char* pLlr, unsigned char* pData);
+
 public:
     Decoder();
     virtual ~Decoder();
@@ -75,6 +101,72 @@ public:
      */
     bool decode_vector(const char* pLlr, void* pData);
 
+    /*!
+     * \brief Decode directly from and into caller-owned memory.
+     *
+     * Decoders which support it read the LLRs in place and write the
+     * information bits straight into _pData_, instead of staging them in
+     * their own containers. This requires _pLlr_ to be aligned to 32 bytes.
+     * Other buffers are decoded through the containers, like decode_vector().
+     *
+     * Throws std::invalid_argument, if one of the buffers is too short.
+     * \param pLlr Pointer to llrCount LLRs, at least blockLength().
+     * \param llrCount Number of LLRs at pLlr.
+     * \param pData Destination memory of dataSize bytes.
+     * \param dataSize At least (infoLength() + 7) / 8 bytes.
+     * \return True, if no errors detected after decoding.
+     */
+    bool decode_vector(const float* pLlr, size_t llrCount, void* pData, size_t dataSize);
+
+    /*!
+     * \brief Decode eight-bit integer LLRs directly from caller-owned memory.
+     * \sa decode_vector(const float*, size_t, void*, size_t)
+     */
+    bool decode_vector(const char* pLlr, size_t llrCount, void* pData, size_t dataSize);
+
+    /*!
+     * \brief Decode several frames in one call.
+     *
+     * The default implementation decodes the frames one after another.
+     * Decoders which are able to process multiple frames in parallel
+     * override this function.
+     *
+     * \param pLlr Pointer to frames * blockLength() consecutive LLRs.
+     * \param frames Number of frames to decode.
+     * \param pData Destination of frames * ((infoLength() + 7) / 8) bytes,
+     *              holding the packed information bits of each frame.
+     * \param pResults Optional destination of _frames_ flags, each telling
+     *                 whether no errors were detected in that frame.
+     * \return True, if no errors were detected in any of the frames.
+     */
+    virtual bool decode_batch(const float* pLlr,
+                              size_t frames,
+                              void* pData,
+                              bool* pResults = nullptr);
+
+    /*!
+     * \brief Decode several frames of eight-bit integer LLRs in one call.
+     * \sa decode_batch(const float*, size_t, void*, bool*)
+     */
+    virtual bool decode_batch(const char* pLlr,
+                              size_t frames,
+                              void* pData,
+                              bool* pResults = nullptr);
+
+    /*!
+     * \brief Create a decoder for the same code that shares all immutable
+     *        state with this one.
+     *
+     * Decoders which split their decoding tree into a shared DecoderPlan and
+     * per-object scratch memory can be cloned cheaply, e.g. to give each
+     * worker thread its own decoder. Systematic mode and the error detector
+     * are carried over; the error detector object itself is shared.
+     *
+     * \return A new decoder, owned by the caller, or nullptr if this decoder
+     *         type does not support cloning.
+     */
+    virtual Decoder* clone() const;
+
     /*!
      * \brief Decoder duration
      * \return Number of ticks in nanoseconds for last decoder call.
@@ -203,7 +295,9 @@ Decoder* makeDecoder(size_t blockLength,
  * \param blockLength size of a polar codeword
  * \param listSize if '1' FastSSC Decoder is returned. Else: SCL Decoder
  * \param frozenBits positions of frozen bits ordered in ascending order.
- * \param decoderType choose decoder type. ['char', 'float', 'mixed', 'scan', ]
+ * \param decoderType choose decoder type.
+ *        ['char', 'float', 'mixed', 'scan', 'dscf', 'bp', 'jit', 'fixed', 'fixed char']
+ *        'fixed' selects the unrolled decoder of a registered code, if there is one.
  */
 Decoder* create(size_t blockLength,
                 size_t listSize,
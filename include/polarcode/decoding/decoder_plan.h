@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_DECODER_PLAN_H
+#define PC_DEC_DECODER_PLAN_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief Description of a single node in a decoding tree.
+ */
+struct PlanNode {
+    unsigned type;           ///< Decoder specific node type.
+    unsigned blockLength;    ///< Length of the subcode.
+    unsigned frozenBitCount; ///< Number of frozen bits in the subcode.
+    int left,                ///< Index of the left child, -1 if there is none.
+        right;               ///< Index of the right child, -1 if there is none.
+};
+
+/*!
+ * \brief The immutable structure of a decoding tree.
+ *
+ * Selecting specialized decoders for all subcodes requires the set of frozen
+ * bits to be split recursively, which is the expensive part of building a
+ * decoder. A DecoderPlan does this once and stores the result in a flat array
+ * of PlanNode objects. Decoders instantiated from the same plan only create
+ * their own nodes and scratch memory. Once constructed, a plan is never
+ * modified and may be shared between threads.
+ */
+class DecoderPlan
+{
+public:
+    /*!
+     * \brief Select the node type for a subcode.
+     * \param frozenBits The set of frozen bits of the subcode.
+     * \param blockLength Length of the subcode.
+     * \param split Set to true, if the subcode has to be split into two children.
+     * \param sourceLength Set to a non-zero length to give the node a single child
+     *        instead. The child covers the last sourceLength bits, if all bits
+     *        before them are frozen, and the first sourceLength bits otherwise.
+     * \return The decoder specific node type.
+     */
+    typedef unsigned (*classifier_t)(const std::vector<unsigned>& frozenBits,
+                                     size_t blockLength,
+                                     bool& split,
+                                     size_t& sourceLength);
+
+    /*!
+     * \brief Build the decoding tree for the given code.
+     * \param blockLength Length of the code.
+     * \param frozenBits Set of frozen bits in the code word.
+     * \param classifier Decoder specific node selection.
+     */
+    DecoderPlan(size_t blockLength,
+                const std::vector<unsigned>& frozenBits,
+                classifier_t classifier);
+
+    size_t blockLength() const;                      ///< Length of the code.
+    const std::vector<unsigned>& frozenBits() const; ///< Frozen bits of the code.
+
+    /*!
+     * \brief Get the description of a node. The root node has index 0.
+     * \param index Index of the node.
+     * \return Reference to the node description.
+     */
+    const PlanNode& node(int index) const;
+
+    /*!
+     * \brief Get the number of nodes in the tree.
+     */
+    size_t nodeCount() const;
+
+    /*!
+     * \brief Count the nodes of the given type.
+     * \param type The decoder specific node type.
+     * \return Number of nodes of this type.
+     */
+    size_t nodeCount(unsigned type) const;
+
+    /*!
+     * \brief Get the number of leaf nodes, which have no children.
+     */
+    size_t leafCount() const;
+
+    /*!
+     * \brief Get the number of levels below the root node.
+     *
+     * Each level costs at least one sequential F/G step, so this bounds the
+     * decoding latency.
+     */
+    unsigned depth() const;
+
+private:
+    size_t mBlockLength;
+    std::vector<unsigned> mFrozenBits;
+    std::vector<PlanNode> mNodes;
+
+    int build(const std::vector<unsigned>& frozenBits,
+              size_t blockLength,
+              classifier_t classifier);
+};
+
+/*!
+ * \brief A reference-counted, read-only decoding plan.
+ */
+typedef std::shared_ptr<const DecoderPlan> plan_t;
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_DECODER_PLAN_H
@@ -13,7 +13,6 @@
 #include <polarcode/decoding/avx_float.h>
 #include <polarcode/decoding/decoder.h>
 #include <polarcode/encoding/encoder.h>
-#include <queue>
 #include <vector>
 
 namespace PolarCode {
@@ -26,47 +25,55 @@ typedef Block<float> block_t;
 
 class Node;
 
-struct DecoderHint {
-    Node* node;
-    float reliability;
-};
-
-inline bool compareHints(DecoderHint& a, DecoderHint& b)
-{
-    return a.reliability < b.reliability;
-}
-
+/*!
+ * \brief A set of decoding options, as a change to the configuration it was
+ * derived from.
+ *
+ * Configurations form a tree, in which each one sets the option of a single
+ * deciding node. Following the parent indices up to the root yields the
+ * options of all depth + 1 configured nodes.
+ */
 struct Configuration {
+    int parent;    ///< Index of the parent configuration, -1 for none
+    unsigned node; ///< Index of the configured deciding node
+    int option;    ///< Option of that node
     int depth;
     float parentMetric;
-    std::vector<DecoderHint> nodeList;
-    std::vector<int> nodeOptions;
-    std::string output;
-};
-
-class compareConfigMetrics
-{
-public:
-    bool operator()(Configuration& a, Configuration& b)
-    {
-        return a.parentMetric < b.parentMetric;
-    }
 };
 
 class Manager
 {
     std::vector<Node*> mNodeList;
     Node* xmRootNode;
-    //	std::priority_queue<Configuration, std::vector<Configuration>,
-    // compareConfigMetrics> mConfigList;
-    std::queue<Configuration> mConfigList;
-    std::vector<unsigned> mNodeRanking;
     int mTrialLimit;
 
-    Configuration mBestConfig;
+    /* All configurations of a frame, in the order in which they are tried.
+     * The list is reserved for the trial limit once the tree is built, so that
+     * decoding does not allocate.
+     */
+    std::vector<Configuration> mConfigList;
+    unsigned mCurrentConfig;
+
+    std::vector<unsigned> mRanking;      ///< Deciding nodes, weakest first
+    std::vector<char> mConfigured;       ///< Marks the nodes of a configuration
+    std::vector<int> mAppliedOptions;    ///< Options of the decoded configuration
+    std::vector<int> mPendingOptions;    ///< Options of the next configuration
+    std::vector<unsigned> mAppliedNodes; ///< Nodes with a non-zero applied option
+    std::vector<unsigned> mPendingNodes; ///< Nodes with a non-zero pending option
+
+    unsigned mBestConfig;
     float mBestMetric;
     bool firstRun;
 
+    float pathMetric();
+    int weakestNode(unsigned config);
+
+    /*!
+     * \brief Decode a configuration, starting at the first node whose option
+     * differs from the previously decoded one.
+     */
+    void applyConfiguration(unsigned config);
+
 public:
     Manager(int trialLimit);
     ~Manager();
@@ -81,9 +88,18 @@ public:
      */
     void pushDecoder(Node*);
 
-    void setRootNode(Node*);
+    /*!
+     * \brief Get the number of deciding nodes created so far.
+     *
+     * Deciding nodes are created in decoding order, so this is the index of
+     * the next one.
+     */
+    unsigned decoderCount();
 
-    void setNodeRanking(std::vector<unsigned>);
+    /*!
+     * \brief Set the root node, after the whole tree has been created.
+     */
+    void setRootNode(Node*);
 
     /*!
      * \brief First decoding run
@@ -138,6 +154,14 @@ public:
 
     virtual void decode();
 
+    /*!
+     * \brief Decode again, starting at a deciding node.
+     *
+     * The LLRs and decisions of all nodes before deciding node _firstNode_
+     * are kept from the previous run. Leaf nodes simply decode again.
+     */
+    virtual void resume(unsigned firstNode);
+
     float reliability();
     int optionCount();
     void setOption(int);
@@ -149,6 +173,7 @@ protected:
     Node *mLeft, ///< Left child node
         *mRight; ///< Right child node
     block_t *mLeftLlr, *mRightLlr;
+    unsigned mRightNode; ///< Index of the first deciding node on the right
 
 public:
     RateRNode();
@@ -162,6 +187,7 @@ public:
     ~RateRNode();
     void setOutput(float*);
     void decode();
+    void resume(unsigned firstNode);
 };
 
 class ShortRateRNode : public RateRNode
@@ -178,6 +204,7 @@ public:
     ~ShortRateRNode();
     void setOutput(float*);
     void decode();
+    void resume(unsigned firstNode);
 };
 
 class RateZeroDecoder : public Node
@@ -0,0 +1,219 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_DSCF_AVX_FLOAT_H
+#define PC_DEC_DSCF_AVX_FLOAT_H
+
+#include <polarcode/decoding/decoder.h>
+#include <polarcode/decoding/decoder_plan.h>
+#include <polarcode/decoding/fastssc_avx_float.h>
+#include <polarcode/encoding/encoder.h>
+
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace DscfAvx {
+
+using FastSscAvx::block_t;
+using FastSscAvx::datapool_t;
+
+/*!
+ * \brief A decision of the first decoding run, which may be reversed.
+ */
+struct FlipCandidate {
+    float metric;  ///< Dynamic SC-Flip metric, lower is more likely wrong
+    unsigned leaf; ///< Index of the deciding leaf, in decoding order
+    unsigned bit;  ///< Code bit to flip, ignored by repetition leaves
+    int partner;   ///< Parity bit to flip alongside, -1 for none
+};
+
+/*!
+ * \brief A leaf of the decoding tree, which makes hard decisions.
+ */
+struct Leaf {
+    FastSscAvx::Node* node; ///< A specialized decoder of FastSscAvxFloat
+    unsigned type;          ///< FastSscAvx::NodeType of the decoder
+};
+
+/*!
+ * \brief Decoding state shared by all nodes of a tree.
+ */
+struct Context {
+    std::vector<Leaf> leaves; ///< All leaves in decoding order
+    FlipCandidate flip;       ///< Decision to reverse
+    bool flipping;            ///< Whether to reverse the decision at all
+
+    /*!
+     * \brief Decode a leaf and reverse its decision, if requested.
+     * \param index Index of the leaf.
+     */
+    void decodeLeaf(unsigned index);
+};
+
+/*!
+ * \brief A Rate-R node, which can resume decoding at any of its leaves.
+ *
+ * Each node keeps the LLRs of its children, so that the LLRs of a leaf stay
+ * valid until a decision before it changes. Resuming decoding at a leaf
+ * only repeats the calculations which depend on that leaf's decision.
+ */
+class RateRNode : public FastSscAvx::Node
+{
+    Context* xmContext;
+    FastSscAvx::Node *mLeft, *mRight;
+    RateRNode *mLeftBranch, *mRightBranch; ///< Children with children, if any
+    unsigned mLeftLeaf, mRightLeaf;        ///< First leaf of each child
+    block_t *mLeftLlr, *mRightLlr;
+    block_t *mLeftBits, *mRightBits; ///< Child bits of short nodes
+    bool mShort;
+
+    FastSscAvx::Node*
+    createChild(const DecoderPlan& plan, int index, RateRNode*& branch, unsigned& leaf);
+    void decodeLeft();
+    void decodeRight();
+    void combine();
+
+public:
+    /*!
+     * \brief Create the child nodes as described by the plan.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node, defining the length of this code.
+     * \param context Shared state, which receives the leaves in decoding order.
+     */
+    RateRNode(const DecoderPlan& plan,
+              const PlanNode& node,
+              FastSscAvx::Node* parent,
+              Context* context);
+    ~RateRNode();
+    void setOutput(float*);
+    void decode();
+
+    /*!
+     * \brief Decode again, beginning at the given leaf.
+     *
+     * All leaves before it must hold the decisions of the last decoding run.
+     * \param leaf Index of the first leaf to decode.
+     */
+    void resume(unsigned leaf);
+};
+
+/*!
+ * \brief Select the node type for a subcode.
+ *
+ * Only rate-0, rate-1, repetition and single parity-check leaves are used,
+ * as their decisions can be reversed individually.
+ * \sa DecoderPlan::classifier_t
+ */
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength);
+
+} // namespace DscfAvx
+
+/*!
+ * \brief The dynamic successive cancellation flip decoder.
+ *
+ * The first run is a Fast-SSC decoding with the specialized nodes of
+ * FastSscAvxFloat. If the error detector rejects its result, each decision
+ * is rated by the dynamic SC-Flip metric
+ *
+ *   M = |L| + 1/alpha * sum(log(1 + exp(-alpha * |L_j|))),
+ *
+ * where the sum runs over the decisions up to and including the rated one.
+ * The decisions are then reversed one at a time, beginning with the lowest
+ * metric, until the error detector accepts the result or the trial limit is
+ * reached. Each trial resumes decoding at the reversed decision instead of
+ * the root. If all trials fail, the result of the first run is returned.
+ */
+class DscfAvxFloat : public Decoder
+{
+    plan_t mPlan;
+    unsigned mTrialLimit;
+    float mAlpha;
+    unsigned mTrialCount;
+
+    FastSscAvx::Node* mNodeBase;
+    FastSscAvx::Node* mLeafRoot; ///< Root node, if it is a leaf
+    DscfAvx::RateRNode* mRoot;   ///< Root node, if it has children
+    DscfAvx::datapool_t* mDataPool;
+    DscfAvx::Context mContext;
+    std::vector<DscfAvx::FlipCandidate> mCandidates;
+    Encoding::Encoder* mEncoder;
+
+    void clear();
+    void initializeContext();
+    void decodeFrom(unsigned leaf);
+    void findCandidates();
+    bool evaluateOutput();
+
+public:
+    /*!
+     * \brief Create a dynamic SC-Flip decoder.
+     * \param blockLength Length of the Polar Code.
+     * \param trialLimit Maximum number of reversed decisions per frame.
+     * \param frozenBits Set of frozen bits in the code word.
+     */
+    DscfAvxFloat(size_t blockLength,
+                 size_t trialLimit,
+                 const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create a dynamic SC-Flip decoder from an existing decoding plan.
+     * \param plan A plan created by DscfAvxFloat::makePlan().
+     * \param trialLimit Maximum number of reversed decisions per frame.
+     */
+    DscfAvxFloat(plan_t plan, size_t trialLimit);
+    ~DscfAvxFloat();
+
+    bool decode();
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Build the decoding plan of this decoder type.
+     * \param blockLength Length of the Polar Code.
+     * \param frozenBits Set of frozen bits in the code word.
+     * \return A plan to be shared by any number of decoders.
+     */
+    static plan_t makePlan(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Get the shared decoding plan.
+     */
+    plan_t plan() const { return mPlan; }
+
+    /*!
+     * \brief Set the maximum number of reversed decisions per frame.
+     */
+    void setTrialLimit(size_t trialLimit);
+
+    /*!
+     * \brief Get the maximum number of reversed decisions per frame.
+     */
+    size_t getListSize() { return mTrialLimit; }
+
+    /*!
+     * \brief Set the scaling of the reliability penalty in the flip metric.
+     * \param alpha Positive scaling factor, which depends on the LLR magnitudes.
+     */
+    void setAlpha(float alpha);
+
+    /*!
+     * \brief Get the number of reversed decisions in the last decode() call.
+     */
+    unsigned trialCount() const { return mTrialCount; }
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_DSCF_AVX_FLOAT_H
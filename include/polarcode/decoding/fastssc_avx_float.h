@@ -12,7 +12,10 @@
 #include <polarcode/datapool.txx>
 #include <polarcode/decoding/avx_float.h>
 #include <polarcode/decoding/decoder.h>
+#include <polarcode/decoding/decoder_plan.h>
+#include <polarcode/decoding/thread_team.h>
 #include <polarcode/encoding/encoder.h>
+#include <functional>
 
 namespace PolarCode {
 namespace Decoding {
@@ -22,6 +25,54 @@ namespace FastSscAvx {
 typedef DataPool<float, 32> datapool_t;
 typedef Block<float> block_t;
 
+/*!
+ * \brief Minimum child length of rate-R nodes, whose F, G and combine kernels
+ *        are split across a thread team.
+ */
+constexpr unsigned PARALLEL_LENGTH = 1 << 15;
+
+/*!
+ * \brief Placement of all LLRs and bits of a decoding tree in a single arena.
+ *
+ * As in the classic SC memory layout, all nodes of a stage share one LLR
+ * buffer: The LLRs of a node are read until its last child is decoded, and
+ * only shorter descendants run in the meantime. The channel LLRs are followed
+ * by the stage buffers in descending order, which adds up to about 2N floats,
+ * then the code word, into which all nodes write their bits in place. Buffers
+ * for bits of sub-vector nodes and G-PC sources come last. Buffers of stages,
+ * which no node of the plan uses, are left out.
+ *
+ * All offsets are in floats and aligned to full AVX vectors.
+ */
+class MemoryLayout
+{
+public:
+    static constexpr unsigned NONE = ~0U; ///< Offset of an unused buffer
+
+    /*!
+     * \brief Lay out the memory for a Fast-SSC decoding plan.
+     * \param plan A plan created by FastSscAvxFloat::makePlan().
+     */
+    MemoryLayout(const DecoderPlan& plan);
+
+    size_t size() const;     ///< Number of floats of the arena.
+    unsigned input() const;  ///< Offset of the channel LLRs.
+    unsigned output() const; ///< Offset of the decoded code word.
+
+    unsigned llr(unsigned length) const;        ///< LLRs of the nodes of a length.
+    unsigned leftBits(unsigned length) const;   ///< Left child bits of short nodes.
+    unsigned rightBits(unsigned length) const;  ///< Right child bits of short nodes.
+    unsigned sourceBits(unsigned length) const; ///< Bits of G-PC sources.
+
+private:
+    size_t mSize;
+    unsigned mInput, mOutput;
+    std::vector<unsigned> mLlr, mLeftBits, mRightBits, mSourceBits; ///< Per stage
+
+    void require(const DecoderPlan& plan, int index);
+    unsigned allocate(unsigned length);
+};
+
 /*!
  * \brief A node of the polar decoding tree.
  */
@@ -30,8 +81,24 @@ class Node
 protected:
     unsigned mBlockLength;  ///< Length of the subcode.
     datapool_t* xmDataPool; ///< Pointer to a DataPool object.
-    block_t *mLlr, *mBit;
+    block_t *mLlr, *mBit;   ///< Memory of a root node without an arena
     float *mInput, *mOutput;
+    const MemoryLayout* xmLayout; ///< Placement of child memory, if any
+    float* xmArena;               ///< Memory of the whole tree
+    ThreadTeam* xmTeam;           ///< Threads of the kernels of long nodes, if any
+
+    /*!
+     * \brief Get a buffer of the tree's arena.
+     * \param offset An offset from xmLayout.
+     */
+    float* arena(unsigned offset);
+
+    /*!
+     * \brief Run a kernel over [0, mBlockLength), split across the thread team.
+     * \param kernel Called as kernel(begin, end) for each member's range, whose
+     *        bounds are multiples of 64 floats.
+     */
+    void split(const std::function<void(unsigned begin, unsigned end)>& kernel);
 
 
 public:
@@ -43,6 +110,21 @@ public:
      * \param pool Pointer to a DataPool, which provides lazy-copyable memory blocks.
      */
     Node(size_t blockLength, datapool_t* pool);
+
+    /*!
+     * \brief Initialize a root node, whose tree works in a single arena.
+     * \param blockLength Length of the code.
+     * \param pool Pointer to a DataPool, which provides lazy-copyable memory blocks.
+     * \param layout Placement of all buffers in the arena.
+     * \param arena Memory of layout->size() floats.
+     * \param team Threads for the kernels of rate-R nodes with children of at
+     *        least PARALLEL_LENGTH bits, or nullptr to decode on one thread.
+     */
+    Node(size_t blockLength,
+         datapool_t* pool,
+         const MemoryLayout* layout,
+         float* arena,
+         ThreadTeam* team = nullptr);
     virtual ~Node();
 
     virtual void decode(); ///< Execute a specialized decoding algorithm.
@@ -77,6 +159,95 @@ public:
 
 enum ChildCreationFlags { BOTH, NO_LEFT = 0x01, NO_RIGHT = 0x02 };
 
+/*!
+ * \brief Node types of the Fast-SSC decoding tree.
+ */
+enum NodeType : unsigned {
+    tRateR,
+    tShortRateR,
+    tROne,
+    tZeroR,
+    tRateZero,
+    tRateOne,
+    tRepetition,
+    tDoubleRepetition,
+    tTripleRepetition,
+    tSpc,
+    tDoubleSpc,
+    tDoubleSpcShort8,
+    tTypeFive,
+    tRepetitionRateOneShort8,
+    tZeroSpc,
+    tZeroSpcShort8,
+    tGRepetition,
+    tGParityCheck
+};
+
+/*
+ * Leaf decoding kernels, which decode the LLRs _in_ of a subcode of length
+ * _blockLength_ into hard decisions _out_. Inputs shorter than a vector are
+ * padded in place, and such outputs are written as a whole vector.
+ */
+void decodeRateZero(float* out, float* in, unsigned blockLength);
+void decodeRateOne(float* out, float* in, unsigned blockLength);
+void decodeRepetition(float* out, float* in, unsigned blockLength);
+void decodeDoubleRepetition(float* out, float* in, unsigned blockLength);
+void decodeTripleRepetition(float* out, float* in, unsigned blockLength);
+void decodeSpc(float* out, float* in, unsigned blockLength);
+void decodeDoubleSpc(float* out, float* in, unsigned blockLength);
+void decodeDoubleSpcShort8(float* out, float* in, unsigned blockLength);
+void decodeTypeFive(float* out, float* in, unsigned blockLength);
+void decodeRepetitionRateOneShort8(float* out, float* in, unsigned blockLength);
+void decodeZeroSpc(float* out, float* in, unsigned blockLength);
+void decodeZeroSpcShort8(float* out, float* in, unsigned blockLength);
+
+/*!
+ * \brief Decode the rate-1 right half of a node, once the left half is in _out_.
+ */
+void decodeROneRight(float* out, float* in, unsigned blockLength);
+
+/*!
+ * \brief Decode the bits [begin, end) of both halves of decodeROneRight().
+ */
+void decodeROneRight(
+    float* out, float* in, unsigned blockLength, unsigned begin, unsigned end);
+
+/*!
+ * \brief Decode a G-REP node with a rate-1 source of half a vector or less.
+ */
+void decodeGRepetitionShort(float* out, float* in, unsigned blockLength);
+
+/*!
+ * \brief Add up all repetitions of a G-REP node's source.
+ */
+void sumRepetitions(float* sourceLlr,
+                    const float* in,
+                    unsigned blockLength,
+                    unsigned sourceLength);
+
+/*!
+ * \brief Copy the decoded source of a G-REP node into all repetitions.
+ */
+void repeatSource(float* out, unsigned blockLength, unsigned sourceLength);
+
+/*!
+ * \brief Combine the LLRs of each parity-check code of a G-PC node.
+ */
+void combineParityChecks(float* sourceLlr,
+                         const float* in,
+                         unsigned blockLength,
+                         unsigned sourceLength);
+
+/*!
+ * \brief Decode the parity-check codes of a G-PC node.
+ * \param sourceBits The decoded parities, or nullptr if all of them are even.
+ */
+void decodeParityChecks(float* out,
+                        const float* in,
+                        const float* sourceBits,
+                        unsigned blockLength,
+                        unsigned sourceLength);
+
 /*!
  * \brief A Rate-R node redirects decoding to polar subcodes of lower complexity.
  */
@@ -85,17 +256,18 @@ class RateRNode : public Node
 protected:
     Node *mLeft, ///< Left child node
         *mRight; ///< Right child node
-    block_t *mLeftLlr,
-        *mRightLlr; ///< Temporarily holds the LLRs child nodes have to decode.
+    float* mChildLlr; ///< LLRs of the child being decoded, shared by the stage
 
 public:
     /*!
-     * \brief Using the set of frozen bits, specialized subcodes are selected.
-     * \param frozenBits The set of frozen bits of this code.
+     * \brief Create the child nodes as described by the plan.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node, defining the length of this code.
      * \param flags Set to [NO_LEFT | NO_RIGHT] to disable child creation.
      */
-    RateRNode(const std::vector<unsigned>& frozenBits,
+    RateRNode(const DecoderPlan& plan,
+              const PlanNode& node,
               Node* parent,
               ChildCreationFlags flags = BOTH);
     virtual ~RateRNode();
@@ -108,15 +280,16 @@ public:
  */
 class ShortRateRNode : public RateRNode
 {
-    block_t *mLeftBits, *mRightBits;
+    float *mLeftBits, *mRightBits;
 
 public:
     /*!
-     * \brief Using the set of frozen bits, specialized subcodes are selected.
-     * \param frozenBits The set of frozen bits of this code.
+     * \brief Create the child nodes as described by the plan.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node, defining the length of this code.
      */
-    ShortRateRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ShortRateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     virtual ~ShortRateRNode();
     void setOutput(float*);
     void decode();
@@ -214,11 +387,6 @@ public:
 
 class ZeroSpcDecoder : public Node
 {
-    unsigned* mFlipIndices;
-    block_t* mTempBlock;
-    float* mTempBlockPtr;
-    void findWeakLlr();
-
 public:
     ZeroSpcDecoder(Node* parent);
     ~ZeroSpcDecoder();
@@ -233,20 +401,85 @@ public:
     void decode();
 };
 
+void decode_generalized_repetition_generic(float* out,
+                                           const float* in,
+                                           const unsigned block_length,
+                                           const unsigned source_length,
+                                           const bool spc);
+
+/*!
+ * \brief A generalized repetition (G-REP) node.
+ *
+ * All descendants are rate-0, except for the rightmost one of a certain stage,
+ * the source. The code word repeats the source code word, so the source is
+ * decoded once from the sum of all repetitions. This replaces a chain of
+ * ZeroRNode objects by a single level.
+ */
+class GRepetitionDecoder : public Node
+{
+    Node* mSource;          ///< Decoder of the repeated subcode, if any
+    unsigned mSourceLength; ///< Length of the repeated subcode
+    float* mSourceLlr;      ///< Summed LLRs of all repetitions
+
+public:
+    /*!
+     * \brief Create a G-REP decoder.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node.
+     */
+    GRepetitionDecoder(const DecoderPlan& plan, const PlanNode& node, Node* parent);
+    ~GRepetitionDecoder();
+    void setOutput(float*);
+    void decode();
+};
+
+void decode_generalized_spc_generic(float* out,
+                                    const float* in,
+                                    const unsigned block_length,
+                                    const unsigned zero_length);
+
+/*!
+ * \brief A generalized parity-check (G-PC) node.
+ *
+ * All descendants are rate-1, except for the leftmost one of a certain stage,
+ * the source. Bit i of the code word belongs to the i % sourceLength-th of
+ * sourceLength interleaved parity-check codes, whose parities are given by the
+ * source code word. For a rate-0 source, these are even parity-check codes. This
+ * replaces a chain of ROneNode objects by a single level.
+ */
+class GParityCheckDecoder : public Node
+{
+    Node* mSource;          ///< Decoder of the parity subcode, none if it is rate-0
+    unsigned mSourceLength; ///< Length of the parity subcode
+    float *mSourceLlr,      ///< Min-sum combined LLRs of each parity-check code
+        *mSourceBits;       ///< Parities of the parity-check codes
+
+public:
+    /*!
+     * \brief Create a G-PC decoder.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node.
+     */
+    GParityCheckDecoder(const DecoderPlan& plan, const PlanNode& node, Node* parent);
+    ~GParityCheckDecoder();
+    void decode();
+};
+
 /*!
  * \brief Optimized decoding, if the right subcode is rate-1.
  */
 class ROneNode : public RateRNode
 {
-    void rightDecode();
-
 public:
     /*!
      * \brief Initialize the right-rate-1 optimized decoder.
-     * \param frozenBits The set of frozen bits of both subcodes (apparently only left
-     * subcode has frozen bits). \param parent The parent node.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node.
      */
-    ROneNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ROneNode();
     void decode();
 };
@@ -259,35 +492,74 @@ class ZeroRNode : public RateRNode
 public:
     /*!
      * \brief Initialize the left-rate-0 optimized decoder.
-     * \param frozenBits The set of frozen bits for both subcodes.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node.
      */
-    ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ZeroRNode();
     void decode();
 };
 
 /*!
- * \brief Create a specialized decoder for the given set of frozen bits.
- * \param frozenBits The set of frozen bits.
+ * \brief Select a specialized decoder for the given set of frozen bits.
+ * \sa DecoderPlan::classifier_t
+ */
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength);
+
+/*!
+ * \brief Instantiate a node of the decoding plan.
+ * \param plan The decoding plan.
+ * \param index Index of the node in the plan.
  * \param parent The parent node from which the code length is fetched.
  * \return Pointer to a polymorphic decoder object.
  */
-Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent);
 
 } // namespace FastSscAvx
 
+namespace FastSscAvxInterleaved {
+class Node;
+}
+
 /*!
  * \brief The recursive systematic Fast-SSC decoder.
  */
 class FastSscAvxFloat : public Decoder
 {
+    plan_t mPlan;                      ///< Shared decoding tree structure
     FastSscAvx::Node *mNodeBase,       ///< General code information
         *mRootNode;                    ///< Actual decoder
     FastSscAvx::datapool_t* mDataPool; ///< Lazy-copy data-block pool
+    FastSscAvx::MemoryLayout* mLayout; ///< Placement of the tree's buffers
+    FastSscAvx::block_t* mArena;       ///< All LLRs and bits of the tree
     Encoding::Encoder* mEncoder;
+    size_t mThreadCount;
+    ThreadTeam* mTeam; ///< Threads of the parallel mode, if enabled
+
+    FastSscAvxInterleaved::Node *mBatchNodeBase, ///< Frame-interleaved code information
+        *mBatchRootNode;                         ///< Frame-interleaved decoder
+    FastSscAvx::block_t* mBatchBits; ///< Deinterleaved output bits of a batch
 
     void clear();
+    void initializeContext(); ///< Create nodes and scratch memory from mPlan.
+    void initializeBatch();
+    /*!
+     * \brief Extract information bits and check for errors.
+     * \param pData Destination of (infoLength() + 7) / 8 bytes.
+     */
+    bool evaluateOutput(unsigned char* pData);
+
+protected:
+    /*!
+     * \brief Decode the caller's LLRs in place, if they are suitably aligned.
+     * \sa Decoder::decodeExternal()
+     */
+    bool decodeExternal(const float* pLlr, unsigned char* pData);
+    using Decoder::decodeExternal;
 
 public:
     /*!
@@ -296,10 +568,61 @@ public:
      * \param frozenBits Set of frozen bits in the code word.
      */
     FastSscAvxFloat(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create a Fast-SSC decoder from an existing decoding plan.
+     * \param plan A plan created by FastSscAvxFloat::makePlan().
+     */
+    FastSscAvxFloat(plan_t plan);
     ~FastSscAvxFloat();
 
     bool decode();
     void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Build the decoding plan of this decoder type.
+     * \param blockLength Length of the Polar Code.
+     * \param frozenBits Set of frozen bits in the code word.
+     * \return A plan to be shared by any number of decoders.
+     */
+    static plan_t makePlan(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Get the shared decoding plan.
+     */
+    plan_t plan() const { return mPlan; }
+
+    /*!
+     * \brief Decode the frames in groups of eight, interleaved across the lanes
+     *        of the AVX registers.
+     *
+     * The frame-interleaved decoding tree is built on first use.
+     * \sa Decoder::decode_batch()
+     */
+    bool decode_batch(const float* pLlr,
+                      size_t frames,
+                      void* pData,
+                      bool* pResults = nullptr);
+    using Decoder::decode_batch;
+
+    /*!
+     * \brief Decode each frame with a team of threads.
+     *
+     * The F, G and combine kernels of rate-R nodes with children of at least
+     * FastSscAvx::PARALLEL_LENGTH bits are split across the team, which lowers
+     * the latency of very long codes. Shorter nodes and the leaves run on the
+     * calling thread. Batches are always decoded on the calling thread.
+     *
+     * \param threadCount Number of threads, including the calling one. The
+     *        default of 1 disables the parallel mode.
+     */
+    void setThreadCount(size_t threadCount);
+
+    /*!
+     * \brief Get the number of threads which decode a frame.
+     */
+    size_t getThreadCount() { return mThreadCount; }
 };
 
 } // namespace Decoding
@@ -0,0 +1,244 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_FASTSSC_AVX_FLOAT_INTERLEAVED_H
+#define PC_DEC_FASTSSC_AVX_FLOAT_INTERLEAVED_H
+
+#include <polarcode/decoding/fastssc_avx_float.h>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief Frame-interleaved Fast-SSC decoding on AVX float vectors.
+ *
+ * Instead of spreading one codeword over the lanes of an AVX register, each
+ * of the eight float lanes belongs to a different codeword. Bit i of frame f
+ * is stored at index i * FRAMECOUNT + f. This way, every code bit occupies a
+ * full vector and a single walk through the decoding tree decodes eight
+ * frames at once, regardless of how short the constituent codes are.
+ */
+namespace FastSscAvxInterleaved {
+
+using FastSscAvx::block_t;
+using FastSscAvx::ChildCreationFlags;
+using FastSscAvx::datapool_t;
+
+/*!
+ * \brief Number of frames that are decoded in parallel.
+ */
+static constexpr unsigned FRAMECOUNT = 8;
+
+/*!
+ * \brief A node of the frame-interleaved decoding tree.
+ */
+class Node
+{
+protected:
+    unsigned mBlockLength;  ///< Length of the subcode, in bits per frame.
+    datapool_t* xmDataPool; ///< Pointer to a DataPool object.
+    block_t *mLlr, *mBit;
+    float *mInput, *mOutput;
+
+public:
+    Node();
+    Node(Node* other);
+    /*!
+     * \brief Initialize a polar code's root node
+     * \param blockLength Length of the code.
+     * \param pool Pointer to a DataPool, which provides FRAMECOUNT * blockLength
+     *             floats per block.
+     */
+    Node(size_t blockLength, datapool_t* pool);
+    virtual ~Node();
+
+    virtual void decode(); ///< Execute a specialized decoding algorithm.
+
+    void setInput(float*);
+    virtual void setOutput(float*);
+
+    datapool_t* pool();
+    unsigned blockLength();
+    float* input();
+    float* output();
+};
+
+/*!
+ * \brief A Rate-R node redirects decoding to polar subcodes of lower complexity.
+ */
+class RateRNode : public Node
+{
+protected:
+    Node *mLeft, ///< Left child node
+        *mRight; ///< Right child node
+    block_t *mLeftLlr,
+        *mRightLlr; ///< Temporarily holds the LLRs child nodes have to decode.
+
+    void connectChildren();
+
+public:
+    RateRNode(const std::vector<unsigned>& frozenBits,
+              Node* parent,
+              ChildCreationFlags flags = FastSscAvx::BOTH);
+    /*!
+     * \brief Create the child nodes as described by the plan.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node, defining the length of this code.
+     * \param flags Set to [NO_LEFT | NO_RIGHT] to disable child creation.
+     */
+    RateRNode(const DecoderPlan& plan,
+              const PlanNode& node,
+              Node* parent,
+              ChildCreationFlags flags = FastSscAvx::BOTH);
+    virtual ~RateRNode();
+    void setOutput(float*);
+    void decode();
+};
+
+/*!
+ * \brief Optimized decoding, if the right subcode is rate-1.
+ */
+class ROneNode : public RateRNode
+{
+    void rightDecode();
+
+public:
+    ROneNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
+    ~ROneNode();
+    void decode();
+};
+
+/*!
+ * \brief Optimized decoding, if the left subcode is rate-0.
+ */
+class ZeroRNode : public RateRNode
+{
+public:
+    ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
+    ~ZeroRNode();
+    void decode();
+};
+
+class RateZeroDecoder : public Node
+{
+public:
+    RateZeroDecoder(Node* parent);
+    ~RateZeroDecoder();
+    void decode();
+};
+
+class RateOneDecoder : public Node
+{
+public:
+    RateOneDecoder(Node* parent);
+    ~RateOneDecoder();
+    void decode();
+};
+
+class RepetitionDecoder : public Node
+{
+public:
+    RepetitionDecoder(Node* parent);
+    ~RepetitionDecoder();
+    void decode();
+};
+
+class SpcDecoder : public Node
+{
+public:
+    SpcDecoder(Node* parent);
+    ~SpcDecoder();
+    void decode();
+};
+
+/*!
+ * \brief Generalized repetition node, see FastSscAvx::GRepetitionDecoder.
+ */
+class GRepetitionDecoder : public Node
+{
+    Node* mSource;          ///< Decoder of the repeated source code
+    unsigned mSourceLength; ///< Length of the source code
+    block_t* mSourceLlr;    ///< Sum of all repetitions of the source
+
+public:
+    GRepetitionDecoder(const DecoderPlan& plan, const PlanNode& node, Node* parent);
+    ~GRepetitionDecoder();
+    void setOutput(float*);
+    void decode();
+};
+
+/*!
+ * \brief Generalized parity-check node, see FastSscAvx::GParityCheckDecoder.
+ */
+class GParityCheckDecoder : public Node
+{
+    Node* mSource;          ///< Decoder of the parities, nullptr if all are even
+    unsigned mSourceLength; ///< Number of parity-check codes
+    block_t *mSourceLlr, *mSourceBits;
+
+public:
+    GParityCheckDecoder(const DecoderPlan& plan, const PlanNode& node, Node* parent);
+    ~GParityCheckDecoder();
+    void decode();
+};
+
+/*!
+ * \brief Create a frame-interleaved decoder for the given set of frozen bits.
+ * \param frozenBits The set of frozen bits.
+ * \param parent The parent node from which the code length is fetched.
+ * \return Pointer to a polymorphic decoder object.
+ */
+Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
+
+/*!
+ * \brief Create the frame-interleaved counterpart of a Fast-SSC plan node.
+ *
+ * The tree takes the same decisions as the single-frame decoder of the plan.
+ * Special leaves without an interleaved kernel are split into their
+ * repetition and parity-check subcodes, which decode alike.
+ *
+ * \param plan A plan created by FastSscAvxFloat::makePlan().
+ * \param index Index of the node in the plan.
+ * \param parent The parent node from which the code length is fetched.
+ * \return Pointer to a polymorphic decoder object.
+ */
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent);
+
+/*!
+ * \brief Interleave up to FRAMECOUNT consecutive frames into lane-wise layout.
+ * \param dst Interleaved destination, FRAMECOUNT * blockLength floats.
+ * \param src Consecutive frames, frameCount * blockLength floats.
+ * \param blockLength Length of a single frame.
+ * \param frameCount Number of frames to interleave. Missing lanes are zeroed.
+ */
+void interleaveFrames(float* dst,
+                      const float* src,
+                      size_t blockLength,
+                      size_t frameCount);
+
+/*!
+ * \brief Inverse of interleaveFrames().
+ * \param dst Consecutive frames, frameCount * blockLength floats.
+ * \param src Interleaved source, FRAMECOUNT * blockLength floats.
+ * \param blockLength Length of a single frame.
+ * \param frameCount Number of frames to extract.
+ */
+void deinterleaveFrames(float* dst,
+                        const float* src,
+                        size_t blockLength,
+                        size_t frameCount);
+
+} // namespace FastSscAvxInterleaved
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_FASTSSC_AVX_FLOAT_INTERLEAVED_H
@@ -11,6 +11,7 @@
 
 #include <polarcode/datapool.txx>
 #include <polarcode/decoding/decoder.h>
+#include <polarcode/decoding/decoder_plan.h>
 #include <polarcode/decoding/fip_char.h>
 #include <polarcode/encoding/encoder.h>
 
@@ -97,11 +98,12 @@ protected:
 
 public:
     /*!
-     * \brief Using the set of frozen bits, specialized subcodes are selected.
-     * \param frozenBits The set of frozen bits of this code.
+     * \brief Create the child nodes as described by the plan.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node, defining the length of this code.
      */
-    RateRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    RateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~RateRNode();
     void decode(fipv* LlrIn, fipv* BitsOut);
 };
@@ -118,11 +120,12 @@ protected:
 
 public:
     /*!
-     * \brief Using the set of frozen bits, specialized subcodes are selected.
-     * \param frozenBits The set of frozen bits of this code.
+     * \brief Create the child nodes as described by the plan.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node, defining the length of this code.
      */
-    ShortRateRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ShortRateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ShortRateRNode();
     void decode(fipv* LlrIn, fipv* BitsOut);
 };
@@ -137,10 +140,11 @@ class ROneNode : public RateRNode
 public:
     /*!
      * \brief Initialize the right-rate-1 optimized decoder.
-     * \param frozenBits The set of frozen bits of both subcodes (apparently only left
-     * subcode has frozen bits). \param parent The parent node.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node.
      */
-    ROneNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ROneNode();
     void decode(fipv* LlrIn, fipv* BitsOut);
 };
@@ -155,10 +159,11 @@ class ShortROneNode : public ShortRateRNode
 public:
     /*!
      * \brief Initialize the right-rate-1 optimized decoder.
-     * \param frozenBits The set of frozen bits of both subcodes (apparently only left
-     * subcode has frozen bits). \param parent The parent node.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
+     * \param parent The parent node.
      */
-    ShortROneNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ShortROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ShortROneNode();
     void decode(fipv* LlrIn, fipv* BitsOut);
 };
@@ -171,10 +176,11 @@ class ZeroRNode : public RateRNode
 public:
     /*!
      * \brief Initialize the left-rate-0 optimized decoder.
-     * \param frozenBits The set of frozen bits for both subcodes.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node.
      */
-    ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ZeroRNode();
     void decode(fipv* LlrIn, fipv* BitsOut);
 };
@@ -187,10 +193,11 @@ class ShortZeroRNode : public ShortRateRNode
 public:
     /*!
      * \brief Initialize the left-rate-0 optimized decoder.
-     * \param frozenBits The set of frozen bits for both subcodes.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node.
      */
-    ShortZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ShortZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ShortZeroRNode();
     void decode(fipv* LlrIn, fipv* BitsOut);
 };
@@ -283,26 +290,87 @@ public:
 };
 
 /*!
- * \brief Create a specialized decoder for the given set of frozen bits.
- * \param frozenBits The set of frozen bits.
+ * \brief Node types of the Fast-SSC decoding tree.
+ */
+enum NodeType : unsigned {
+    tRateR,
+    tShortRateR,
+    tROne,
+    tShortROne,
+    tZeroR,
+    tShortZeroR,
+    tRateZero,
+    tRateOne,
+    tRepetition,
+    tShortRepetition,
+    tDoubleRepetition,
+    tSpc,
+    tShortSpc,
+    tZeroSpc,
+    tShortZeroSpc,
+    tShortZeroOne
+};
+
+/*!
+ * \brief Select a specialized decoder for the given set of frozen bits.
+ * \sa DecoderPlan::classifier_t
+ */
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength);
+
+/*!
+ * \brief Instantiate a node of the decoding plan.
+ * \param plan The decoding plan.
+ * \param index Index of the node in the plan.
  * \param parent The parent node from which the code length is fetched.
  * \return Pointer to a polymorphic decoder object.
  */
-Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent);
 
 } // namespace FastSscFip
 
+namespace FastSscFipInterleaved {
+class Node;
+}
+
 /*!
  * \brief The recursive systematic Fast-SSC decoder.
  */
 class FastSscFipChar : public Decoder
 {
+    plan_t mPlan;                              ///< Shared decoding tree structure
     FastSscFip::Node *mNodeBase,               ///< General code information
         *mRootNode;                            ///< Actual decoder
     DataPool<fipv, BYTESPERVECTOR>* mDataPool; ///< Lazy-copy data-block pool
     Encoding::Encoder* mEncoder;               ///< Encoder for non-systematic output
 
+    FastSscFipInterleaved::Node *mBatchNodeBase, ///< Inter-frame code information
+        *mBatchRootNode;                         ///< Inter-frame decoder
+    Block<fipv>*mBatchLlr,                       ///< Consecutive LLRs of a batch
+        *mBatchBits;                             ///< Deinterleaved output bits of a batch
+
     void clear();
+    void initializeContext(); ///< Create nodes and scratch memory from mPlan.
+    void initializeBatch();
+    /*!
+     * \brief Extract information bits and check for errors.
+     * \param pData Destination of (infoLength() + 7) / 8 bytes.
+     */
+    bool evaluateOutput(unsigned char* pData);
+    bool decodeBatchGroup(const char* pLlr,
+                          size_t frameCount,
+                          unsigned char* pData,
+                          bool* pResults);
+
+protected:
+    /*!
+     * \brief Decode the caller's LLRs in place, if they are suitably aligned.
+     * \sa Decoder::decodeExternal()
+     */
+    bool decodeExternal(const char* pLlr, unsigned char* pData);
+    using Decoder::decodeExternal;
 
 public:
     /*!
@@ -311,10 +379,51 @@ public:
      * \param frozenBits Set of frozen bits in the code word.
      */
     FastSscFipChar(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create a Fast-SSC decoder from an existing decoding plan.
+     * \param plan A plan created by FastSscFipChar::makePlan().
+     */
+    FastSscFipChar(plan_t plan);
     ~FastSscFipChar();
 
     bool decode();
     void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Build the decoding plan of this decoder type.
+     * \param blockLength Length of the Polar Code.
+     * \param frozenBits Set of frozen bits in the code word.
+     * \return A plan to be shared by any number of decoders.
+     */
+    static plan_t makePlan(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Get the shared decoding plan.
+     */
+    plan_t plan() const { return mPlan; }
+
+    /*!
+     * \brief Decode the frames in groups of BYTESPERVECTOR, one frame per
+     *        byte lane of the AVX registers.
+     *
+     * The inter-frame decoding tree is built on first use.
+     * \sa Decoder::decode_batch()
+     */
+    bool decode_batch(const char* pLlr,
+                      size_t frames,
+                      void* pData,
+                      bool* pResults = nullptr);
+
+    /*!
+     * \brief Quantize float LLRs to eight bits and decode them in groups.
+     * \sa decode_batch(const char*, size_t, void*, bool*)
+     */
+    bool decode_batch(const float* pLlr,
+                      size_t frames,
+                      void* pData,
+                      bool* pResults = nullptr);
 };
 
 } // namespace Decoding
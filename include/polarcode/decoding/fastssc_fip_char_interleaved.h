@@ -0,0 +1,173 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_FASTSSC_FIP_INTERLEAVED_H
+#define PC_DEC_FASTSSC_FIP_INTERLEAVED_H
+
+#include <polarcode/decoding/fastssc_fip_char.h>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief Inter-frame Fast-SSC decoding on eight-bit integer vectors.
+ *
+ * Each of the BYTESPERVECTOR lanes of a fipv belongs to a different
+ * codeword. Bit i of frame f is stored at byte i * FRAMECOUNT + f, so every
+ * code bit occupies a full vector. The subvector-length special cases of the
+ * single-frame decoder are therefore not needed and one walk through the
+ * decoding tree decodes FRAMECOUNT frames.
+ */
+namespace FastSscFipInterleaved {
+
+typedef DataPool<fipv, BYTESPERVECTOR> datapool_t;
+
+/*!
+ * \brief Number of frames that are decoded in parallel.
+ */
+static constexpr unsigned FRAMECOUNT = BYTESPERVECTOR;
+
+/*!
+ * \brief A node of the inter-frame decoding tree.
+ */
+class Node
+{
+    Block<fipv>*mLlr, *mBit;
+
+protected:
+    datapool_t* xmDataPool; ///< Pointer to a DataPool object.
+    size_t mBlockLength;    ///< Length of the subcode, equal to its vector count.
+
+public:
+    Node();
+    Node(Node* parent);
+    /*!
+     * \brief Initialize a polar code's root node
+     * \param blockLength Length of the code.
+     * \param pool Pointer to a DataPool, which provides lazy-copyable memory blocks.
+     */
+    Node(size_t blockLength, datapool_t* pool);
+    virtual ~Node();
+
+    virtual void decode(fipv* LlrIn,
+                        fipv* BitsOut); ///< Execute a specialized decoding algorithm.
+
+    datapool_t* pool();
+    size_t blockLength();
+    fipv* input();
+    fipv* output();
+};
+
+/*!
+ * \brief A Rate-R node redirects decoding to polar subcodes of lower complexity.
+ */
+class RateRNode : public Node
+{
+protected:
+    Node *mLeft,           ///< Left child node
+        *mRight;           ///< Right child node
+    Block<fipv>* ChildLlr; ///< Temporarily holds the LLRs child nodes have to decode.
+
+public:
+    RateRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ~RateRNode();
+    void decode(fipv* LlrIn, fipv* BitsOut);
+};
+
+/*!
+ * \brief Optimized decoding, if the right subcode is rate-1.
+ */
+class ROneNode : public RateRNode
+{
+public:
+    ROneNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ~ROneNode();
+    void decode(fipv* LlrIn, fipv* BitsOut);
+};
+
+/*!
+ * \brief Optimized decoding, if the left subcode is rate-0.
+ */
+class ZeroRNode : public RateRNode
+{
+public:
+    ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ~ZeroRNode();
+    void decode(fipv* LlrIn, fipv* BitsOut);
+};
+
+class RateZeroDecoder : public Node
+{
+public:
+    RateZeroDecoder(Node* parent);
+    ~RateZeroDecoder();
+    void decode(fipv*, fipv* BitsOut);
+};
+
+class RateOneDecoder : public Node
+{
+public:
+    RateOneDecoder(Node* parent);
+    ~RateOneDecoder();
+    void decode(fipv* LlrIn, fipv* BitsOut);
+};
+
+class RepetitionDecoder : public Node
+{
+public:
+    RepetitionDecoder(Node* parent);
+    ~RepetitionDecoder();
+    void decode(fipv* LlrIn, fipv* BitsOut);
+};
+
+class SpcDecoder : public Node
+{
+public:
+    SpcDecoder(Node* parent);
+    ~SpcDecoder();
+    void decode(fipv* LlrIn, fipv* BitsOut);
+};
+
+/*!
+ * \brief Create an inter-frame decoder for the given set of frozen bits.
+ * \param frozenBits The set of frozen bits.
+ * \param parent The parent node from which the code length is fetched.
+ * \return Pointer to a polymorphic decoder object.
+ */
+Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
+
+/*!
+ * \brief Interleave up to FRAMECOUNT consecutive frames into lane-wise layout.
+ * \param dst Interleaved destination, FRAMECOUNT * blockLength bytes.
+ * \param src Consecutive frames, frameCount * blockLength bytes.
+ * \param blockLength Length of a single frame.
+ * \param frameCount Number of frames to interleave. Missing lanes are zeroed.
+ */
+void interleaveFrames(char* dst,
+                      const char* src,
+                      size_t blockLength,
+                      size_t frameCount);
+
+/*!
+ * \brief Inverse of interleaveFrames().
+ * \param dst Consecutive frames, frameCount * blockLength bytes.
+ * \param src Interleaved source, FRAMECOUNT * blockLength bytes.
+ * \param blockLength Length of a single frame.
+ * \param frameCount Number of frames to extract.
+ */
+void deinterleaveFrames(char* dst,
+                        const char* src,
+                        size_t blockLength,
+                        size_t frameCount);
+
+} // namespace FastSscFipInterleaved
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_FASTSSC_FIP_INTERLEAVED_H
@@ -0,0 +1,186 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_FASTSSC_SCHEDULE_H
+#define PC_DEC_FASTSSC_SCHEDULE_H
+
+#include <polarcode/decoding/fastssc_avx_float.h>
+
+#include <cstdint>
+#include <string>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace FastSscAvx {
+
+/*!
+ * \brief Operations of a flattened Fast-SSC decoding schedule.
+ */
+enum Opcode : unsigned {
+    opF,                       ///< F-function into the left child's LLRs
+    opG,                       ///< G-function into the right child's LLRs
+    opG0R,                     ///< G-function behind a rate-0 left child
+    opCombine,                 ///< Combine the children's bits in place
+    opCombine0R,               ///< Combine behind a rate-0 left child
+    opCombineShort,            ///< Combine the bits of two sub-vector children
+    opROneRight,               ///< Decode a rate-1 right child and combine
+    opRateZero,                ///< Leaf decoders, see NodeType
+    opRateOne,                 ///<
+    opRepetition,              ///<
+    opDoubleRepetition,        ///<
+    opTripleRepetition,        ///<
+    opSpc,                     ///<
+    opDoubleSpc,               ///<
+    opDoubleSpcShort8,         ///<
+    opTypeFive,                ///<
+    opRepetitionRateOneShort8, ///<
+    opZeroSpc,                 ///<
+    opZeroSpcShort8,           ///<
+    opGRepetitionShort,        ///< G-REP node with a sub-vector rate-1 source
+    opSumRepetitions,          ///< Sum the repetitions of a G-REP source
+    opRepeatSource,            ///< Copy a G-REP source into all repetitions
+    opCombineParityChecks,     ///< Combine the LLRs of the codes of a G-PC node
+    opDecodeParityChecks,      ///< Decode the parity-check codes of a G-PC node
+    opCount
+};
+
+/*!
+ * \brief A single step of a decoding schedule.
+ *
+ * All operands are offsets into the float arena of the decoder.
+ */
+struct Instruction {
+    unsigned opcode; ///< The operation, an Opcode.
+    unsigned length; ///< Length of the node this step belongs to.
+    unsigned input;  ///< Offset of the node's LLRs.
+    unsigned output; ///< Offset of the written LLRs or bits.
+    unsigned bits;   ///< Offset of bits to read, or Schedule::NONE.
+    unsigned param;  ///< Length of the source of generalized nodes, or zero.
+
+    bool operator==(const Instruction& other) const;
+};
+
+/*!
+ * \brief The decoding tree of FastSscAvxFloat as a linear list of instructions.
+ *
+ * The tree decoder descends through virtual calls of nodes, each of which
+ * are linked by pointers. A schedule records the same kernel calls in
+ * decoding order, working on an arena of the same MemoryLayout. An
+ * interpreter then runs the decoder in a single loop, without pointer chasing.
+ *
+ * Schedules can be printed for inspection, and they can be stored and loaded
+ * as a vector of 32-bit words.
+ */
+class Schedule
+{
+public:
+    static constexpr unsigned NONE = ~0U; ///< Unused operand
+
+    /*!
+     * \brief Compile a Fast-SSC decoding plan.
+     * \param plan A plan created by FastSscAvxFloat::makePlan().
+     */
+    Schedule(const DecoderPlan& plan);
+
+    /*!
+     * \brief Load a schedule written by serialize().
+     *
+     * Throws std::invalid_argument, if the words are no valid schedule.
+     */
+    Schedule(const std::vector<uint32_t>& words);
+
+    /*!
+     * \brief Write the schedule into a vector of 32-bit words.
+     */
+    std::vector<uint32_t> serialize() const;
+
+    /*!
+     * \brief List the instructions, one per line.
+     */
+    std::string toString() const;
+
+    size_t blockLength() const;                      ///< Length of the code.
+    const std::vector<unsigned>& frozenBits() const; ///< Frozen bits of the code.
+    size_t arenaLength() const;   ///< Number of floats of the decoder's arena.
+    unsigned inputOffset() const; ///< Offset of the channel LLRs in the arena.
+    unsigned outputOffset() const; ///< Offset of the decoded code word.
+
+    const std::vector<Instruction>& instructions() const;
+
+private:
+    size_t mBlockLength;
+    std::vector<unsigned> mFrozenBits;
+    std::vector<Instruction> mInstructions;
+    size_t mArenaLength;
+    unsigned mInputOffset, mOutputOffset;
+
+    void compile(const DecoderPlan& plan,
+                 const MemoryLayout& layout,
+                 int index,
+                 unsigned input,
+                 unsigned output);
+    void emit(unsigned opcode,
+              unsigned length,
+              unsigned input,
+              unsigned output,
+              unsigned bits = NONE,
+              unsigned param = 0);
+    void validate() const;
+};
+
+/*!
+ * \brief A reference-counted, read-only decoding schedule.
+ */
+typedef std::shared_ptr<const Schedule> schedule_t;
+
+} // namespace FastSscAvx
+
+/*!
+ * \brief A Fast-SSC decoder, which runs a flattened decoding schedule.
+ *
+ * Decisions equal those of FastSscAvxFloat.
+ */
+class FastSscScheduleFloat : public Decoder
+{
+    FastSscAvx::schedule_t mSchedule;
+    FastSscAvx::datapool_t* mDataPool;
+    FastSscAvx::block_t* mArena;
+    Encoding::Encoder* mEncoder;
+
+    void clear();
+    void initializeContext(); ///< Create the arena and containers for mSchedule.
+
+public:
+    /*!
+     * \brief Compile the decoding tree of a code and create a decoder for it.
+     * \param blockLength Length of the Polar Code.
+     * \param frozenBits Set of frozen bits in the code word.
+     */
+    FastSscScheduleFloat(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create a decoder from an existing schedule.
+     */
+    FastSscScheduleFloat(FastSscAvx::schedule_t schedule);
+    ~FastSscScheduleFloat();
+
+    bool decode();
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Get the shared decoding schedule.
+     */
+    FastSscAvx::schedule_t schedule() const { return mSchedule; }
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_FASTSSC_SCHEDULE_H
@@ -364,7 +364,7 @@ inline void CombineBits(fipv *Left, fipv *Right, fipv *Out) {
 
 template<unsigned blockLength>
 inline void Combine_0R(fipv *Bits) {
-	const unsigned vecLength = blockLength / 8;
+	constexpr unsigned vecLength = nBit2cvecCount(blockLength);
 	for(unsigned i = 0; i < vecLength; ++i) {
 		fi_store(Bits + i, fi_load(Bits + vecLength + i));
 	}
@@ -408,9 +408,9 @@ inline void Combine_0RShort<8>(fipv *Bits, fipv *RightBits) {
 #ifdef __AVX2__
 template<>
 inline void Combine_0RShort<16>(__m256i *Bits, __m256i *RightBits) {
+	// Both halves of the node get the lower lane
 	__m256i vec = _mm256_loadu_si256(RightBits);
-	_mm256_store_si256(Bits, vec);
-	_mm256_store_si256(Bits+1, vec);
+	_mm256_store_si256(Bits, _mm256_permute2x128_si256(vec, vec, 0));
 }
 #endif
 
@@ -15,7 +15,6 @@
 namespace PolarCode {
 namespace Decoding {
 
-
 namespace FixedDecoding {
 
 template <size_t ALIGNMENT>
@@ -48,20 +47,46 @@ public:
     virtual void decode(void* LlrIn, void* BitsOut) = 0;
 };
 
+/*!
+ * \brief Create the unrolled 8-bit kernel of a registered code.
+ * \return The kernel, or nullptr for an unknown scheme.
+ */
 FixedDecoder* createFixedDecoder(unsigned int scheme);
 
+/*!
+ * \brief Create the unrolled floating point decoder of a registered code.
+ * \return A TemplatizedFloat decoder, or nullptr for an unknown scheme.
+ */
+Decoder* createFixedFloat(unsigned int scheme);
+
 } // namespace FixedDecoding
 
+/*!
+ * \brief 8-bit Fast-SSC decoder, unrolled for a code of the registry.
+ */
 class FixedChar : public Decoder
 {
+    unsigned int mScheme;
     FixedDecoding::FixedDecoder* mDecoder;
     Encoding::Encoder* mEncoder;
 
 public:
+    /*!
+     * \brief Create the decoder of a registered code.
+     * \param scheme Index of the code in codeRegistry.
+     */
     FixedChar(unsigned int scheme);
     ~FixedChar();
 
     bool decode();
+    Decoder* clone() const;
+
+    /*!
+     * \brief Fixed decoders can not change their code.
+     *
+     * Throws std::invalid_argument, unless the code is the fixed one.
+     */
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
 };
 
 } // namespace Decoding
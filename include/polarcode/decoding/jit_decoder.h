@@ -0,0 +1,147 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_JIT_DECODER_H
+#define PC_DEC_JIT_DECODER_H
+
+#include <polarcode/decoding/fastssc_avx_float.h>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace Jit {
+
+/*!
+ * \brief Entry point of a compiled decoder library.
+ *
+ * Returns nullptr, if the library was compiled for a different code.
+ */
+typedef Decoder* (*factory_t)(size_t blockLength,
+                              const unsigned* frozenBits,
+                              size_t frozenBitCount);
+
+/*!
+ * \brief Settings of the runtime compiler.
+ */
+struct Options {
+    std::string compiler;   ///< Command of the C++ compiler
+    std::string flags;      ///< Flags to build a shared object
+    std::string includeDir; ///< Location of the polarcode headers
+    std::string cacheDir;   ///< Directory of the compiled decoders
+};
+
+/*!
+ * \brief Get the settings of the runtime compiler.
+ *
+ * The compiler of the library build is used by default, together with the
+ * installed headers, or the source headers for a library in its build tree.
+ * They can be overridden by the environment variables POLARCODE_JIT_CXX,
+ * POLARCODE_JIT_FLAGS and POLARCODE_JIT_INCLUDE_DIR. The decoders are
+ * cached in POLARCODE_JIT_CACHE, or else in $XDG_CACHE_HOME/polarcode or
+ * ~/.cache/polarcode.
+ */
+Options defaultOptions();
+
+/*!
+ * \brief Get the name of the cached decoder for a code.
+ * \return The block length and a hash of the generated code, the compiler
+ *         call, the headers and the library, in hexadecimal.
+ */
+std::string cacheKey(size_t blockLength,
+                     const std::vector<unsigned>& frozenBits,
+                     const Options& options);
+
+/*!
+ * \brief Generate the source code of a specialized decoder.
+ *
+ * The library instantiates TemplatizedFloat for the given code and exports
+ * a factory_t named polarcode_jit_create.
+ * \param blockLength Length of the code.
+ * \param frozenBits The set of frozen bits, in ascending order.
+ */
+std::string sourceCode(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+/*!
+ * \brief Get the factory of a compiled decoder, compiling it if needed.
+ *
+ * Each code is compiled once per cache directory. Libraries which are
+ * compiled or loaded by this process stay loaded until it exits, and all
+ * requests for the same code share one compilation.
+ * \param frozenBits The set of frozen bits, in ascending order.
+ * \return A future factory, which is nullptr if the compilation failed.
+ */
+std::shared_future<factory_t> compile(size_t blockLength,
+                                      const std::vector<unsigned>& frozenBits,
+                                      const Options& options);
+
+} // namespace Jit
+
+/*!
+ * \brief A Fast-SSC decoder, which specializes itself for its code at runtime.
+ *
+ * On creation, a TemplatizedFloat decoder for the given frozen set is
+ * compiled with the system compiler in the background, or loaded from the
+ * cache of earlier compilations. Until it is ready, FastSscAvxFloat decodes
+ * the frames. Both produce the same decisions, so a long-running process
+ * gets the speed of a fixed decoder for any code it meets, without building
+ * it into the library.
+ *
+ * Before the compiled decoder takes over, it decodes a few noisy probe frames
+ * along with Fast-SSC. If the compiler is missing or fails, or any decision
+ * differs, the decoder keeps using Fast-SSC.
+ */
+class JitDecoder : public Decoder
+{
+    Jit::Options mOptions;
+    std::unique_ptr<FastSscAvxFloat> mFallback;
+    std::unique_ptr<Decoder> mCompiled;
+    std::shared_future<Jit::factory_t> mFactory;
+    Decoder* mActive; ///< The decoder which runs the next frame
+
+    void useDecoder(Decoder* decoder);
+    void switchToCompiled();
+
+public:
+    /*!
+     * \brief Create a decoder and start its compilation.
+     * \param blockLength Length of the Polar Code.
+     * \param frozenBits Set of frozen bits in the code word.
+     * \param options Settings of the runtime compiler.
+     */
+    JitDecoder(size_t blockLength,
+               const std::vector<unsigned>& frozenBits,
+               const Jit::Options& options = Jit::defaultOptions());
+    ~JitDecoder();
+
+    bool decode();
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    void setSystematic(bool sys);
+    void setErrorDetection(ErrorDetection::Detector* pDetector);
+
+    /*!
+     * \brief Wait for the compilation of the specialized decoder.
+     * \return True, if the specialized decoder decodes the next frame.
+     */
+    bool waitForCompilation();
+
+    /*!
+     * \brief Check whether the specialized decoder is in use.
+     */
+    bool isCompiled() const { return mActive == mCompiled.get(); }
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_JIT_DECODER_H
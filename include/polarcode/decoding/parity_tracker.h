@@ -0,0 +1,137 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_PARITY_TRACKER_H
+#define PC_DEC_PARITY_TRACKER_H
+
+#include <polarcode/errordetection/distributed_crc.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief Evaluates distributed parity checks while list decoding.
+ *
+ * The tracker follows the leaf nodes of a list decoder from left to right.
+ * After a leaf has decided its bits, its hard decisions are transformed back
+ * to the bits u of the polar transform, and the information bits among them
+ * are recorded for every path. Parity checks whose check bit lies within the
+ * leaf are evaluated then. Tracking only works for non-systematic codes,
+ * whose information bits are exactly the non-frozen u bits.
+ */
+class ParityTracker
+{
+    unsigned mWordCount;                  ///< 64-bit words per path
+    std::vector<unsigned> mInfoCount;     ///< Information bits before each u bit
+    std::vector<unsigned> mInfoPositions; ///< u bit of each information bit
+    std::vector<uint64_t> mCheckMasks;    ///< Check and dependency bits, per check
+    std::vector<unsigned> mCheckEnds;     ///< Information bits needed per check
+    std::vector<uint64_t> mBits;          ///< Decided information bits, per path
+    std::vector<uint64_t> mNextBits;      ///< Information bits of the next paths
+    std::vector<uint64_t> mLeafBits;      ///< Packed decisions of the current leaf
+
+    unsigned mPosition;              ///< First u bit of the current leaf
+    unsigned mLeafLength;            ///< Length of the current leaf
+    unsigned mCheckBegin, mCheckEnd; ///< Checks completed by the current leaf
+
+    void record(unsigned path);
+
+public:
+    ParityTracker();
+
+    /*!
+     * \brief Set up the checks for a code.
+     * \param blockLength Length of the polar code.
+     * \param frozenBits Set of frozen bits.
+     * \param listSize Maximum number of paths.
+     * \param checks Parity checks over the information bits, sorted by position.
+     */
+    void configure(size_t blockLength,
+                   const std::vector<unsigned>& frozenBits,
+                   size_t listSize,
+                   const std::vector<ErrorDetection::ParityCheck>& checks);
+
+    /*!
+     * \brief Remove all checks.
+     */
+    void disable();
+
+    /*!
+     * \brief Check, if any parity checks are configured.
+     */
+    bool enabled() const;
+
+    /*!
+     * \brief Prepare for a new code word with a single path.
+     */
+    void reset();
+
+    /*!
+     * \brief Move on to the next leaf.
+     * \param blockLength Length of the leaf.
+     * \return True, if the leaf contains information bits which are still
+     *         relevant to a parity check.
+     */
+    bool advance(unsigned blockLength);
+
+    /*!
+     * \brief Record the hard decisions of the current leaf.
+     * \param path Index of the path.
+     * \param bits Decisions in their sign bits.
+     */
+    void insert(unsigned path, const float* bits);
+
+    /*!
+     * \brief Record the hard decisions of the current leaf.
+     * \param path Index of the path.
+     * \param bits Decisions in their sign bits.
+     */
+    void insert(unsigned path, const char* bits);
+
+    /*!
+     * \brief Record the hard decisions of the current leaf.
+     * \param path Index of the path.
+     * \param bits Decisions packed into bytes, lowest bit first.
+     */
+    void insertPacked(unsigned path, const uint8_t* bits);
+
+    /*!
+     * \brief Check, if the current leaf completes any parity checks.
+     */
+    bool checksPending() const;
+
+    /*!
+     * \brief Evaluate the checks completed by the current leaf.
+     * \param path Index of the path.
+     * \return True, if all of them are satisfied.
+     */
+    bool passes(unsigned path) const;
+
+    /*!
+     * \brief Copy the recorded bits of a path into the next path list.
+     */
+    void duplicatePath(unsigned destination, unsigned source);
+
+    /*!
+     * \brief Exchange the recorded bits of two paths.
+     */
+    void swapPaths(unsigned first, unsigned second);
+
+    /*!
+     * \brief Make the next path list the current one.
+     */
+    void switchToNext();
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_PARITY_TRACKER_H
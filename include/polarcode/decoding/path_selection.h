@@ -0,0 +1,103 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_PATH_SELECTION_H
+#define PC_DEC_PATH_SELECTION_H
+
+#include <cstdint>
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief Algorithms to select the surviving paths of a list decoder.
+ */
+enum PathSelectionMode {
+    tSelectionSort,  ///< Scalar partial selection sort, simplePartialSortDescending()
+    tThresholdSelect ///< AVX2 threshold search followed by a rank sort
+};
+
+/*!
+ * \brief Finds the n best of the candidate paths at a branching node.
+ *
+ * The threshold select maps all metrics to order-preserving 32-bit integer
+ * keys. A binary search over the key range, counting eight candidates per
+ * instruction, finds the key of the n-th best candidate. The candidates above
+ * that threshold are compacted and ranked by comparing each one against all
+ * others at once. Both algorithms leave the best candidate at index zero.
+ */
+class PathSelector
+{
+    PathSelectionMode mMode;
+    std::vector<int32_t> mKeys;         ///< Keys of all candidates, padded
+    std::vector<int32_t> mSelectedKeys; ///< Keys of the selected candidates, padded
+    std::vector<unsigned> mSelected;    ///< Candidate indices in original order
+    std::vector<unsigned> mOrder;       ///< Candidate indices in descending order
+    std::vector<float> mFloatTemp;
+    std::vector<long> mLongTemp;
+
+    void prepare(unsigned size);
+    void selectKeys(unsigned n, unsigned size);
+
+public:
+    /*!
+     * \brief Create a selector.
+     * \param mode The selection algorithm.
+     */
+    PathSelector(PathSelectionMode mode = tThresholdSelect);
+
+    /*!
+     * \brief Set the selection algorithm.
+     */
+    void setMode(PathSelectionMode mode);
+
+    /*!
+     * \brief Get the selection algorithm.
+     */
+    PathSelectionMode mode() const;
+
+    /*!
+     * \brief Sort the n best of _size_ metrics to the front, best first.
+     *
+     * Behaves like simplePartialSortDescending(): Afterwards, Indices[i] holds
+     * the original position of the i-th best metric, which is moved to
+     * Values[i]. Entries beyond n are undefined.
+     *
+     * \param Indices Receives the candidate indices, at least _size_ elements.
+     * \param Values The candidate metrics.
+     * \param n Number of candidates to select.
+     * \param size Number of candidates.
+     */
+    void select(std::vector<unsigned>& Indices,
+                std::vector<float>& Values,
+                unsigned n,
+                unsigned size);
+
+    /*!
+     * \brief Sort the n best of _size_ metrics in fixed-size arrays to the front.
+     * \sa select()
+     */
+    void select(unsigned* Indices, float* Values, unsigned n, unsigned size);
+
+    /*!
+     * \brief Sort the n best of _size_ integer metrics to the front, best first.
+     *
+     * Metrics more than 2^31 below the best one are treated as equal.
+     * \sa select()
+     */
+    void select(std::vector<unsigned>& Indices,
+                std::vector<long>& Values,
+                unsigned n,
+                unsigned size);
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_PATH_SELECTION_H
@@ -9,12 +9,18 @@
 #ifndef PC_DEC_SCAN_H
 #define PC_DEC_SCAN_H
 
+#include <polarcode/datapool.txx>
 #include <polarcode/decoding/decoder.h>
 #include <vector>
 
 namespace PolarCode {
 namespace Decoding {
 
+namespace ScanObjects {
+typedef DataPool<float, 32> datapool_t;
+typedef Block<float> block_t;
+} // namespace ScanObjects
+
 /*!
  * \brief SCAN - Soft-output CANcellation
  *
@@ -22,19 +28,32 @@ namespace Decoding {
  * "Low-Complexity Soft-Output Decoding of Polar Codes"
  * by Ubaid U. Fayyaz and John R. Barry
  *
+ * The decoding tree is stored level by level in contiguous arrays, in natural
+ * bit order. A node of level l holds N/2^l LLRs, so that a group of nodes is
+ * processed with AVX2 as soon as it is eight values wide.
+ *
+ * If the error detector can reject a result, decoding stops after the first
+ * iteration whose output passes the check.
  */
 class Scan : public Decoder
 {
-    std::vector<float> mLlr, mEven, mOdd;
-    std::vector<float> mSystematicOutput;
+    ScanObjects::datapool_t* mDataPool;
+    ScanObjects::block_t* mLlr;     ///< L messages of all levels, root first
+    ScanObjects::block_t* mEven;    ///< B messages of the last even node per level
+    ScanObjects::block_t* mOdd;     ///< B messages of all odd nodes of levels 1..n
+    ScanObjects::block_t* mInfoLlr; ///< Soft decisions on the information bits
     std::vector<bool> mBooleanFrozen;
-    unsigned int mLevelCount, mN, mIterationLimit;
-
-    unsigned int addressToIndex(unsigned level, unsigned group, unsigned bit);
+    unsigned int mLevelCount, mN, mIterationLimit, mIterationCount;
 
-    void updatellrmap(unsigned level, unsigned group);
-    void updatebitmap(unsigned level, unsigned group);
+    void clear();
+    float* llr(unsigned level);
+    float* even(unsigned level);
+    float* odd(unsigned level, unsigned group);
 
+    void updatellrmap(unsigned group);
+    void updatebitmap(unsigned group);
+    void iterate();
+    bool evaluateOutput();
 
 public:
     Scan(size_t blockLength,
@@ -55,6 +74,11 @@ public:
      * \return size_t with Decoder List size.
      */
     size_t getListSize() { return mIterationLimit; }
+
+    /*!
+     * \brief Get the number of iterations of the last decode() call.
+     */
+    unsigned iterationCount() const { return mIterationCount; }
 };
 
 
@@ -12,6 +12,10 @@
 #include <polarcode/datapool.txx>
 #include <polarcode/decoding/avx_float.h>
 #include <polarcode/decoding/decoder.h>
+#include <polarcode/decoding/decoder_plan.h>
+#include <polarcode/decoding/parity_tracker.h>
+#include <polarcode/decoding/path_selection.h>
+#include <polarcode/decoding/thread_team.h>
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <map>
 #include <vector>
@@ -22,6 +26,8 @@ namespace Decoding {
 namespace SclAvx {
 typedef DataPool<float, 32> datapool_t;
 typedef Block<float> block_t;
+typedef DataPool<uint8_t, 32> bitpool_t; ///< Pool of packed bit-blocks
+typedef Block<uint8_t> bitblock_t;
 
 /*!
  * \brief This class manages the collection of decoding paths.
@@ -29,26 +35,54 @@ typedef Block<float> block_t;
  * In the former list decoder implementation every decoder function
  * reimplemented list access. Now it is centralized in an object of
  * PathList class.
+ *
+ * Partial sums are stored as packed bits, one bit per decision, in the format
+ * of FastSscAvx::packSigns(). This makes copies of diverging paths 32 times
+ * cheaper than with float bits.
+ *
+ * Stages shorter than an AVX vector are stored path-interleaved instead: Row i
+ * of such a stage holds the i-th LLR or bit of all paths, path j in lane j.
+ * Their nodes process eight paths per instruction, and duplicating paths
+ * becomes a permutation of lanes in switchToNext().
  */
 class PathList
 {
     std::vector<std::vector<block_t*>> mLlrTree;
-    std::vector<std::vector<block_t*>> mBitTree;
-    std::vector<std::vector<block_t*>> mLeftBitTree;
+    std::vector<std::vector<bitblock_t*>> mBitTree;
+    std::vector<std::vector<bitblock_t*>> mLeftBitTree;
     std::vector<float> mMetric;
     std::vector<std::vector<block_t*>> mNextLlrTree;
-    std::vector<std::vector<block_t*>> mNextBitTree;
-    std::vector<std::vector<block_t*>> mNextLeftBitTree;
+    std::vector<std::vector<bitblock_t*>> mNextBitTree;
+    std::vector<std::vector<bitblock_t*>> mNextLeftBitTree;
     std::vector<float> mNextMetric;
     //	std::vector<unsigned> mCorrectedNodeIds;
     //	std::vector<unsigned> mNextCorrectedNodeIds;
     unsigned mPathLimit, mPathCount, mNextPathCount;
     unsigned mStageCount;
     datapool_t* xmDataPool;
+    bitpool_t mBitPool;     ///< Packed bit-blocks of all paths
+    PathSelector mSelector; ///< Candidate selection of all nodes
+    ParityTracker mParity;  ///< Distributed parity checks, if any
+
+    unsigned mInterleavedStages;              ///< Number of path-interleaved stages
+    unsigned mLaneCount;                      ///< Row length of interleaved stages
+    std::vector<block_t*> mInterleavedBlocks; ///< Owned rows of all stages
+    std::vector<float*> mInterleavedLlr, mInterleavedBit, mInterleavedLeftBit;
+    float* mPermuted;             ///< Scratch row of permutations
+    std::vector<int> mSourcePath; ///< Source of each path for the next permutation
+    unsigned mPermutationStage;   ///< Lowest stage to permute
+    ThreadTeam* xmTeam;           ///< Threads of parallel path loops, if any
 
     float mApparentlyBestMetric; ///< Information for statistics calculation
     float mSelectedPathMetric;   ///< Information for statistics calculation
 
+    /*!
+     * \brief Reorder the lanes of all path-interleaved stages from _stage_ on.
+     *
+     * Lane j receives the lane mSourcePath[j] for the first _pathCount_ paths.
+     */
+    void permuteInterleaved(unsigned stage, unsigned pathCount);
+
 public:
     PathList();
 
@@ -147,6 +181,18 @@ public:
      */
     void allocateStage(unsigned stage);
 
+    /*!
+     * \brief Reserve data pool blocks for the peak usage of the given stages.
+     *
+     * A stage holds an LLR-, a bit- and a left bit-block per path. While the
+     * next generation of paths is formed, each path may additionally copy its
+     * bit-block. One more LLR-block serves as scratch memory of the
+     * constituent decoders.
+     *
+     * \param stages Marks the stages which are visited by the decoding tree.
+     */
+    void reserve(const std::vector<bool>& stages);
+
     /*!
      * \brief Return LLR- and bit-blocks to the data pool for the given stage.
      *
@@ -165,22 +211,56 @@ public:
     float* Llr(unsigned path, unsigned stage);
 
     /*!
-     * \brief Get a pointer to a bit-block.
+     * \brief Get a pointer to a packed bit-block.
      *
      * \param path Index of the path.
      * \param stage Index of the stage.
      * \return A pointer to an AVX2 aligned memory block.
      */
-    float* Bit(unsigned path, unsigned stage);
+    uint8_t* Bit(unsigned path, unsigned stage);
 
     /*!
-     * \brief Get a pointer to a left bit-block.
+     * \brief Get a pointer to a packed left bit-block.
      *
      * \param path Index of the path.
      * \param stage Index of the stage.
      * \return A pointer to an AVX2 aligned memory block.
      */
-    float* LeftBit(unsigned path, unsigned stage);
+    uint8_t* LeftBit(unsigned path, unsigned stage);
+
+    /*!
+     * \brief Check, if a stage is stored path-interleaved.
+     *
+     * All stages below eight bits are interleaved, except the code's own stage.
+     */
+    bool interleaved(unsigned stage);
+
+    /*!
+     * \brief Get the distance between the rows of a path-interleaved stage.
+     * \return A multiple of eight, not less than the path limit.
+     */
+    unsigned LaneCount();
+
+    /*!
+     * \brief Get the LLR-rows of a path-interleaved stage.
+     * \param stage Index of the stage.
+     * \return A pointer to (1 << stage) AVX2 aligned rows of LaneCount() floats.
+     */
+    float* InterleavedLlr(unsigned stage);
+
+    /*!
+     * \brief Get the bit-rows of a path-interleaved stage.
+     *
+     * Bits are given by the sign of each float.
+     * \sa InterleavedLlr()
+     */
+    float* InterleavedBit(unsigned stage);
+
+    /*!
+     * \brief Get the left bit-rows of a path-interleaved stage.
+     * \sa InterleavedBit()
+     */
+    float* InterleavedLeftBit(unsigned stage);
 
     /*!
      * \brief Swap bit blocks and grant write access to LLR blocks.
@@ -198,13 +278,13 @@ public:
     float* NextLlr(unsigned path, unsigned stage);
 
     /*!
-     * \brief Get a pointer to a future bit-block.
+     * \brief Get a pointer to a future packed bit-block.
      *
      * \param path Index of the path.
      * \param stage Index of the stage.
      * \return A pointer to an AVX2 aligned memory block.
      */
-    float* NextBit(unsigned path, unsigned stage);
+    uint8_t* NextBit(unsigned path, unsigned stage);
 
     /*!
      * \brief Get a reference to the path metric variable.
@@ -234,6 +314,85 @@ public:
      * \brief Set the new number of active paths.
      */
     void setNextPathCount(unsigned);
+
+    /*!
+     * \brief Minimum number of floats a loop over paths processes, before it
+     *        is split across the thread team.
+     */
+    static constexpr unsigned PARALLEL_WORKLOAD = 1 << 14;
+
+    /*!
+     * \brief Set the thread team for loops over paths.
+     * \param team The team, or nullptr to run all loops on the calling thread.
+     */
+    void setTeam(ThreadTeam* team);
+
+    /*!
+     * \brief Get the number of threads which run loops over paths.
+     */
+    unsigned TeamSize();
+
+    /*!
+     * \brief Run a loop over paths, split across the thread team if there is
+     *        enough work.
+     *
+     * The body is called as body(member, begin, end) for each range of paths,
+     * where _member_ is below TeamSize(). It must not allocate, release or
+     * duplicate blocks, as the data pool is not shared between threads.
+     *
+     * \param pathCount Number of paths.
+     * \param workload Number of floats the body processes per path.
+     * \param body The loop body.
+     */
+    template <typename Body>
+    void forEachPath(unsigned pathCount, unsigned workload, Body body)
+    {
+        if (xmTeam == nullptr || pathCount * workload < PARALLEL_WORKLOAD) {
+            body(0, 0, pathCount);
+        } else {
+            xmTeam->split(pathCount, 1, body);
+        }
+    }
+
+    /*!
+     * \brief Get the selector which finds the surviving candidates at branching
+     *        nodes.
+     */
+    PathSelector& selector();
+
+    /*!
+     * \brief Get the tracker of distributed parity checks.
+     */
+    ParityTracker& parity();
+
+    /*!
+     * \brief Remove the paths which fail a distributed parity check.
+     *
+     * Each leaf node calls this function after deciding its bits. The leaves
+     * are expected to be visited from left to right. The order of surviving
+     * paths is kept. If no path survives, the path count drops to zero and the
+     * decoding tree is left early.
+     *
+     * \param stage Stage of the leaf node.
+     * \param blockLength Length of the leaf node.
+     */
+    void checkParity(unsigned stage, unsigned blockLength);
+
+    /*!
+     * \brief Derive soft decisions on the bits of a path from the path metrics.
+     *
+     * The reliability of a bit is the metric gap between the reference path
+     * and the best competing path which decided otherwise, following the
+     * max-log approximation. Only the paths behind the reference compete. If
+     * none of them disagrees, the competitor is assumed to be _penalty_ below
+     * the worst surviving path, as the better ones were all kept.
+     *
+     * \param reference Index of the path which gives the signs.
+     * \param stage Stage of the bit-blocks.
+     * \param penalty Metric distance of unseen competitors to the last path.
+     * \param output LLRs of the bits, room for at least eight values.
+     */
+    void softDecisions(unsigned reference, unsigned stage, float penalty, float* output);
 };
 
 /*!
@@ -321,16 +480,23 @@ public:
 
     /*!
      * \brief Create a decoder node.
-     * \param frozenBits The set of frozen bits for this code.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node to copy all information from.
      */
-    RateRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    RateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~RateRNode();
     void decode();
     //	unsigned lastId();
     //	void setId(unsigned newId);
 };
 
+/*!
+ * \brief A node of eight bits or less, whose children are path-interleaved.
+ *
+ * If the parent stage is stored per path, the LLRs of eight paths are
+ * transposed on the fly.
+ */
 class ShortRateRNode : public RateRNode
 {
     unsigned mLastId;
@@ -338,10 +504,11 @@ class ShortRateRNode : public RateRNode
 public:
     /*!
      * \brief Create a decoder node.
-     * \param frozenBits The set of frozen bits for this code.
+     * \param plan The decoding plan.
+     * \param node Description of this node in the plan.
      * \param parent The parent node to copy all information from.
      */
-    ShortRateRNode(const std::vector<unsigned>& frozenBits, Node* parent);
+    ShortRateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent);
     ~ShortRateRNode();
     void decode();
     //	unsigned lastId();
@@ -349,6 +516,8 @@ public:
 
 class RateZeroDecoder : public Node
 {
+    void decodeInterleaved(); ///< Decode eight paths at a time
+
 public:
     RateZeroDecoder(Node* parent);
     ~RateZeroDecoder();
@@ -359,9 +528,12 @@ class RateOneDecoder : public Node
 {
     std::vector<unsigned> mIndices;
     std::vector<float> mMetrics;
-    std::vector<std::vector<unsigned>> mBitFlipHints;
-    block_t* mTempBlock;
-    float* mTemp;
+    std::vector<float> mWeakLlrs;        ///< Rows of the two weakest LLRs
+    std::vector<unsigned> mWeakIndices; ///< Their positions, two per path
+    std::vector<uint8_t> mPathMasks;    ///< Bits to flip of interleaved paths
+    std::vector<block_t*> mTempBlocks;  ///< Scratch memory of each thread
+
+    void decodeInterleaved(); ///< Decode eight paths at a time
 
 public:
     RateOneDecoder(Node* parent);
@@ -374,6 +546,9 @@ class RepetitionDecoder : public Node
     std::vector<unsigned> mIndices;
     std::vector<float> mMetrics;
     std::vector<float> mResults;
+    std::vector<uint8_t> mPathMasks; ///< Decided bits of interleaved paths
+
+    void decodeInterleaved(); ///< Decode eight paths at a time
 
 public:
     RepetitionDecoder(Node* parent);
@@ -385,10 +560,12 @@ class SpcDecoder : public Node
 {
     std::vector<unsigned> mIndices;
     std::vector<float> mMetrics;
-    std::vector<std::array<unsigned, 4>> mBitFlipHints;
-    std::vector<unsigned> mBitFlipCount;
-    block_t* mTempBlock;
-    float* mTemp;
+    std::vector<float> mWeakLlrs;        ///< Rows of the four weakest LLRs and parity
+    std::vector<unsigned> mWeakIndices; ///< Their positions, four per path
+    std::vector<uint8_t> mPathMasks;    ///< Bits to flip of interleaved paths
+    std::vector<block_t*> mTempBlocks;  ///< Scratch memory of each thread
+
+    void decodeInterleaved(); ///< Decode eight paths at a time
 
 public:
     SpcDecoder(Node* parent);
@@ -396,7 +573,28 @@ public:
     void decode();
 };
 
-Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
+/*!
+ * \brief Node types of the list decoding tree.
+ */
+enum NodeType : unsigned { tRateR, tShortRateR, tRateZero, tRateOne, tRepetition, tSpc };
+
+/*!
+ * \brief Select a specialized list decoder for the given set of frozen bits.
+ * \sa DecoderPlan::classifier_t
+ */
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength);
+
+/*!
+ * \brief Instantiate a node of the decoding plan.
+ * \param plan The decoding plan.
+ * \param index Index of the node in the plan.
+ * \param parent The parent node from which the code length is fetched.
+ * \return Pointer to a polymorphic decoder object.
+ */
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent);
 
 } // namespace SclAvx
 
@@ -407,14 +605,48 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
 class SclAvxFloat : public Decoder
 {
     size_t mListSize;
+    PathSelectionMode mPathSelection;
+    size_t mThreadCount;
+    ThreadTeam* mTeam; ///< Threads of the parallel mode, if enabled
+    plan_t mPlan;      ///< Shared decoding tree structure
     SclAvx::Node *mNodeBase, *mRootNode;
     SclAvx::datapool_t* mDataPool;
-    SclAvx::PathList* mPathList;
     Encoding::Encoder* mEncoder;
 
     void clear();
+    void initializeContext(); ///< Create nodes and path list from mPlan.
     void makeInitialPathList();
-    bool extractBestPath();
+    void configureParityChecks(); ///< Set up early termination, if possible.
+
+protected:
+    SclAvx::PathList* mPathList;
+
+    /*!
+     * \brief Find the first path which passes the error detector.
+     *
+     * The information bits of that path are written to the output container.
+     * If no path passes, the first path is taken.
+     *
+     * \param path Receives the index of the selected path.
+     * \return True, if the selected path passed the error detector.
+     */
+    bool selectPath(unsigned& path);
+
+    /*!
+     * \brief Select the output path and release the path list.
+     * \return True, if the output passed the error detector.
+     */
+    virtual bool extractBestPath();
+
+    /*!
+     * \brief Produce the output of a frame without any surviving path.
+     *
+     * Called instead of extractBestPath(), if parity checks terminated the
+     * decoding early. The information bits are set to zero.
+     *
+     * \return False, as the frame failed.
+     */
+    virtual bool rejectFrame();
 
 public:
     /*!
@@ -426,11 +658,47 @@ public:
     SclAvxFloat(size_t blockLength,
                 size_t listSize,
                 const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create a list decoder from an existing decoding plan.
+     * \param plan A plan created by SclAvxFloat::makePlan().
+     * \param listSize Number of paths to examine while decoding.
+     */
+    SclAvxFloat(plan_t plan, size_t listSize);
     ~SclAvxFloat();
 
     bool decode();
     void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
 
+    /*!
+     * \brief Set the error detection scheme.
+     *
+     * An ErrorDetection::DistributedCrc enables early termination on
+     * non-systematic codes: Paths are discarded as soon as they fail one of its
+     * check bits, and decoding stops when no path is left. On systematic codes,
+     * the CRC is only checked after decoding.
+     *
+     * \param pDetector The error detector, owned by the caller.
+     */
+    void setErrorDetection(ErrorDetection::Detector* pDetector);
+    void setSystematic(bool sys);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Build the decoding plan of this decoder type.
+     *
+     * The plan does not depend on the list size.
+     * \param blockLength Length of the Polar Code.
+     * \param frozenBits Set of frozen bits in the code word.
+     * \return A plan to be shared by any number of decoders.
+     */
+    static plan_t makePlan(size_t blockLength, const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Get the shared decoding plan.
+     */
+    plan_t plan() const { return mPlan; }
+
     /*!
      * \brief Set the path limit parameter.
      * \param newListSize The new maximum path count for decoding.
@@ -442,6 +710,31 @@ public:
      * \return size_t with Decoder List size.
      */
     size_t getListSize() { return mListSize; }
+
+    /*!
+     * \brief Select the algorithm which finds the surviving paths.
+     * \param mode The path selection algorithm, tThresholdSelect by default.
+     */
+    void setPathSelection(PathSelectionMode mode);
+
+    /*!
+     * \brief Decode each frame with a team of threads.
+     *
+     * The paths are split across the team in the loops of the decoding tree
+     * which process at least SclAvx::PathList::PARALLEL_WORKLOAD floats. The
+     * threads synchronise after each loop, and path selection, copies and
+     * memory management stay on the calling thread. This pays off for list
+     * sizes from about 128 on. Decisions do not depend on the thread count.
+     *
+     * \param threadCount Number of threads, including the calling one. The
+     *        default of 1 disables the parallel mode.
+     */
+    void setThreadCount(size_t threadCount);
+
+    /*!
+     * \brief Get the number of threads which decode a frame.
+     */
+    size_t getThreadCount() { return mThreadCount; }
 };
 
 
@@ -12,6 +12,8 @@
 #include <polarcode/datapool.txx>
 #include <polarcode/decoding/decoder.h>
 #include <polarcode/decoding/fip_char.h>
+#include <polarcode/decoding/parity_tracker.h>
+#include <polarcode/decoding/path_selection.h>
 #include <polarcode/encoding/encoder.h>
 #include <map>
 #include <vector>
@@ -44,6 +46,8 @@ class PathList
     unsigned mPathLimit, mPathCount, mNextPathCount;
     unsigned mStageCount;
     datapool_t* xmDataPool;
+    PathSelector mSelector; ///< Candidate selection of all nodes
+    ParityTracker mParity;  ///< Distributed parity checks, if any
 
 public:
     PathList();
@@ -144,6 +148,18 @@ public:
      */
     void allocateStage(unsigned stage);
 
+    /*!
+     * \brief Reserve data pool blocks for the peak usage of the given stages.
+     *
+     * A stage holds an LLR-, a bit- and a left bit-block per path. While the
+     * next generation of paths is formed, each path may additionally copy its
+     * bit-block. One more block serves as scratch memory of the constituent
+     * decoders.
+     *
+     * \param stages Marks the stages which are visited by the decoding tree.
+     */
+    void reserve(const std::vector<bool>& stages);
+
     /*!
      * \brief Return LLR- and bit-blocks to the data pool for the given stage.
      *
@@ -231,6 +247,30 @@ public:
      * \brief Set the new number of active paths.
      */
     void setNextPathCount(unsigned);
+
+    /*!
+     * \brief Get the selector which finds the surviving candidates at branching
+     *        nodes.
+     */
+    PathSelector& selector();
+
+    /*!
+     * \brief Get the tracker of distributed parity checks.
+     */
+    ParityTracker& parity();
+
+    /*!
+     * \brief Remove the paths which fail a distributed parity check.
+     *
+     * Each leaf node calls this function after deciding its bits. The leaves
+     * are expected to be visited from left to right. The order of surviving
+     * paths is kept. If no path survives, the path count drops to zero and the
+     * decoding tree is left early.
+     *
+     * \param stage Stage of the leaf node.
+     * \param blockLength Length of the leaf node.
+     */
+    void checkParity(unsigned stage, unsigned blockLength);
 };
 
 /*!
@@ -391,6 +431,7 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent);
 class SclFipChar : public Decoder
 {
     size_t mListSize;
+    PathSelectionMode mPathSelection;
     SclFip::Node *mNodeBase, *mRootNode;
     SclFip::datapool_t* mDataPool;
     SclFip::PathList* mPathList;
@@ -399,6 +440,7 @@ class SclFipChar : public Decoder
     void clear();
     void makeInitialPathList();
     bool extractBestPath();
+    void configureParityChecks(); ///< Set up early termination, if possible.
 
 public:
     /*!
@@ -415,6 +457,19 @@ public:
     bool decode();
     void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
 
+    /*!
+     * \brief Set the error detection scheme.
+     *
+     * An ErrorDetection::DistributedCrc enables early termination on
+     * non-systematic codes: Paths are discarded as soon as they fail one of its
+     * check bits, and decoding stops when no path is left. On systematic codes,
+     * the CRC is only checked after decoding.
+     *
+     * \param pDetector The error detector, owned by the caller.
+     */
+    void setErrorDetection(ErrorDetection::Detector* pDetector);
+    void setSystematic(bool sys);
+
     /*!
      * \brief Set the path limit parameter.
      * \param newListSize The new maximum path count for decoding.
@@ -426,6 +481,12 @@ public:
      * \return size_t with Decoder List size.
      */
     size_t getListSize() { return mListSize; }
+
+    /*!
+     * \brief Select the algorithm which finds the surviving paths.
+     * \param mode The path selection algorithm, tThresholdSelect by default.
+     */
+    void setPathSelection(PathSelectionMode mode);
 };
 
 
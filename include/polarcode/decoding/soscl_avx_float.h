@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_SOSCL_AVX_FLOAT_H
+#define PC_DEC_SOSCL_AVX_FLOAT_H
+
+#include <polarcode/decoding/scl_avx_float.h>
+
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief A soft-output list decoder.
+ *
+ * Decoding is done by SclAvxFloat. Before the surviving paths are released,
+ * the metric gaps between them give the reliability of each code bit, see
+ * SclAvx::PathList::softDecisions(). This only touches the final bit-blocks
+ * of the paths, no further pass over the decoding tree is needed.
+ *
+ * The a-posteriori LLRs of the code bits replace the hard decisions of the
+ * selected path in the output container, so that getSoftCodeword() returns
+ * them. Their signs are the decisions of the selected path. The extrinsic
+ * LLRs, i.e. the a-posteriori LLRs without the channel LLRs, are meant to be
+ * fed back to a detector or equalizer.
+ *
+ * If the error detector rejects all paths, none of them can be trusted. The
+ * extrinsic LLRs are zero then, and the soft code word equals the channel LLRs.
+ */
+class SoSclAvxFloat : public SclAvxFloat
+{
+    float mPenalty;
+    std::vector<float> mPosterior;
+    std::vector<float> mExtrinsic;
+
+    void allocateOutput();
+
+protected:
+    bool extractBestPath();
+    bool rejectFrame();
+
+public:
+    /*!
+     * \brief Create a soft-output list decoder.
+     * \param blockLength Number of bits sent over a channel.
+     * \param listSize Number of paths to examine while decoding.
+     * \param frozenBits The set of frozen bits.
+     */
+    SoSclAvxFloat(size_t blockLength,
+                  size_t listSize,
+                  const std::vector<unsigned>& frozenBits);
+
+    /*!
+     * \brief Create a soft-output list decoder from an existing decoding plan.
+     * \param plan A plan created by SclAvxFloat::makePlan().
+     * \param listSize Number of paths to examine while decoding.
+     */
+    SoSclAvxFloat(plan_t plan, size_t listSize);
+    ~SoSclAvxFloat();
+
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits);
+    Decoder* clone() const;
+
+    /*!
+     * \brief Set the reliability of bits on which all paths agree.
+     *
+     * The best discarded path is assumed to lie _penalty_ below the worst
+     * surviving path. A larger penalty makes unanimous decisions more reliable.
+     *
+     * \param penalty Non-negative metric distance, in units of the channel LLRs.
+     */
+    void setPenalty(float penalty);
+
+    /*!
+     * \brief Get the metric distance of discarded paths to the surviving ones.
+     */
+    float penalty() const { return mPenalty; }
+
+    /*!
+     * \brief Copy the extrinsic LLRs of the code bits into eLlr.
+     * \param eLlr Memory for blockLength() values.
+     */
+    void getExtrinsicChannelInformation(float* eLlr);
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_SOSCL_AVX_FLOAT_H
@@ -11,37 +11,36 @@
 
 #include <polarcode/avxconvenience.h>
 #include <polarcode/decoding/decoder.h>
+#include <polarcode/encoding/butterfly_fip_packed.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
 namespace TemplatizedFloatCalc {
 
-inline float float_or(float& a, float& b)
+// Bits of floats are accessed through HybridFloat, as pointer casts break the
+// strict aliasing rules and get reordered by the optimizer
+inline float float_or(float a, float b)
 {
-    union {
-        unsigned int iRet;
-        float fRet;
-    };
-    unsigned int* iA = reinterpret_cast<unsigned int*>(&a);
-    unsigned int* iB = reinterpret_cast<unsigned int*>(&b);
-    iRet = *iA | *iB;
-    return fRet;
+    HybridFloat hA, hB;
+    hA.f = a;
+    hB.f = b;
+    hA.u |= hB.u;
+    return hA.f;
 }
 
-inline float float_xor(float& a, float& b)
+inline float float_xor(float a, float b)
 {
-    union {
-        unsigned int iRet;
-        float fRet;
-    };
-    unsigned int* iA = reinterpret_cast<unsigned int*>(&a);
-    unsigned int* iB = reinterpret_cast<unsigned int*>(&b);
-    iRet = *iA ^ *iB;
-    return fRet;
+    HybridFloat hA, hB;
+    hA.f = a;
+    hB.f = b;
+    hA.u ^= hB.u;
+    return hA.f;
 }
 
 inline __m256 hardDecode(__m256 x)
@@ -69,17 +68,12 @@ inline void F_function_calc(__m256& Left, __m256& Right, float* Out)
     _mm256_store_ps(Out, _mm256_or_ps(sgnV, minV));
 }
 
-inline float F_function_signXor(float& fa, float& fb)
+inline float F_function_signXor(float fa, float fb)
 {
-    unsigned int* ia = reinterpret_cast<unsigned int*>(&fa);
-    unsigned int* ib = reinterpret_cast<unsigned int*>(&fb);
-    union {
-        float fRet;
-        unsigned int iRet;
-    };
-
-    iRet = (*ia ^ *ib) & 0x80000000U;
-    return fRet;
+    HybridFloat ret;
+    ret.f = float_xor(fa, fb);
+    ret.u &= 0x80000000U;
+    return ret.f;
 }
 
 inline float F_function_calc(float Left, float Right)
@@ -259,10 +253,7 @@ inline void decodeRepetition(float* input, float* output)
 template <const int size>
 inline void decodeSpc(float* input, float* output)
 {
-    union {
-        float fParity;
-        unsigned int iParity;
-    };
+    HybridFloat parity;
     unsigned minIdx = 0;
     float testAbs, minAbs = INFINITY;
 
@@ -284,16 +275,14 @@ inline void decodeSpc(float* input, float* output)
             }
         }
 
-        // Flip least reliable bit, if neccessary
-        fParity = reduce_xor_ps(parVec);
+        parity.f = reduce_xor_ps(parVec);
 
     } else {
-        unsigned int* iInput = reinterpret_cast<unsigned int*>(input);
-        iParity = 0;
+        parity.f = 0.0f;
         minAbs = fabs(input[0]);
         for (unsigned i = 0; i < size; ++i) {
             output[i] = input[i];
-            iParity ^= iInput[i];
+            parity.f = TemplatizedFloatCalc::float_xor(parity.f, input[i]);
             testAbs = fabs(input[i]);
             if (testAbs < minAbs) {
                 minAbs = testAbs;
@@ -301,8 +290,11 @@ inline void decodeSpc(float* input, float* output)
             }
         }
     }
-    iParity &= 0x80000000;
-    reinterpret_cast<unsigned int*>(output)[minIdx] ^= iParity;
+
+    // Flip least reliable bit, if neccessary
+    if (parity.u & 0x80000000U) {
+        output[minIdx] = -output[minIdx];
+    }
 }
 
 template <const int size>
@@ -346,7 +338,7 @@ class TemplatizedFloat : public Decoder
     inline void decodeRateR(float input[size], float output[size])
     {
         using namespace TemplatizedFloatCalc;
-        float llr[size / 2];
+        alignas(32) float llr[size / 2];
 
         F_function<size / 2>(input, llr);
         decodeNode<begin, size / 2>(llr, output);
@@ -359,7 +351,7 @@ class TemplatizedFloat : public Decoder
     inline void decodeROne(float input[size], float output[size])
     {
         using namespace TemplatizedFloatCalc;
-        float llr[size / 2];
+        alignas(32) float llr[size / 2];
 
         F_function<size / 2>(input, llr);
         decodeNode<begin, size / 2>(llr, output);
@@ -370,7 +362,7 @@ class TemplatizedFloat : public Decoder
     inline void decodeZeroR(float input[size], float output[size])
     {
         using namespace TemplatizedFloatCalc;
-        float llr[size / 2];
+        alignas(32) float llr[size / 2];
 
         G_function_0R<size / 2>(input, llr);
         decodeNode<begin + size / 2, size / 2>(llr, output + size / 2);
@@ -423,22 +415,65 @@ class TemplatizedFloat : public Decoder
         */
     }
 
+    Encoding::Encoder* mEncoder;
+
 public:
     TemplatizedFloat(std::vector<unsigned> frozenBits)
     {
+        mBlockLength = N;
+        mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+        mEncoder = new Encoding::ButterflyFipPacked(N, mFrozenBits);
+        mEncoder->setSystematic(false);
         mLlrContainer = new FloatContainer(N);
         mBitContainer = new FloatContainer(N, frozenBits);
-        mOutputContainer = new unsigned char[(N - frozenBits.size()) / 8];
+        mLlrContainer->setFrozenBits(mFrozenBits);
+        mOutputContainer = new unsigned char[(N - frozenBits.size() + 7) / 8];
     }
 
-    ~TemplatizedFloat() {}
+    ~TemplatizedFloat() { delete mEncoder; }
 
     bool decode()
     {
         decodeNode<0, N>(dynamic_cast<FloatContainer*>(mLlrContainer)->data(),
                          dynamic_cast<FloatContainer*>(mBitContainer)->data());
-        mBitContainer->getPackedInformationBits(mOutputContainer);
-        return true;
+        if (!mSystematic) {
+            mEncoder->setFloatCodeword(
+                dynamic_cast<FloatContainer*>(mBitContainer)->data());
+            mEncoder->encode();
+            mEncoder->getInformation(mOutputContainer);
+        } else {
+            mBitContainer->getPackedInformationBits(mOutputContainer);
+        }
+        return mErrorDetector->check(mOutputContainer,
+                                     (N - mFrozenBits.size() + 7) / 8);
+    }
+
+    Decoder* clone() const
+    {
+        Decoder* decoder = new TemplatizedFloat<N, frozenBitSet>(mFrozenBits);
+        decoder->setSystematic(mSystematic);
+        decoder->setErrorDetection(mErrorDetector);
+        return decoder;
+    }
+
+    /*!
+     * \brief The code of a templatized decoder is fixed at compile time.
+     *
+     * Throws std::invalid_argument, unless the code is the fixed one.
+     */
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
+    {
+        std::vector<int> frozenSet(N, 0);
+        for (unsigned bit : frozenBits) {
+            if (bit < N) {
+                frozenSet[bit] = 1;
+            }
+        }
+        if (blockLength != N || frozenBits.size() != mFrozenBits.size() ||
+            !std::equal(frozenSet.begin(), frozenSet.end(), frozenBitSet.begin())) {
+            throw std::invalid_argument(
+                "TemplatizedFloat: The code of a fixed decoder is fixed!");
+        }
     }
 };
 
@@ -0,0 +1,537 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_TEMPLATIZED_SCL_H
+#define PC_DEC_TEMPLATIZED_SCL_H
+
+#include <polarcode/decoding/path_selection.h>
+#include <polarcode/decoding/templatized_float.h>
+
+#include <cstring>
+
+namespace PolarCode {
+namespace Decoding {
+namespace TemplatizedSclCalc {
+
+// Node types, in the order SclAvx::classifyNode() checks them
+enum NodeKind { kRateOne, kRateZero, kRepetition, kSpc, kRateR };
+
+constexpr unsigned stageOf(unsigned size) { return size > 1 ? 1 + stageOf(size / 2) : 0; }
+
+// LLR- and bit-blocks of nodes shorter than a vector are padded to eight values
+constexpr unsigned paddedLength(unsigned size) { return size < 8 ? 8 : size; }
+
+// The LLR-blocks of a path are stacked from stage stageCount-1 down to stage 0
+constexpr unsigned llrOffset(unsigned stage, unsigned stageCount)
+{
+    return stage + 1 >= stageCount
+               ? 0
+               : paddedLength(1U << (stage + 1)) + llrOffset(stage + 1, stageCount);
+}
+
+template <int begin, int size, int N>
+constexpr NodeKind nodeKind(const std::array<int, N>& frozenBitSet)
+{
+    const int count = partialSum<begin, size, N>(frozenBitSet);
+    if (count == 0) {
+        return kRateOne;
+    } else if (count == size) {
+        return kRateZero;
+    } else if (count == size - 1 && size < 8) {
+        return kRepetition;
+    } else if (count == 1) {
+        return kSpc;
+    }
+    return kRateR;
+}
+
+// Like the vectorized G-function, only the sign bit of the decision counts
+inline float polarG(float left, float right, float bit)
+{
+    HybridFloat l, b;
+    l.f = left;
+    b.f = bit;
+    l.u ^= b.u & 0x80000000U;
+    return l.f + right;
+}
+
+inline void flipSign(float& x)
+{
+    HybridFloat h;
+    h.f = x;
+    h.u ^= 0x80000000U;
+    x = h.f;
+}
+
+template <unsigned subBlockLength>
+inline void G_function(float* LLRin, float* LLRout, float* BitsIn)
+{
+    if (subBlockLength < 8) {
+        for (unsigned i = 0; i < subBlockLength; ++i) {
+            LLRout[i] = polarG(LLRin[i], LLRin[i + subBlockLength], BitsIn[i]);
+        }
+    } else {
+        TemplatizedFloatCalc::G_function<subBlockLength>(LLRin, LLRout, BitsIn);
+    }
+}
+
+/*!
+ * \brief Find the n smallest of _size_ values by partial selection sort.
+ *
+ * Follows findWeakLlrs(), so that ties are resolved in the same way. Indices
+ * beyond _size_ are set to _size_.
+ */
+template <unsigned size, unsigned n>
+inline void findWeakLlrs(float* values, unsigned* indices)
+{
+    for (unsigned i = 0; i < n; ++i) {
+        indices[i] = size;
+    }
+    unsigned order[size];
+    for (unsigned i = 0; i < size; ++i) {
+        order[i] = i;
+    }
+    constexpr unsigned lim = std::min(size - 1, n);
+    for (unsigned i = 0; i < lim; ++i) {
+        unsigned index = i;
+        for (unsigned j = i + 1; j < size; ++j) {
+            if (values[j] < values[index]) {
+                index = j;
+            }
+        }
+        std::swap(values[i], values[index]);
+        std::swap(order[i], order[index]);
+    }
+    for (unsigned i = 0; i < std::min(size, n); ++i) {
+        indices[i] = order[i];
+    }
+}
+
+} // namespace TemplatizedSclCalc
+
+/*!
+ * \brief A list decoder for a code and list size which are fixed at compile time.
+ *
+ * Like TemplatizedFloat does for Fast-SSC, the decoding tree of SclAvxFloat
+ * is resolved by the compiler: Node types, stage sizes and offsets, and the
+ * ranges of the path copies are constants, so there is neither a virtual call
+ * nor a lookup of data blocks. Each path owns a stack of LLR-blocks and a
+ * bit-block of N values, which are stored in slots of fixed-size arrays.
+ *
+ * A surviving path keeps the slot of its parent. Only further children are
+ * copied into a free slot, and only the LLRs which are still needed and the
+ * decided bits in front of the current node.
+ *
+ * The decisions are the same as those of SclAvxFloat with the default path
+ * selection. Distributed CRCs are checked only after decoding.
+ */
+template <const unsigned N, const std::array<int, N>& frozenBitSet, const unsigned L>
+class TemplatizedScl : public Decoder
+{
+    static constexpr unsigned stageCount = TemplatizedSclCalc::stageOf(N);
+    static constexpr unsigned stackLength =
+        N > 1 ? TemplatizedSclCalc::llrOffset(0, stageCount) + 8 : 8;
+    static constexpr unsigned maxCandidates = 8 * L;
+
+    alignas(32) float mLlr[L][stackLength];
+    alignas(32) float mBits[L][TemplatizedSclCalc::paddedLength(N)];
+    alignas(32) float mChannel[TemplatizedSclCalc::paddedLength(N)];
+    alignas(32) float mTemp[TemplatizedSclCalc::paddedLength(N)];
+
+    unsigned mPathCount;
+    float mMetric[L];
+    unsigned mSlot[L];     ///< Memory slot of each path
+    unsigned mNextSlot[L]; ///< Memory slots of the next generation of paths
+
+    float mCandidates[maxCandidates]; ///< Candidate metrics, sorted by selection
+    unsigned mOrder[maxCandidates];   ///< Candidate indices, sorted by selection
+    unsigned mWeak[L][4];             ///< Least reliable bits of each path
+    bool mOddParity[L];
+    float mResult[L];
+
+    PathSelector mSelector;
+    Encoding::Encoder* mEncoder;
+
+    float* llr(unsigned stage, unsigned slot)
+    {
+        return stage == stageCount
+                   ? mChannel
+                   : mLlr[slot] + TemplatizedSclCalc::llrOffset(stage, stageCount);
+    }
+
+    /*
+     * The LLRs of an ancestor are needed as long as its right child is not
+     * decoded, i.e. while the node lies in the ancestor's left half.
+     */
+    template <const int begin, const unsigned stage>
+    inline void copyLlrs(unsigned destination, unsigned source)
+    {
+        if constexpr (stage < stageCount) {
+            if ((begin >> (stage - 1) & 1) == 0) {
+                memcpy(llr(stage, destination),
+                       llr(stage, source),
+                       TemplatizedSclCalc::paddedLength(1U << stage) * sizeof(float));
+            }
+            copyLlrs<begin, stage + 1>(destination, source);
+        }
+    }
+
+    template <const int begin, const int size>
+    inline void copyPath(unsigned destination, unsigned source)
+    {
+        copyLlrs<begin, TemplatizedSclCalc::stageOf(size) + 1>(destination, source);
+        if (begin > 0) {
+            memcpy(mBits[destination], mBits[source], begin * sizeof(float));
+        }
+    }
+
+    /*
+     * Select the best candidates of all paths and assign memory slots to
+     * them. A candidate number is path * branchCount + decision.
+     */
+    template <const int begin, const int size>
+    inline unsigned selectPaths(unsigned branchCount)
+    {
+        const unsigned candidateCount = mPathCount * branchCount;
+        const unsigned newPathCount = std::min(candidateCount, L);
+        mSelector.select(mOrder, mCandidates, newPathCount, candidateCount);
+
+        bool taken[L] = {};
+        bool firstChild[L];
+        for (unsigned path = 0; path < newPathCount; ++path) {
+            const unsigned parent = mOrder[path] / branchCount;
+            firstChild[path] = !taken[parent];
+            taken[parent] = true;
+        }
+
+        unsigned freeSlots[L], freeCount = 0;
+        for (unsigned path = 0; path < L; ++path) {
+            if (!taken[path]) {
+                freeSlots[freeCount++] = mSlot[path];
+            }
+        }
+
+        for (unsigned path = 0; path < newPathCount; ++path) {
+            const unsigned parentSlot = mSlot[mOrder[path] / branchCount];
+            if (firstChild[path]) {
+                mNextSlot[path] = parentSlot;
+            } else {
+                mNextSlot[path] = freeSlots[--freeCount];
+                copyPath<begin, size>(mNextSlot[path], parentSlot);
+            }
+        }
+        for (unsigned path = newPathCount; path < L; ++path) {
+            mNextSlot[path] = freeSlots[--freeCount];
+        }
+        return newPathCount;
+    }
+
+    // The slots of the parents stay intact until the bits are written
+    inline void switchToNext(unsigned newPathCount)
+    {
+        for (unsigned path = 0; path < newPathCount; ++path) {
+            mMetric[path] = mCandidates[path];
+        }
+        memcpy(mSlot, mNextSlot, sizeof(mSlot));
+        mPathCount = newPathCount;
+    }
+
+    template <const int begin, const int size>
+    inline void decodeRateZero()
+    {
+        constexpr unsigned stage = TemplatizedSclCalc::stageOf(size);
+        const __m256 zero = _mm256_setzero_ps();
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            float* input = llr(stage, mSlot[path]);
+            float* output = mBits[mSlot[path]] + begin;
+            __m256 punishment = _mm256_setzero_ps();
+            for (unsigned i = size; i < 8; ++i) {
+                input[i] = 0.0f;
+            }
+            for (unsigned bit = 0; bit < size; bit += 8) {
+                punishment = _mm256_add_ps(
+                    punishment, _mm256_min_ps(_mm256_load_ps(input + bit), zero));
+            }
+            for (unsigned bit = 0; bit < size; ++bit) {
+                output[bit] = INFINITY;
+            }
+            mMetric[path] += reduce_add_ps(punishment);
+        }
+    }
+
+    template <const int begin, const int size>
+    inline void decodeRateOne()
+    {
+        constexpr unsigned stage = TemplatizedSclCalc::stageOf(size);
+        const __m256 sgnMask = _mm256_set1_ps(-0.0);
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            const float metric = mMetric[path];
+            float* input = llr(stage, mSlot[path]);
+            for (unsigned i = size; i < 8; ++i) {
+                input[i] = INFINITY;
+            }
+            for (unsigned i = 0; i < size; i += 8) {
+                _mm256_store_ps(mTemp + i,
+                                _mm256_andnot_ps(sgnMask, _mm256_load_ps(input + i)));
+            }
+            TemplatizedSclCalc::findWeakLlrs<size, 2>(mTemp, mWeak[path]);
+            mCandidates[path * 4] = metric;
+            mCandidates[path * 4 + 1] = metric - mTemp[0];
+            mCandidates[path * 4 + 2] = metric - mTemp[1];
+            mCandidates[path * 4 + 3] = metric - mTemp[0] - mTemp[1];
+        }
+
+        const unsigned newPathCount = selectPaths<begin, size>(4);
+        for (unsigned path = 0; path < newPathCount; ++path) {
+            const unsigned parent = mOrder[path] / 4, decision = mOrder[path] % 4;
+            const float* input = llr(stage, mSlot[parent]);
+            float* output = mBits[mNextSlot[path]] + begin;
+            memcpy(output, input, size * sizeof(float));
+            for (unsigned weak = 0; weak < 2; ++weak) {
+                if ((decision >> weak & 1) && mWeak[parent][weak] < size) {
+                    TemplatizedSclCalc::flipSign(output[mWeak[parent][weak]]);
+                }
+            }
+        }
+        switchToNext(newPathCount);
+    }
+
+    template <const int begin, const int size>
+    inline void decodeRepetition()
+    {
+        constexpr unsigned stage = TemplatizedSclCalc::stageOf(size);
+        const __m256 zero = _mm256_setzero_ps();
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            const float metric = mMetric[path];
+            __m256 vZero = _mm256_setzero_ps();   // metric for '0' decision
+            __m256 vOne = _mm256_setzero_ps();    // metric for '1' decision
+            __m256 vResult = _mm256_setzero_ps(); // repetition decoding result
+            float* input = llr(stage, mSlot[path]);
+            for (unsigned i = size; i < 8; ++i) {
+                input[i] = 0.0f;
+            }
+            for (unsigned i = 0; i < size; i += 8) {
+                __m256 Llr = _mm256_load_ps(input + i);
+                vZero = _mm256_add_ps(vZero, _mm256_min_ps(Llr, zero));
+                vOne = _mm256_add_ps(vOne, _mm256_max_ps(Llr, zero));
+                vResult = _mm256_add_ps(vResult, Llr);
+            }
+            mResult[path] = fabs(reduce_add_ps(vResult));
+            mCandidates[path * 2] = metric + reduce_add_ps(vZero);
+            mCandidates[path * 2 + 1] = metric - reduce_add_ps(vOne);
+        }
+
+        const unsigned newPathCount = selectPaths<begin, size>(2);
+        for (unsigned path = 0; path < newPathCount; ++path) {
+            const unsigned parent = mOrder[path] / 2;
+            const float result =
+                mOrder[path] % 2 ? -mResult[parent] : mResult[parent];
+            float* output = mBits[mNextSlot[path]] + begin;
+            for (unsigned i = 0; i < size; ++i) {
+                output[i] = result;
+            }
+        }
+        switchToNext(newPathCount);
+    }
+
+    template <const int begin, const int size>
+    inline void decodeSpc()
+    {
+        // Weak bits to flip per candidate, for even parity. Odd parity
+        // additionally flips the weakest bit.
+        static constexpr unsigned char flips[8] = { 0x0, 0x3, 0x5, 0x9,
+                                                    0x6, 0xA, 0xC, 0xF };
+        constexpr unsigned stage = TemplatizedSclCalc::stageOf(size);
+        const __m256 sgnMask = _mm256_set1_ps(-0.0);
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            float metric = mMetric[path];
+            float* input = llr(stage, mSlot[path]);
+            __m256 vParity = _mm256_set1_ps(0.0f);
+            for (unsigned i = size; i < 8; ++i) {
+                input[i] = INFINITY;
+            }
+            for (unsigned i = 0; i < size; i += 8) {
+                __m256 Llr = _mm256_load_ps(input + i);
+                vParity = _mm256_xor_ps(vParity, Llr);
+                _mm256_store_ps(mTemp + i, _mm256_andnot_ps(sgnMask, Llr));
+            }
+            TemplatizedSclCalc::findWeakLlrs<size, 4>(mTemp, mWeak[path]);
+
+            HybridFloat parity;
+            parity.f = reduce_xor_ps(vParity);
+            mOddParity[path] = parity.u & 0x80000000U;
+            float parityInv = 1.0f;
+            if (mOddParity[path]) {
+                parityInv = 0.0f;
+                metric -= mTemp[0];
+            }
+
+            float* candidates = mCandidates + path * 8;
+            candidates[0] = metric;
+            candidates[1] = metric - parityInv * mTemp[0] - mTemp[1];
+            candidates[2] = metric - parityInv * mTemp[0] - mTemp[2];
+            candidates[3] = metric - parityInv * mTemp[0] - mTemp[3];
+            candidates[4] = metric - mTemp[1] - mTemp[2];
+            candidates[5] = metric - mTemp[1] - mTemp[3];
+            candidates[6] = metric - mTemp[2] - mTemp[3];
+            candidates[7] =
+                metric - parityInv * mTemp[0] - mTemp[1] - mTemp[2] - mTemp[3];
+        }
+
+        const unsigned newPathCount = selectPaths<begin, size>(8);
+        for (unsigned path = 0; path < newPathCount; ++path) {
+            const unsigned parent = mOrder[path] / 8;
+            const unsigned mask = flips[mOrder[path] % 8] ^ mOddParity[parent];
+            const float* input = llr(stage, mSlot[parent]);
+            float* output = mBits[mNextSlot[path]] + begin;
+            memcpy(output, input, size * sizeof(float));
+            for (unsigned weak = 0; weak < 4; ++weak) {
+                if ((mask >> weak & 1) && mWeak[parent][weak] < size) {
+                    TemplatizedSclCalc::flipSign(output[mWeak[parent][weak]]);
+                }
+            }
+        }
+        switchToNext(newPathCount);
+    }
+
+    template <const int begin, const int size>
+    inline void decodeRateR()
+    {
+        using namespace TemplatizedFloatCalc;
+        constexpr unsigned stage = TemplatizedSclCalc::stageOf(size);
+        constexpr unsigned half = size / 2;
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            F_function<half>(llr(stage, mSlot[path]), llr(stage - 1, mSlot[path]));
+        }
+        decodeNode<begin, half>();
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            TemplatizedSclCalc::G_function<half>(llr(stage, mSlot[path]),
+                                                 llr(stage - 1, mSlot[path]),
+                                                 mBits[mSlot[path]] + begin);
+        }
+        decodeNode<begin + half, half>();
+
+        for (unsigned path = 0; path < mPathCount; ++path) {
+            C_function<half>(mBits[mSlot[path]] + begin);
+        }
+    }
+
+    template <const int begin, const int size>
+    inline void decodeNode()
+    {
+        using namespace TemplatizedSclCalc;
+        constexpr NodeKind kind = nodeKind<begin, size, N>(frozenBitSet);
+        if constexpr (kind == kRateOne) {
+            decodeRateOne<begin, size>();
+        } else if constexpr (kind == kRateZero) {
+            decodeRateZero<begin, size>();
+        } else if constexpr (kind == kRepetition) {
+            decodeRepetition<begin, size>();
+        } else if constexpr (kind == kSpc) {
+            decodeSpc<begin, size>();
+        } else {
+            decodeRateR<begin, size>();
+        }
+    }
+
+    // Take the first path which passes the error detector, or else the best one
+    bool selectOutput()
+    {
+        const unsigned byteLength = (N - mFrozenBits.size() + 7) / 8;
+        for (unsigned path = 0; path <= mPathCount; ++path) {
+            float* bits = mBits[mSlot[path < mPathCount ? path : 0]];
+            if (mSystematic) {
+                mBitContainer->insertLlr(bits);
+                mBitContainer->getPackedInformationBits(mOutputContainer);
+            } else {
+                mEncoder->setFloatCodeword(bits);
+                mEncoder->encode();
+                mEncoder->getInformation(mOutputContainer);
+            }
+            if (path == mPathCount) {
+                break;
+            }
+            if (mErrorDetector->check(mOutputContainer, byteLength)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    TemplatizedScl(std::vector<unsigned> frozenBits)
+    {
+        mBlockLength = N;
+        mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+        mEncoder = new Encoding::ButterflyFipPacked(N, mFrozenBits);
+        mEncoder->setSystematic(false);
+        mLlrContainer = new FloatContainer(N);
+        mBitContainer = new FloatContainer(N, frozenBits);
+        mLlrContainer->setFrozenBits(mFrozenBits);
+        mOutputContainer = new unsigned char[(N - frozenBits.size() + 7) / 8];
+        memset(mChannel, 0, sizeof(mChannel));
+    }
+
+    ~TemplatizedScl() { delete mEncoder; }
+
+    bool decode()
+    {
+        memcpy(mChannel,
+               dynamic_cast<FloatContainer*>(mLlrContainer)->data(),
+               N * sizeof(float));
+        for (unsigned slot = 0; slot < L; ++slot) {
+            mSlot[slot] = slot;
+        }
+        mMetric[0] = 0.0f;
+        mPathCount = 1;
+
+        decodeNode<0, N>();
+        return selectOutput();
+    }
+
+    Decoder* clone() const
+    {
+        Decoder* decoder = new TemplatizedScl<N, frozenBitSet, L>(mFrozenBits);
+        decoder->setSystematic(mSystematic);
+        decoder->setErrorDetection(mErrorDetector);
+        return decoder;
+    }
+
+    size_t getListSize() { return L; }
+
+    /*!
+     * \brief The code of a templatized decoder is fixed at compile time.
+     *
+     * Throws std::invalid_argument, unless the code is the fixed one.
+     */
+    void initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
+    {
+        std::vector<int> frozenSet(N, 0);
+        for (unsigned bit : frozenBits) {
+            if (bit < N) {
+                frozenSet[bit] = 1;
+            }
+        }
+        if (blockLength != N || frozenBits.size() != mFrozenBits.size() ||
+            !std::equal(frozenSet.begin(), frozenSet.end(), frozenBitSet.begin())) {
+            throw std::invalid_argument(
+                "TemplatizedScl: The code of a fixed decoder is fixed!");
+        }
+    }
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_TEMPLATIZED_SCL_H
@@ -0,0 +1,92 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_DEC_THREAD_TEAM_H
+#define PC_DEC_THREAD_TEAM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PolarCode {
+namespace Decoding {
+
+/*!
+ * \brief A fixed team of threads which runs parallel loops inside a decoder.
+ *
+ * Unlike DecodeService, which decodes whole frames on separate threads, a
+ * ThreadTeam splits the work of a single frame. The calling thread is the
+ * first member of the team and joins the work of each loop. Between loops, the
+ * other members poll for a short while before they go to sleep, so that the
+ * fork-join cost stays in the order of a microsecond while a frame is decoded.
+ *
+ * A team must only be used by one thread at a time.
+ */
+class ThreadTeam
+{
+public:
+    /*!
+     * \brief A job, called once per member with its index.
+     */
+    typedef std::function<void(unsigned member)> job_t;
+
+    /*!
+     * \brief A loop body, called once per member with its range of indices.
+     */
+    typedef std::function<void(unsigned member, unsigned begin, unsigned end)> range_t;
+
+    /*!
+     * \brief Start the members of a team.
+     * \param size Number of members, including the calling thread.
+     */
+    ThreadTeam(size_t size);
+
+    /*!
+     * \brief Stop all members.
+     */
+    ~ThreadTeam();
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    size_t size() const; ///< Number of members, including the calling thread.
+
+    /*!
+     * \brief Run a job on all members and wait until all of them finished.
+     *
+     * The calling thread runs member 0.
+     */
+    void run(const job_t& job);
+
+    /*!
+     * \brief Split the indices [0, count) into contiguous ranges, one per member.
+     * \param count Number of loop iterations.
+     * \param granularity Range boundaries are multiples of this value.
+     * \param body The loop body.
+     */
+    void split(unsigned count, unsigned granularity, const range_t& body);
+
+private:
+    std::vector<std::thread> mThreads;
+    const job_t* mJob;
+    std::atomic<unsigned> mGeneration; ///< Incremented for each job
+    std::atomic<unsigned> mPending;    ///< Members still working on the job
+    std::mutex mMutex;
+    std::condition_variable mWakeup;
+    bool mStop;
+
+    void work(unsigned member);
+};
+
+} // namespace Decoding
+} // namespace PolarCode
+
+#endif // PC_DEC_THREAD_TEAM_H
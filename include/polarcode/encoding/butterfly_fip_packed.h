@@ -9,6 +9,7 @@
 #ifndef PC_ENC_BUTTERFLY_FIP_PACKED_H
 #define PC_ENC_BUTTERFLY_FIP_PACKED_H
 
+#include <polarcode/avxconvenience.h>
 #include <polarcode/encoding/encoder.h>
 
 namespace PolarCode {
@@ -24,7 +25,16 @@ namespace Encoding {
  */
 class ButterflyFipPacked : public Encoder
 {
-    void transform();
+    PackedContainer* mExternalContainer; ///< Points to the caller's code word memory
+
+    void transform(fipv* vBit);
+
+protected:
+    /*!
+     * \brief Encode in the caller's memory, if it is suitably aligned.
+     * \sa Encoder::encodeExternal()
+     */
+    void encodeExternal(unsigned char* pInfo, unsigned char* pCode);
 
 public:
     ButterflyFipPacked();
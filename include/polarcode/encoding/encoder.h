@@ -36,6 +36,17 @@ protected:
     BitContainer* mBitContainer;       ///< Internal bit memory
     std::vector<unsigned> mFrozenBits; ///< Indices for frozen bits
 
+    /*!
+     * \brief Encode from and into caller-owned memory.
+     *
+     * Called by encode_vector(void*, size_t, void*, size_t) after the buffer
+     * sizes have been checked. The default implementation copies the data
+     * through mBitContainer.
+     * \param pInfo Packed information bits, check bits are inserted in place.
+     * \param pCode Destination of blockLength() / 8 bytes.
+     */
+    virtual void encodeExternal(unsigned char* pInfo, unsigned char* pCode);
+
 public:
     Encoder();
     virtual ~Encoder();
@@ -46,6 +57,22 @@ public:
      */
     void encode_vector(void* pInfo, void* pCode);
 
+    /*!
+     * \brief Encode directly into caller-owned memory.
+     *
+     * Encoders which support it run the transformation on _pCode_ itself,
+     * instead of staging the code word in their own container. This requires
+     * _pCode_ to be aligned to 32 bytes. Other buffers are encoded through
+     * the container, like encode_vector(void*, void*).
+     *
+     * Throws std::invalid_argument, if one of the buffers is too short.
+     * \param pInfo Packed information bits, check bits are inserted in place.
+     * \param infoSize At least (infoLength() + 7) / 8 bytes.
+     * \param pCode Destination memory of codeSize bytes.
+     * \param codeSize At least blockLength() / 8 bytes.
+     */
+    void encode_vector(void* pInfo, size_t infoSize, void* pCode, size_t codeSize);
+
     /*!
      * \brief Encoder duration
      * \return Number of ticks in nanoseconds for last encoder call.
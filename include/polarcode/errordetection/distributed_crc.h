@@ -0,0 +1,116 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef PC_ERR_DISTRIBUTED_CRC_H
+#define PC_ERR_DISTRIBUTED_CRC_H
+
+#include <polarcode/errordetection/errordetector.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace PolarCode {
+namespace ErrorDetection {
+
+/*!
+ * \brief A single check bit of a distributed CRC.
+ *
+ * All positions refer to the interleaved bit layout, i.e. to the information
+ * bits of the polar code in decoding order.
+ */
+struct ParityCheck {
+    unsigned position;                  ///< Position of the check bit
+    std::vector<unsigned> dependencies; ///< Positions of the message bits it covers
+};
+
+/*!
+ * \brief A CRC whose check bits are interleaved with the message bits.
+ *
+ * Each CRC bit is a parity over a subset of the message bits. The message and
+ * CRC bits are interleaved such that every CRC bit directly follows the last
+ * message bit it covers, as done for the 5G downlink control channel. A
+ * successive cancellation list decoder can thus discard a path as soon as one
+ * of the CRC bits is decided, see SclAvxFloat and SclFipChar.
+ *
+ * The interleaver is built greedily: The CRC bit which covers the fewest
+ * message bits not placed so far is placed next, preceded by those message
+ * bits. The CRC itself is not reflected, starts at zero and is not inverted.
+ *
+ * All data is packed MSB first in the interleaved layout. Use interleave() and
+ * deinterleave() to convert from and to the plain message.
+ */
+class DistributedCrc : public Detector
+{
+    unsigned mMessageBits, mWidth;
+    std::vector<unsigned> mMessagePositions; ///< Layout position of each message bit
+    std::vector<ParityCheck> mChecks;        ///< Sorted by position
+
+    bool passes(const unsigned char* data, const ParityCheck& check) const;
+    void checkLength(int bytes) const;
+
+public:
+    /*!
+     * \brief Create a distributed CRC.
+     * \param messageBits Number of message bits, excluding the CRC.
+     * \param width Number of CRC bits, at most 32.
+     * \param polynomial Generator polynomial without its leading term, e.g.
+     *        0xB2B117 for the 24-bit CRC of 5G control information.
+     */
+    DistributedCrc(unsigned messageBits, unsigned width, uint32_t polynomial);
+    ~DistributedCrc();
+
+    std::string getType() { return std::string("CRC"); }
+    unsigned getCheckBitCount() { return mWidth; }
+
+    /*!
+     * \brief Compute the CRC bits of data in the interleaved layout.
+     * \param pData Message bits at their interleaved positions.
+     * \param bytes Number of bytes, at least (messageBits + width + 7) / 8.
+     *        Any bits behind the CRC are left untouched.
+     * \throws std::invalid_argument if the data is too short.
+     */
+    void generate(void* pData, int bytes);
+
+    /*!
+     * \brief Check the CRC bits of data in the interleaved layout.
+     * \param bytes Number of bytes, at least (messageBits + width + 7) / 8.
+     *        Any bits behind the CRC are ignored.
+     * \throws std::invalid_argument if the data is too short.
+     */
+    bool check(void* pData, int bytes);
+    int multiCheck(void** pData, int nArrays, int nBytes);
+
+    /*!
+     * \brief Get the number of message bits, excluding the CRC.
+     */
+    unsigned messageBits() const;
+
+    /*!
+     * \brief Get the check bits, sorted by their position.
+     */
+    const std::vector<ParityCheck>& parityChecks() const;
+
+    /*!
+     * \brief Place a message in the interleaved layout and append the CRC.
+     * \param pMessage The packed message bits.
+     * \param pData Receives messageBits + width packed bits.
+     */
+    void interleave(const void* pMessage, void* pData);
+
+    /*!
+     * \brief Extract the message from the interleaved layout.
+     * \param pData Packed bits in the interleaved layout.
+     * \param pMessage Receives the packed message bits.
+     */
+    void deinterleave(const void* pData, void* pMessage);
+};
+
+} // namespace ErrorDetection
+} // namespace PolarCode
+
+#endif // PC_ERR_DISTRIBUTED_CRC_H
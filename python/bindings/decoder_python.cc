@@ -71,5 +71,43 @@ void bind_decoder(py::module& m)
 
                  self.decode_vector((char*)inb.ptr, (void*)resb.ptr);
                  return result;
+             })
+        .def("decode_batch",
+             [](Decoder& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>
+                    array) {
+                 py::buffer_info inb = array.request();
+                 if (inb.ndim != 2) {
+                     throw std::runtime_error("Only TWO-dimensional arrays allowed!");
+                 }
+                 if ((size_t)inb.shape[1] != self.blockLength()) {
+                     throw std::runtime_error("Input row size != blockSize!");
+                 }
+                 const size_t frames = inb.shape[0];
+                 auto result = py::array_t<uint8_t>(
+                     { frames, (size_t)(self.infoLength() + 7) / 8 });
+                 py::buffer_info resb = result.request();
+
+                 self.decode_batch((float*)inb.ptr, frames, (void*)resb.ptr);
+                 return result;
+             })
+        .def("decode_batch",
+             [](Decoder& self,
+                const py::array_t<int8_t, py::array::c_style | py::array::forcecast>
+                    array) {
+                 py::buffer_info inb = array.request();
+                 if (inb.ndim != 2) {
+                     throw std::runtime_error("Only TWO-dimensional arrays allowed!");
+                 }
+                 if ((size_t)inb.shape[1] != self.blockLength()) {
+                     throw std::runtime_error("Input row size != blockSize!");
+                 }
+                 const size_t frames = inb.shape[0];
+                 auto result = py::array_t<uint8_t>(
+                     { frames, (size_t)(self.infoLength() + 7) / 8 });
+                 py::buffer_info resb = result.request();
+
+                 self.decode_batch((char*)inb.ptr, frames, (void*)resb.ptr);
+                 return result;
              });
 }
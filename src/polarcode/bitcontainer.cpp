@@ -963,6 +963,10 @@ void PackedContainer::insertCharBits(const void* pData)
     const unsigned char* inPtr = static_cast<const unsigned char*>(pData);
     unsigned char currentByte;
 
+    if (mFakeSize != mElementCount) {
+        outPtr += (mFakeSize - mElementCount) / 8;
+    }
+
     for (unsigned int byte = 0; byte < nBytes; ++byte) {
         currentByte = 0;
         for (unsigned int bit = 0; bit < 8; ++bit) {
@@ -1011,6 +1015,15 @@ void PackedContainer::resetFrozenBits()
 
 char* PackedContainer::data() { return mData; }
 
+void PackedContainer::setData(char* external)
+{
+    if (!mDataIsExternal) {
+        _mm_free(mData);
+    }
+    mData = external;
+    mDataIsExternal = true;
+}
+
 // Dummy
 void PackedContainer::insertLlr(const char*) {}
 void PackedContainer::getSoftBits(void*) {}
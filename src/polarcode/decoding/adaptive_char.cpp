@@ -7,28 +7,71 @@
  */
 
 #include <polarcode/decoding/adaptive_char.h>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
 
+namespace {
+
+std::vector<size_t> doublingListSizes(size_t listSize)
+{
+    std::vector<size_t> listSizes;
+    for (size_t size = 2; size < listSize; size *= 2) {
+        listSizes.push_back(size);
+    }
+    if (listSize > 1) {
+        listSizes.push_back(listSize);
+    }
+    return listSizes;
+}
+
+} // namespace
 
 AdaptiveChar::AdaptiveChar(size_t blockLength,
                            size_t listSize,
                            const std::vector<unsigned>& frozenBits)
-    : mListSize(listSize)
+    : mListSize(1), mLastListSize(1)
 {
     mBlockLength = blockLength;
     mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
     mExternalContainers = true;
 
     mFastDecoder = new FastSscFipChar(mBlockLength, mFrozenBits);
-    mListDecoder = new SclFipChar(mBlockLength, mListSize, mFrozenBits);
+    setListSizes(doublingListSizes(listSize));
 }
 
 AdaptiveChar::~AdaptiveChar()
 {
     delete mFastDecoder;
-    delete mListDecoder;
+    clearListDecoders();
+}
+
+void AdaptiveChar::clearListDecoders()
+{
+    for (SclFipChar* decoder : mListDecoders) {
+        delete decoder;
+    }
+    mListDecoders.clear();
+}
+
+void AdaptiveChar::setListSizes(const std::vector<size_t>& listSizes)
+{
+    for (size_t i = 0; i < listSizes.size(); ++i) {
+        if (listSizes[i] < 2 || (i > 0 && listSizes[i] <= listSizes[i - 1])) {
+            throw std::invalid_argument(
+                "AdaptiveChar: List sizes must be increasing and above one!");
+        }
+    }
+    clearListDecoders();
+    mListSizes = listSizes;
+    mListSize = mListSizes.empty() ? 1 : mListSizes.back();
+    for (size_t listSize : mListSizes) {
+        SclFipChar* decoder = new SclFipChar(mBlockLength, listSize, mFrozenBits);
+        decoder->setSystematic(mSystematic);
+        decoder->setErrorDetection(mErrorDetector);
+        mListDecoders.push_back(decoder);
+    }
 }
 
 bool AdaptiveChar::decode()
@@ -36,31 +79,40 @@ bool AdaptiveChar::decode()
     bool success = mFastDecoder->decode();
     mOutputContainer = mFastDecoder->packedOutput();
     mBitContainer = mFastDecoder->outputContainer();
-    if (!success && mListSize > 1) {
-        success = mListDecoder->decode();
-        mOutputContainer = mListDecoder->packedOutput();
-        mBitContainer = mListDecoder->outputContainer();
+    mLastListSize = 1;
+
+    // The fast decoder keeps its quantized LLRs, which are copied only on failure
+    const char* llr =
+        dynamic_cast<CharContainer*>(mFastDecoder->inputContainer())->data();
+    for (unsigned i = 0; !success && i < mListDecoders.size(); ++i) {
+        mListDecoders[i]->setSignal(llr);
+        success = mListDecoders[i]->decode();
+        mOutputContainer = mListDecoders[i]->packedOutput();
+        mBitContainer = mListDecoders[i]->outputContainer();
+        mLastListSize = mListSizes[i];
     }
     return success;
 }
 
 void AdaptiveChar::setSystematic(bool sys)
 {
+    mSystematic = sys;
     mFastDecoder->setSystematic(sys);
-    mListDecoder->setSystematic(sys);
+    for (SclFipChar* decoder : mListDecoders) {
+        decoder->setSystematic(sys);
+    }
 }
 
 void AdaptiveChar::setErrorDetection(ErrorDetection::Detector* pDetector)
 {
+    mErrorDetector = pDetector;
     mFastDecoder->setErrorDetection(pDetector);
-    mListDecoder->setErrorDetection(pDetector);
+    for (SclFipChar* decoder : mListDecoders) {
+        decoder->setErrorDetection(pDetector);
+    }
 }
 
-void AdaptiveChar::setSignal(const float* pLlr)
-{
-    mFastDecoder->setSignal(pLlr);
-    mListDecoder->setSignal(pLlr);
-}
+void AdaptiveChar::setSignal(const float* pLlr) { mFastDecoder->setSignal(pLlr); }
 
 
 } // namespace Decoding
@@ -8,20 +8,54 @@
 
 #include <polarcode/decoding/adaptive_float.h>
 #include <iostream>
+#include <stdexcept>
 namespace PolarCode {
 namespace Decoding {
 
+namespace {
+
+std::vector<size_t> doublingListSizes(size_t listSize)
+{
+    std::vector<size_t> listSizes;
+    for (size_t size = 2; size < listSize; size *= 2) {
+        listSizes.push_back(size);
+    }
+    if (listSize > 1) {
+        listSizes.push_back(listSize);
+    }
+    return listSizes;
+}
+
+} // namespace
 
 AdaptiveFloat::AdaptiveFloat(size_t blockLength,
                              size_t listSize,
                              const std::vector<unsigned>& frozenBits)
-    : mListSize(listSize)
+    : mListSize(1), mLastListSize(1)
 {
     mBlockLength = blockLength;
     mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
     mExternalContainers = true;
     mFastDecoder = std::make_unique<FastSscAvxFloat>(mBlockLength, mFrozenBits);
-    mListDecoder = std::make_unique<SclAvxFloat>(mBlockLength, mListSize, mFrozenBits);
+    mListPlan = SclAvxFloat::makePlan(mBlockLength, mFrozenBits);
+    setListSizes(doublingListSizes(listSize));
+}
+
+AdaptiveFloat::AdaptiveFloat(plan_t fastPlan, plan_t listPlan, size_t listSize)
+    : AdaptiveFloat(fastPlan, listPlan, doublingListSizes(listSize))
+{
+}
+
+AdaptiveFloat::AdaptiveFloat(plan_t fastPlan,
+                             plan_t listPlan,
+                             const std::vector<size_t>& listSizes)
+    : mListPlan(listPlan), mListSize(1), mLastListSize(1)
+{
+    mBlockLength = fastPlan->blockLength();
+    mFrozenBits = fastPlan->frozenBits();
+    mExternalContainers = true;
+    mFastDecoder = std::make_unique<FastSscAvxFloat>(fastPlan);
+    setListSizes(listSizes);
 }
 
 AdaptiveFloat::~AdaptiveFloat()
@@ -30,37 +64,78 @@ AdaptiveFloat::~AdaptiveFloat()
     mBitContainer = nullptr;
 }
 
+void AdaptiveFloat::createListDecoders()
+{
+    // All list sizes share one plan, and only the path lists differ
+    mListDecoders.clear();
+    for (size_t listSize : mListSizes) {
+        mListDecoders.push_back(std::make_unique<SclAvxFloat>(mListPlan, listSize));
+        mListDecoders.back()->setSystematic(mSystematic);
+        mListDecoders.back()->setErrorDetection(mErrorDetector);
+    }
+}
+
+void AdaptiveFloat::setListSizes(const std::vector<size_t>& listSizes)
+{
+    for (size_t i = 0; i < listSizes.size(); ++i) {
+        if (listSizes[i] < 2 || (i > 0 && listSizes[i] <= listSizes[i - 1])) {
+            throw std::invalid_argument(
+                "AdaptiveFloat: List sizes must be increasing and above one!");
+        }
+    }
+    mListSizes = listSizes;
+    mListSize = mListSizes.empty() ? 1 : mListSizes.back();
+    createListDecoders();
+}
+
 bool AdaptiveFloat::decode()
 {
     bool success = mFastDecoder->decode();
     mOutputContainer = mFastDecoder->packedOutput();
     mBitContainer = mFastDecoder->outputContainer();
+    mLastListSize = 1;
 
-    if (!success && mListSize > 1) {
-        success = mListDecoder->decode();
-        mOutputContainer = mListDecoder->packedOutput();
-        mBitContainer = mListDecoder->outputContainer();
+    // The fast decoder keeps its LLRs, which are copied only on failure
+    const float* llr =
+        dynamic_cast<FloatContainer*>(mFastDecoder->inputContainer())->data();
+    for (unsigned i = 0; !success && i < mListDecoders.size(); ++i) {
+        mListDecoders[i]->setSignal(llr);
+        success = mListDecoders[i]->decode();
+        mOutputContainer = mListDecoders[i]->packedOutput();
+        mBitContainer = mListDecoders[i]->outputContainer();
+        mLastListSize = mListSizes[i];
     }
     return success;
 }
 
+Decoder* AdaptiveFloat::clone() const
+{
+    AdaptiveFloat* decoder =
+        new AdaptiveFloat(mFastDecoder->plan(), mListPlan, mListSizes);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
 void AdaptiveFloat::setSystematic(bool sys)
 {
+    mSystematic = sys;
     mFastDecoder->setSystematic(sys);
-    mListDecoder->setSystematic(sys);
+    for (auto& decoder : mListDecoders) {
+        decoder->setSystematic(sys);
+    }
 }
 
 void AdaptiveFloat::setErrorDetection(ErrorDetection::Detector* pDetector)
 {
+    mErrorDetector = pDetector;
     mFastDecoder->setErrorDetection(pDetector);
-    mListDecoder->setErrorDetection(pDetector);
+    for (auto& decoder : mListDecoders) {
+        decoder->setErrorDetection(pDetector);
+    }
 }
 
-void AdaptiveFloat::setSignal(const float* pLlr)
-{
-    mFastDecoder->setSignal(pLlr);
-    mListDecoder->setSignal(pLlr);
-}
+void AdaptiveFloat::setSignal(const float* pLlr) { mFastDecoder->setSignal(pLlr); }
 
 
 } // namespace Decoding
@@ -0,0 +1,326 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/avx_float.h>
+#include <polarcode/decoding/bp_avx_float.h>
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace BpAvx {
+
+namespace {
+
+// Min-sum overestimates the LLRs of the box-plus operation
+const float MIN_SUM_SCALE = 0.9375f;
+
+inline __m256 boxplus(const __m256 a, const __m256 b)
+{
+    return _mm256_mul_ps(FastSscAvx::_mm256_polarf_ps(a, b),
+                         _mm256_set1_ps(MIN_SUM_SCALE));
+}
+
+/*
+ * Butterflies of distance one, two and four lie within a vector. Each lane
+ * gets the value of its partner lane, and the lanes of b are selected by
+ * the blend mask.
+ */
+template <unsigned distance>
+inline __m256 partner(const __m256 x);
+
+template <>
+inline __m256 partner<1>(const __m256 x)
+{
+    return _mm256_permute_ps(x, 0xB1);
+}
+
+template <>
+inline __m256 partner<2>(const __m256 x)
+{
+    return _mm256_permute_ps(x, 0x4E);
+}
+
+template <>
+inline __m256 partner<4>(const __m256 x)
+{
+    return _mm256_permute2f128_ps(x, x, 0x01);
+}
+
+template <unsigned distance, int lowerLanes>
+void updateShortStage(float* out,
+                      const float* in,
+                      const float* prior,
+                      unsigned blockLength)
+{
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        const __m256 x = _mm256_load_ps(in + i);
+        const __m256 p = _mm256_load_ps(prior + i);
+        const __m256 xPartner = partner<distance>(x);
+        const __m256 pPartner = partner<distance>(p);
+        const __m256 upper = boxplus(x, _mm256_add_ps(xPartner, pPartner));
+        const __m256 lower = _mm256_add_ps(boxplus(xPartner, pPartner), x);
+        _mm256_store_ps(out + i, _mm256_blend_ps(upper, lower, lowerLanes));
+    }
+}
+
+template <unsigned distance, int lowerLanes>
+void encodeShortStage(float* bits, unsigned blockLength)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        const __m256 x = _mm256_load_ps(bits + i);
+        const __m256 sum = _mm256_blend_ps(partner<distance>(x), zero, lowerLanes);
+        _mm256_store_ps(bits + i, _mm256_xor_ps(x, sum));
+    }
+}
+
+void encodeStage(float* bits, unsigned distance, unsigned blockLength)
+{
+    switch (distance) {
+    case 1:
+        encodeShortStage<1, 0xAA>(bits, blockLength);
+        break;
+    case 2:
+        encodeShortStage<2, 0xCC>(bits, blockLength);
+        break;
+    case 4:
+        encodeShortStage<4, 0xF0>(bits, blockLength);
+        break;
+    default:
+        for (unsigned group = 0; group < blockLength; group += 2 * distance) {
+            for (unsigned i = group; i < group + distance; i += 8) {
+                const __m256 a = _mm256_load_ps(bits + i);
+                const __m256 b = _mm256_load_ps(bits + i + distance);
+                _mm256_store_ps(bits + i, _mm256_xor_ps(a, b));
+            }
+        }
+    }
+}
+
+} // namespace
+
+void updateStage(float* out,
+                 const float* in,
+                 const float* prior,
+                 unsigned distance,
+                 unsigned blockLength)
+{
+    switch (distance) {
+    case 1:
+        updateShortStage<1, 0xAA>(out, in, prior, blockLength);
+        break;
+    case 2:
+        updateShortStage<2, 0xCC>(out, in, prior, blockLength);
+        break;
+    case 4:
+        updateShortStage<4, 0xF0>(out, in, prior, blockLength);
+        break;
+    default:
+        for (unsigned group = 0; group < blockLength; group += 2 * distance) {
+            for (unsigned a = group; a < group + distance; a += 8) {
+                const unsigned b = a + distance;
+                const __m256 inA = _mm256_load_ps(in + a);
+                const __m256 inB = _mm256_load_ps(in + b);
+                const __m256 priorA = _mm256_load_ps(prior + a);
+                const __m256 priorB = _mm256_load_ps(prior + b);
+                _mm256_store_ps(out + a, boxplus(inA, _mm256_add_ps(inB, priorB)));
+                _mm256_store_ps(out + b, _mm256_add_ps(boxplus(inA, priorA), inB));
+            }
+        }
+    }
+}
+
+} // namespace BpAvx
+
+BpAvxFloat::BpAvxFloat(size_t blockLength,
+                       unsigned iterationLimit,
+                       const std::vector<unsigned>& frozenBits)
+    : mIterationCount(0),
+      mStageCount(0),
+      mDataPool(nullptr),
+      mLeft(nullptr),
+      mRight(nullptr),
+      mInfoLlr(nullptr),
+      mCodeLlr(nullptr),
+      mReencode(nullptr),
+      mInfoContainer(nullptr)
+{
+    setIterationLimit(iterationLimit);
+    initialize(blockLength, frozenBits);
+}
+
+BpAvxFloat::~BpAvxFloat() { clear(); }
+
+void BpAvxFloat::clear()
+{
+    if (mDataPool == nullptr) {
+        return;
+    }
+    mDataPool->release(mLeft);
+    mDataPool->release(mRight);
+    mDataPool->release(mInfoLlr);
+    mDataPool->release(mCodeLlr);
+    mDataPool->release(mReencode);
+    delete mDataPool;
+    delete mInfoContainer;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mDataPool = nullptr;
+    mInfoContainer = nullptr;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+}
+
+void BpAvxFloat::initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    if (blockLength == mBlockLength && frozenBits == mFrozenBits) {
+        return;
+    }
+    if (blockLength < 8) {
+        throw std::invalid_argument("Minimum block length for BP decoding is 8!");
+    }
+    clear();
+
+    mBlockLength = blockLength;
+    mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+    mStageCount = log2(blockLength);
+
+    const size_t messageCount = (mStageCount + 1) * mBlockLength;
+    mDataPool = new BpAvx::datapool_t();
+    mLeft = mDataPool->allocate(messageCount);
+    mRight = mDataPool->allocate(messageCount);
+    mInfoLlr = mDataPool->allocate(mBlockLength);
+    mCodeLlr = mDataPool->allocate(mBlockLength);
+    mReencode = mDataPool->allocate(mBlockLength);
+
+    // The frozen bits are known to be zero
+    float* prior = mRight->data;
+    memset(prior, 0, mBlockLength * sizeof(float));
+    for (unsigned bit : mFrozenBits) {
+        prior[bit] = INFINITY;
+    }
+
+    // The channel LLRs are the L messages of the code bits
+    mLlrContainer =
+        new FloatContainer(mLeft->data + mStageCount * mBlockLength, mBlockLength);
+    mBitContainer = new FloatContainer(mCodeLlr->data, mBlockLength);
+    mInfoContainer = new FloatContainer(mInfoLlr->data, mBlockLength);
+    mLlrContainer->setFrozenBits(mFrozenBits);
+    mBitContainer->setFrozenBits(mFrozenBits);
+    mInfoContainer->setFrozenBits(mFrozenBits);
+    mOutputContainer = new unsigned char[(mBlockLength - mFrozenBits.size() + 7) / 8];
+}
+
+Decoder* BpAvxFloat::clone() const
+{
+    BpAvxFloat* decoder = new BpAvxFloat(mBlockLength, mIterationLimit, mFrozenBits);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void BpAvxFloat::setIterationLimit(unsigned iterationLimit)
+{
+    if (iterationLimit == 0) {
+        throw std::invalid_argument("BpAvxFloat: At least one iteration is needed!");
+    }
+    mIterationLimit = iterationLimit;
+}
+
+void BpAvxFloat::makeDecisions()
+{
+    const float* left = mLeft->data;
+    const float* right = mRight->data;
+    const float* leftCode = left + mStageCount * mBlockLength;
+    const float* rightCode = right + mStageCount * mBlockLength;
+
+    for (unsigned i = 0; i < mBlockLength; i += 8) {
+        const __m256 info =
+            _mm256_add_ps(_mm256_load_ps(left + i), _mm256_load_ps(right + i));
+        const __m256 code =
+            _mm256_add_ps(_mm256_load_ps(leftCode + i), _mm256_load_ps(rightCode + i));
+        _mm256_store_ps(mInfoLlr->data + i, info);
+        _mm256_store_ps(mCodeLlr->data + i, code);
+        _mm256_store_ps(mReencode->data + i, FastSscAvx::hardDecode(info));
+    }
+}
+
+bool BpAvxFloat::consistent()
+{
+    float* bits = mReencode->data;
+    for (unsigned stage = 0; stage < mStageCount; ++stage) {
+        BpAvx::encodeStage(bits, 1U << stage, mBlockLength);
+    }
+    for (unsigned i = 0; i < mBlockLength; i += 8) {
+        const __m256 difference =
+            _mm256_xor_ps(_mm256_load_ps(bits + i), _mm256_load_ps(mCodeLlr->data + i));
+        if (_mm256_movemask_ps(difference)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BpAvxFloat::evaluateOutput()
+{
+    if (mSystematic) {
+        mBitContainer->getPackedInformationBits(mOutputContainer);
+    } else {
+        mInfoContainer->getPackedInformationBits(mOutputContainer);
+    }
+    return mErrorDetector->check(mOutputContainer,
+                                 (mBlockLength - mFrozenBits.size() + 7) / 8);
+}
+
+bool BpAvxFloat::decode()
+{
+    float* left = mLeft->data;
+    float* right = mRight->data;
+
+    // Only the R messages of the information bits are known in advance
+    memset(right + mBlockLength, 0, mStageCount * mBlockLength * sizeof(float));
+
+    mIterationCount = 0;
+    while (mIterationCount < mIterationLimit) {
+        for (unsigned stage = mStageCount; stage-- > 0;) {
+            BpAvx::updateStage(left + stage * mBlockLength,
+                               left + (stage + 1) * mBlockLength,
+                               right + stage * mBlockLength,
+                               1U << stage,
+                               mBlockLength);
+        }
+        for (unsigned stage = 0; stage < mStageCount; ++stage) {
+            BpAvx::updateStage(right + (stage + 1) * mBlockLength,
+                               right + stage * mBlockLength,
+                               left + (stage + 1) * mBlockLength,
+                               1U << stage,
+                               mBlockLength);
+        }
+        ++mIterationCount;
+
+        makeDecisions();
+        if (consistent() && evaluateOutput()) {
+            return true;
+        }
+    }
+    return evaluateOutput();
+}
+
+void BpAvxFloat::getExtrinsicChannelInformation(float* eLlr)
+{
+    memcpy(eLlr, mRight->data + mStageCount * mBlockLength, mBlockLength * sizeof(float));
+}
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -0,0 +1,234 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/decode_service.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace {
+
+void atomicMax(std::atomic<size_t>& target, size_t value)
+{
+    size_t current = target.load(std::memory_order_relaxed);
+    while (current < value &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+DecodeService::DecodeService(size_t threadCount)
+    : mStop(false),
+      mNextWorker(0),
+      mPending(0),
+      mMaxPending(0),
+      mCompleted(0),
+      mStolen(0),
+      mLatencySum(0),
+      mMaxLatency(0)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        mWorkers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        mWorkers[i]->thread = std::thread(&DecodeService::run, this, i);
+    }
+}
+
+DecodeService::~DecodeService()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWaitMutex);
+        mStop = true;
+    }
+    mWakeup.notify_all();
+    for (auto& worker : mWorkers) {
+        worker->thread.join();
+    }
+}
+
+unsigned DecodeService::registerCode(factory_t factory)
+{
+    // Query the code parameters once, workers create their own decoders later
+    std::unique_ptr<Decoder> probe(factory());
+    if (!probe) {
+        throw std::invalid_argument("DecodeService: Factory did not create a decoder!");
+    }
+
+    std::lock_guard<std::mutex> lock(mCodeMutex);
+    mCodes.push_back({ factory, probe->blockLength(), (probe->infoLength() + 7) / 8 });
+    return mCodes.size() - 1;
+}
+
+unsigned DecodeService::registerCode(const Decoder& prototype)
+{
+    std::shared_ptr<Decoder> reference(prototype.clone());
+    if (!reference) {
+        throw std::invalid_argument(
+            "DecodeService: Decoder does not support clone(), register a factory!");
+    }
+    return registerCode([reference]() { return reference->clone(); });
+}
+
+DecodeService::Code DecodeService::code(unsigned codeId) const
+{
+    std::lock_guard<std::mutex> lock(mCodeMutex);
+    if (codeId >= mCodes.size()) {
+        throw std::invalid_argument("DecodeService: Unknown code ID!");
+    }
+    return mCodes[codeId];
+}
+
+std::future<DecodeResult> DecodeService::submit(const float* pLlr, unsigned codeId)
+{
+    return std::move(submit(pLlr, 1, codeId).front());
+}
+
+std::vector<std::future<DecodeResult>>
+DecodeService::submit(const float* pLlr, size_t frames, unsigned codeId)
+{
+    const size_t blockLength = code(codeId).blockLength;
+    const clock_t::time_point now = clock_t::now();
+    std::vector<std::future<DecodeResult>> futures;
+    futures.reserve(frames);
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        Job job;
+        job.codeId = codeId;
+        job.llr.assign(pLlr + frame * blockLength, pLlr + (frame + 1) * blockLength);
+        job.submitted = now;
+        futures.push_back(job.promise.get_future());
+
+        // Count the job before it becomes visible, so it cannot be taken
+        // while the counter would still miss it.
+        {
+            std::lock_guard<std::mutex> lock(mWaitMutex);
+            atomicMax(mMaxPending, ++mPending);
+        }
+
+        Worker& worker = *mWorkers[mNextWorker++ % mWorkers.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.jobs.push_back(std::move(job));
+        }
+        mWakeup.notify_one();
+    }
+    return futures;
+}
+
+bool DecodeService::takeJob(size_t workerIndex, Job& job)
+{
+    const size_t workerCount = mWorkers.size();
+
+    // Own queue first, then the oldest job of any other queue
+    for (size_t offset = 0; offset < workerCount; ++offset) {
+        Worker& victim = *mWorkers[(workerIndex + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            --mPending;
+            if (offset != 0) {
+                ++mStolen;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void DecodeService::run(size_t workerIndex)
+{
+    Worker& worker = *mWorkers[workerIndex];
+    Job job;
+
+    while (true) {
+        if (takeJob(workerIndex, job)) {
+            execute(worker, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mWaitMutex);
+        mWakeup.wait(lock, [this]() { return mStop || mPending > 0; });
+        if (mStop && mPending == 0) {
+            return;
+        }
+    }
+}
+
+void DecodeService::execute(Worker& worker, Job& job)
+{
+    const clock_t::time_point start = clock_t::now();
+
+    try {
+        const Code jobCode = code(job.codeId);
+        if (worker.decoders.size() <= job.codeId) {
+            worker.decoders.resize(job.codeId + 1);
+        }
+        std::unique_ptr<Decoder>& decoder = worker.decoders[job.codeId];
+        if (!decoder) {
+            decoder.reset(jobCode.factory());
+        }
+
+        DecodeResult result;
+        result.information.resize(jobCode.infoBytes);
+        result.success =
+            decoder->decode_vector(job.llr.data(), result.information.data());
+
+        const clock_t::time_point end = clock_t::now();
+        result.queueDuration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - job.submitted)
+                .count();
+        result.decodeDuration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        const size_t latency = result.queueDuration + result.decodeDuration;
+        mLatencySum += latency;
+        atomicMax(mMaxLatency, latency);
+        ++mCompleted;
+
+        job.promise.set_value(std::move(result));
+    } catch (...) {
+        job.promise.set_exception(std::current_exception());
+    }
+}
+
+size_t DecodeService::threadCount() const { return mWorkers.size(); }
+
+size_t DecodeService::queueDepth() const { return mPending; }
+
+DecodeServiceStatistics DecodeService::statistics() const
+{
+    DecodeServiceStatistics stats;
+    stats.queueDepth = mPending;
+    stats.maxQueueDepth = mMaxPending;
+    stats.completed = mCompleted;
+    stats.stolen = mStolen;
+    stats.meanLatency = stats.completed ? mLatencySum / stats.completed : 0;
+    stats.maxLatency = mMaxLatency;
+    return stats;
+}
+
+void DecodeService::resetStatistics()
+{
+    mMaxPending = mPending.load();
+    mCompleted = 0;
+    mStolen = 0;
+    mLatencySum = 0;
+    mMaxLatency = 0;
+}
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -7,9 +7,13 @@
  */
 
 #include <polarcode/decoding/adaptive_float.h>
+#include <polarcode/decoding/bp_avx_float.h>
 #include <polarcode/decoding/decoder.h>
+#include <polarcode/decoding/dscf_avx_float.h>
 #include <polarcode/decoding/fastssc_avx_float.h>
 #include <polarcode/decoding/fastssc_fip_char.h>
+#include <polarcode/decoding/fixed_fip_char.h>
+#include <polarcode/decoding/jit_decoder.h>
 #include <polarcode/decoding/scan.h>
 #include <polarcode/decoding/scl_avx_float.h>
 #include <polarcode/decoding/scl_fip_char.h>
@@ -19,6 +23,7 @@
 #include <chrono>
 #include <cstring>
 #include <iostream>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
@@ -33,7 +38,16 @@ Decoder* create(size_t blockLength,
                    decoderType.begin(),
                    [](unsigned char c) { return std::tolower(c); });
     int decoderFlag = 0;
-    if (decoderType.find("char") != std::string::npos) {
+    if (decoderType.find("dscf") != std::string::npos ||
+        decoderType.find("flip") != std::string::npos) {
+        decoderFlag = 4;
+    } else if (decoderType.find("bp") != std::string::npos) {
+        decoderFlag = 5;
+    } else if (decoderType.find("jit") != std::string::npos) {
+        decoderFlag = 6;
+    } else if (decoderType.find("fixed") != std::string::npos) {
+        decoderFlag = decoderType.find("char") != std::string::npos ? 8 : 7;
+    } else if (decoderType.find("char") != std::string::npos) {
         decoderFlag = 0;
     } else if (decoderType.find("float") != std::string::npos) {
         decoderFlag = 1;
@@ -45,9 +59,17 @@ Decoder* create(size_t blockLength,
         throw std::logic_error("Unknown PolarDecoder type!");
     }
 
-    if (listSize < 2 && decoderFlag != 0) {
+    if (listSize < 2 && decoderFlag != 0 && decoderFlag < 4) {
         decoderFlag = 1;
     }
+    if (listSize > 1 && decoderFlag == 6) {
+        // List decoders are not specialized at runtime
+        decoderFlag = 1;
+    }
+    if (listSize > 1 && decoderFlag > 6) {
+        // Unrolled decoders exist for successive cancellation only
+        decoderFlag = decoderFlag == 8 ? 0 : 1;
+    }
     return makeDecoder(blockLength, listSize, frozenBits, decoderFlag);
 }
 
@@ -57,11 +79,42 @@ Decoder* makeDecoder(size_t blockLength,
                      int decoder_impl)
 {
     Decoder* dec;
-    if (listSize == 1) {
+    if (decoder_impl == 4) {
+        // The list size is the trial limit of the flip decoder
+        dec = new DscfAvxFloat(blockLength, listSize, frozenBits);
+    } else if (decoder_impl == 5) {
+        // The list size is the iteration limit of belief propagation
+        dec = new BpAvxFloat(blockLength, listSize, frozenBits);
+    } else if (listSize == 1) {
+        // Codes of the registry have unrolled decoders
+        const int scheme = findCodingScheme(blockLength, frozenBits);
         switch (decoder_impl) {
         case 1:
             dec = new FastSscAvxFloat(blockLength, frozenBits);
             break;
+        case 6:
+            // Registered codes are unrolled already, others get compiled at runtime
+            if (scheme >= 0) {
+                dec = FixedDecoding::createFixedFloat(scheme);
+            } else {
+                dec = new JitDecoder(blockLength, frozenBits);
+            }
+            break;
+        case 7:
+            if (scheme >= 0) {
+                dec = FixedDecoding::createFixedFloat(scheme);
+            } else {
+                dec = new FastSscAvxFloat(blockLength, frozenBits);
+            }
+            break;
+        case 8:
+            // The unrolled char kernels do not follow Fast-SSC decision for decision
+            if (scheme >= 0) {
+                dec = new FixedChar(scheme);
+            } else {
+                dec = new FastSscFipChar(blockLength, frozenBits);
+            }
+            break;
         default:
             dec = new FastSscFipChar(blockLength, frozenBits);
             break;
@@ -180,6 +233,78 @@ bool Decoder::decode_vector(const char* pLlr, void* pData)
     return res;
 }
 
+bool Decoder::decode_vector(const float* pLlr,
+                            size_t llrCount,
+                            void* pData,
+                            size_t dataSize)
+{
+    if (llrCount < mBlockLength || dataSize < (infoLength() + 7) / 8) {
+        throw std::invalid_argument("Decoder: Buffer too short for this code!");
+    }
+    return decodeExternal(pLlr, static_cast<unsigned char*>(pData));
+}
+
+bool Decoder::decode_vector(const char* pLlr,
+                            size_t llrCount,
+                            void* pData,
+                            size_t dataSize)
+{
+    if (llrCount < mBlockLength || dataSize < (infoLength() + 7) / 8) {
+        throw std::invalid_argument("Decoder: Buffer too short for this code!");
+    }
+    return decodeExternal(pLlr, static_cast<unsigned char*>(pData));
+}
+
+bool Decoder::decodeExternal(const float* pLlr, unsigned char* pData)
+{
+    return decode_vector(pLlr, pData);
+}
+
+bool Decoder::decodeExternal(const char* pLlr, unsigned char* pData)
+{
+    return decode_vector(pLlr, pData);
+}
+
+bool Decoder::decode_batch(const float* pLlr,
+                           size_t frames,
+                           void* pData,
+                           bool* pResults)
+{
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    unsigned char* data = static_cast<unsigned char*>(pData);
+    bool result = true;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const bool success =
+            decode_vector(pLlr + frame * mBlockLength, data + frame * infoBytes);
+        if (pResults != nullptr) {
+            pResults[frame] = success;
+        }
+        result &= success;
+    }
+    return result;
+}
+
+bool Decoder::decode_batch(const char* pLlr,
+                           size_t frames,
+                           void* pData,
+                           bool* pResults)
+{
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    unsigned char* data = static_cast<unsigned char*>(pData);
+    bool result = true;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const bool success =
+            decode_vector(pLlr + frame * mBlockLength, data + frame * infoBytes);
+        if (pResults != nullptr) {
+            pResults[frame] = success;
+        }
+        result &= success;
+    }
+    return result;
+}
+
+Decoder* Decoder::clone() const { return nullptr; }
+
 UndefinedDecoder::UndefinedDecoder() {}
 
 UndefinedDecoder::~UndefinedDecoder() {}
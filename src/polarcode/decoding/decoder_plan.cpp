@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/decoder_plan.h>
+#include <polarcode/polarcode.h>
+
+#include <algorithm>
+
+namespace PolarCode {
+namespace Decoding {
+
+DecoderPlan::DecoderPlan(size_t blockLength,
+                         const std::vector<unsigned>& frozenBits,
+                         classifier_t classifier)
+    : mBlockLength(blockLength), mFrozenBits(frozenBits)
+{
+    mNodes.reserve(2 * blockLength);
+    build(mFrozenBits, mBlockLength, classifier);
+    mNodes.shrink_to_fit();
+}
+
+int DecoderPlan::build(const std::vector<unsigned>& frozenBits,
+                       size_t blockLength,
+                       classifier_t classifier)
+{
+    bool split = false;
+    size_t sourceLength = 0;
+    int index = mNodes.size();
+    mNodes.push_back({ classifier(frozenBits, blockLength, split, sourceLength),
+                       static_cast<unsigned>(blockLength),
+                       static_cast<unsigned>(frozenBits.size()),
+                       -1,
+                       -1 });
+
+    if (sourceLength != 0) {
+        // A prefix of frozen bits leaves the source at the end of the subcode
+        const size_t offset = blockLength - sourceLength;
+        const size_t frozenPrefix =
+            std::count_if(frozenBits.begin(), frozenBits.end(), [offset](unsigned bit) {
+                return bit < offset;
+            });
+        const bool suffix = frozenPrefix == offset;
+        std::vector<unsigned> sourceFrozenBits;
+        for (unsigned bit : frozenBits) {
+            if (suffix && bit >= offset) {
+                sourceFrozenBits.push_back(bit - offset);
+            } else if (!suffix && bit < sourceLength) {
+                sourceFrozenBits.push_back(bit);
+            }
+        }
+
+        int source = build(sourceFrozenBits, sourceLength, classifier);
+        if (suffix) {
+            mNodes[index].right = source;
+        } else {
+            mNodes[index].left = source;
+        }
+    } else if (split) {
+        std::vector<unsigned> leftFrozenBits, rightFrozenBits;
+        splitFrozenBits(frozenBits, blockLength / 2, leftFrozenBits, rightFrozenBits);
+
+        // Children are appended behind this node, which may reallocate mNodes
+        int left = build(leftFrozenBits, blockLength / 2, classifier);
+        int right = build(rightFrozenBits, blockLength / 2, classifier);
+        mNodes[index].left = left;
+        mNodes[index].right = right;
+    }
+    return index;
+}
+
+size_t DecoderPlan::blockLength() const { return mBlockLength; }
+
+const std::vector<unsigned>& DecoderPlan::frozenBits() const { return mFrozenBits; }
+
+const PlanNode& DecoderPlan::node(int index) const { return mNodes[index]; }
+
+size_t DecoderPlan::nodeCount() const { return mNodes.size(); }
+
+size_t DecoderPlan::nodeCount(unsigned type) const
+{
+    return std::count_if(mNodes.begin(), mNodes.end(), [type](const PlanNode& node) {
+        return node.type == type;
+    });
+}
+
+size_t DecoderPlan::leafCount() const
+{
+    return std::count_if(mNodes.begin(), mNodes.end(), [](const PlanNode& node) {
+        return node.left < 0 && node.right < 0;
+    });
+}
+
+unsigned DecoderPlan::depth() const
+{
+    // Children are always stored behind their parent
+    std::vector<unsigned> levels(mNodes.size(), 0);
+    unsigned maximum = 0;
+    for (size_t i = 0; i < mNodes.size(); ++i) {
+        for (int child : { mNodes[i].left, mNodes[i].right }) {
+            if (child >= 0) {
+                levels[child] = levels[i] + 1;
+            }
+        }
+        maximum = std::max(maximum, levels[i]);
+    }
+    return maximum;
+}
+
+} // namespace Decoding
+} // namespace PolarCode
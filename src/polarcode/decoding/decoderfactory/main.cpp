@@ -6,14 +6,16 @@
  *
  */
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <polarcode/avxconvenience.h>
-#include <polarcode/construction/bhattacharrya.h>
+#include <polarcode/construction/constructor.h>
 
 using namespace std;
 
@@ -24,90 +26,50 @@ struct CodingScheme {
     float designSnr;
 };
 
-vector<CodingScheme> createRegistry()
+/*
+ * Read the code registry. Each line defines one code as
+ *
+ *   <blockLength> <infoLength> <designSNR> <construction> <systematic|nonsystematic>
+ *
+ * where the construction is one of those known to Construction::frozen_bits().
+ * Everything after a '#' is a comment.
+ */
+bool readRegistry(const char* fileName, vector<CodingScheme>& reg)
 {
-    vector<CodingScheme> reg;
-    float dSnr = -0.25;
-    CodingScheme scheme = { 16384, 8192, {}, true, dSnr };
-
-    PolarCode::Construction::Bhattacharrya* constructor =
-        new PolarCode::Construction::Bhattacharrya();
-
-    reg.clear();
-
-    constructor->setBlockLength(scheme.blockLength);
-    constructor->setInformationLength(scheme.infoLength);
-    constructor->setParameterByDesignSNR(scheme.designSnr);
-
-
-    /*	//-1.59 dB
-            dSnr = -1.59;
-            constructor->setParameterByDesignSNR(dSnr);
-            scheme.frozenBits = constructor->construct();
-            scheme.designSnr = dSnr;
-            reg.push_back(scheme);
-
-            //0.0 dB
-            dSnr = 0.0;
-            constructor->setParameterByDesignSNR(dSnr);
-            scheme.frozenBits = constructor->construct();
-            scheme.designSnr = dSnr;
-            reg.push_back(scheme);
-
-            //1.0 dB
-            dSnr = 1.0;
-            constructor->setParameterByDesignSNR(dSnr);
-            scheme.frozenBits = constructor->construct();
-            scheme.designSnr = dSnr;
-            reg.push_back(scheme);*/
-
-
-    /*	//Rate 1/8
-            scheme.infoLength = scheme.blockLength / 8;
-            constructor->setBlockLength(scheme.blockLength);
-            constructor->setInformationLength(scheme.infoLength);
-            scheme.frozenBits = constructor->construct();
-            reg.push_back(scheme);
-
-            //Rate 1/4
-            scheme.infoLength = scheme.blockLength / 4;
-            constructor->setBlockLength(scheme.blockLength);
-            constructor->setInformationLength(scheme.infoLength);
-            scheme.frozenBits = constructor->construct();
-            reg.push_back(scheme);
-
-            //Rate 1/2
-            scheme.infoLength = scheme.blockLength / 2;
-            constructor->setBlockLength(scheme.blockLength);
-            constructor->setInformationLength(scheme.infoLength);
-            scheme.frozenBits = constructor->construct();
-            reg.push_back(scheme);
-    */
-
-    // N=1024, K=512
-    scheme.blockLength = 1024;
-    scheme.infoLength = scheme.blockLength / 2;
-    constructor->setBlockLength(scheme.blockLength);
-    constructor->setInformationLength(scheme.infoLength);
-    scheme.frozenBits = constructor->construct();
-    reg.push_back(scheme);
-
-    /*	//N=4096, K=2048
-            scheme.blockLength = 4096;
-            scheme.infoLength = scheme.blockLength / 2;
-            constructor->setBlockLength(scheme.blockLength);
-            constructor->setInformationLength(scheme.infoLength);
-            scheme.frozenBits = constructor->construct();
-            reg.push_back(scheme);*/
-
-    /*	//N=32768, K=8192
-            scheme.blockLength = 32768;
-            scheme.infoLength = scheme.blockLength / 2;
-            constructor->setBlockLength(scheme.blockLength);
-            constructor->setInformationLength(scheme.infoLength);
-            scheme.frozenBits = constructor->construct();
-            reg.push_back(scheme);*/
-    return reg;
+    ifstream file(fileName);
+    if (!file.is_open()) {
+        cout << "Registry " << fileName << " can't be read." << endl;
+        return false;
+    }
+
+    string line;
+    unsigned lineNumber = 0;
+    while (getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+
+        CodingScheme scheme;
+        string construction, systematic;
+        istringstream fields(line);
+        fields >> scheme.blockLength >> scheme.infoLength >> scheme.designSnr >>
+            construction >> systematic;
+        if (fields.fail() || scheme.blockLength < 2 ||
+            (scheme.blockLength & (scheme.blockLength - 1)) != 0 ||
+            scheme.infoLength == 0 || scheme.infoLength > scheme.blockLength ||
+            (systematic != "systematic" && systematic != "nonsystematic")) {
+            cout << fileName << ":" << lineNumber << ": Invalid code definition." << endl;
+            return false;
+        }
+        scheme.systematic = systematic == "systematic";
+        scheme.frozenBits = PolarCode::Construction::frozen_bits(
+            scheme.blockLength, scheme.infoLength, scheme.designSnr, construction);
+        sort(scheme.frozenBits.begin(), scheme.frozenBits.end());
+        reg.push_back(scheme);
+    }
+    return true;
 }
 
 void splitFrozenBits(vector<unsigned>& source,
@@ -284,22 +246,30 @@ string writeDecoder(unsigned length,
 int main(int argc, char** argv)
 {
     cout << "This is the factory for fixed decoder creation." << endl;
-    if (argc != 2)
+    if (argc != 3) {
+        cout << "Usage: " << argv[0] << " <registry> <output file>" << endl;
         return 1;
+    }
 
-    ofstream file(argv[1]);
+    std::vector<CodingScheme> registry;
+    if (!readRegistry(argv[1], registry)) {
+        return 3;
+    }
+
+    ofstream file(argv[2]);
     if (!file.is_open()) {
-        cout << "File " << argv[1] << " can't been created." << endl;
+        cout << "File " << argv[2] << " can't been created." << endl;
         return 2;
     }
 
-    std::vector<CodingScheme> registry = createRegistry();
-
     // Write header
 
-    file << R"TREWQ(#include <polarcode/decoding/fip_templates.txx>
+    file << R"TREWQ(// Generated by pcfactory from the code registry, do not edit.
+
+#include <polarcode/decoding/fip_templates.txx>
 #include <immintrin.h>
 #include <polarcode/decoding/fixed_fip_char.h>
+#include <polarcode/decoding/templatized_float.h>
 #include <array>
 
 namespace PolarCode {
@@ -320,7 +290,7 @@ std::vector<CodingScheme> codeRegistry = {
             }
         }
         file << "}, " << (registry[i].systematic ? "true" : "false") << ", "
-             << registry[i].designSnr << "}";
+             << registry[i].designSnr << "f}";
         if (i + 1 < registry.size())
             file << ",";
         file << endl;
@@ -328,17 +298,33 @@ std::vector<CodingScheme> codeRegistry = {
     file << "};" << endl << endl << "namespace FixedDecoding {" << endl << endl;
 
 
+    // Frozen bit sets for the floating point templates
+
+    for (unsigned i = 0; i < registry.size(); ++i) {
+        vector<int> frozenSet(registry[i].blockLength, 0);
+        for (unsigned bit : registry[i].frozenBits) {
+            frozenSet[bit] = 1;
+        }
+        file << "constexpr std::array<int, " << registry[i].blockLength
+             << "> frozenSet_" << i << " = {";
+        for (unsigned j = 0; j < frozenSet.size(); ++j) {
+            file << frozenSet[j] << (j + 1 < frozenSet.size() ? "," : "");
+        }
+        file << "};" << endl << endl;
+    }
+
+
     // Declare the decoders
 
     for (unsigned i = 0; i < registry.size(); ++i) {
         file << "class Fix_" << i << " : public FixedDecoder {" << endl
 #ifdef __AVX2__
              << "	std::array<__m256i, 5> mBitL, mBitR;" << endl
-             << "	std::array<__m256i*, " << (log2(registry[i].blockLength) - 1)
+             << "	std::array<__m256i*, " << log2(registry[i].blockLength)
              << "> mLlr;" << endl
 #else
              << "	std::array<__m128i, 4> mBitL, mBitR;" << endl
-             << "	std::array<__m128i*, " << (log2(registry[i].blockLength) - 1)
+             << "	std::array<__m128i*, " << log2(registry[i].blockLength)
              << "> mLlr;" << endl
 #endif
              << endl
@@ -396,7 +382,7 @@ std::vector<CodingScheme> codeRegistry = {
     }
 
 
-    // Function to create a decoder object by scheme number
+    // Functions to create a decoder object by scheme number
 
     file << "FixedDecoder* createFixedDecoder(unsigned int scheme) {\n\tswitch(scheme) "
             "{\n";
@@ -405,6 +391,19 @@ std::vector<CodingScheme> codeRegistry = {
         file << "		case " << i << ": return new Fix_" << i << "();\n";
     }
 
+    file << "		default: return nullptr;" << endl
+         << "	}" << endl
+         << "}" << endl
+         << endl;
+
+    file << "Decoder* createFixedFloat(unsigned int scheme) {\n\tswitch(scheme) {\n";
+
+    for (unsigned i = 0; i < registry.size(); ++i) {
+        file << "		case " << i << ": return new TemplatizedFloat<"
+             << registry[i].blockLength << ", frozenSet_" << i << ">(codeRegistry[" << i
+             << "].frozenBits);\n";
+    }
+
     file << "		default: return nullptr;" << endl
          << "	}" << endl
          << "}" << endl
@@ -10,157 +10,221 @@
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <polarcode/polarcode.h>
 #include <algorithm>
-#include <list>
 
 namespace PolarCode {
 namespace Decoding {
 
 namespace DepthFirstObjects {
 
-Manager::Manager(int trialLimit) : mTrialLimit(trialLimit) { mNodeList.clear(); }
+Manager::Manager(int trialLimit)
+    : xmRootNode(nullptr),
+      mTrialLimit(trialLimit),
+      mCurrentConfig(0),
+      mBestConfig(0),
+      mBestMetric(0.0f),
+      firstRun(true)
+{
+    mNodeList.clear();
+}
 
 Manager::~Manager() {}
 
 void Manager::pushDecoder(Node* node) { mNodeList.push_back(node); }
 
-void Manager::setRootNode(Node* node) { xmRootNode = node; }
+unsigned Manager::decoderCount() { return mNodeList.size(); }
 
-void Manager::decode()
+void Manager::setRootNode(Node* node)
 {
-    xmRootNode->decode();
+    xmRootNode = node;
 
-    // mConfigList.clear();
-    while (!mConfigList.empty())
-        mConfigList.pop();
+    const unsigned nodeCount = mNodeList.size();
+    int maxOptionCount = 1;
+    for (auto decoder : mNodeList) {
+        maxOptionCount = std::max(maxOptionCount, decoder->optionCount());
+    }
 
-    // Create initial configurations, including the base that has just been decoded
-    std::vector<DecoderHint> hintList;
+    // Up to the trial limit initial configurations,
+    // and the children of each further trial
+    mConfigList.reserve((mTrialLimit + 1) * (maxOptionCount + 1));
+    mRanking.resize(nodeCount);
+    mConfigured.assign(nodeCount, 0);
+    mAppliedOptions.assign(nodeCount, 0);
+    mPendingOptions.assign(nodeCount, 0);
+    mAppliedNodes.reserve(nodeCount);
+    mPendingNodes.reserve(nodeCount);
+}
 
-    // Collect a new list of reliabilities and accumulate paths' total reliability
-    hintList.clear();
+float Manager::pathMetric()
+{
     float metric = 0.0f;
     for (auto decoder : mNodeList) {
         metric += decoder->reliability();
-        hintList.push_back({ decoder, decoder->reliability() });
+    }
+    return metric;
+}
+
+int Manager::weakestNode(unsigned config)
+{
+    // Exclude the nodes of the configuration
+    // to prevent double configuring of already considered nodes
+    for (int c = config; c >= 0; c = mConfigList[c].parent) {
+        mConfigured[mConfigList[c].node] = 1;
     }
 
-    auto myCompareHints = [](const DecoderHint a, const DecoderHint b) -> bool {
-        return a.reliability < b.reliability;
-    };
+    int weakest = -1;
+    float weakestReliability = INFINITY;
+    for (unsigned node = 0; node < mNodeList.size(); ++node) {
+        float reliability = mNodeList[node]->reliability();
+        if (!mConfigured[node] && (weakest < 0 || reliability < weakestReliability)) {
+            weakest = node;
+            weakestReliability = reliability;
+        }
+    }
 
-    // Sort all nodes
-    std::sort(hintList.begin(), hintList.end(), myCompareHints);
-    firstRun = true;
+    for (int c = config; c >= 0; c = mConfigList[c].parent) {
+        mConfigured[mConfigList[c].node] = 0;
+    }
+    return weakest;
+}
 
-    // Create configurations
-    int nodeRank = 0;
-    do {
-        int optionCount = hintList[nodeRank].node->optionCount();
-        Configuration conf;
-        conf.depth = 0;
-        conf.parentMetric = metric;
-        conf.nodeList = hintList;
-        if (nodeRank != 0) {
-            std::rotate(conf.nodeList.begin(),
-                        conf.nodeList.begin() + nodeRank,
-                        conf.nodeList.begin() + nodeRank + 1);
+void Manager::applyConfiguration(unsigned config)
+{
+    for (int c = config; c >= 0; c = mConfigList[c].parent) {
+        const Configuration& conf = mConfigList[c];
+        if (conf.option != 0) {
+            mPendingOptions[conf.node] = conf.option;
+            mPendingNodes.push_back(conf.node);
         }
+    }
 
-        for (int i = (nodeRank == 0 ? 0 : 1); i < optionCount; ++i) {
-            conf.nodeOptions.clear();
-            conf.nodeOptions.push_back(i); // Set option for weakest node
+    // Everything before the first changed node stays as it is
+    unsigned firstNode = mNodeList.size();
+    for (unsigned node : mAppliedNodes) {
+        if (mPendingOptions[node] != mAppliedOptions[node]) {
+            firstNode = std::min(firstNode, node);
+        }
+    }
+    for (unsigned node : mPendingNodes) {
+        if (mPendingOptions[node] != mAppliedOptions[node]) {
+            firstNode = std::min(firstNode, node);
+        }
+    }
+
+    for (unsigned node : mAppliedNodes) {
+        mAppliedOptions[node] = 0;
+    }
+    for (unsigned node : mPendingNodes) {
+        mAppliedOptions[node] = mPendingOptions[node];
+        mPendingOptions[node] = 0;
+        // Nodes reset their option after decoding, so only set it on those to come
+        if (node >= firstNode) {
+            mNodeList[node]->setOption(mAppliedOptions[node]);
+        }
+    }
+    std::swap(mAppliedNodes, mPendingNodes);
+    mPendingNodes.clear();
+
+    if (firstNode < mNodeList.size()) {
+        xmRootNode->resume(firstNode);
+    }
+}
+
+void Manager::decode()
+{
+    xmRootNode->decode();
+
+    // The tree now holds the decisions without any options
+    for (unsigned node : mAppliedNodes) {
+        mAppliedOptions[node] = 0;
+    }
+    mAppliedNodes.clear();
+    mConfigList.clear();
+    mCurrentConfig = 0;
+    firstRun = true;
+
+    const unsigned nodeCount = mNodeList.size();
+    if (nodeCount == 0) {
+        return;
+    }
+    float metric = pathMetric();
+
+    // Rank the weakest nodes, each trial needs at most one of them
+    const unsigned rankCount = std::min(nodeCount, (unsigned)mTrialLimit + 1);
+    for (unsigned node = 0; node < nodeCount; ++node) {
+        mRanking[node] = node;
+    }
+    std::partial_sort(mRanking.begin(),
+                      mRanking.begin() + rankCount,
+                      mRanking.end(),
+                      [this](unsigned a, unsigned b) -> bool {
+                          return mNodeList[a]->reliability() <
+                                 mNodeList[b]->reliability();
+                      });
 
-            mConfigList.push(conf);
+    // Create initial configurations, including the base that has just been decoded
+    unsigned nodeRank = 0;
+    do {
+        unsigned node = mRanking[nodeRank];
+        int optionCount = mNodeList[node]->optionCount();
+        for (int i = (nodeRank == 0 ? 0 : 1); i < optionCount; ++i) {
+            mConfigList.push_back({ -1, node, i, 0, metric });
         }
         nodeRank++;
-    } while (
-        (nodeRank < mTrialLimit * 2 / 3 || hintList[nodeRank].reliability < log(9)) &&
-        mConfigList.size() < (unsigned)mTrialLimit);
+    } while (nodeRank < rankCount &&
+             ((int)nodeRank < mTrialLimit * 2 / 3 ||
+              mNodeList[mRanking[nodeRank]]->reliability() < log(9)) &&
+             mConfigList.size() < (unsigned)mTrialLimit);
 
     mBestMetric = metric;
-    mBestConfig = mConfigList.front();
+    mBestConfig = 0;
 }
 
 
 void Manager::decodeNext()
 {
-    Configuration currentConfig = mConfigList.front();
-    mConfigList.pop();
-    int depth = currentConfig.depth;
+    if (mCurrentConfig >= mConfigList.size()) {
+        return;
+    }
+    const unsigned current = mCurrentConfig++;
     float metric = 0.0f;
 
-    if (mConfigList.size() < (unsigned)mTrialLimit) {
-        std::vector<DecoderHint> hintList;
-
-        if (!firstRun) {
-            // Collect a new list of reliabilities
-            hintList.clear();
-            for (auto hint : currentConfig.nodeList) {
-                metric += hint.node->reliability();
-                hintList.push_back({ hint.node, hint.node->reliability() });
-            }
-            // Sort all nodes, excluding the current configuration
-            // to prevent double configuring of already considered nodes
-            auto myCompareHints = [](const DecoderHint a, const DecoderHint b) -> bool {
-                return a.reliability < b.reliability;
-            };
-            std::sort(hintList.begin() + depth + 1, hintList.end(), myCompareHints);
-        } else {
-            hintList = currentConfig.nodeList;
-            metric = currentConfig.parentMetric;
-            firstRun = false;
-        }
+    if (!firstRun) {
+        metric = pathMetric();
+    } else {
+        metric = mConfigList[current].parentMetric;
+        firstRun = false;
+    }
 
+    if (mConfigList.size() - mCurrentConfig < (unsigned)mTrialLimit) {
         // Create new configurations based on changing the most unreliable node
-        DecoderHint& weakestNode = hintList.at(depth + 1);
-        int optionCount = weakestNode.node->optionCount();
-
-        for (int i = 0; i < optionCount; ++i) {
-            Configuration conf;
-            conf.depth = depth + 1;
-            conf.parentMetric = metric;
-            conf.nodeList = hintList;
-            conf.nodeOptions = currentConfig.nodeOptions;
-            conf.nodeOptions.push_back(i);
-            mConfigList.push(conf);
-        }
-    } else {
-        if (!firstRun) {
-            for (auto hint : currentConfig.nodeList) {
-                metric += hint.node->reliability();
+        int weakest = weakestNode(current);
+        if (weakest >= 0) {
+            int depth = mConfigList[current].depth + 1;
+            int optionCount = mNodeList[weakest]->optionCount();
+            for (int i = 0; i < optionCount; ++i) {
+                mConfigList.push_back(
+                    { (int)current, (unsigned)weakest, i, depth, metric });
             }
-        } else {
-            metric = currentConfig.parentMetric;
-            firstRun = false;
         }
     }
 
     // Save current config, if it is better than previous ones
     if (metric > mBestMetric) {
-        mBestConfig = currentConfig;
+        mBestConfig = current;
         mBestMetric = metric;
     }
 
-    // Configure every node according to the next configuration
-    const Configuration& newConfig = mConfigList.front();
-    depth = newConfig.depth;
-    for (int i = 0; i <= depth; ++i) {
-        newConfig.nodeList[i].node->setOption(newConfig.nodeOptions[i]);
+    // Decode the next configuration
+    if (mCurrentConfig < mConfigList.size()) {
+        applyConfiguration(mCurrentConfig);
     }
-
-    // Decode
-    xmRootNode->decode();
 }
 
 void Manager::decodeBestConfig()
 {
-    int depth = mBestConfig.depth;
-    for (int i = 0; i <= depth; ++i) {
-        mBestConfig.nodeList[i].node->setOption(mBestConfig.nodeOptions[i]);
+    if (mBestConfig < mConfigList.size()) {
+        applyConfiguration(mBestConfig);
     }
-
-    // Decode
-    xmRootNode->decode();
 }
 
 
@@ -227,6 +291,8 @@ void Node::decode()
     // Should never be called
 }
 
+void Node::resume(unsigned) { decode(); }
+
 float Node::reliability() { return mReliability; }
 
 int Node::optionCount() { return mOptionCount; }
@@ -254,6 +320,7 @@ RateRNode::RateRNode(const std::vector<unsigned>& frozenBits, Node* parent) : No
     mLeft->setInput(mLeftLlr->data);
     mLeft->setOutput(mOutput);
 
+    mRightNode = xmManager->decoderCount();
     mRight = createDecoder(rightFrozenBits, this);
     mRight->setInput(mRightLlr->data);
     mRight->setOutput(mOutput + mBlockLength);
@@ -283,6 +350,22 @@ void RateRNode::decode()
     FastSscAvx::Combine(mOutput, mBlockLength);
 }
 
+void RateRNode::resume(unsigned firstNode)
+{
+    // Combining overwrote the left bits, combining again restores them
+    FastSscAvx::Combine(mOutput, mBlockLength);
+
+    if (firstNode < mRightNode) {
+        mLeft->resume(firstNode);
+        FastSscAvx::G_function(mInput, mRightLlr->data, mOutput, mBlockLength);
+        mRight->decode();
+    } else {
+        // The right LLRs are still valid
+        mRight->resume(firstNode);
+    }
+    FastSscAvx::Combine(mOutput, mBlockLength);
+}
+
 /*************
  * ShortRateRNode
  * ***********/
@@ -314,6 +397,19 @@ void ShortRateRNode::decode()
         mLeftBits->data, mRightBits->data, mOutput, mBlockLength);
 }
 
+void ShortRateRNode::resume(unsigned firstNode)
+{
+    if (firstNode < mRightNode) {
+        mLeft->resume(firstNode);
+        FastSscAvx::G_function(mInput, mRightLlr->data, mLeftBits->data, mBlockLength);
+        mRight->decode();
+    } else {
+        mRight->resume(firstNode);
+    }
+    FastSscAvx::CombineBitsShort(
+        mLeftBits->data, mRightBits->data, mOutput, mBlockLength);
+}
+
 /*************
  * RateZeroDecoder
  * ***********/
@@ -569,6 +665,13 @@ void DepthFirst::clear()
     delete mRootNode;
     delete mNodeBase;
     delete mDataPool;
+    delete mManager;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
 }
 
 void DepthFirst::initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
@@ -0,0 +1,446 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/avx_float.h>
+#include <polarcode/decoding/dscf_avx_float.h>
+#include <polarcode/encoding/butterfly_fip_packed.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace DscfAvx {
+
+void Context::decodeLeaf(unsigned index)
+{
+    const Leaf& leaf = leaves[index];
+    leaf.node->decode();
+    if (!flipping || flip.leaf != index) {
+        return;
+    }
+
+    unsigned* bits = reinterpret_cast<unsigned*>(leaf.node->output());
+    if (leaf.type == FastSscAvx::tRepetition) {
+        for (unsigned i = 0; i < leaf.node->blockLength(); ++i) {
+            bits[i] ^= 0x80000000;
+        }
+    } else {
+        bits[flip.bit] ^= 0x80000000;
+        if (flip.partner >= 0) {
+            bits[flip.partner] ^= 0x80000000;
+        }
+    }
+}
+
+/*************
+ * RateRNode
+ * ***********/
+
+RateRNode::RateRNode(const DecoderPlan& plan,
+                     const PlanNode& node,
+                     FastSscAvx::Node* parent,
+                     Context* context)
+    : FastSscAvx::Node(parent),
+      xmContext(context),
+      mLeftBits(nullptr),
+      mRightBits(nullptr),
+      mShort(node.type == FastSscAvx::tShortRateR)
+{
+    mBlockLength /= 2;
+
+    // The left child is created first, so that leaves are in decoding order
+    mLeft = createChild(plan, node.left, mLeftBranch, mLeftLeaf);
+    mRight = createChild(plan, node.right, mRightBranch, mRightLeaf);
+
+    mLeftLlr = xmDataPool->allocate(mBlockLength);
+    mRightLlr = xmDataPool->allocate(mBlockLength);
+    mLeft->setInput(mLeftLlr->data);
+    mRight->setInput(mRightLlr->data);
+
+    if (mShort) {
+        mLeftBits = xmDataPool->allocate(8);
+        mRightBits = xmDataPool->allocate(8);
+        mLeft->setOutput(mLeftBits->data);
+        mRight->setOutput(mRightBits->data);
+    } else {
+        mLeft->setOutput(mOutput);
+        mRight->setOutput(mOutput + mBlockLength);
+    }
+}
+
+RateRNode::~RateRNode()
+{
+    delete mLeft;
+    delete mRight;
+    xmDataPool->release(mLeftLlr);
+    xmDataPool->release(mRightLlr);
+    if (mShort) {
+        xmDataPool->release(mLeftBits);
+        xmDataPool->release(mRightBits);
+    }
+}
+
+FastSscAvx::Node* RateRNode::createChild(const DecoderPlan& plan,
+                                         int index,
+                                         RateRNode*& branch,
+                                         unsigned& leaf)
+{
+    const PlanNode& child = plan.node(index);
+    leaf = xmContext->leaves.size();
+    if (child.left >= 0 || child.right >= 0) {
+        branch = new RateRNode(plan, child, this, xmContext);
+        return branch;
+    }
+
+    branch = nullptr;
+    FastSscAvx::Node* decoder = FastSscAvx::createDecoder(plan, index, this);
+    xmContext->leaves.push_back({decoder, child.type});
+    return decoder;
+}
+
+void RateRNode::setOutput(float* output)
+{
+    mOutput = output;
+    if (!mShort) {
+        mLeft->setOutput(mOutput);
+        mRight->setOutput(mOutput + mBlockLength);
+    }
+}
+
+void RateRNode::decodeLeft()
+{
+    if (mLeftBranch) {
+        mLeftBranch->decode();
+    } else {
+        xmContext->decodeLeaf(mLeftLeaf);
+    }
+}
+
+void RateRNode::decodeRight()
+{
+    float* leftBits = mShort ? mLeftBits->data : mOutput;
+    FastSscAvx::G_function(mInput, mRightLlr->data, leftBits, mBlockLength);
+    if (mRightBranch) {
+        mRightBranch->decode();
+    } else {
+        xmContext->decodeLeaf(mRightLeaf);
+    }
+}
+
+void RateRNode::combine()
+{
+    if (mShort) {
+        FastSscAvx::CombineBitsShort(
+            mLeftBits->data, mRightBits->data, mOutput, mBlockLength);
+    } else {
+        FastSscAvx::Combine(mOutput, mBlockLength);
+    }
+}
+
+void RateRNode::decode()
+{
+    FastSscAvx::F_function(mInput, mLeftLlr->data, mBlockLength);
+    decodeLeft();
+    decodeRight();
+    combine();
+}
+
+void RateRNode::resume(unsigned leaf)
+{
+    // Combining is its own inverse and restores the child bits in place
+    if (!mShort) {
+        FastSscAvx::Combine(mOutput, mBlockLength);
+    }
+
+    if (leaf < mRightLeaf) {
+        // The LLRs of the left child are unchanged
+        if (mLeftBranch) {
+            mLeftBranch->resume(leaf);
+        } else {
+            xmContext->decodeLeaf(mLeftLeaf);
+        }
+        decodeRight();
+    } else {
+        if (mRightBranch) {
+            mRightBranch->resume(leaf);
+        } else {
+            xmContext->decodeLeaf(mRightLeaf);
+        }
+    }
+    combine();
+}
+
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength)
+{
+    const size_t frozenBitCount = frozenBits.size();
+    split = false;
+    sourceLength = 0;
+
+    if (frozenBitCount == blockLength) {
+        return FastSscAvx::tRateZero;
+    }
+    if (frozenBitCount == 0) {
+        return FastSscAvx::tRateOne;
+    }
+    if (frozenBitCount == blockLength - 1) {
+        return FastSscAvx::tRepetition;
+    }
+    if (frozenBitCount == 1) {
+        return FastSscAvx::tSpc;
+    }
+
+    split = true;
+    return blockLength <= 8 ? FastSscAvx::tShortRateR : FastSscAvx::tRateR;
+}
+
+} // namespace DscfAvx
+
+DscfAvxFloat::DscfAvxFloat(size_t blockLength,
+                           size_t trialLimit,
+                           const std::vector<unsigned>& frozenBits)
+    : mTrialLimit(trialLimit), mAlpha(1.0f), mTrialCount(0)
+{
+    initialize(blockLength, frozenBits);
+}
+
+DscfAvxFloat::DscfAvxFloat(plan_t plan, size_t trialLimit)
+    : mPlan(plan), mTrialLimit(trialLimit), mAlpha(1.0f), mTrialCount(0)
+{
+    initializeContext();
+}
+
+DscfAvxFloat::~DscfAvxFloat() { clear(); }
+
+void DscfAvxFloat::clear()
+{
+    delete mEncoder;
+    delete mRoot;
+    delete mLeafRoot;
+    delete mNodeBase;
+    delete mDataPool;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+    mContext.leaves.clear();
+}
+
+plan_t DscfAvxFloat::makePlan(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    return std::make_shared<const DecoderPlan>(
+        blockLength, frozenBits, DscfAvx::classifyNode);
+}
+
+void DscfAvxFloat::initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    if (blockLength == mBlockLength && frozenBits == mFrozenBits) {
+        return;
+    }
+    if (mBlockLength != 0) {
+        clear();
+    }
+    mPlan = makePlan(blockLength, frozenBits);
+    initializeContext();
+}
+
+void DscfAvxFloat::initializeContext()
+{
+    mBlockLength = mPlan->blockLength();
+    mFrozenBits = mPlan->frozenBits();
+    mEncoder = new Encoding::ButterflyFipPacked(mBlockLength, mFrozenBits);
+    mEncoder->setSystematic(false);
+    mDataPool = new DscfAvx::datapool_t();
+    mNodeBase = new FastSscAvx::Node(mBlockLength, mDataPool);
+
+    mContext.leaves.clear();
+    mContext.flipping = false;
+    const PlanNode& root = mPlan->node(0);
+    if (root.left >= 0 || root.right >= 0) {
+        mRoot = new DscfAvx::RateRNode(*mPlan, root, mNodeBase, &mContext);
+        mLeafRoot = nullptr;
+    } else {
+        mRoot = nullptr;
+        mLeafRoot = FastSscAvx::createDecoder(*mPlan, 0, mNodeBase);
+        mContext.leaves.push_back({mLeafRoot, root.type});
+    }
+    mCandidates.reserve(mBlockLength);
+
+    mLlrContainer = new FloatContainer(mNodeBase->input(), mBlockLength);
+    mBitContainer = new FloatContainer(mNodeBase->output(), mBlockLength);
+    mLlrContainer->setFrozenBits(mFrozenBits);
+    mBitContainer->setFrozenBits(mFrozenBits);
+    mOutputContainer = new unsigned char[(mBlockLength - mFrozenBits.size() + 7) / 8];
+}
+
+Decoder* DscfAvxFloat::clone() const
+{
+    DscfAvxFloat* decoder = new DscfAvxFloat(mPlan, mTrialLimit);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    decoder->setAlpha(mAlpha);
+    return decoder;
+}
+
+void DscfAvxFloat::setTrialLimit(size_t trialLimit) { mTrialLimit = trialLimit; }
+
+void DscfAvxFloat::setAlpha(float alpha)
+{
+    if (!(alpha > 0.0f)) {
+        throw std::invalid_argument("DscfAvxFloat: Alpha must be positive!");
+    }
+    mAlpha = alpha;
+}
+
+void DscfAvxFloat::decodeFrom(unsigned leaf)
+{
+    if (mRoot) {
+        mRoot->resume(leaf);
+    } else {
+        mContext.decodeLeaf(0);
+    }
+}
+
+void DscfAvxFloat::findCandidates()
+{
+    using DscfAvx::FlipCandidate;
+
+    mCandidates.clear();
+    float penalty = 0.0f;
+    auto reliability = [this](float magnitude) {
+        return std::log1p(std::exp(-mAlpha * magnitude));
+    };
+
+    for (unsigned index = 0; index < mContext.leaves.size(); ++index) {
+        const DscfAvx::Leaf& leaf = mContext.leaves[index];
+        const float* llr = leaf.node->input();
+        const unsigned length = leaf.node->blockLength();
+        const size_t first = mCandidates.size();
+
+        switch (leaf.type) {
+        case FastSscAvx::tRateOne:
+            for (unsigned bit = 0; bit < length; ++bit) {
+                const float magnitude = std::fabs(llr[bit]);
+                mCandidates.push_back({magnitude, index, bit, -1});
+                penalty += reliability(magnitude);
+            }
+            break;
+        case FastSscAvx::tRepetition: {
+            float sum = 0.0f;
+            for (unsigned bit = 0; bit < length; ++bit) {
+                sum += llr[bit];
+            }
+            mCandidates.push_back({std::fabs(sum), index, 0, -1});
+            penalty += reliability(std::fabs(sum));
+            break;
+        }
+        case FastSscAvx::tSpc: {
+            // Any other bit flips together with the least reliable one
+            unsigned minIndex = 0;
+            bool parity = false;
+            for (unsigned bit = 0; bit < length; ++bit) {
+                parity ^= std::signbit(llr[bit]);
+                if (std::fabs(llr[bit]) < std::fabs(llr[minIndex])) {
+                    minIndex = bit;
+                }
+            }
+            const float minMagnitude = std::fabs(llr[minIndex]);
+            for (unsigned bit = 0; bit < length; ++bit) {
+                const float magnitude = std::fabs(llr[bit]);
+                penalty += reliability(magnitude);
+                if (bit != minIndex) {
+                    const float metric =
+                        parity ? magnitude - minMagnitude : magnitude + minMagnitude;
+                    mCandidates.push_back(
+                        {metric, index, bit, static_cast<int>(minIndex)});
+                }
+            }
+            break;
+        }
+        default:
+            continue;
+        }
+
+        // The penalty covers every decision up to this leaf
+        for (size_t i = first; i < mCandidates.size(); ++i) {
+            mCandidates[i].metric += penalty / mAlpha;
+        }
+    }
+
+    const size_t keep = std::min<size_t>(mTrialLimit, mCandidates.size());
+    std::partial_sort(mCandidates.begin(),
+                      mCandidates.begin() + keep,
+                      mCandidates.end(),
+                      [](const FlipCandidate& a, const FlipCandidate& b) {
+                          return a.metric < b.metric;
+                      });
+    mCandidates.resize(keep);
+}
+
+bool DscfAvxFloat::decode()
+{
+    mTrialCount = 0;
+    mContext.flipping = false;
+    if (mRoot) {
+        mRoot->decode();
+    } else {
+        mContext.decodeLeaf(0);
+    }
+    const bool result = evaluateOutput();
+    if (result || mTrialLimit == 0) {
+        return result;
+    }
+
+    findCandidates();
+    if (mCandidates.empty()) {
+        return false;
+    }
+
+    // Earlier leaves keep their decisions, so each trial resumes at the
+    // first leaf which differs from the previous trial.
+    unsigned previous = mContext.leaves.size();
+    mContext.flipping = true;
+    for (const DscfAvx::FlipCandidate& candidate : mCandidates) {
+        mContext.flip = candidate;
+        decodeFrom(std::min(previous, candidate.leaf));
+        previous = candidate.leaf;
+        ++mTrialCount;
+        if (evaluateOutput()) {
+            return true;
+        }
+    }
+
+    // Restore the result of the first run
+    mContext.flipping = false;
+    decodeFrom(previous);
+    evaluateOutput();
+    return false;
+}
+
+bool DscfAvxFloat::evaluateOutput()
+{
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    if (!mSystematic) {
+        mEncoder->setFloatCodeword(dynamic_cast<FloatContainer*>(mBitContainer)->data());
+        mEncoder->encode();
+        mEncoder->getInformation(mOutputContainer);
+    } else {
+        mBitContainer->getPackedInformationBits(mOutputContainer);
+    }
+    return mErrorDetector->check(mOutputContainer, infoBytes);
+}
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -7,14 +7,18 @@
  */
 
 #include <polarcode/decoding/fastssc_avx_float.h>
+#include <polarcode/decoding/fastssc_avx_float_interleaved.h>
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <polarcode/polarcode.h>
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
+#include <stdexcept>
 #include <string>
 
 #include <cmath>
+#include <cstdint>
 #include <cstring> //for memset
 
 #include <fmt/core.h>
@@ -39,23 +43,130 @@ inline void memFloatFill(float* dst, float value, const size_t blockLength)
     }
 }
 
+MemoryLayout::MemoryLayout(const DecoderPlan& plan) : mSize(0)
+{
+    const unsigned stageCount = __builtin_ctz(plan.blockLength()) + 1;
+    mLlr.assign(stageCount, NONE);
+    mLeftBits.assign(stageCount, NONE);
+    mRightBits.assign(stageCount, NONE);
+    mSourceBits.assign(stageCount, NONE);
+    require(plan, 0);
+
+    // Stage buffers follow the channel LLRs in the order they are visited
+    mInput = allocate(plan.blockLength());
+    for (unsigned stage = stageCount - 1; stage-- > 0;) {
+        if (mLlr[stage] != NONE) {
+            mLlr[stage] = allocate(1 << stage);
+        }
+    }
+    mOutput = allocate(plan.blockLength());
+    for (auto buffers : { &mLeftBits, &mRightBits, &mSourceBits }) {
+        for (unsigned stage = stageCount; stage-- > 0;) {
+            if ((*buffers)[stage] != NONE) {
+                (*buffers)[stage] = allocate(1 << stage);
+            }
+        }
+    }
+}
+
+/*
+ * Marks the buffers, which the subtree of a node uses, with zero.
+ */
+void MemoryLayout::require(const DecoderPlan& plan, int index)
+{
+    const PlanNode& node = plan.node(index);
+    const unsigned stage = __builtin_ctz(node.blockLength);
+
+    switch (node.type) {
+    case tShortRateR:
+        mLeftBits[stage] = 0;
+        mRightBits[stage] = 0;
+        [[fallthrough]];
+    case tRateR:
+    case tROne:
+    case tZeroR:
+        mLlr[stage - 1] = 0;
+        break;
+    case tGRepetition:
+        if (plan.node(node.right).blockLength < 8) {
+            return;
+        }
+        mLlr[__builtin_ctz(plan.node(node.right).blockLength)] = 0;
+        require(plan, node.right);
+        return;
+    case tGParityCheck:
+        if (plan.node(node.left).type == tRateZero) {
+            return;
+        }
+        mLlr[__builtin_ctz(plan.node(node.left).blockLength)] = 0;
+        mSourceBits[__builtin_ctz(plan.node(node.left).blockLength)] = 0;
+        require(plan, node.left);
+        return;
+    default:
+        return;
+    }
+
+    if (node.left >= 0 && node.type != tZeroR) {
+        require(plan, node.left);
+    }
+    if (node.right >= 0 && node.type != tROne) {
+        require(plan, node.right);
+    }
+}
+
+unsigned MemoryLayout::allocate(unsigned length)
+{
+    const unsigned offset = mSize;
+    mSize += nBit2fCount(length);
+    return offset;
+}
+
+size_t MemoryLayout::size() const { return mSize; }
+
+unsigned MemoryLayout::input() const { return mInput; }
+
+unsigned MemoryLayout::output() const { return mOutput; }
+
+unsigned MemoryLayout::llr(unsigned length) const { return mLlr[__builtin_ctz(length)]; }
+
+unsigned MemoryLayout::leftBits(unsigned length) const
+{
+    return mLeftBits[__builtin_ctz(length)];
+}
+
+unsigned MemoryLayout::rightBits(unsigned length) const
+{
+    return mRightBits[__builtin_ctz(length)];
+}
+
+unsigned MemoryLayout::sourceBits(unsigned length) const
+{
+    return mSourceBits[__builtin_ctz(length)];
+}
+
 Node::Node()
     : mBlockLength(0),
       xmDataPool(nullptr),
       mLlr(nullptr),
       mBit(nullptr),
       mInput(nullptr),
-      mOutput(nullptr)
+      mOutput(nullptr),
+      xmLayout(nullptr),
+      xmArena(nullptr),
+      xmTeam(nullptr)
 {
 }
 
 Node::Node(Node* other)
     : mBlockLength(other->mBlockLength),
       xmDataPool(other->xmDataPool),
-      mLlr(xmDataPool->allocate(mBlockLength)),
-      mBit(xmDataPool->allocate(mBlockLength)),
+      mLlr(nullptr),
+      mBit(nullptr),
       mInput(other->mInput),
-      mOutput(other->mOutput)
+      mOutput(other->mOutput),
+      xmLayout(other->xmLayout),
+      xmArena(other->xmArena),
+      xmTeam(other->xmTeam)
 {
 }
 
@@ -65,14 +176,46 @@ Node::Node(size_t blockLength, datapool_t* pool)
       mLlr(pool->allocate(blockLength)),
       mBit(pool->allocate(blockLength)),
       mInput(mLlr->data),
-      mOutput(mBit->data)
+      mOutput(mBit->data),
+      xmLayout(nullptr),
+      xmArena(nullptr),
+      xmTeam(nullptr)
+{
+}
+
+Node::Node(size_t blockLength,
+           datapool_t* pool,
+           const MemoryLayout* layout,
+           float* arena,
+           ThreadTeam* team)
+    : mBlockLength(blockLength),
+      xmDataPool(pool),
+      mLlr(nullptr),
+      mBit(nullptr),
+      mInput(arena + layout->input()),
+      mOutput(arena + layout->output()),
+      xmLayout(layout),
+      xmArena(arena),
+      xmTeam(team)
 {
 }
 
 Node::~Node()
 {
-    xmDataPool->release(mLlr);
-    xmDataPool->release(mBit);
+    if (xmDataPool) {
+        xmDataPool->release(mLlr);
+        xmDataPool->release(mBit);
+    }
+}
+
+float* Node::arena(unsigned offset) { return xmArena + offset; }
+
+void Node::split(const std::function<void(unsigned begin, unsigned end)>& kernel)
+{
+    // Ranges of whole cache lines, such that members never share one
+    xmTeam->split(mBlockLength, 64, [&](unsigned, unsigned begin, unsigned end) {
+        kernel(begin, end);
+    });
 }
 
 void Node::decode() {}
@@ -94,37 +237,88 @@ float* Node::output() { return mOutput; }
  * RateRNode
  * ***********/
 
-RateRNode::RateRNode(const std::vector<unsigned>& frozenBits,
+/*
+ * Ranges [begin, end) of the kernels of a node, whose children are _half_ bits
+ * long. A range of each kernel reads and writes only the same range of each
+ * half, such that the ranges can be computed in parallel.
+ */
+namespace {
+
+void fRange(const float* in, float* out, unsigned half, unsigned begin, unsigned end)
+{
+    for (unsigned i = begin; i < end; i += 8) {
+        const __m256 left = _mm256_load_ps(in + i);
+        const __m256 right = _mm256_load_ps(in + half + i);
+        _mm256_store_ps(out + i, _mm256_polarf_ps(left, right));
+    }
+}
+
+void gRange(const float* in,
+            float* out,
+            const float* bits,
+            unsigned half,
+            unsigned begin,
+            unsigned end)
+{
+    for (unsigned i = begin; i < end; i += 8) {
+        const __m256 left = _mm256_load_ps(in + i);
+        const __m256 right = _mm256_load_ps(in + half + i);
+        _mm256_store_ps(out + i, _mm256_polarg_ps(left, right, _mm256_load_ps(bits + i)));
+    }
+}
+
+void g0RRange(const float* in, float* out, unsigned half, unsigned begin, unsigned end)
+{
+    for (unsigned i = begin; i < end; i += 8) {
+        const __m256 left = _mm256_load_ps(in + i);
+        const __m256 right = _mm256_load_ps(in + half + i);
+        _mm256_store_ps(out + i, _mm256_add_ps(left, right));
+    }
+}
+
+void combineRange(float* bits, unsigned half, unsigned begin, unsigned end)
+{
+    for (unsigned i = begin; i < end; i += 8) {
+        const __m256 left = _mm256_load_ps(bits + i);
+        const __m256 right = _mm256_load_ps(bits + half + i);
+        _mm256_store_ps(bits + i, _mm256_xor_ps(left, right));
+    }
+}
+
+void combine0RRange(float* bits, unsigned half, unsigned begin, unsigned end)
+{
+    memcpy(bits + begin, bits + half + begin, (end - begin) * sizeof(float));
+}
+
+} // namespace
+
+RateRNode::RateRNode(const DecoderPlan& plan,
+                     const PlanNode& node,
                      Node* parent,
                      ChildCreationFlags flags)
     : Node(parent)
 {
     mBlockLength /= 2;
-
-    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
-    splitFrozenBits(frozenBits, mBlockLength, leftFrozenBits, rightFrozenBits);
+    if (mBlockLength < PARALLEL_LENGTH) {
+        xmTeam = nullptr; // Not worth a fork and join, neither for any child
+    }
 
     if (flags & NO_LEFT) {
         mLeft = new Node();
     } else {
-        // fmt::print("ctor: left  RateR( {} / {})\n", mBlockLength,
-        // leftFrozenBits.size());
-        mLeft = createDecoder(leftFrozenBits, this);
+        mLeft = createDecoder(plan, node.left, this);
     }
 
     if (flags & NO_RIGHT) {
         mRight = new Node();
     } else {
-        // fmt::print("ctor: right RateR( {} / {})\n", mBlockLength,
-        // rightFrozenBits.size());
-        mRight = createDecoder(rightFrozenBits, this);
+        mRight = createDecoder(plan, node.right, this);
     }
 
-    mLeftLlr = xmDataPool->allocate(mBlockLength);
-    mRightLlr = xmDataPool->allocate(mBlockLength);
-
-    mLeft->setInput(mLeftLlr->data);
-    mRight->setInput(mRightLlr->data);
+    // The right child reads its LLRs only after the left one has finished
+    mChildLlr = arena(xmLayout->llr(mBlockLength));
+    mLeft->setInput(mChildLlr);
+    mRight->setInput(mChildLlr);
 
     mLeft->setOutput(mOutput);
     mRight->setOutput(mOutput + mBlockLength);
@@ -134,8 +328,6 @@ RateRNode::~RateRNode()
 {
     delete mLeft;
     delete mRight;
-    xmDataPool->release(mLeftLlr);
-    xmDataPool->release(mRightLlr);
 }
 
 void RateRNode::setOutput(float* output)
@@ -147,9 +339,24 @@ void RateRNode::setOutput(float* output)
 
 void RateRNode::decode()
 {
-    F_function(mInput, mLeftLlr->data, mBlockLength);
+    if (xmTeam != nullptr) {
+        split([&](unsigned begin, unsigned end) {
+            fRange(mInput, mChildLlr, mBlockLength, begin, end);
+        });
+        mLeft->decode();
+        split([&](unsigned begin, unsigned end) {
+            gRange(mInput, mChildLlr, mOutput, mBlockLength, begin, end);
+        });
+        mRight->decode();
+        split([&](unsigned begin, unsigned end) {
+            combineRange(mOutput, mBlockLength, begin, end);
+        });
+        return;
+    }
+
+    F_function(mInput, mChildLlr, mBlockLength);
     mLeft->decode();
-    G_function(mInput, mRightLlr->data, mOutput, mBlockLength);
+    G_function(mInput, mChildLlr, mOutput, mBlockLength);
     mRight->decode();
     Combine(mOutput, mBlockLength);
 }
@@ -158,72 +365,88 @@ void RateRNode::decode()
  * ShortRateRNode
  * ***********/
 
-ShortRateRNode::ShortRateRNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent),
-      mLeftBits(xmDataPool->allocate(8)),
-      mRightBits(xmDataPool->allocate(8))
+ShortRateRNode::ShortRateRNode(const DecoderPlan& plan,
+                               const PlanNode& node,
+                               Node* parent)
+    : RateRNode(plan, node, parent),
+      mLeftBits(arena(xmLayout->leftBits(2 * mBlockLength))),
+      mRightBits(arena(xmLayout->rightBits(2 * mBlockLength)))
 {
-    mLeft->setOutput(mLeftBits->data);
-    mRight->setOutput(mRightBits->data);
+    mLeft->setOutput(mLeftBits);
+    mRight->setOutput(mRightBits);
 }
 
-ShortRateRNode::~ShortRateRNode()
-{
-    xmDataPool->release(mLeftBits);
-    xmDataPool->release(mRightBits);
-}
+ShortRateRNode::~ShortRateRNode() {}
 
 void ShortRateRNode::setOutput(float* output) { mOutput = output; }
 
 void ShortRateRNode::decode()
 {
-    F_function(mInput, mLeftLlr->data, mBlockLength);
+    F_function(mInput, mChildLlr, mBlockLength);
     mLeft->decode();
-    G_function(mInput, mRightLlr->data, mLeftBits->data, mBlockLength);
+    G_function(mInput, mChildLlr, mLeftBits, mBlockLength);
     mRight->decode();
-    CombineBitsShort(mLeftBits->data, mRightBits->data, mOutput, mBlockLength);
+    CombineBitsShort(mLeftBits, mRightBits, mOutput, mBlockLength);
 }
 
 /*************
  * ROneNode
  * ***********/
 
-ROneNode::ROneNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent, NO_RIGHT)
+ROneNode::ROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : RateRNode(plan, node, parent, NO_RIGHT)
 {
 }
 
 ROneNode::~ROneNode() {}
 
-void ROneNode::decode()
+void decodeROneRight(float* out, float* in, unsigned blockLength)
 {
-    F_function(mInput, mLeftLlr->data, mBlockLength);
-    mLeft->decode();
-    rightDecode();
+    decodeROneRight(out, in, blockLength, 0, blockLength / 2);
 }
 
-void ROneNode::rightDecode()
+void decodeROneRight(
+    float* out, float* in, unsigned blockLength, unsigned begin, unsigned end)
 {
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        __m256 Llr_l = _mm256_load_ps(mInput + i);
-        __m256 Llr_r = _mm256_load_ps(mInput + mBlockLength + i);
-        __m256 Bits = _mm256_load_ps(mOutput + i);
+    const unsigned half = blockLength / 2;
+    for (unsigned i = begin; i < end; i += 8) {
+        __m256 Llr_l = _mm256_load_ps(in + i);
+        __m256 Llr_r = _mm256_load_ps(in + half + i);
+        __m256 Bits = _mm256_load_ps(out + i);
         __m256 HBits = hardDecode(Bits);
 
-        __m256 Llr_o = _mm256_xor_ps(Llr_l, HBits);               // G-function
-        Llr_o = _mm256_add_ps(Llr_o, Llr_r);                      // G-function
-        /*nop*/                                                   // Rate 1 decoder
-        _mm256_store_ps(mOutput + i, _mm256_xor_ps(Bits, Llr_o)); // Combine left bit
-        _mm256_store_ps(mOutput + i + mBlockLength, Llr_o);       // Right bit
+        __m256 Llr_o = _mm256_xor_ps(Llr_l, HBits);           // G-function
+        Llr_o = _mm256_add_ps(Llr_o, Llr_r);                  // G-function
+        /*nop*/                                               // Rate 1 decoder
+        _mm256_store_ps(out + i, _mm256_xor_ps(Bits, Llr_o)); // Combine left bit
+        _mm256_store_ps(out + i + half, Llr_o);               // Right bit
     }
 }
 
+void ROneNode::decode()
+{
+    if (xmTeam != nullptr) {
+        split([&](unsigned begin, unsigned end) {
+            fRange(mInput, mChildLlr, mBlockLength, begin, end);
+        });
+        mLeft->decode();
+        split([&](unsigned begin, unsigned end) {
+            decodeROneRight(mOutput, mInput, 2 * mBlockLength, begin, end);
+        });
+        return;
+    }
+
+    F_function(mInput, mChildLlr, mBlockLength);
+    mLeft->decode();
+    decodeROneRight(mOutput, mInput, 2 * mBlockLength);
+}
+
 /*************
  * ZeroRNode
  * ***********/
 
-ZeroRNode::ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent, NO_LEFT)
+ZeroRNode::ZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : RateRNode(plan, node, parent, NO_LEFT)
 {
 }
 
@@ -231,7 +454,18 @@ ZeroRNode::~ZeroRNode() {}
 
 void ZeroRNode::decode()
 {
-    G_function_0R(mInput, mRightLlr->data, mBlockLength);
+    if (xmTeam != nullptr) {
+        split([&](unsigned begin, unsigned end) {
+            g0RRange(mInput, mChildLlr, mBlockLength, begin, end);
+        });
+        mRight->decode();
+        split([&](unsigned begin, unsigned end) {
+            combine0RRange(mOutput, mBlockLength, begin, end);
+        });
+        return;
+    }
+
+    G_function_0R(mInput, mChildLlr, mBlockLength);
     mRight->decode();
     Combine_0R(mOutput, mBlockLength);
 }
@@ -244,7 +478,12 @@ RateZeroDecoder::RateZeroDecoder(Node* parent) : Node(parent) {}
 
 RateZeroDecoder::~RateZeroDecoder() {}
 
-void RateZeroDecoder::decode() { memFloatFill(mOutput, INFINITY, mBlockLength); }
+void decodeRateZero(float* out, float*, unsigned blockLength)
+{
+    memFloatFill(out, INFINITY, blockLength);
+}
+
+void RateZeroDecoder::decode() { decodeRateZero(mOutput, mInput, mBlockLength); }
 
 /*************
  * RateOneDecoder
@@ -254,14 +493,16 @@ RateOneDecoder::RateOneDecoder(Node* parent) : Node(parent) {}
 
 RateOneDecoder::~RateOneDecoder() {}
 
-void RateOneDecoder::decode()
+void decodeRateOne(float* out, float* in, unsigned blockLength)
 {
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        __m256 llr = _mm256_load_ps(mInput + i);
-        _mm256_store_ps(mOutput + i, llr);
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        __m256 llr = _mm256_load_ps(in + i);
+        _mm256_store_ps(out + i, llr);
     }
 }
 
+void RateOneDecoder::decode() { decodeRateOne(mOutput, mInput, mBlockLength); }
+
 /*************
  * RepetitionDecoder
  * ***********/
@@ -270,22 +511,24 @@ RepetitionDecoder::RepetitionDecoder(Node* parent) : Node(parent) {}
 
 RepetitionDecoder::~RepetitionDecoder() {}
 
-void RepetitionDecoder::decode()
+void decodeRepetition(float* out, float* in, unsigned blockLength)
 {
     __m256 LlrSum = _mm256_setzero_ps();
 
-    RepetitionPrepare(mInput, mBlockLength);
+    RepetitionPrepare(in, blockLength);
 
     // Accumulate vectors
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        LlrSum = _mm256_add_ps(LlrSum, _mm256_load_ps(mInput + i));
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        LlrSum = _mm256_add_ps(LlrSum, _mm256_load_ps(in + i));
     }
 
     // Get final sum and save decoding result
     float Bits = reduce_add_ps(LlrSum);
-    memFloatFill(mOutput, Bits, mBlockLength);
+    memFloatFill(out, Bits, blockLength);
 }
 
+void RepetitionDecoder::decode() { decodeRepetition(mOutput, mInput, mBlockLength); }
+
 /*************
  * DoubleRepetitionDecoder
  * ***********/
@@ -300,37 +543,42 @@ DoubleRepetitionDecoder::DoubleRepetitionDecoder(Node* parent) : Node(parent)
 
 DoubleRepetitionDecoder::~DoubleRepetitionDecoder() {}
 
-void DoubleRepetitionDecoder::decode()
+void decodeDoubleRepetition(float* out, float* in, unsigned blockLength)
 {
     __m256 llr_sum = _mm256_setzero_ps();
 
-    RepetitionPrepare(mInput, mBlockLength);
+    RepetitionPrepare(in, blockLength);
 
     // Accumulate vectors
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        llr_sum = _mm256_add_ps(llr_sum, _mm256_load_ps(mInput + i));
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        llr_sum = _mm256_add_ps(llr_sum, _mm256_load_ps(in + i));
     }
 
-    if (mBlockLength >= 8) {
+    if (blockLength >= 8) {
         llr_sum = _mm256_add_ps(llr_sum, _mm256_permute2f128_ps(llr_sum, llr_sum, 1));
 
         llr_sum = _mm256_add_ps(llr_sum, _mm256_shuffle_ps(llr_sum, llr_sum, 0x4E));
 
-        for (unsigned i = 0; i < mBlockLength; i += 8) {
-            _mm256_store_ps(mOutput + i, llr_sum);
+        for (unsigned i = 0; i < blockLength; i += 8) {
+            _mm256_store_ps(out + i, llr_sum);
         }
     } else {
         float even_llr_sum = llr_sum[0] + llr_sum[2] + llr_sum[4] + llr_sum[6];
 
         float odd_llr_sum = llr_sum[1] + llr_sum[3] + llr_sum[5] + llr_sum[7];
 
-        for (unsigned i = 0; i < mBlockLength; i += 2) {
-            mOutput[i] = even_llr_sum;
-            mOutput[i + 1] = odd_llr_sum;
+        for (unsigned i = 0; i < blockLength; i += 2) {
+            out[i] = even_llr_sum;
+            out[i + 1] = odd_llr_sum;
         }
     }
 }
 
+void DoubleRepetitionDecoder::decode()
+{
+    decodeDoubleRepetition(mOutput, mInput, mBlockLength);
+}
+
 /*************
  * SpcDecoder
  * ***********/
@@ -339,18 +587,18 @@ SpcDecoder::SpcDecoder(Node* parent) : Node(parent) {}
 
 SpcDecoder::~SpcDecoder() {}
 
-void SpcDecoder::decode()
+void decodeSpc(float* out, float* in, unsigned blockLength)
 {
     const __m256 sgnMask = _mm256_set1_ps(-0.0);
     __m256 parVec = _mm256_setzero_ps();
     unsigned minIdx = 0;
     float testAbs, minAbs = INFINITY;
 
-    SpcPrepare(mInput, mBlockLength);
+    SpcPrepare(in, blockLength);
 
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        __m256 vecIn = _mm256_load_ps(mInput + i);
-        _mm256_store_ps(mOutput + i, vecIn);
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        __m256 vecIn = _mm256_load_ps(in + i);
+        _mm256_store_ps(out + i, vecIn);
 
         parVec = _mm256_xor_ps(parVec, vecIn);
 
@@ -369,9 +617,11 @@ void SpcDecoder::decode()
     };
     fParity = reduce_xor_ps(parVec);
     iParity &= 0x80000000;
-    reinterpret_cast<unsigned int*>(mOutput)[minIdx] ^= iParity;
+    reinterpret_cast<unsigned int*>(out)[minIdx] ^= iParity;
 }
 
+void SpcDecoder::decode() { decodeSpc(mOutput, mInput, mBlockLength); }
+
 
 /*************
  * DoubleSpcDecoder
@@ -422,10 +672,10 @@ DoubleSpcDecoder::DoubleSpcDecoder(Node* parent) : Node(parent) {}
 
 DoubleSpcDecoder::~DoubleSpcDecoder() {}
 
-void DoubleSpcDecoder::decode()
+void decodeDoubleSpc(float* out, float* in, unsigned blockLength)
 {
-    // SpcPrepare(mInput, mBlockLength);
-    const float* llrs = mInput;
+    // SpcPrepare(in, blockLength);
+    const float* llrs = in;
 
     __m256 parity = _mm256_setzero_ps();
     __m256 minvalues = _mm256_set1_ps(std::numeric_limits<float>::max());
@@ -433,9 +683,9 @@ void DoubleSpcDecoder::decode()
 
     __m256 indices = _mm256_setr_ps(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0);
 
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
+    for (unsigned i = 0; i < blockLength; i += 8) {
         const __m256 part = _mm256_load_ps(llrs + i);
-        _mm256_store_ps(mOutput + i, part);
+        _mm256_store_ps(out + i, part);
         parity = _mm256_xor_ps(parity, part);
         minvalues = _mm256_argabsmin_ps(minindices, indices, minvalues, part);
         indices = _mm256_add_ps(indices, IDX_STEP);
@@ -459,20 +709,22 @@ void DoubleSpcDecoder::decode()
     const bool even_parity = std::signbit(parities[0]);
     const bool odd_parity = std::signbit(parities[1]);
 
-    reinterpret_cast<unsigned int*>(mOutput)[even_idx] ^=
+    reinterpret_cast<unsigned int*>(out)[even_idx] ^=
         (even_parity ? 0x80000000 : 0x00000000);
-    reinterpret_cast<unsigned int*>(mOutput)[odd_idx] ^=
+    reinterpret_cast<unsigned int*>(out)[odd_idx] ^=
         (odd_parity ? 0x80000000 : 0x00000000);
 }
 
+void DoubleSpcDecoder::decode() { decodeDoubleSpc(mOutput, mInput, mBlockLength); }
+
 
 DoubleSpcDecoderShort8::DoubleSpcDecoderShort8(Node* parent) : Node(parent) {}
 
 DoubleSpcDecoderShort8::~DoubleSpcDecoderShort8() {}
 
-void DoubleSpcDecoderShort8::decode()
+void decodeDoubleSpcShort8(float* out, float* in, unsigned)
 {
-    const __m256 values = _mm256_load_ps(mInput);
+    const __m256 values = _mm256_load_ps(in);
     const __m256 minvalues = _mm256_abs_ps(values);
 
     const __m256 fourMin = _mm256_min4_ps(minvalues);
@@ -484,7 +736,12 @@ void DoubleSpcDecoderShort8::decode()
     const __m256 parities = _mm256_reduce_xor_half_ps(values);
     const __m256 signed_mask = _mm256_and_ps(parities, signs);
     const __m256 result = _mm256_xor_ps(signed_mask, values);
-    _mm256_store_ps(mOutput, result);
+    _mm256_store_ps(out, result);
+}
+
+void DoubleSpcDecoderShort8::decode()
+{
+    decodeDoubleSpcShort8(mOutput, mInput, mBlockLength);
 }
 
 
@@ -492,18 +749,14 @@ void DoubleSpcDecoderShort8::decode()
  * ZeroSpcDecoder
  * ***********/
 
-ZeroSpcDecoder::ZeroSpcDecoder(Node* parent) : Node(parent)
-{
-    mTempBlock = xmDataPool->allocate(mBlockLength);
-    mTempBlockPtr = mTempBlock->data;
-}
+ZeroSpcDecoder::ZeroSpcDecoder(Node* parent) : Node(parent) {}
 
-ZeroSpcDecoder::~ZeroSpcDecoder() { xmDataPool->release(mTempBlock); }
+ZeroSpcDecoder::~ZeroSpcDecoder() {}
 
-void ZeroSpcDecoder::decode()
+void decodeZeroSpc(float* out, float* in, unsigned blockLength)
 {
     const __m256 sgnMask = _mm256_set1_ps(-0.0);
-    const size_t subBlockLength = mBlockLength / 2;
+    const size_t subBlockLength = blockLength / 2;
     __m256 parVec = _mm256_setzero_ps();
     unsigned minIdx = 0;
     float testAbs, minAbs = INFINITY;
@@ -511,13 +764,13 @@ void ZeroSpcDecoder::decode()
     // Check parity equation
     for (unsigned i = 0; i < subBlockLength; i += 8) {
         // G-function with only frozen bits
-        __m256 left = _mm256_load_ps(mInput + i);
-        __m256 right = _mm256_load_ps(mInput + subBlockLength + i);
+        __m256 left = _mm256_load_ps(in + i);
+        __m256 right = _mm256_load_ps(in + subBlockLength + i);
         __m256 llr = _mm256_add_ps(left, right);
 
         // Save output
-        _mm256_store_ps(mOutput + i, right);
-        _mm256_store_ps(mOutput + subBlockLength + i, right);
+        _mm256_store_ps(out + i, right);
+        _mm256_store_ps(out + subBlockLength + i, right);
 
         // Update parity counter
         parVec = _mm256_xor_ps(parVec, llr);
@@ -540,11 +793,13 @@ void ZeroSpcDecoder::decode()
     };
     fParity = reduce_xor_ps(parVec);
     iParity &= 0x80000000;
-    unsigned* iOutput = reinterpret_cast<unsigned*>(mOutput);
+    unsigned* iOutput = reinterpret_cast<unsigned*>(out);
     iOutput[minIdx] ^= iParity;
     iOutput[minIdx + subBlockLength] ^= iParity;
 }
 
+void ZeroSpcDecoder::decode() { decodeZeroSpc(mOutput, mInput, mBlockLength); }
+
 /*************
  * ZeroSpcDecoderShort8
  * ***********/
@@ -553,15 +808,20 @@ ZeroSpcDecoderShort8::ZeroSpcDecoderShort8(Node* parent) : Node(parent) {}
 
 ZeroSpcDecoderShort8::~ZeroSpcDecoderShort8() {}
 
-void ZeroSpcDecoderShort8::decode()
+void decodeZeroSpcShort8(float* out, float* in, unsigned)
 {
-    const __m256 input = _mm256_load_ps(mInput);
+    const __m256 input = _mm256_load_ps(in);
     const __m256 swaplane = _mm256_permute2f128_ps(input, input, 0b00000001);
 
     const __m256 spc_input = _mm256_add_ps(input, swaplane);
     const __m256 spc_output = _mm256_spc_right4_ps(spc_input);
     const __m256 result = _mm256_permute2f128_ps(spc_output, spc_output, 0b00010001);
-    _mm256_store_ps(mOutput, result);
+    _mm256_store_ps(out, result);
+}
+
+void ZeroSpcDecoderShort8::decode()
+{
+    decodeZeroSpcShort8(mOutput, mInput, mBlockLength);
 }
 
 
@@ -569,11 +829,11 @@ TripleRepetitionDecoder::TripleRepetitionDecoder(Node* parent) : Node(parent) {}
 
 TripleRepetitionDecoder::~TripleRepetitionDecoder() {}
 
-void TripleRepetitionDecoder::decode()
+void decodeTripleRepetition(float* out, float* in, unsigned blockLength)
 {
     __m256 input = _mm256_setzero_ps();
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        const __m256 part = _mm256_load_ps(mInput + i);
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        const __m256 part = _mm256_load_ps(in + i);
         input = _mm256_add_ps(input, part);
     }
 
@@ -583,11 +843,16 @@ void TripleRepetitionDecoder::decode()
     const __m256 spc_output = _mm256_spc_right4_ps(spc_input);
     const __m256 result = _mm256_permute2f128_ps(spc_output, spc_output, 0b00010001);
 
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        _mm256_store_ps(mOutput + i, result);
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        _mm256_store_ps(out + i, result);
     }
 }
 
+void TripleRepetitionDecoder::decode()
+{
+    decodeTripleRepetition(mOutput, mInput, mBlockLength);
+}
+
 
 namespace {
 
@@ -715,9 +980,9 @@ RepetitionRateOneDecoderShort8::RepetitionRateOneDecoderShort8(Node* parent)
 
 RepetitionRateOneDecoderShort8::~RepetitionRateOneDecoderShort8() {}
 
-void RepetitionRateOneDecoderShort8::decode()
+void decodeRepetitionRateOneShort8(float* out, float* in, unsigned)
 {
-    const __m256 input = _mm256_load_ps(mInput);
+    const __m256 input = _mm256_load_ps(in);
 
     const __m256 swaplane = _mm256_permute2f128_ps(input, input, 0b00000001);
 
@@ -735,7 +1000,12 @@ void RepetitionRateOneDecoderShort8::decode()
     const __m256 sign_result = _mm256_xor_ps(broad_sign, _mm256_set1_ps(1.0f));
     const __m256 result = _mm256_blend_ps(sign_result, one_result, 0b11110000);
 
-    _mm256_store_ps(mOutput, result);
+    _mm256_store_ps(out, result);
+}
+
+void RepetitionRateOneDecoderShort8::decode()
+{
+    decodeRepetitionRateOneShort8(mOutput, mInput, mBlockLength);
 }
 
 
@@ -759,12 +1029,12 @@ TypeFiveDecoder::TypeFiveDecoder(Node* parent) : Node(parent) {}
 
 TypeFiveDecoder::~TypeFiveDecoder() {}
 
-void TypeFiveDecoder::decode()
+void decodeTypeFive(float* out, float* in, unsigned blockLength)
 {
     __m256 llrs = _mm256_setzero_ps();
 
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        const __m256 part = _mm256_load_ps(mInput + i);
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        const __m256 part = _mm256_load_ps(in + i);
         llrs = _mm256_add_ps(llrs, part);
     }
 
@@ -786,34 +1056,277 @@ void TypeFiveDecoder::decode()
     const __m256 sign_result = _mm256_xor_ps(broad_sign, _mm256_set1_ps(1.0f));
     const __m256 result = _mm256_blend_ps(sign_result, spc_result, 0b11110000);
 
-    for (unsigned i = 0; i < mBlockLength; i += 8) {
-        _mm256_storeu_ps(mOutput + i, result);
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        _mm256_storeu_ps(out + i, result);
     }
 }
 
-// End of decoder definitions
+void TypeFiveDecoder::decode() { decodeTypeFive(mOutput, mInput, mBlockLength); }
+
+/*************
+ * GRepetitionDecoder
+ * ***********/
+
+void decode_generalized_repetition_generic(float* out,
+                                           const float* in,
+                                           const unsigned block_length,
+                                           const unsigned source_length,
+                                           const bool spc)
+{
+    std::vector<float> source(in, in + source_length);
+    for (unsigned i = source_length; i < block_length; i += source_length) {
+        for (unsigned j = 0; j < source_length; ++j) {
+            source[j] += in[i + j];
+        }
+    }
+
+    if (spc) {
+        calculate_spc_generic(out, source.data(), source_length);
+    } else {
+        std::copy(source.begin(), source.end(), out);
+    }
+
+    for (unsigned i = source_length; i < block_length; i += source_length) {
+        std::copy(out, out + source_length, out + i);
+    }
+}
 
+GRepetitionDecoder::GRepetitionDecoder(const DecoderPlan& plan,
+                                       const PlanNode& node,
+                                       Node* parent)
+    : Node(parent),
+      mSource(nullptr),
+      mSourceLength(plan.node(node.right).blockLength),
+      mSourceLlr(nullptr)
+{
+    if (mSourceLength < 8) {
+        return; // Short rate-1 sources are decoded in a single register
+    }
+
+    // The source inherits the length of its parent
+    mBlockLength = mSourceLength;
+    mSource = createDecoder(plan, node.right, this);
+    mBlockLength = node.blockLength;
+
+    mSourceLlr = arena(xmLayout->llr(mSourceLength));
+    mSource->setInput(mSourceLlr);
+    mSource->setOutput(mOutput);
+}
+
+GRepetitionDecoder::~GRepetitionDecoder() { delete mSource; }
+
+void GRepetitionDecoder::setOutput(float* output)
+{
+    mOutput = output;
+    if (mSource) {
+        mSource->setOutput(mOutput);
+    }
+}
+
+void decodeGRepetitionShort(float* out, float* in, unsigned blockLength)
+{
+    // Sum all repetitions, then fold the two halves of the vector
+    __m256 llrs = _mm256_setzero_ps();
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        llrs = _mm256_add_ps(llrs, _mm256_load_ps(in + i));
+    }
+    llrs = _mm256_add_ps(llrs, _mm256_permute2f128_ps(llrs, llrs, 1));
+    for (unsigned i = 0; i < blockLength; i += 8) {
+        _mm256_store_ps(out + i, llrs);
+    }
+}
+
+void sumRepetitions(float* sourceLlr,
+                    const float* in,
+                    unsigned blockLength,
+                    unsigned sourceLength)
+{
+    for (unsigned j = 0; j < sourceLength; j += 8) {
+        __m256 llrs = _mm256_load_ps(in + j);
+        for (unsigned i = sourceLength; i < blockLength; i += sourceLength) {
+            llrs = _mm256_add_ps(llrs, _mm256_load_ps(in + i + j));
+        }
+        _mm256_store_ps(sourceLlr + j, llrs);
+    }
+}
+
+void repeatSource(float* out, unsigned blockLength, unsigned sourceLength)
+{
+    for (unsigned i = sourceLength; i < blockLength; i += sourceLength) {
+        for (unsigned j = 0; j < sourceLength; j += 8) {
+            _mm256_store_ps(out + i + j, _mm256_load_ps(out + j));
+        }
+    }
+}
 
-Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
+void GRepetitionDecoder::decode()
 {
+    if (mSource == nullptr) {
+        decodeGRepetitionShort(mOutput, mInput, mBlockLength);
+        return;
+    }
 
-    size_t blockLength = parent->blockLength();
+    sumRepetitions(mSourceLlr, mInput, mBlockLength, mSourceLength);
+
+    // The source writes its code word into the first repetition
+    mSource->decode();
+
+    repeatSource(mOutput, mBlockLength, mSourceLength);
+}
+
+/*************
+ * GParityCheckDecoder
+ * ***********/
+
+void decode_generalized_spc_generic(float* out,
+                                    const float* in,
+                                    const unsigned block_length,
+                                    const unsigned zero_length)
+{
+    std::copy(in, in + block_length, out);
+
+    for (unsigned j = 0; j < zero_length; ++j) {
+        bool parity = false;
+        unsigned idx = j;
+        float min = std::numeric_limits<float>::max();
+        for (unsigned i = j; i < block_length; i += zero_length) {
+            parity ^= std::signbit(in[i]);
+            if (std::abs(in[i]) < min) {
+                min = std::abs(in[i]);
+                idx = i;
+            }
+        }
+        if (parity) {
+            out[idx] *= -1.0f;
+        }
+    }
+}
+
+GParityCheckDecoder::GParityCheckDecoder(const DecoderPlan& plan,
+                                         const PlanNode& node,
+                                         Node* parent)
+    : Node(parent),
+      mSource(nullptr),
+      mSourceLength(plan.node(node.left).blockLength),
+      mSourceLlr(nullptr),
+      mSourceBits(nullptr)
+{
+    if (plan.node(node.left).type == tRateZero) {
+        return; // All parity-check codes are even
+    }
+
+    // The source inherits the length of its parent
+    mBlockLength = mSourceLength;
+    mSource = createDecoder(plan, node.left, this);
+    mBlockLength = node.blockLength;
+
+    mSourceLlr = arena(xmLayout->llr(mSourceLength));
+    mSourceBits = arena(xmLayout->sourceBits(mSourceLength));
+    mSource->setInput(mSourceLlr);
+    mSource->setOutput(mSourceBits);
+}
+
+GParityCheckDecoder::~GParityCheckDecoder() { delete mSource; }
+
+void combineParityChecks(float* sourceLlr,
+                         const float* in,
+                         unsigned blockLength,
+                         unsigned sourceLength)
+{
+    // Min-sum combination of all bits of each parity-check code
+    for (unsigned j = 0; j < sourceLength; j += 8) {
+        __m256 llrs = _mm256_load_ps(in + j);
+        for (unsigned i = sourceLength; i < blockLength; i += sourceLength) {
+            llrs = _mm256_polarf_ps(llrs, _mm256_load_ps(in + i + j));
+        }
+        _mm256_store_ps(sourceLlr + j, llrs);
+    }
+}
+
+void decodeParityChecks(float* out,
+                        const float* in,
+                        const float* sourceBits,
+                        unsigned blockLength,
+                        unsigned sourceLength)
+{
+    unsigned* iOutput = reinterpret_cast<unsigned*>(out);
+
+    // Each lane tracks one of the interleaved parity-check codes
+    const unsigned stride = std::max(sourceLength, 8U);
+    for (unsigned j = 0; j < stride; j += 8) {
+        __m256 parity =
+            sourceBits ? _mm256_load_ps(sourceBits + j) : _mm256_setzero_ps();
+        __m256 minvalues = _mm256_set1_ps(std::numeric_limits<float>::max());
+        __m256 minindices = _mm256_setzero_ps();
+        __m256 indices = _mm256_setr_ps(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0);
+        indices = _mm256_add_ps(indices, _mm256_set1_ps(j));
+        const __m256 step = _mm256_set1_ps(stride);
+
+        for (unsigned i = j; i < blockLength; i += stride) {
+            const __m256 part = _mm256_load_ps(in + i);
+            _mm256_store_ps(out + i, part);
+            parity = _mm256_xor_ps(parity, part);
+            minvalues = _mm256_argabsmin_ps(minindices, indices, minvalues, part);
+            indices = _mm256_add_ps(indices, step);
+        }
+
+        if (sourceLength == 4) {
+            // Lanes l and l + 4 belong to the same code
+            const __m256 swapped = _mm256_permute2f128_ps(minvalues, minvalues, 1);
+            const __m256 upper = _mm256_cmp_ps(swapped, minvalues, _CMP_LT_OQ);
+            minindices = _mm256_blendv_ps(
+                minindices, _mm256_permute2f128_ps(minindices, minindices, 1), upper);
+            parity = _mm256_xor_ps(parity, _mm256_permute2f128_ps(parity, parity, 1));
+        }
+
+        const unsigned flips = _mm256_movemask_ps(parity);
+        for (unsigned lane = 0; lane < std::min(sourceLength, 8U); ++lane) {
+            if (flips >> lane & 1) {
+                iOutput[static_cast<unsigned>(minindices[lane])] ^= 0x80000000;
+            }
+        }
+    }
+}
+
+void GParityCheckDecoder::decode()
+{
+    if (mSource) {
+        combineParityChecks(mSourceLlr, mInput, mBlockLength, mSourceLength);
+        mSource->decode();
+    }
+    decodeParityChecks(mOutput,
+                       mInput,
+                       mSource ? mSourceBits : nullptr,
+                       mBlockLength,
+                       mSourceLength);
+}
+
+// End of decoder definitions
+
+
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength)
+{
     size_t frozenBitCount = frozenBits.size();
+    split = false;
+    sourceLength = 0;
 
     // Begin with the two most simple codes:
     if (frozenBitCount == blockLength) {
-        return new RateZeroDecoder(parent);
+        return tRateZero;
     }
     if (frozenBitCount == 0) {
-        return new RateOneDecoder(parent);
+        return tRateOne;
     }
 
     // Following are "one bit unlike the others" codes:
     if (frozenBitCount == (blockLength - 1)) {
-        return new RepetitionDecoder(parent);
+        return tRepetition;
     }
     if (frozenBitCount == 1) {
-        return new SpcDecoder(parent);
+        return tSpc;
     }
 
     // Following are "interleaved one bit unlike the others" codes:
@@ -823,14 +1336,14 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
                 throw std::invalid_argument(fmt::format("{}", frozenBits));
             }
         }
-        return new DoubleRepetitionDecoder(parent);
+        return tDoubleRepetition;
     }
 
     if (frozenBitCount == 2 and frozenBits[0] == 0 and frozenBits[1] == 1) {
         if (blockLength == 8) {
-            return new DoubleSpcDecoderShort8(parent);
+            return tDoubleSpcShort8;
         } else {
-            return new DoubleSpcDecoder(parent);
+            return tDoubleSpc;
         }
     }
 
@@ -841,24 +1354,55 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
                 throw std::invalid_argument(fmt::format("{}", frozenBits));
             }
         }
-        return new TripleRepetitionDecoder(parent);
+        return tTripleRepetition;
     }
 
     if (frozenBitCount == blockLength - 4 and
         frozenBits[frozenBitCount - 1] == blockLength - 4 and
         frozenBits[frozenBitCount - 2] == blockLength - 6) {
-        return new TypeFiveDecoder(parent);
+        return tTypeFive;
     }
 
     if (blockLength == 8 and frozenBitCount == 3 and frozenBits[0] == 0 and
         frozenBits[1] == 1 and frozenBits[2] == 2) {
-        return new RepetitionRateOneDecoderShort8(parent);
+        return tRepetitionRateOneShort8;
     }
 
     if (blockLength == 8 and frozenBitCount == 5 and
         frozenBits[frozenBitCount - 1] == blockLength - 4 and
         frozenBits[frozenBitCount - 2] == blockLength - 5) {
-        return new ZeroSpcDecoderShort8(parent);
+        return tZeroSpcShort8;
+    }
+
+    // Generalized nodes replace chains of rate-0 or rate-1 siblings
+    if (blockLength >= 16) {
+        std::vector<bool> frozen(blockLength, false);
+        for (unsigned bit : frozenBits) {
+            frozen[bit] = true;
+        }
+        const size_t firstInfo = std::find(frozen.begin(), frozen.end(), false) -
+                                 frozen.begin();
+        const size_t infoSuffix = std::find(frozen.rbegin(), frozen.rend(), true) -
+                                  frozen.rbegin();
+        size_t repetitionSource = 1, parityCheckSource = 1;
+        while (repetitionSource < blockLength - firstInfo) {
+            repetitionSource *= 2;
+        }
+        while (parityCheckSource < blockLength - infoSuffix) {
+            parityCheckSource *= 2;
+        }
+
+        // Sources shorter than a vector are only supported for rate-1 and rate-0
+        if (repetitionSource <= blockLength / 4 &&
+            (repetitionSource >= 8 || blockLength - frozenBitCount == 4)) {
+            sourceLength = repetitionSource;
+            return tGRepetition;
+        }
+        if (parityCheckSource <= blockLength / 4 &&
+            (parityCheckSource >= 8 || frozenBitCount == 4)) {
+            sourceLength = parityCheckSource;
+            return tGParityCheck;
+        }
     }
 
     if (blockLength == 8) {
@@ -871,7 +1415,8 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
 
     // Fallback: No special code available, split into smaller subcodes
     if (blockLength <= 8) {
-        return new ShortRateRNode(frozenBits, parent);
+        split = true;
+        return tShortRateR;
     } else {
         std::vector<unsigned> leftFrozenBits, rightFrozenBits;
         splitFrozenBits(frozenBits, blockLength / 2, leftFrozenBits, rightFrozenBits);
@@ -879,19 +1424,65 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
         // Last case of optimization:
         // Common child node combination(s)
         if (leftFrozenBits.size() == blockLength / 2 && rightFrozenBits.size() == 1) {
-            return new ZeroSpcDecoder(parent);
+            return tZeroSpc;
         }
 
+        split = true;
+
         // Minor optimization:
         // Right rate-1
         if (rightFrozenBits.size() == 0) {
-            return new ROneNode(frozenBits, parent);
+            return tROne;
         }
         // Left rate-0
         if (leftFrozenBits.size() == blockLength / 2) {
-            return new ZeroRNode(frozenBits, parent);
+            return tZeroR;
         }
-        return new RateRNode(frozenBits, parent);
+        return tRateR;
+    }
+}
+
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent)
+{
+    const PlanNode& node = plan.node(index);
+
+    switch (node.type) {
+    case tRateZero:
+        return new RateZeroDecoder(parent);
+    case tRateOne:
+        return new RateOneDecoder(parent);
+    case tRepetition:
+        return new RepetitionDecoder(parent);
+    case tDoubleRepetition:
+        return new DoubleRepetitionDecoder(parent);
+    case tTripleRepetition:
+        return new TripleRepetitionDecoder(parent);
+    case tSpc:
+        return new SpcDecoder(parent);
+    case tDoubleSpc:
+        return new DoubleSpcDecoder(parent);
+    case tDoubleSpcShort8:
+        return new DoubleSpcDecoderShort8(parent);
+    case tTypeFive:
+        return new TypeFiveDecoder(parent);
+    case tRepetitionRateOneShort8:
+        return new RepetitionRateOneDecoderShort8(parent);
+    case tZeroSpc:
+        return new ZeroSpcDecoder(parent);
+    case tZeroSpcShort8:
+        return new ZeroSpcDecoderShort8(parent);
+    case tGRepetition:
+        return new GRepetitionDecoder(plan, node, parent);
+    case tGParityCheck:
+        return new GParityCheckDecoder(plan, node, parent);
+    case tShortRateR:
+        return new ShortRateRNode(plan, node, parent);
+    case tROne:
+        return new ROneNode(plan, node, parent);
+    case tZeroR:
+        return new ZeroRNode(plan, node, parent);
+    default:
+        return new RateRNode(plan, node, parent);
     }
 }
 
@@ -899,18 +1490,59 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
 
 FastSscAvxFloat::FastSscAvxFloat(size_t blockLength,
                                  const std::vector<unsigned>& frozenBits)
+    : mThreadCount(1),
+      mTeam(nullptr),
+      mBatchNodeBase(nullptr),
+      mBatchRootNode(nullptr),
+      mBatchBits(nullptr)
 {
     initialize(blockLength, frozenBits);
 }
 
+FastSscAvxFloat::FastSscAvxFloat(plan_t plan)
+    : mPlan(plan),
+      mThreadCount(1),
+      mTeam(nullptr),
+      mBatchNodeBase(nullptr),
+      mBatchRootNode(nullptr),
+      mBatchBits(nullptr)
+{
+    initializeContext();
+}
+
 FastSscAvxFloat::~FastSscAvxFloat() { clear(); }
 
 void FastSscAvxFloat::clear()
 {
+    if (mBatchNodeBase) {
+        delete mBatchRootNode;
+        delete mBatchNodeBase;
+        mDataPool->release(mBatchBits);
+        mBatchRootNode = nullptr;
+        mBatchNodeBase = nullptr;
+        mBatchBits = nullptr;
+    }
     delete mEncoder;
     delete mRootNode;
     delete mNodeBase;
+    delete mLayout;
+    mDataPool->release(mArena);
     delete mDataPool;
+    delete mTeam;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+    mTeam = nullptr;
+}
+
+plan_t FastSscAvxFloat::makePlan(size_t blockLength,
+                                 const std::vector<unsigned>& frozenBits)
+{
+    return std::make_shared<const DecoderPlan>(
+        blockLength, frozenBits, FastSscAvx::classifyNode);
 }
 
 void FastSscAvxFloat::initialize(size_t blockLength,
@@ -922,14 +1554,25 @@ void FastSscAvxFloat::initialize(size_t blockLength,
     if (mBlockLength != 0) {
         clear();
     }
-    mBlockLength = blockLength;
-    // mFrozenBits = frozenBits;
-    mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+    mPlan = makePlan(blockLength, frozenBits);
+    initializeContext();
+}
+
+void FastSscAvxFloat::initializeContext()
+{
+    mBlockLength = mPlan->blockLength();
+    mFrozenBits = mPlan->frozenBits();
     mEncoder = new Encoding::ButterflyFipPacked(mBlockLength, mFrozenBits);
     mEncoder->setSystematic(false);
     mDataPool = new DataPool<float, 32>();
-    mNodeBase = new FastSscAvx::Node(mBlockLength, mDataPool);
-    mRootNode = FastSscAvx::createDecoder(mFrozenBits, mNodeBase);
+    mLayout = new FastSscAvx::MemoryLayout(*mPlan);
+    mArena = mDataPool->allocate(mLayout->size());
+    if (mThreadCount > 1) {
+        mTeam = new ThreadTeam(mThreadCount);
+    }
+    mNodeBase = new FastSscAvx::Node(
+        mBlockLength, mDataPool, mLayout, mArena->data, mTeam);
+    mRootNode = FastSscAvx::createDecoder(*mPlan, 0, mNodeBase);
     mLlrContainer = new FloatContainer(mNodeBase->input(), mBlockLength);
     mBitContainer = new FloatContainer(mNodeBase->output(), mBlockLength);
     mLlrContainer->setFrozenBits(mFrozenBits);
@@ -937,20 +1580,111 @@ void FastSscAvxFloat::initialize(size_t blockLength,
     mOutputContainer = new unsigned char[(mBlockLength - mFrozenBits.size() + 7) / 8];
 }
 
+void FastSscAvxFloat::setThreadCount(size_t threadCount)
+{
+    if (threadCount == 0) {
+        throw std::invalid_argument("FastSscAvxFloat: At least one thread is needed!");
+    }
+    if (threadCount == mThreadCount) {
+        return;
+    }
+    clear();
+    mThreadCount = threadCount;
+    initializeContext();
+}
+
+Decoder* FastSscAvxFloat::clone() const
+{
+    FastSscAvxFloat* decoder = new FastSscAvxFloat(mPlan);
+    decoder->setThreadCount(mThreadCount);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void FastSscAvxFloat::initializeBatch()
+{
+    if (mBatchNodeBase) {
+        return;
+    }
+    mBatchNodeBase = new FastSscAvxInterleaved::Node(mBlockLength, mDataPool);
+    mBatchRootNode = FastSscAvxInterleaved::createDecoder(*mPlan, 0, mBatchNodeBase);
+    mBatchBits = mDataPool->allocate(mBlockLength * FastSscAvxInterleaved::FRAMECOUNT);
+}
+
 bool FastSscAvxFloat::decode()
 {
     mRootNode->decode();
+    return evaluateOutput(mOutputContainer);
+}
+
+bool FastSscAvxFloat::decodeExternal(const float* pLlr, unsigned char* pData)
+{
+    if (mBlockLength < 8 || reinterpret_cast<uintptr_t>(pLlr) % 32 != 0) {
+        return Decoder::decodeExternal(pLlr, pData);
+    }
+
+    // The nodes only read their input, so the root can work on the caller's LLRs
+    mRootNode->setInput(const_cast<float*>(pLlr));
+    mRootNode->decode();
+    mRootNode->setInput(mNodeBase->input());
+    return evaluateOutput(pData);
+}
 
+bool FastSscAvxFloat::decode_batch(const float* pLlr,
+                                   size_t frames,
+                                   void* pData,
+                                   bool* pResults)
+{
+    using FastSscAvxInterleaved::FRAMECOUNT;
+
+    initializeBatch();
+
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    unsigned char* data = static_cast<unsigned char*>(pData);
+    float* bits = dynamic_cast<FloatContainer*>(mBitContainer)->data();
+    bool result = true;
+
+    for (size_t first = 0; first < frames; first += FRAMECOUNT) {
+        const size_t count = std::min<size_t>(FRAMECOUNT, frames - first);
+
+        FastSscAvxInterleaved::interleaveFrames(
+            mBatchNodeBase->input(), pLlr + first * mBlockLength, mBlockLength, count);
+        mBatchRootNode->decode();
+        FastSscAvxInterleaved::deinterleaveFrames(
+            mBatchBits->data, mBatchNodeBase->output(), mBlockLength, count);
+
+        for (size_t frame = 0; frame < count; ++frame) {
+            memcpy(bits,
+                   mBatchBits->data + frame * mBlockLength,
+                   mBlockLength * sizeof(float));
+            const bool success = evaluateOutput(data + (first + frame) * infoBytes);
+            if (pResults != nullptr) {
+                pResults[first + frame] = success;
+            }
+            result &= success;
+        }
+    }
+    return result;
+}
+
+bool FastSscAvxFloat::evaluateOutput(unsigned char* pData)
+{
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
     if (!mSystematic) {
+        // The packed encoder output is written in whole words, which may
+        // exceed the destination.
         mEncoder->setFloatCodeword(dynamic_cast<FloatContainer*>(mBitContainer)->data());
         mEncoder->encode();
         mEncoder->getInformation(mOutputContainer);
+        if (pData != mOutputContainer) {
+            memcpy(pData, mOutputContainer, infoBytes);
+        }
     } else {
-        mBitContainer->getPackedInformationBits(mOutputContainer);
+        mBitContainer->getPackedInformationBits(pData);
     }
 
-    bool result = mErrorDetector->check(mOutputContainer,
-                                        (mBlockLength - mFrozenBits.size() + 7) / 8);
+    bool result = mErrorDetector->check(pData, infoBytes);
     return result;
 }
 
@@ -0,0 +1,682 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/fastssc_avx_float_interleaved.h>
+#include <polarcode/polarcode.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace FastSscAvxInterleaved {
+
+namespace {
+
+inline void memFloatFill(float* dst, float value, const size_t floatCount)
+{
+    const __m256 vec = _mm256_set1_ps(value);
+    for (unsigned i = 0; i < floatCount; i += 8) {
+        _mm256_store_ps(dst + i, vec);
+    }
+}
+
+/*!
+ * \brief Transpose an 8x8 block of floats.
+ * \param dst Row i of the result is stored at dst + i * dstStride.
+ * \param dstStride Distance between two output rows.
+ * \param src Row i of the input is loaded from src + i * srcStride.
+ * \param srcStride Distance between two input rows.
+ */
+inline void transpose8x8(float* dst, size_t dstStride, const float* src, size_t srcStride)
+{
+    __m256 r0 = _mm256_loadu_ps(src + 0 * srcStride);
+    __m256 r1 = _mm256_loadu_ps(src + 1 * srcStride);
+    __m256 r2 = _mm256_loadu_ps(src + 2 * srcStride);
+    __m256 r3 = _mm256_loadu_ps(src + 3 * srcStride);
+    __m256 r4 = _mm256_loadu_ps(src + 4 * srcStride);
+    __m256 r5 = _mm256_loadu_ps(src + 5 * srcStride);
+    __m256 r6 = _mm256_loadu_ps(src + 6 * srcStride);
+    __m256 r7 = _mm256_loadu_ps(src + 7 * srcStride);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+    r0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    r2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    r4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    r5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    r6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    r7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+    _mm256_storeu_ps(dst + 0 * dstStride, _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps(dst + 1 * dstStride, _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dstStride, _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dstStride, _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dstStride, _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dstStride, _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dstStride, _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dstStride, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+} // namespace
+
+void interleaveFrames(float* dst, const float* src, size_t blockLength, size_t frameCount)
+{
+    if (frameCount == FRAMECOUNT && blockLength % 8 == 0) {
+        for (unsigned i = 0; i < blockLength; i += 8) {
+            transpose8x8(dst + i * FRAMECOUNT, FRAMECOUNT, src + i, blockLength);
+        }
+    } else {
+        for (unsigned i = 0; i < blockLength; ++i) {
+            for (unsigned f = 0; f < FRAMECOUNT; ++f) {
+                dst[i * FRAMECOUNT + f] =
+                    f < frameCount ? src[f * blockLength + i] : 0.0f;
+            }
+        }
+    }
+}
+
+void deinterleaveFrames(float* dst,
+                        const float* src,
+                        size_t blockLength,
+                        size_t frameCount)
+{
+    if (frameCount == FRAMECOUNT && blockLength % 8 == 0) {
+        for (unsigned i = 0; i < blockLength; i += 8) {
+            transpose8x8(dst + i, blockLength, src + i * FRAMECOUNT, FRAMECOUNT);
+        }
+    } else {
+        for (unsigned f = 0; f < frameCount; ++f) {
+            for (unsigned i = 0; i < blockLength; ++i) {
+                dst[f * blockLength + i] = src[i * FRAMECOUNT + f];
+            }
+        }
+    }
+}
+
+Node::Node()
+    : mBlockLength(0),
+      xmDataPool(nullptr),
+      mLlr(nullptr),
+      mBit(nullptr),
+      mInput(nullptr),
+      mOutput(nullptr)
+{
+}
+
+Node::Node(Node* other)
+    : mBlockLength(other->mBlockLength),
+      xmDataPool(other->xmDataPool),
+      mLlr(nullptr),
+      mBit(nullptr),
+      mInput(other->mInput),
+      mOutput(other->mOutput)
+{
+}
+
+Node::Node(size_t blockLength, datapool_t* pool)
+    : mBlockLength(blockLength),
+      xmDataPool(pool),
+      mLlr(pool->allocate(blockLength * FRAMECOUNT)),
+      mBit(pool->allocate(blockLength * FRAMECOUNT)),
+      mInput(mLlr->data),
+      mOutput(mBit->data)
+{
+}
+
+Node::~Node()
+{
+    if (mLlr)
+        xmDataPool->release(mLlr);
+    if (mBit)
+        xmDataPool->release(mBit);
+}
+
+void Node::decode() {}
+
+void Node::setInput(float* input) { mInput = input; }
+
+void Node::setOutput(float* output) { mOutput = output; }
+
+unsigned Node::blockLength() { return mBlockLength; }
+
+datapool_t* Node::pool() { return xmDataPool; }
+
+float* Node::input() { return mInput; }
+
+float* Node::output() { return mOutput; }
+
+/*************
+ * RateRNode
+ * ***********/
+
+RateRNode::RateRNode(const std::vector<unsigned>& frozenBits,
+                     Node* parent,
+                     ChildCreationFlags flags)
+    : Node(parent)
+{
+    mBlockLength /= 2;
+
+    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
+    splitFrozenBits(frozenBits, mBlockLength, leftFrozenBits, rightFrozenBits);
+
+    if (flags & FastSscAvx::NO_LEFT) {
+        mLeft = new Node();
+    } else {
+        mLeft = createDecoder(leftFrozenBits, this);
+    }
+
+    if (flags & FastSscAvx::NO_RIGHT) {
+        mRight = new Node();
+    } else {
+        mRight = createDecoder(rightFrozenBits, this);
+    }
+
+    connectChildren();
+}
+
+RateRNode::RateRNode(const DecoderPlan& plan,
+                     const PlanNode& node,
+                     Node* parent,
+                     ChildCreationFlags flags)
+    : Node(parent)
+{
+    mBlockLength /= 2;
+
+    if (flags & FastSscAvx::NO_LEFT) {
+        mLeft = new Node();
+    } else {
+        mLeft = createDecoder(plan, node.left, this);
+    }
+
+    if (flags & FastSscAvx::NO_RIGHT) {
+        mRight = new Node();
+    } else {
+        mRight = createDecoder(plan, node.right, this);
+    }
+
+    connectChildren();
+}
+
+void RateRNode::connectChildren()
+{
+    mLeftLlr = xmDataPool->allocate(mBlockLength * FRAMECOUNT);
+    mRightLlr = xmDataPool->allocate(mBlockLength * FRAMECOUNT);
+
+    mLeft->setInput(mLeftLlr->data);
+    mRight->setInput(mRightLlr->data);
+
+    mLeft->setOutput(mOutput);
+    mRight->setOutput(mOutput + mBlockLength * FRAMECOUNT);
+}
+
+RateRNode::~RateRNode()
+{
+    delete mLeft;
+    delete mRight;
+    xmDataPool->release(mLeftLlr);
+    xmDataPool->release(mRightLlr);
+}
+
+void RateRNode::setOutput(float* output)
+{
+    mOutput = output;
+    mLeft->setOutput(mOutput);
+    mRight->setOutput(mOutput + mBlockLength * FRAMECOUNT);
+}
+
+void RateRNode::decode()
+{
+    // With one code bit per vector, the single-frame kernels apply unchanged
+    // to the scaled length.
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    FastSscAvx::F_function(mInput, mLeftLlr->data, floatCount);
+    mLeft->decode();
+    FastSscAvx::G_function(mInput, mRightLlr->data, mOutput, floatCount);
+    mRight->decode();
+    FastSscAvx::Combine(mOutput, floatCount);
+}
+
+/*************
+ * ROneNode
+ * ***********/
+
+ROneNode::ROneNode(const std::vector<unsigned>& frozenBits, Node* parent)
+    : RateRNode(frozenBits, parent, FastSscAvx::NO_RIGHT)
+{
+}
+
+ROneNode::ROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : RateRNode(plan, node, parent, FastSscAvx::NO_RIGHT)
+{
+}
+
+ROneNode::~ROneNode() {}
+
+void ROneNode::decode()
+{
+    FastSscAvx::F_function(mInput, mLeftLlr->data, mBlockLength * FRAMECOUNT);
+    mLeft->decode();
+    rightDecode();
+}
+
+void ROneNode::rightDecode()
+{
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    for (unsigned i = 0; i < floatCount; i += 8) {
+        __m256 Llr_l = _mm256_load_ps(mInput + i);
+        __m256 Llr_r = _mm256_load_ps(mInput + floatCount + i);
+        __m256 Bits = _mm256_load_ps(mOutput + i);
+
+        __m256 Llr_o = FastSscAvx::_mm256_polarg_ps(Llr_l, Llr_r, Bits);
+        _mm256_store_ps(mOutput + i, _mm256_xor_ps(Bits, Llr_o));
+        _mm256_store_ps(mOutput + i + floatCount, Llr_o);
+    }
+}
+
+/*************
+ * ZeroRNode
+ * ***********/
+
+ZeroRNode::ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent)
+    : RateRNode(frozenBits, parent, FastSscAvx::NO_LEFT)
+{
+}
+
+ZeroRNode::ZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : RateRNode(plan, node, parent, FastSscAvx::NO_LEFT)
+{
+}
+
+ZeroRNode::~ZeroRNode() {}
+
+void ZeroRNode::decode()
+{
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    FastSscAvx::G_function_0R(mInput, mRightLlr->data, floatCount);
+    mRight->decode();
+    for (unsigned i = 0; i < floatCount; i += 8) {
+        _mm256_store_ps(mOutput + i, _mm256_load_ps(mOutput + floatCount + i));
+    }
+}
+
+/*************
+ * RateZeroDecoder
+ * ***********/
+
+RateZeroDecoder::RateZeroDecoder(Node* parent) : Node(parent) {}
+
+RateZeroDecoder::~RateZeroDecoder() {}
+
+void RateZeroDecoder::decode()
+{
+    memFloatFill(mOutput, INFINITY, mBlockLength * FRAMECOUNT);
+}
+
+/*************
+ * RateOneDecoder
+ * ***********/
+
+RateOneDecoder::RateOneDecoder(Node* parent) : Node(parent) {}
+
+RateOneDecoder::~RateOneDecoder() {}
+
+void RateOneDecoder::decode()
+{
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    for (unsigned i = 0; i < floatCount; i += 8) {
+        _mm256_store_ps(mOutput + i, _mm256_load_ps(mInput + i));
+    }
+}
+
+/*************
+ * RepetitionDecoder
+ * ***********/
+
+RepetitionDecoder::RepetitionDecoder(Node* parent) : Node(parent) {}
+
+RepetitionDecoder::~RepetitionDecoder() {}
+
+void RepetitionDecoder::decode()
+{
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    __m256 LlrSum = _mm256_setzero_ps();
+
+    // Each lane accumulates the LLRs of its own frame
+    for (unsigned i = 0; i < floatCount; i += 8) {
+        LlrSum = _mm256_add_ps(LlrSum, _mm256_load_ps(mInput + i));
+    }
+
+    for (unsigned i = 0; i < floatCount; i += 8) {
+        _mm256_store_ps(mOutput + i, LlrSum);
+    }
+}
+
+/*************
+ * SpcDecoder
+ * ***********/
+
+SpcDecoder::SpcDecoder(Node* parent) : Node(parent) {}
+
+SpcDecoder::~SpcDecoder() {}
+
+void SpcDecoder::decode()
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 parVec = _mm256_setzero_ps();
+    __m256 minValues = _mm256_set1_ps(INFINITY);
+    __m256 minIndices = _mm256_setzero_ps();
+    __m256 indices = _mm256_setzero_ps();
+
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        __m256 vecIn = _mm256_load_ps(mInput + i * FRAMECOUNT);
+        _mm256_store_ps(mOutput + i * FRAMECOUNT, vecIn);
+
+        parVec = _mm256_xor_ps(parVec, vecIn);
+        minValues =
+            FastSscAvx::_mm256_argabsmin_ps(minIndices, indices, minValues, vecIn);
+        indices = _mm256_add_ps(indices, one);
+    }
+
+    // Flip least reliable bit of each frame, if neccessary
+    alignas(32) float parity[FRAMECOUNT];
+    alignas(32) float minIdx[FRAMECOUNT];
+    _mm256_store_ps(parity, _mm256_and_ps(parVec, FastSscAvx::SIGN_MASK));
+    _mm256_store_ps(minIdx, minIndices);
+    unsigned int* iOutput = reinterpret_cast<unsigned int*>(mOutput);
+    const unsigned int* iParity = reinterpret_cast<const unsigned int*>(parity);
+    for (unsigned f = 0; f < FRAMECOUNT; ++f) {
+        iOutput[static_cast<unsigned>(minIdx[f]) * FRAMECOUNT + f] ^= iParity[f];
+    }
+}
+
+/*************
+ * GRepetitionDecoder
+ * ***********/
+
+GRepetitionDecoder::GRepetitionDecoder(const DecoderPlan& plan,
+                                       const PlanNode& node,
+                                       Node* parent)
+    : Node(parent), mSourceLength(plan.node(node.right).blockLength)
+{
+    // The source inherits the length of its parent
+    mBlockLength = mSourceLength;
+    mSource = createDecoder(plan, node.right, this);
+    mBlockLength = node.blockLength;
+
+    mSourceLlr = xmDataPool->allocate(mSourceLength * FRAMECOUNT);
+    mSource->setInput(mSourceLlr->data);
+    mSource->setOutput(mOutput);
+}
+
+GRepetitionDecoder::~GRepetitionDecoder()
+{
+    delete mSource;
+    xmDataPool->release(mSourceLlr);
+}
+
+void GRepetitionDecoder::setOutput(float* output)
+{
+    mOutput = output;
+    mSource->setOutput(mOutput);
+}
+
+void GRepetitionDecoder::decode()
+{
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    const unsigned sourceCount = mSourceLength * FRAMECOUNT;
+    float* sourceLlr = mSourceLlr->data;
+
+    if (mSourceLength < 8) {
+        // Sum in the order of FastSscAvx::decodeGRepetitionShort(), which adds
+        // every eighth bit and folds the two halves of the vector at last
+        for (unsigned j = 0; j < sourceCount; j += 8) {
+            __m256 lower = _mm256_setzero_ps(), upper = _mm256_setzero_ps();
+            for (unsigned i = j; i < floatCount; i += 8 * FRAMECOUNT) {
+                lower = _mm256_add_ps(lower, _mm256_load_ps(mInput + i));
+                upper = _mm256_add_ps(upper, _mm256_load_ps(mInput + i + 4 * FRAMECOUNT));
+            }
+            _mm256_store_ps(sourceLlr + j, _mm256_add_ps(lower, upper));
+        }
+    } else {
+        for (unsigned j = 0; j < sourceCount; j += 8) {
+            __m256 llrs = _mm256_load_ps(mInput + j);
+            for (unsigned i = sourceCount; i < floatCount; i += sourceCount) {
+                llrs = _mm256_add_ps(llrs, _mm256_load_ps(mInput + i + j));
+            }
+            _mm256_store_ps(sourceLlr + j, llrs);
+        }
+    }
+
+    // The source writes its code word into the first repetition
+    mSource->decode();
+
+    for (unsigned i = sourceCount; i < floatCount; i += sourceCount) {
+        for (unsigned j = 0; j < sourceCount; j += 8) {
+            _mm256_store_ps(mOutput + i + j, _mm256_load_ps(mOutput + j));
+        }
+    }
+}
+
+/*************
+ * GParityCheckDecoder
+ * ***********/
+
+GParityCheckDecoder::GParityCheckDecoder(const DecoderPlan& plan,
+                                         const PlanNode& node,
+                                         Node* parent)
+    : Node(parent),
+      mSource(nullptr),
+      mSourceLength(plan.node(node.left).blockLength),
+      mSourceLlr(nullptr),
+      mSourceBits(nullptr)
+{
+    if (plan.node(node.left).type == FastSscAvx::tRateZero) {
+        return; // All parity-check codes are even
+    }
+
+    // The source inherits the length of its parent
+    mBlockLength = mSourceLength;
+    mSource = createDecoder(plan, node.left, this);
+    mBlockLength = node.blockLength;
+
+    mSourceLlr = xmDataPool->allocate(mSourceLength * FRAMECOUNT);
+    mSourceBits = xmDataPool->allocate(mSourceLength * FRAMECOUNT);
+    mSource->setInput(mSourceLlr->data);
+    mSource->setOutput(mSourceBits->data);
+}
+
+GParityCheckDecoder::~GParityCheckDecoder()
+{
+    if (mSource) {
+        delete mSource;
+        xmDataPool->release(mSourceLlr);
+        xmDataPool->release(mSourceBits);
+    }
+}
+
+void GParityCheckDecoder::decode()
+{
+    const unsigned floatCount = mBlockLength * FRAMECOUNT;
+    const unsigned sourceCount = mSourceLength * FRAMECOUNT;
+
+    if (mSource) {
+        // Min-sum combination of all bits of each parity-check code
+        for (unsigned j = 0; j < sourceCount; j += 8) {
+            __m256 llrs = _mm256_load_ps(mInput + j);
+            for (unsigned i = sourceCount; i < floatCount; i += sourceCount) {
+                llrs = FastSscAvx::_mm256_polarf_ps(llrs, _mm256_load_ps(mInput + i + j));
+            }
+            _mm256_store_ps(mSourceLlr->data + j, llrs);
+        }
+        mSource->decode();
+    }
+
+    // Codes shorter than a vector are searched in two halves by
+    // FastSscAvx::decodeParityChecks(), which prefers the lower half on ties
+    const unsigned halves = mSourceLength < 8 ? 2 : 1;
+    const unsigned stride = mSourceLength * halves * FRAMECOUNT;
+    for (unsigned j = 0; j < sourceCount; j += 8) {
+        __m256 parity =
+            mSource ? _mm256_load_ps(mSourceBits->data + j) : _mm256_setzero_ps();
+        __m256 minValues[2], minIndices[2];
+        for (unsigned half = 0; half < halves; ++half) {
+            const unsigned first = j + half * sourceCount;
+            minValues[half] = _mm256_set1_ps(std::numeric_limits<float>::max());
+            minIndices[half] = _mm256_setzero_ps();
+            __m256 indices = _mm256_set1_ps(first / FRAMECOUNT);
+            const __m256 step = _mm256_set1_ps(stride / FRAMECOUNT);
+            for (unsigned i = first; i < floatCount; i += stride) {
+                const __m256 part = _mm256_load_ps(mInput + i);
+                _mm256_store_ps(mOutput + i, part);
+                parity = _mm256_xor_ps(parity, part);
+                minValues[half] = FastSscAvx::_mm256_argabsmin_ps(
+                    minIndices[half], indices, minValues[half], part);
+                indices = _mm256_add_ps(indices, step);
+            }
+        }
+        if (halves == 2) {
+            const __m256 upper = _mm256_cmp_ps(minValues[1], minValues[0], _CMP_LT_OQ);
+            minIndices[0] = _mm256_blendv_ps(minIndices[0], minIndices[1], upper);
+        }
+
+        // Flip the least reliable bit of each frame with odd parity
+        alignas(32) float minIdx[FRAMECOUNT];
+        _mm256_store_ps(minIdx, minIndices[0]);
+        const unsigned flips = _mm256_movemask_ps(parity);
+        for (unsigned f = 0; f < FRAMECOUNT; ++f) {
+            if (flips >> f & 1) {
+                float& bit = mOutput[static_cast<unsigned>(minIdx[f]) * FRAMECOUNT + f];
+                bit = -bit;
+            }
+        }
+    }
+}
+
+// End of decoder definitions
+
+Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
+{
+    size_t blockLength = parent->blockLength();
+    size_t frozenBitCount = frozenBits.size();
+
+    if (frozenBitCount == blockLength) {
+        return new RateZeroDecoder(parent);
+    }
+    if (frozenBitCount == 0) {
+        return new RateOneDecoder(parent);
+    }
+    if (frozenBitCount == (blockLength - 1)) {
+        return new RepetitionDecoder(parent);
+    }
+    if (frozenBitCount == 1) {
+        return new SpcDecoder(parent);
+    }
+
+    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
+    splitFrozenBits(frozenBits, blockLength / 2, leftFrozenBits, rightFrozenBits);
+
+    if (rightFrozenBits.size() == 0) {
+        return new ROneNode(frozenBits, parent);
+    }
+    if (leftFrozenBits.size() == blockLength / 2) {
+        return new ZeroRNode(frozenBits, parent);
+    }
+    return new RateRNode(frozenBits, parent);
+}
+
+namespace {
+
+/*
+ * The classifier accepts special leaves only for one frozen set each, which
+ * FastSscAvx::classifyNode() describes.
+ */
+std::vector<unsigned> specialFrozenBits(const PlanNode& node)
+{
+    const unsigned blockLength = node.blockLength;
+    std::vector<unsigned> frozenBits;
+    switch (node.type) {
+    case FastSscAvx::tDoubleSpc:
+    case FastSscAvx::tDoubleSpcShort8:
+        frozenBits = { 0, 1 };
+        break;
+    case FastSscAvx::tTypeFive:
+        frozenBits.resize(blockLength - 5);
+        std::iota(frozenBits.begin(), frozenBits.end(), 0);
+        frozenBits.push_back(blockLength - 4);
+        break;
+    case FastSscAvx::tZeroSpc:
+        frozenBits.resize(blockLength / 2 + 1);
+        std::iota(frozenBits.begin(), frozenBits.end(), 0);
+        break;
+    default:
+        // The repetition-like leaves freeze the first bits
+        frozenBits.resize(node.frozenBitCount);
+        std::iota(frozenBits.begin(), frozenBits.end(), 0);
+        break;
+    }
+    return frozenBits;
+}
+
+} // namespace
+
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent)
+{
+    const PlanNode& node = plan.node(index);
+
+    switch (node.type) {
+    case FastSscAvx::tRateZero:
+        return new RateZeroDecoder(parent);
+    case FastSscAvx::tRateOne:
+        return new RateOneDecoder(parent);
+    case FastSscAvx::tRepetition:
+        return new RepetitionDecoder(parent);
+    case FastSscAvx::tSpc:
+        return new SpcDecoder(parent);
+    case FastSscAvx::tDoubleRepetition:
+    case FastSscAvx::tTripleRepetition:
+    case FastSscAvx::tDoubleSpc:
+    case FastSscAvx::tDoubleSpcShort8:
+    case FastSscAvx::tTypeFive:
+    case FastSscAvx::tRepetitionRateOneShort8:
+    case FastSscAvx::tZeroSpc:
+    case FastSscAvx::tZeroSpcShort8:
+        return createDecoder(specialFrozenBits(node), parent);
+    case FastSscAvx::tGRepetition:
+        return new GRepetitionDecoder(plan, node, parent);
+    case FastSscAvx::tGParityCheck:
+        return new GParityCheckDecoder(plan, node, parent);
+    case FastSscAvx::tROne:
+        return new ROneNode(plan, node, parent);
+    case FastSscAvx::tZeroR:
+        return new ZeroRNode(plan, node, parent);
+    case FastSscAvx::tRateR:
+    case FastSscAvx::tShortRateR:
+        return new RateRNode(plan, node, parent);
+    default:
+        throw std::invalid_argument("FastSscAvxInterleaved: Unknown node type!");
+    }
+}
+
+} // namespace FastSscAvxInterleaved
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -7,13 +7,16 @@
  */
 
 #include <polarcode/decoding/fastssc_fip_char.h>
+#include <polarcode/decoding/fastssc_fip_char_interleaved.h>
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <polarcode/polarcode.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
 #include <cmath>
+#include <cstdint>
 #include <cstring> //for memset
 
 namespace PolarCode {
@@ -79,44 +82,46 @@ ShortNode::~ShortNode()
 
 // Constructors of nodes
 
-RateRNode::RateRNode(const std::vector<unsigned>& frozenBits, Node* parent) : Node(parent)
+RateRNode::RateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : Node(parent)
 {
     mBlockLength /= 2;
     mVecCount = nBit2cvecCount(mBlockLength);
 
-    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
-    splitFrozenBits(frozenBits, mBlockLength, leftFrozenBits, rightFrozenBits);
-
-    mLeft = createDecoder(leftFrozenBits, this);
-    mRight = createDecoder(rightFrozenBits, this);
+    mLeft = createDecoder(plan, node.left, this);
+    mRight = createDecoder(plan, node.right, this);
 
     ChildLlr = xmDataPool->allocate(mVecCount);
 }
 
-ShortRateRNode::ShortRateRNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent),
+ShortRateRNode::ShortRateRNode(const DecoderPlan& plan,
+                               const PlanNode& node,
+                               Node* parent)
+    : RateRNode(plan, node, parent),
       LeftBits(xmDataPool->allocate(mVecCount)),
       RightBits(xmDataPool->allocate(mVecCount))
 {
 }
 
-ROneNode::ROneNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent)
+ROneNode::ROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : RateRNode(plan, node, parent)
 {
 }
 
-ShortROneNode::ShortROneNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : ShortRateRNode(frozenBits, parent)
+ShortROneNode::ShortROneNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : ShortRateRNode(plan, node, parent)
 {
 }
 
-ZeroRNode::ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent)
+ZeroRNode::ZeroRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : RateRNode(plan, node, parent)
 {
 }
 
-ShortZeroRNode::ShortZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : ShortRateRNode(frozenBits, parent)
+ShortZeroRNode::ShortZeroRNode(const DecoderPlan& plan,
+                               const PlanNode& node,
+                               Node* parent)
+    : ShortRateRNode(plan, node, parent)
 {
 }
 
@@ -493,37 +498,40 @@ void ShortZeroRNode::decode(fipv* LlrIn, fipv* BitsOut)
 
 // End of mass defining
 
-Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength)
 {
-    size_t blockLength = parent->blockLength();
     size_t frozenBitCount = frozenBits.size();
+    split = false;
 
     // Begin with the two most simple codes:
     if (frozenBitCount == blockLength) {
-        return new RateZeroDecoder(parent);
+        return tRateZero;
     }
     if (frozenBitCount == 0) {
-        return new RateOneDecoder(parent);
+        return tRateOne;
     }
 
     // Following are "one bit unlike the others" codes:
     if (frozenBitCount == (blockLength - 1)) {
         if (blockLength <= BYTESPERVECTOR) {
-            return new ShortRepetitionDecoder(parent);
+            return tShortRepetition;
         } else {
-            return new RepetitionDecoder(parent);
+            return tRepetition;
         }
     }
     if (frozenBitCount == 1) {
         if (blockLength <= BYTESPERVECTOR) {
-            return new ShortSpcDecoder(parent);
+            return tShortSpc;
         } else {
-            return new SpcDecoder(parent);
+            return tSpc;
         }
     }
 
     if (frozenBitCount == blockLength - 2 and blockLength >= BYTESPERVECTOR) {
-        return new DoubleRepetitionDecoder(parent);
+        return tDoubleRepetition;
     }
 
     // Precalculate subcodes to find special child node combinations
@@ -532,58 +540,138 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
 
     if (blockLength <= BYTESPERVECTOR) {
         if (leftFrozenBits.size() == blockLength / 2 && rightFrozenBits.size() == 0) {
-            return new ShortZeroOneDecoder(parent);
+            return tShortZeroOne;
         }
 
         if (leftFrozenBits.size() == blockLength / 2 && rightFrozenBits.size() == 1) {
-            return new ShortZeroSpcDecoder(parent);
+            return tShortZeroSpc;
         }
 
         // Fallback: No special decoder available
+        split = true;
         if (rightFrozenBits.size() == 0) {
-            return new ShortROneNode(frozenBits, parent);
+            return tShortROne;
         }
 
         if (leftFrozenBits.size() == blockLength / 2) {
-            return new ShortZeroRNode(frozenBits, parent);
+            return tShortZeroR;
         }
 
-        return new ShortRateRNode(frozenBits, parent);
+        return tShortRateR;
     } else {
         if (leftFrozenBits.size() == blockLength / 2 && rightFrozenBits.size() == 1) {
-            return new ZeroSpcDecoder(parent);
+            return tZeroSpc;
         }
         // Minor optimization:
+        split = true;
 
         // Right rate-1
         if (rightFrozenBits.size() == 0) {
-            return new ROneNode(frozenBits, parent);
+            return tROne;
         }
         // Left rate-0
         if (leftFrozenBits.size() == blockLength / 2) {
-            return new ZeroRNode(frozenBits, parent);
+            return tZeroR;
         }
 
-        return new RateRNode(frozenBits, parent);
+        return tRateR;
+    }
+}
+
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent)
+{
+    const PlanNode& node = plan.node(index);
+
+    switch (node.type) {
+    case tRateZero:
+        return new RateZeroDecoder(parent);
+    case tRateOne:
+        return new RateOneDecoder(parent);
+    case tRepetition:
+        return new RepetitionDecoder(parent);
+    case tShortRepetition:
+        return new ShortRepetitionDecoder(parent);
+    case tDoubleRepetition:
+        return new DoubleRepetitionDecoder(parent);
+    case tSpc:
+        return new SpcDecoder(parent);
+    case tShortSpc:
+        return new ShortSpcDecoder(parent);
+    case tZeroSpc:
+        return new ZeroSpcDecoder(parent);
+    case tShortZeroSpc:
+        return new ShortZeroSpcDecoder(parent);
+    case tShortZeroOne:
+        return new ShortZeroOneDecoder(parent);
+    case tShortRateR:
+        return new ShortRateRNode(plan, node, parent);
+    case tShortROne:
+        return new ShortROneNode(plan, node, parent);
+    case tShortZeroR:
+        return new ShortZeroRNode(plan, node, parent);
+    case tROne:
+        return new ROneNode(plan, node, parent);
+    case tZeroR:
+        return new ZeroRNode(plan, node, parent);
+    default:
+        return new RateRNode(plan, node, parent);
     }
 }
 
+
 } // namespace FastSscFip
 
 FastSscFipChar::FastSscFipChar(size_t blockLength,
                                const std::vector<unsigned>& frozenBits)
+    : mBatchNodeBase(nullptr),
+      mBatchRootNode(nullptr),
+      mBatchLlr(nullptr),
+      mBatchBits(nullptr)
 {
     initialize(blockLength, frozenBits);
 }
 
+FastSscFipChar::FastSscFipChar(plan_t plan)
+    : mPlan(plan),
+      mBatchNodeBase(nullptr),
+      mBatchRootNode(nullptr),
+      mBatchLlr(nullptr),
+      mBatchBits(nullptr)
+{
+    initializeContext();
+}
+
 FastSscFipChar::~FastSscFipChar() { clear(); }
 
 void FastSscFipChar::clear()
 {
+    if (mBatchNodeBase) {
+        delete mBatchRootNode;
+        delete mBatchNodeBase;
+        mDataPool->release(mBatchLlr);
+        mDataPool->release(mBatchBits);
+        mBatchRootNode = nullptr;
+        mBatchNodeBase = nullptr;
+        mBatchLlr = nullptr;
+        mBatchBits = nullptr;
+    }
     delete mEncoder;
     delete mRootNode;
     delete mNodeBase;
     delete mDataPool;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+}
+
+plan_t FastSscFipChar::makePlan(size_t blockLength,
+                                const std::vector<unsigned>& frozenBits)
+{
+    return std::make_shared<const DecoderPlan>(
+        blockLength, frozenBits, FastSscFip::classifyNode);
 }
 
 void FastSscFipChar::initialize(size_t blockLength,
@@ -595,37 +683,171 @@ void FastSscFipChar::initialize(size_t blockLength,
     if (mBlockLength != 0) {
         clear();
     }
-    mBlockLength = blockLength;
-    mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+    mPlan = makePlan(blockLength, frozenBits);
+    initializeContext();
+}
+
+void FastSscFipChar::initializeContext()
+{
+    mBlockLength = mPlan->blockLength();
+    mFrozenBits = mPlan->frozenBits();
 
     mEncoder = new Encoding::ButterflyFipPacked(mBlockLength, mFrozenBits);
     mEncoder->setSystematic(false);
 
     mDataPool = new DataPool<fipv, BYTESPERVECTOR>();
-    mNodeBase = new FastSscFip::Node(blockLength, mDataPool);
-    mRootNode = FastSscFip::createDecoder(frozenBits, mNodeBase);
+    mNodeBase = new FastSscFip::Node(mBlockLength, mDataPool);
+    mRootNode = FastSscFip::createDecoder(*mPlan, 0, mNodeBase);
     mLlrContainer =
         new CharContainer(reinterpret_cast<char*>(mNodeBase->input()), mBlockLength);
     mBitContainer =
         new CharContainer(reinterpret_cast<char*>(mNodeBase->output()), mBlockLength);
     mLlrContainer->setFrozenBits(mFrozenBits);
     mBitContainer->setFrozenBits(mFrozenBits);
-    mOutputContainer = new unsigned char[(mBlockLength - frozenBits.size() + 7) / 8];
+    mOutputContainer = new unsigned char[(mBlockLength - mFrozenBits.size() + 7) / 8];
+}
+
+Decoder* FastSscFipChar::clone() const
+{
+    FastSscFipChar* decoder = new FastSscFipChar(mPlan);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void FastSscFipChar::initializeBatch()
+{
+    if (mBatchNodeBase) {
+        return;
+    }
+    // One vector per code bit holds that bit of all frames
+    mBatchNodeBase = new FastSscFipInterleaved::Node(mBlockLength, mDataPool);
+    mBatchRootNode = FastSscFipInterleaved::createDecoder(mFrozenBits, mBatchNodeBase);
+    mBatchLlr = mDataPool->allocate(mBlockLength);
+    mBatchBits = mDataPool->allocate(mBlockLength);
 }
 
 bool FastSscFipChar::decode()
 {
     mRootNode->decode(mNodeBase->input(), mNodeBase->output());
+    return evaluateOutput(mOutputContainer);
+}
+
+bool FastSscFipChar::decodeExternal(const char* pLlr, unsigned char* pData)
+{
+    if (mBlockLength < BYTESPERVECTOR ||
+        reinterpret_cast<uintptr_t>(pLlr) % BYTESPERVECTOR != 0) {
+        return Decoder::decodeExternal(pLlr, pData);
+    }
+
+    // The nodes only read their input, so the root can work on the caller's LLRs
+    mRootNode->decode(reinterpret_cast<fipv*>(const_cast<char*>(pLlr)),
+                      mNodeBase->output());
+    return evaluateOutput(pData);
+}
+
+bool FastSscFipChar::decodeBatchGroup(const char* pLlr,
+                                      size_t frameCount,
+                                      unsigned char* pData,
+                                      bool* pResults)
+{
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    char* bits = dynamic_cast<CharContainer*>(mBitContainer)->data();
+    char* batchBits = reinterpret_cast<char*>(mBatchBits->data);
+    bool result = true;
+
+    char* batchLlr = reinterpret_cast<char*>(mBatchNodeBase->input());
+    FastSscFipInterleaved::interleaveFrames(batchLlr,
+                                            pLlr,
+                                            mBlockLength,
+                                            frameCount);
+    mBatchRootNode->decode(mBatchNodeBase->input(), mBatchNodeBase->output());
+    FastSscFipInterleaved::deinterleaveFrames(
+        batchBits,
+        reinterpret_cast<char*>(mBatchNodeBase->output()),
+        mBlockLength,
+        frameCount);
+
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        memcpy(bits, batchBits + frame * mBlockLength, mBlockLength);
+        const bool success = evaluateOutput(pData + frame * infoBytes);
+        if (pResults != nullptr) {
+            pResults[frame] = success;
+        }
+        result &= success;
+    }
+    return result;
+}
+
+bool FastSscFipChar::decode_batch(const char* pLlr,
+                                  size_t frames,
+                                  void* pData,
+                                  bool* pResults)
+{
+    using FastSscFipInterleaved::FRAMECOUNT;
+
+    initializeBatch();
+
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    unsigned char* data = static_cast<unsigned char*>(pData);
+    bool result = true;
+
+    for (size_t first = 0; first < frames; first += FRAMECOUNT) {
+        const size_t count = std::min<size_t>(FRAMECOUNT, frames - first);
+        result &= decodeBatchGroup(pLlr + first * mBlockLength,
+                                   count,
+                                   data + first * infoBytes,
+                                   pResults != nullptr ? pResults + first : nullptr);
+    }
+    return result;
+}
+
+bool FastSscFipChar::decode_batch(const float* pLlr,
+                                  size_t frames,
+                                  void* pData,
+                                  bool* pResults)
+{
+    using FastSscFipInterleaved::FRAMECOUNT;
+
+    initializeBatch();
+
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    unsigned char* data = static_cast<unsigned char*>(pData);
+    char* llr = reinterpret_cast<char*>(mBatchLlr->data);
+    bool result = true;
+
+    for (size_t first = 0; first < frames; first += FRAMECOUNT) {
+        const size_t count = std::min<size_t>(FRAMECOUNT, frames - first);
+        // Quantize each frame with the same conversion as setSignal()
+        for (size_t frame = 0; frame < count; ++frame) {
+            mLlrContainer->insertLlr(pLlr + (first + frame) * mBlockLength);
+            memcpy(llr + frame * mBlockLength, mNodeBase->input(), mBlockLength);
+        }
+        result &= decodeBatchGroup(llr,
+                                   count,
+                                   data + first * infoBytes,
+                                   pResults != nullptr ? pResults + first : nullptr);
+    }
+    return result;
+}
+
+bool FastSscFipChar::evaluateOutput(unsigned char* pData)
+{
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
     if (!mSystematic) {
+        // The packed encoder output is written in whole words, which may
+        // exceed the destination.
         mEncoder->setCharCodeword(dynamic_cast<CharContainer*>(mBitContainer)->data());
         mEncoder->encode();
         mEncoder->getInformation(mOutputContainer);
+        if (pData != mOutputContainer) {
+            memcpy(pData, mOutputContainer, infoBytes);
+        }
     } else {
-        mBitContainer->getPackedInformationBits(mOutputContainer);
+        mBitContainer->getPackedInformationBits(pData);
     }
 
-    bool result = mErrorDetector->check(mOutputContainer,
-                                        (mBlockLength - mFrozenBits.size() + 7) / 8);
+    bool result = mErrorDetector->check(pData, infoBytes);
     return result;
 }
 
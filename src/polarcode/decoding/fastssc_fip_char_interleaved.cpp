@@ -0,0 +1,315 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/fastssc_fip_char_interleaved.h>
+#include <polarcode/polarcode.h>
+
+#include <cstring>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace FastSscFipInterleaved {
+
+namespace {
+
+/*!
+ * \brief Transpose a 16x16 block of bytes by four perfect shuffles.
+ * \param dst Row i of the result is stored at dst + i * dstStride.
+ * \param dstStride Distance between two output rows.
+ * \param src Row i of the input is loaded from src + i * srcStride.
+ * \param srcStride Distance between two input rows.
+ */
+inline void transpose16x16(char* dst, size_t dstStride, const char* src, size_t srcStride)
+{
+    __m128i a[16], b[16];
+    for (unsigned i = 0; i < 16; ++i) {
+        a[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * srcStride));
+    }
+    for (unsigned stage = 0; stage < 4; ++stage) {
+        for (unsigned j = 0; j < 8; ++j) {
+            b[2 * j] = _mm_unpacklo_epi8(a[j], a[j + 8]);
+            b[2 * j + 1] = _mm_unpackhi_epi8(a[j], a[j + 8]);
+        }
+        memcpy(a, b, sizeof(a));
+    }
+    for (unsigned i = 0; i < 16; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dstStride), a[i]);
+    }
+}
+
+} // namespace
+
+void interleaveFrames(char* dst, const char* src, size_t blockLength, size_t frameCount)
+{
+    if (frameCount == FRAMECOUNT && blockLength % 16 == 0) {
+        for (unsigned i = 0; i < blockLength; i += 16) {
+            for (unsigned f = 0; f < FRAMECOUNT; f += 16) {
+                transpose16x16(dst + i * FRAMECOUNT + f,
+                               FRAMECOUNT,
+                               src + f * blockLength + i,
+                               blockLength);
+            }
+        }
+    } else {
+        for (unsigned i = 0; i < blockLength; ++i) {
+            for (unsigned f = 0; f < FRAMECOUNT; ++f) {
+                dst[i * FRAMECOUNT + f] = f < frameCount ? src[f * blockLength + i] : 0;
+            }
+        }
+    }
+}
+
+void deinterleaveFrames(char* dst, const char* src, size_t blockLength, size_t frameCount)
+{
+    if (frameCount == FRAMECOUNT && blockLength % 16 == 0) {
+        for (unsigned i = 0; i < blockLength; i += 16) {
+            for (unsigned f = 0; f < FRAMECOUNT; f += 16) {
+                transpose16x16(dst + f * blockLength + i,
+                               blockLength,
+                               src + i * FRAMECOUNT + f,
+                               FRAMECOUNT);
+            }
+        }
+    } else {
+        for (unsigned f = 0; f < frameCount; ++f) {
+            for (unsigned i = 0; i < blockLength; ++i) {
+                dst[f * blockLength + i] = src[i * FRAMECOUNT + f];
+            }
+        }
+    }
+}
+
+Node::Node() : mLlr(nullptr), mBit(nullptr), xmDataPool(nullptr), mBlockLength(0) {}
+
+Node::Node(Node* parent)
+    : mLlr(nullptr),
+      mBit(nullptr),
+      xmDataPool(parent->pool()),
+      mBlockLength(parent->blockLength())
+{
+}
+
+Node::Node(size_t blockLength, datapool_t* pool)
+    : mLlr(pool->allocate(blockLength)),
+      mBit(pool->allocate(blockLength)),
+      xmDataPool(pool),
+      mBlockLength(blockLength)
+{
+}
+
+Node::~Node()
+{
+    if (mLlr != nullptr)
+        xmDataPool->release(mLlr);
+    if (mBit != nullptr)
+        xmDataPool->release(mBit);
+}
+
+void Node::decode(fipv*, fipv*) {}
+
+size_t Node::blockLength() { return mBlockLength; }
+
+datapool_t* Node::pool() { return xmDataPool; }
+
+fipv* Node::input() { return mLlr->data; }
+
+fipv* Node::output() { return mBit->data; }
+
+// Constructors of nodes
+
+RateRNode::RateRNode(const std::vector<unsigned>& frozenBits, Node* parent) : Node(parent)
+{
+    mBlockLength /= 2;
+
+    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
+    splitFrozenBits(frozenBits, mBlockLength, leftFrozenBits, rightFrozenBits);
+
+    mLeft = createDecoder(leftFrozenBits, this);
+    mRight = createDecoder(rightFrozenBits, this);
+
+    ChildLlr = xmDataPool->allocate(mBlockLength);
+}
+
+ROneNode::ROneNode(const std::vector<unsigned>& frozenBits, Node* parent)
+    : RateRNode(frozenBits, parent)
+{
+}
+
+ZeroRNode::ZeroRNode(const std::vector<unsigned>& frozenBits, Node* parent)
+    : RateRNode(frozenBits, parent)
+{
+}
+
+RateZeroDecoder::RateZeroDecoder(Node* parent) : Node(parent) {}
+
+RateOneDecoder::RateOneDecoder(Node* parent) : Node(parent) {}
+
+RepetitionDecoder::RepetitionDecoder(Node* parent) : Node(parent) {}
+
+SpcDecoder::SpcDecoder(Node* parent) : Node(parent) {}
+
+// Destructors of nodes
+
+RateRNode::~RateRNode()
+{
+    delete mLeft;
+    delete mRight;
+    xmDataPool->release(ChildLlr);
+}
+
+ROneNode::~ROneNode() {}
+
+ZeroRNode::~ZeroRNode() {}
+
+RateZeroDecoder::~RateZeroDecoder() {}
+
+RateOneDecoder::~RateOneDecoder() {}
+
+RepetitionDecoder::~RepetitionDecoder() {}
+
+SpcDecoder::~SpcDecoder() {}
+
+// Decoders
+
+void RateZeroDecoder::decode(fipv*, fipv* BitsOut)
+{
+    const fipv inf = fi_set1_epi8(127);
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        fi_store(BitsOut + i, inf);
+    }
+}
+
+void RateOneDecoder::decode(fipv* LlrIn, fipv* BitsOut)
+{
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        fi_store(BitsOut + i, fi_load(LlrIn + i));
+    }
+}
+
+/* WARNING: Saturation can lead to wrong results!
+        See FastSscFip::RepetitionDecoder.
+*/
+void RepetitionDecoder::decode(fipv* LlrIn, fipv* BitsOut)
+{
+    fipv LlrSum = fi_setzero();
+
+    // Each lane accumulates the LLRs of its own frame
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        LlrSum = fi_adds_epi8(LlrSum, fi_load(LlrIn + i));
+    }
+
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        fi_store(BitsOut + i, LlrSum);
+    }
+}
+
+void SpcDecoder::decode(fipv* LlrIn, fipv* BitsOut)
+{
+    const fipv zero = fi_setzero();
+    fipv parVec = fi_setzero();
+    fipv minAbs = fi_set1_epi8(-1); // 255 as unsigned
+
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        fipv vecIn = fi_load(LlrIn + i);
+        fi_store(BitsOut + i, vecIn);
+        parVec = fi_xor(parVec, vecIn);
+        minAbs = fi_min_epu8(minAbs, fi_abs_epi8(vecIn));
+    }
+
+    // Flip the first least reliable bit in each frame with odd parity
+    fipv flip = fi_cmpeq_epi8(fi_and(parVec, fi_set1_epi8(-128)), fi_set1_epi8(-128));
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        fipv bits = fi_load(BitsOut + i);
+        fipv mask = fi_and(flip, fi_cmpeq_epi8(fi_abs_epi8(bits), minAbs));
+        fi_store(BitsOut + i, fi_blendv_epi8(bits, fi_subs_epi8(zero, bits), mask));
+        flip = fi_andnot(mask, flip);
+    }
+}
+
+void RateRNode::decode(fipv* LlrIn, fipv* BitsOut)
+{
+    // With one code bit per vector, the single-frame kernels apply unchanged
+    // to the scaled length.
+    const unsigned byteCount = mBlockLength * FRAMECOUNT;
+
+    FastSscFip::F_function(LlrIn, ChildLlr->data, byteCount);
+
+    mLeft->decode(ChildLlr->data, BitsOut);
+
+    FastSscFip::G_function(LlrIn, ChildLlr->data, BitsOut, byteCount);
+
+    mRight->decode(ChildLlr->data, BitsOut + mBlockLength);
+
+    FastSscFip::CombineInPlace(BitsOut, mBlockLength);
+}
+
+void ROneNode::decode(fipv* LlrIn, fipv* BitsOut)
+{
+    FastSscFip::F_function(LlrIn, ChildLlr->data, mBlockLength * FRAMECOUNT);
+
+    mLeft->decode(ChildLlr->data, BitsOut);
+
+    for (unsigned i = 0; i < mBlockLength; ++i) {
+        fipv Llr_l = fi_load(LlrIn + i);
+        fipv Llr_r = fi_load(LlrIn + i + mBlockLength);
+        fipv Bits = fi_load(BitsOut + i);
+        fipv Llr_o;
+
+        FastSscFip::G_function_calc(Llr_l, Llr_r, Bits, &Llr_o);
+        /*nop*/                                      // Rate 1 decoder
+        fi_store(BitsOut + i, fi_xor(Bits, Llr_o));  // Combine left bit
+        fi_store(BitsOut + i + mBlockLength, Llr_o); // Copy right bit
+    }
+}
+
+void ZeroRNode::decode(fipv* LlrIn, fipv* BitsOut)
+{
+    FastSscFip::G_function_0R(LlrIn, ChildLlr->data, mBlockLength * FRAMECOUNT);
+
+    mRight->decode(ChildLlr->data, BitsOut + mBlockLength);
+
+    FastSscFip::Combine_0R(BitsOut, mBlockLength * FRAMECOUNT);
+}
+
+// End of mass defining
+
+Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
+{
+    size_t blockLength = parent->blockLength();
+    size_t frozenBitCount = frozenBits.size();
+
+    if (frozenBitCount == blockLength) {
+        return new RateZeroDecoder(parent);
+    }
+    if (frozenBitCount == 0) {
+        return new RateOneDecoder(parent);
+    }
+    if (frozenBitCount == (blockLength - 1)) {
+        return new RepetitionDecoder(parent);
+    }
+    if (frozenBitCount == 1) {
+        return new SpcDecoder(parent);
+    }
+
+    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
+    splitFrozenBits(frozenBits, blockLength / 2, leftFrozenBits, rightFrozenBits);
+
+    if (rightFrozenBits.size() == 0) {
+        return new ROneNode(frozenBits, parent);
+    }
+    if (leftFrozenBits.size() == blockLength / 2) {
+        return new ZeroRNode(frozenBits, parent);
+    }
+    return new RateRNode(frozenBits, parent);
+}
+
+} // namespace FastSscFipInterleaved
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -0,0 +1,588 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/fastssc_schedule.h>
+#include <polarcode/encoding/butterfly_fip_packed.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace FastSscAvx {
+
+namespace {
+
+const uint32_t SCHEDULE_MAGIC = 0x50435343; // "PCSC"
+const uint32_t SCHEDULE_VERSION = 1;
+
+const char* const opcodeNames[opCount] = { "F",
+                                           "G",
+                                           "G0R",
+                                           "Combine",
+                                           "Combine0R",
+                                           "CombineShort",
+                                           "ROneRight",
+                                           "RateZero",
+                                           "RateOne",
+                                           "Repetition",
+                                           "DoubleRepetition",
+                                           "TripleRepetition",
+                                           "Spc",
+                                           "DoubleSpc",
+                                           "DoubleSpcShort8",
+                                           "TypeFive",
+                                           "RepetitionRateOneShort8",
+                                           "ZeroSpc",
+                                           "ZeroSpcShort8",
+                                           "GRepetitionShort",
+                                           "SumRepetitions",
+                                           "RepeatSource",
+                                           "CombineParityChecks",
+                                           "DecodeParityChecks" };
+
+// Leaf node types and their opcodes
+unsigned leafOpcode(unsigned type)
+{
+    switch (type) {
+    case tRateZero:
+        return opRateZero;
+    case tRateOne:
+        return opRateOne;
+    case tRepetition:
+        return opRepetition;
+    case tDoubleRepetition:
+        return opDoubleRepetition;
+    case tTripleRepetition:
+        return opTripleRepetition;
+    case tSpc:
+        return opSpc;
+    case tDoubleSpc:
+        return opDoubleSpc;
+    case tDoubleSpcShort8:
+        return opDoubleSpcShort8;
+    case tTypeFive:
+        return opTypeFive;
+    case tRepetitionRateOneShort8:
+        return opRepetitionRateOneShort8;
+    case tZeroSpc:
+        return opZeroSpc;
+    case tZeroSpcShort8:
+        return opZeroSpcShort8;
+    default:
+        return opCount;
+    }
+}
+
+unsigned padded(unsigned length) { return nBit2fCount(length); }
+
+bool isPowerOfTwo(unsigned value) { return value != 0 && (value & (value - 1)) == 0; }
+
+/*
+ * Whether the kernel of an instruction supports its length and source length.
+ * These are the lengths, for which the decoding tree creates the node types.
+ */
+bool supportedShape(const Instruction& op)
+{
+    const unsigned length = op.length, source = op.param;
+    const bool validSource = isPowerOfTwo(source) && source < length;
+    switch (op.opcode) {
+    case opF:
+    case opG:
+        return length >= 2;
+    case opCombineShort:
+        return length >= 2 && length <= 8;
+    case opDoubleRepetition:
+        return length >= 4;
+    case opTypeFive:
+        return length >= 8;
+    case opDoubleSpcShort8:
+    case opRepetitionRateOneShort8:
+    case opZeroSpcShort8:
+        return length == 8;
+    case opG0R:
+    case opCombine:
+    case opCombine0R:
+    case opROneRight:
+    case opTripleRepetition:
+    case opDoubleSpc:
+    case opZeroSpc:
+    case opGRepetitionShort:
+        return length >= 16;
+    case opSumRepetitions:
+    case opRepeatSource:
+    case opCombineParityChecks:
+        return length >= 16 && validSource && source >= 8;
+    case opDecodeParityChecks:
+        return length >= 16 && validSource && source >= 4;
+    default:
+        return true;
+    }
+}
+
+/*
+ * Number of floats each operand of an instruction covers, zero if the
+ * operand is unused.
+ */
+void operandExtents(const Instruction& op,
+                    unsigned& input,
+                    unsigned& output,
+                    unsigned& bits)
+{
+    const unsigned length = padded(op.length), half = padded(op.length / 2);
+    input = length;
+    output = length;
+    bits = 0;
+    switch (op.opcode) {
+    case opF:
+    case opG0R:
+        output = half;
+        break;
+    case opG:
+        output = half;
+        bits = half;
+        break;
+    case opCombine:
+    case opCombine0R:
+    case opRepeatSource:
+        input = 0;
+        break;
+    case opCombineShort:
+        input = 8;
+        output = 8;
+        bits = 8;
+        break;
+    case opSumRepetitions:
+    case opCombineParityChecks:
+        output = padded(op.param);
+        break;
+    case opDecodeParityChecks:
+        bits = op.bits == Schedule::NONE ? 0 : padded(op.param);
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+bool Instruction::operator==(const Instruction& other) const
+{
+    return opcode == other.opcode && length == other.length && input == other.input &&
+           output == other.output && bits == other.bits && param == other.param;
+}
+
+Schedule::Schedule(const DecoderPlan& plan)
+    : mBlockLength(plan.blockLength()), mFrozenBits(plan.frozenBits())
+{
+    const MemoryLayout layout(plan);
+    mArenaLength = layout.size();
+    mInputOffset = layout.input();
+    mOutputOffset = layout.output();
+    compile(plan, layout, 0, mInputOffset, mOutputOffset);
+}
+
+Schedule::Schedule(const std::vector<uint32_t>& words)
+{
+    size_t position = 0;
+    auto next = [&words, &position]() {
+        if (position >= words.size()) {
+            throw std::invalid_argument("Schedule: Unexpected end of data!");
+        }
+        return words[position++];
+    };
+    // Number of items of _size_ words each, which the remaining data can hold
+    auto count = [&words, &position, &next](size_t size) {
+        const size_t items = next();
+        if (items > (words.size() - position) / size) {
+            throw std::invalid_argument("Schedule: Unexpected end of data!");
+        }
+        return items;
+    };
+
+    if (next() != SCHEDULE_MAGIC || next() != SCHEDULE_VERSION) {
+        throw std::invalid_argument("Schedule: Unknown format!");
+    }
+    mBlockLength = next();
+    mFrozenBits.resize(count(1));
+    for (unsigned& bit : mFrozenBits) {
+        bit = next();
+    }
+    mArenaLength = next();
+    mInputOffset = next();
+    mOutputOffset = next();
+    mInstructions.resize(count(6));
+    for (Instruction& op : mInstructions) {
+        op.opcode = next();
+        op.length = next();
+        op.input = next();
+        op.output = next();
+        op.bits = next();
+        op.param = next();
+    }
+    if (position != words.size()) {
+        throw std::invalid_argument("Schedule: Trailing data!");
+    }
+    validate();
+}
+
+std::vector<uint32_t> Schedule::serialize() const
+{
+    std::vector<uint32_t> words = { SCHEDULE_MAGIC,
+                                    SCHEDULE_VERSION,
+                                    static_cast<uint32_t>(mBlockLength),
+                                    static_cast<uint32_t>(mFrozenBits.size()) };
+    words.insert(words.end(), mFrozenBits.begin(), mFrozenBits.end());
+    words.push_back(mArenaLength);
+    words.push_back(mInputOffset);
+    words.push_back(mOutputOffset);
+    words.push_back(mInstructions.size());
+    for (const Instruction& op : mInstructions) {
+        words.insert(words.end(),
+                     { op.opcode, op.length, op.input, op.output, op.bits, op.param });
+    }
+    return words;
+}
+
+std::string Schedule::toString() const
+{
+    std::string text = fmt::format("Schedule for N={}, K={}, {} floats of memory\n",
+                                   mBlockLength,
+                                   mBlockLength - mFrozenBits.size(),
+                                   mArenaLength);
+    for (const Instruction& op : mInstructions) {
+        text += fmt::format("{:<24} N={:<6} in={:<7} out={}",
+                            opcodeNames[op.opcode],
+                            op.length,
+                            op.input == NONE ? "-" : std::to_string(op.input),
+                            op.output);
+        if (op.bits != NONE) {
+            text += fmt::format(" bits={}", op.bits);
+        }
+        if (op.param != 0) {
+            text += fmt::format(" source={}", op.param);
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+size_t Schedule::blockLength() const { return mBlockLength; }
+
+const std::vector<unsigned>& Schedule::frozenBits() const { return mFrozenBits; }
+
+size_t Schedule::arenaLength() const { return mArenaLength; }
+
+unsigned Schedule::inputOffset() const { return mInputOffset; }
+
+unsigned Schedule::outputOffset() const { return mOutputOffset; }
+
+const std::vector<Instruction>& Schedule::instructions() const { return mInstructions; }
+
+void Schedule::emit(unsigned opcode,
+                    unsigned length,
+                    unsigned input,
+                    unsigned output,
+                    unsigned bits,
+                    unsigned param)
+{
+    mInstructions.push_back({ opcode, length, input, output, bits, param });
+}
+
+void Schedule::compile(const DecoderPlan& plan,
+                       const MemoryLayout& layout,
+                       int index,
+                       unsigned input,
+                       unsigned output)
+{
+    const PlanNode& node = plan.node(index);
+    const unsigned length = node.blockLength, half = length / 2;
+
+    const unsigned leaf = leafOpcode(node.type);
+    if (leaf != opCount) {
+        emit(leaf, length, input, output);
+        return;
+    }
+
+    switch (node.type) {
+    case tRateR: {
+        const unsigned child = layout.llr(half);
+        emit(opF, length, input, child);
+        compile(plan, layout, node.left, child, output);
+        emit(opG, length, input, child, output);
+        compile(plan, layout, node.right, child, output + half);
+        emit(opCombine, length, NONE, output);
+        break;
+    }
+    case tShortRateR: {
+        const unsigned child = layout.llr(half);
+        const unsigned left = layout.leftBits(length);
+        const unsigned right = layout.rightBits(length);
+        emit(opF, length, input, child);
+        compile(plan, layout, node.left, child, left);
+        emit(opG, length, input, child, left);
+        compile(plan, layout, node.right, child, right);
+        emit(opCombineShort, length, left, output, right);
+        break;
+    }
+    case tROne: {
+        const unsigned child = layout.llr(half);
+        emit(opF, length, input, child);
+        compile(plan, layout, node.left, child, output);
+        emit(opROneRight, length, input, output);
+        break;
+    }
+    case tZeroR: {
+        const unsigned child = layout.llr(half);
+        emit(opG0R, length, input, child);
+        compile(plan, layout, node.right, child, output + half);
+        emit(opCombine0R, length, NONE, output);
+        break;
+    }
+    case tGRepetition: {
+        const unsigned sourceLength = plan.node(node.right).blockLength;
+        if (sourceLength < 8) {
+            emit(opGRepetitionShort, length, input, output);
+            break;
+        }
+        // The source writes its code word into the first repetition
+        const unsigned source = layout.llr(sourceLength);
+        emit(opSumRepetitions, length, input, source, NONE, sourceLength);
+        compile(plan, layout, node.right, source, output);
+        emit(opRepeatSource, length, NONE, output, NONE, sourceLength);
+        break;
+    }
+    case tGParityCheck: {
+        const unsigned sourceLength = plan.node(node.left).blockLength;
+        if (plan.node(node.left).type == tRateZero) {
+            emit(opDecodeParityChecks, length, input, output, NONE, sourceLength);
+            break;
+        }
+        const unsigned source = layout.llr(sourceLength);
+        const unsigned sourceBits = layout.sourceBits(sourceLength);
+        emit(opCombineParityChecks, length, input, source, NONE, sourceLength);
+        compile(plan, layout, node.left, source, sourceBits);
+        emit(opDecodeParityChecks, length, input, output, sourceBits, sourceLength);
+        break;
+    }
+    default:
+        throw std::invalid_argument("Schedule: Unknown node type!");
+    }
+}
+
+void Schedule::validate() const
+{
+    if (!isPowerOfTwo(mBlockLength)) {
+        throw std::invalid_argument("Schedule: Invalid block length!");
+    }
+    std::vector<bool> frozen(mBlockLength, false);
+    for (unsigned bit : mFrozenBits) {
+        if (bit >= mBlockLength || frozen[bit]) {
+            throw std::invalid_argument("Schedule: Invalid frozen bit!");
+        }
+        frozen[bit] = true;
+    }
+
+    // Every operand has to be an aligned range inside the arena
+    auto check = [this](unsigned offset, unsigned extent) {
+        if (offset % 8 != 0 || offset > mArenaLength || extent > mArenaLength - offset) {
+            throw std::invalid_argument("Schedule: Operand out of range!");
+        }
+    };
+    check(mInputOffset, padded(mBlockLength));
+    check(mOutputOffset, padded(mBlockLength));
+    for (const Instruction& op : mInstructions) {
+        if (op.opcode >= opCount || !isPowerOfTwo(op.length) ||
+            op.length > mBlockLength || op.param > op.length || !supportedShape(op)) {
+            throw std::invalid_argument("Schedule: Invalid instruction!");
+        }
+        unsigned input, output, bits;
+        operandExtents(op, input, output, bits);
+        if (input) {
+            check(op.input, input);
+        }
+        check(op.output, output);
+        if (bits) {
+            check(op.bits, bits);
+        }
+    }
+}
+
+} // namespace FastSscAvx
+
+FastSscScheduleFloat::FastSscScheduleFloat(size_t blockLength,
+                                           const std::vector<unsigned>& frozenBits)
+{
+    initialize(blockLength, frozenBits);
+}
+
+FastSscScheduleFloat::FastSscScheduleFloat(FastSscAvx::schedule_t schedule)
+    : mSchedule(schedule)
+{
+    initializeContext();
+}
+
+FastSscScheduleFloat::~FastSscScheduleFloat() { clear(); }
+
+void FastSscScheduleFloat::clear()
+{
+    delete mEncoder;
+    mDataPool->release(mArena);
+    delete mDataPool;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+}
+
+void FastSscScheduleFloat::initialize(size_t blockLength,
+                                      const std::vector<unsigned>& frozenBits)
+{
+    if (blockLength == mBlockLength && frozenBits == mFrozenBits) {
+        return;
+    }
+    if (mBlockLength != 0) {
+        clear();
+    }
+    mSchedule = std::make_shared<const FastSscAvx::Schedule>(
+        *FastSscAvxFloat::makePlan(blockLength, frozenBits));
+    initializeContext();
+}
+
+void FastSscScheduleFloat::initializeContext()
+{
+    mBlockLength = mSchedule->blockLength();
+    mFrozenBits = mSchedule->frozenBits();
+    mEncoder = new Encoding::ButterflyFipPacked(mBlockLength, mFrozenBits);
+    mEncoder->setSystematic(false);
+    mDataPool = new FastSscAvx::datapool_t();
+    mArena = mDataPool->allocate(mSchedule->arenaLength());
+    memset(mArena->data, 0, mSchedule->arenaLength() * sizeof(float));
+
+    float* arena = mArena->data;
+    mLlrContainer = new FloatContainer(arena + mSchedule->inputOffset(), mBlockLength);
+    mBitContainer = new FloatContainer(arena + mSchedule->outputOffset(), mBlockLength);
+    mLlrContainer->setFrozenBits(mFrozenBits);
+    mBitContainer->setFrozenBits(mFrozenBits);
+    mOutputContainer = new unsigned char[(mBlockLength - mFrozenBits.size() + 7) / 8];
+}
+
+Decoder* FastSscScheduleFloat::clone() const
+{
+    FastSscScheduleFloat* decoder = new FastSscScheduleFloat(mSchedule);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+bool FastSscScheduleFloat::decode()
+{
+    using namespace FastSscAvx;
+    float* arena = mArena->data;
+
+    for (const Instruction& op : mSchedule->instructions()) {
+        const unsigned half = op.length / 2;
+        float* out = arena + op.output;
+        switch (op.opcode) {
+        case opF:
+            F_function(arena + op.input, out, half);
+            break;
+        case opG:
+            G_function(arena + op.input, out, arena + op.bits, half);
+            break;
+        case opG0R:
+            G_function_0R(arena + op.input, out, half);
+            break;
+        case opCombine:
+            Combine(out, half);
+            break;
+        case opCombine0R:
+            Combine_0R(out, half);
+            break;
+        case opCombineShort:
+            CombineBitsShort(arena + op.input, arena + op.bits, out, half);
+            break;
+        case opROneRight:
+            decodeROneRight(out, arena + op.input, op.length);
+            break;
+        case opRateZero:
+            decodeRateZero(out, arena + op.input, op.length);
+            break;
+        case opRateOne:
+            decodeRateOne(out, arena + op.input, op.length);
+            break;
+        case opRepetition:
+            decodeRepetition(out, arena + op.input, op.length);
+            break;
+        case opDoubleRepetition:
+            decodeDoubleRepetition(out, arena + op.input, op.length);
+            break;
+        case opTripleRepetition:
+            decodeTripleRepetition(out, arena + op.input, op.length);
+            break;
+        case opSpc:
+            decodeSpc(out, arena + op.input, op.length);
+            break;
+        case opDoubleSpc:
+            decodeDoubleSpc(out, arena + op.input, op.length);
+            break;
+        case opDoubleSpcShort8:
+            decodeDoubleSpcShort8(out, arena + op.input, op.length);
+            break;
+        case opTypeFive:
+            decodeTypeFive(out, arena + op.input, op.length);
+            break;
+        case opRepetitionRateOneShort8:
+            decodeRepetitionRateOneShort8(out, arena + op.input, op.length);
+            break;
+        case opZeroSpc:
+            decodeZeroSpc(out, arena + op.input, op.length);
+            break;
+        case opZeroSpcShort8:
+            decodeZeroSpcShort8(out, arena + op.input, op.length);
+            break;
+        case opGRepetitionShort:
+            decodeGRepetitionShort(out, arena + op.input, op.length);
+            break;
+        case opSumRepetitions:
+            sumRepetitions(out, arena + op.input, op.length, op.param);
+            break;
+        case opRepeatSource:
+            repeatSource(out, op.length, op.param);
+            break;
+        case opCombineParityChecks:
+            combineParityChecks(out, arena + op.input, op.length, op.param);
+            break;
+        case opDecodeParityChecks:
+            decodeParityChecks(out,
+                               arena + op.input,
+                               op.bits == Schedule::NONE ? nullptr : arena + op.bits,
+                               op.length,
+                               op.param);
+            break;
+        }
+    }
+
+    const size_t infoBytes = (mBlockLength - mFrozenBits.size() + 7) / 8;
+    if (!mSystematic) {
+        mEncoder->setFloatCodeword(dynamic_cast<FloatContainer*>(mBitContainer)->data());
+        mEncoder->encode();
+        mEncoder->getInformation(mOutputContainer);
+    } else {
+        mBitContainer->getPackedInformationBits(mOutputContainer);
+    }
+    return mErrorDetector->check(mOutputContainer, infoBytes);
+}
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -93,6 +93,7 @@ RateRNode::~RateRNode()
     xmDataPool->release(mRightLlr);
     xmDataPool->release(mLeftExt);
     xmDataPool->release(mRightExt);
+    xmDataPool->release(mTemp);
 }
 
 inline void addVectors(float* a, float* b, float* dst, unsigned length)
@@ -9,10 +9,31 @@
 #include <polarcode/decoding/fixed_fip_char.h>
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <polarcode/errordetection/dummy.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
 
+int findCodingScheme(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    std::vector<unsigned> sortedFrozenBits;
+    const std::vector<unsigned>* key = &frozenBits;
+    if (!std::is_sorted(frozenBits.begin(), frozenBits.end())) {
+        sortedFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+        std::sort(sortedFrozenBits.begin(), sortedFrozenBits.end());
+        key = &sortedFrozenBits;
+    }
+
+    for (unsigned scheme = 0; scheme < codeRegistry.size(); ++scheme) {
+        if (codeRegistry[scheme].blockLength == blockLength &&
+            codeRegistry[scheme].frozenBits == *key) {
+            return scheme;
+        }
+    }
+    return -1;
+}
+
 namespace FixedDecoding {
 
 FixedDecoder::FixedDecoder() {}
@@ -22,8 +43,11 @@ FixedDecoder::~FixedDecoder() {}
 } // namespace FixedDecoding
 
 
-FixedChar::FixedChar(unsigned int scheme)
+FixedChar::FixedChar(unsigned int scheme) : mScheme(scheme)
 {
+    if (scheme >= codeRegistry.size()) {
+        throw std::invalid_argument("FixedChar: Unknown coding scheme!");
+    }
     mDecoder = FixedDecoding::createFixedDecoder(scheme);
 
     mBlockLength = codeRegistry[scheme].blockLength;
@@ -43,6 +67,21 @@ FixedChar::~FixedChar()
     delete mDecoder;
 }
 
+Decoder* FixedChar::clone() const
+{
+    FixedChar* decoder = new FixedChar(mScheme);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void FixedChar::initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    if (findCodingScheme(blockLength, frozenBits) != (int)mScheme) {
+        throw std::invalid_argument("FixedChar: The code of a fixed decoder is fixed!");
+    }
+}
+
 bool FixedChar::decode()
 {
     mDecoder->decode(reinterpret_cast<CharContainer*>(mLlrContainer)->data(),
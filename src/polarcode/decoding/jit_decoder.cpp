@@ -0,0 +1,468 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/jit_decoder.h>
+
+#include <dlfcn.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#ifndef POLARCODE_JIT_CXX
+#define POLARCODE_JIT_CXX "c++"
+#endif
+
+#ifndef POLARCODE_JIT_INCLUDE_DIR
+#define POLARCODE_JIT_INCLUDE_DIR "/usr/local/include"
+#endif
+
+#ifndef POLARCODE_JIT_BUILD_LIBDIR
+#define POLARCODE_JIT_BUILD_LIBDIR ""
+#endif
+
+#ifndef POLARCODE_JIT_BUILD_INCLUDE_DIR
+#define POLARCODE_JIT_BUILD_INCLUDE_DIR POLARCODE_JIT_INCLUDE_DIR
+#endif
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace Jit {
+
+namespace {
+
+// 64-bit FNV-1a
+class Hash
+{
+    uint64_t mHash = 0xcbf29ce484222325ULL;
+
+public:
+    void add(const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            mHash ^= static_cast<unsigned char>(data[i]);
+            mHash *= 0x100000001b3ULL;
+        }
+    }
+    void add(const std::string& text) { add(text.data(), text.size() + 1); }
+    void add(uint64_t value)
+    {
+        for (unsigned byte = 0; byte < 8; ++byte) {
+            mHash ^= (value >> (8 * byte)) & 0xFF;
+            mHash *= 0x100000001b3ULL;
+        }
+    }
+    uint64_t value() const { return mHash; }
+};
+
+std::string environment(const char* name, const std::string& fallback)
+{
+    const char* value = std::getenv(name);
+    return value != nullptr && value[0] != '\0' ? std::string(value) : fallback;
+}
+
+std::string quote(const std::string& argument)
+{
+    std::string quoted = "'";
+    for (char c : argument) {
+        quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    }
+    return quoted + "'";
+}
+
+// The compiled decoders link against the library they were requested by
+std::string libraryPath()
+{
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&defaultOptions), &info) == 0 ||
+        info.dli_fname == nullptr) {
+        return "";
+    }
+    std::string path(info.dli_fname);
+    return path.find(".so") != std::string::npos ? path : "";
+}
+
+// Everything but the file names of the compiler call
+std::string compilerArguments(const Options& options)
+{
+    std::string arguments =
+        options.compiler + " " + options.flags + " -I" + quote(options.includeDir);
+    const std::string parent = libraryPath();
+    if (!parent.empty()) {
+        arguments += " " + quote(parent);
+    }
+    return arguments;
+}
+
+// Size and modification time of a file, or zero, if it does not exist
+uint64_t fileStamp(const std::filesystem::path& path)
+{
+    std::error_code error;
+    const uint64_t size = std::filesystem::file_size(path, error);
+    if (error) {
+        return 0;
+    }
+    const auto time = std::filesystem::last_write_time(path, error);
+    return size ^ (static_cast<uint64_t>(time.time_since_epoch().count()) << 20);
+}
+
+// Hash of the polarcode headers, which are read once per directory
+uint64_t headerFingerprint(const std::string& includeDir)
+{
+    namespace fs = std::filesystem;
+    static std::mutex mutex;
+    static std::map<std::string, uint64_t> fingerprints;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto fingerprint = fingerprints.find(includeDir);
+    if (fingerprint != fingerprints.end()) {
+        return fingerprint->second;
+    }
+
+    std::vector<fs::path> headers;
+    std::error_code error;
+    for (fs::recursive_directory_iterator entry(includeDir + "/polarcode", error), end;
+         !error && entry != end;
+         entry.increment(error)) {
+        if (entry->is_regular_file(error)) {
+            headers.push_back(entry->path());
+        }
+    }
+    std::sort(headers.begin(), headers.end());
+
+    Hash hash;
+    for (const fs::path& header : headers) {
+        std::ifstream file(header, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+        hash.add(header.string());
+        hash.add(contents);
+    }
+    return fingerprints[includeDir] = hash.value();
+}
+
+// The build tree has no installed headers
+std::string defaultIncludeDir()
+{
+    namespace fs = std::filesystem;
+    const std::string library = libraryPath();
+    std::error_code error;
+    if (!library.empty() && std::string(POLARCODE_JIT_BUILD_LIBDIR) != "" &&
+        fs::equivalent(fs::path(library).parent_path(),
+                       POLARCODE_JIT_BUILD_LIBDIR,
+                       error)) {
+        return POLARCODE_JIT_BUILD_INCLUDE_DIR;
+    }
+    return POLARCODE_JIT_INCLUDE_DIR;
+}
+
+factory_t build(size_t blockLength,
+                std::vector<unsigned> frozenBits,
+                const Options& options)
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::create_directories(options.cacheDir, error);
+
+    const std::string base =
+        options.cacheDir + "/polarcode_" + cacheKey(blockLength, frozenBits, options);
+    const std::string library = base + ".so";
+
+    if (!fs::exists(library)) {
+        // Other processes might compile the same code, so move the results in place
+        const std::string temporary = base + "." + std::to_string(getpid());
+        const std::string source = temporary + ".cpp";
+        const std::string output = temporary + ".so";
+        const std::string log = temporary + ".log";
+        {
+            std::ofstream file(source);
+            file << sourceCode(blockLength, frozenBits);
+            if (!file.flush()) {
+                fs::remove(source, error);
+                return nullptr;
+            }
+        }
+
+        const std::string command = compilerArguments(options) + " -o " +
+                                    quote(output) + " " + quote(source) + " > " +
+                                    quote(log) + " 2>&1";
+        const bool compiled = std::system(command.c_str()) == 0;
+        fs::rename(source, base + ".cpp", error);
+        fs::rename(log, base + ".log", error);
+        if (!compiled) {
+            fs::remove(output, error);
+            return nullptr;
+        }
+        fs::rename(output, library, error);
+        if (error) {
+            fs::remove(output, error);
+            return nullptr;
+        }
+    }
+
+    void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<factory_t>(dlsym(handle, "polarcode_jit_create"));
+}
+
+} // namespace
+
+Options defaultOptions()
+{
+    Options options;
+    options.compiler = environment("POLARCODE_JIT_CXX", POLARCODE_JIT_CXX);
+    options.flags = environment("POLARCODE_JIT_FLAGS",
+                                "-std=c++17 -O3 -march=native -mavx2 -fPIC -shared "
+                                "-Wno-ignored-attributes");
+    options.includeDir = environment("POLARCODE_JIT_INCLUDE_DIR", defaultIncludeDir());
+
+    std::string cacheHome = environment("XDG_CACHE_HOME", "");
+    if (cacheHome.empty()) {
+        const std::string home = environment("HOME", "");
+        cacheHome = home.empty() ? "/tmp" : home + "/.cache";
+    }
+    options.cacheDir = environment("POLARCODE_JIT_CACHE", cacheHome + "/polarcode");
+    return options;
+}
+
+std::string cacheKey(size_t blockLength,
+                     const std::vector<unsigned>& frozenBits,
+                     const Options& options)
+{
+    // Any change of the code, the compiler call, the headers or the library
+    // has to give a new library
+    Hash hash;
+    hash.add(sourceCode(blockLength, frozenBits));
+    hash.add(compilerArguments(options));
+    hash.add(headerFingerprint(options.includeDir));
+    hash.add(fileStamp(libraryPath()));
+
+    char key[17];
+    snprintf(
+        key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash.value()));
+    return std::to_string(blockLength) + "_" + key;
+}
+
+std::string sourceCode(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    std::vector<int> frozenSet(blockLength, 0);
+    for (unsigned bit : frozenBits) {
+        frozenSet[bit] = 1;
+    }
+
+    std::ostringstream code;
+    code << "// Decoder for a single code, generated by PolarCode::Decoding::Jit\n"
+         << "#include <polarcode/decoding/templatized_float.h>\n\n"
+         << "namespace {\n"
+         << "constexpr std::array<int, " << blockLength << "> frozenSet = {";
+    for (size_t i = 0; i < blockLength; ++i) {
+        code << frozenSet[i] << (i + 1 < blockLength ? "," : "");
+    }
+    code << "};\n"
+         << "}\n\n"
+         << "extern \"C\" PolarCode::Decoding::Decoder* polarcode_jit_create(\n"
+         << "    size_t blockLength, const unsigned* frozenBits, size_t frozenBitCount)\n"
+         << "{\n"
+         << "    // The cache key might collide\n"
+         << "    std::vector<unsigned> bits(frozenBits, frozenBits + frozenBitCount);\n"
+         << "    if (blockLength != frozenSet.size() || bits.size() != "
+         << frozenBits.size() << ") {\n"
+         << "        return nullptr;\n"
+         << "    }\n"
+         << "    for (unsigned bit : bits) {\n"
+         << "        if (bit >= blockLength || !frozenSet[bit]) {\n"
+         << "            return nullptr;\n"
+         << "        }\n"
+         << "    }\n"
+         << "    return new PolarCode::Decoding::TemplatizedFloat<" << blockLength
+         << ", frozenSet>(bits);\n"
+         << "}\n";
+    return code.str();
+}
+
+std::shared_future<factory_t> compile(size_t blockLength,
+                                      const std::vector<unsigned>& frozenBits,
+                                      const Options& options)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_future<factory_t>> libraries;
+
+    const std::string name =
+        options.cacheDir + "/" + cacheKey(blockLength, frozenBits, options);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto library = libraries.find(name);
+    if (library != libraries.end()) {
+        return library->second;
+    }
+
+    // The compiler runs detached, so that no decoder has to wait for it
+    std::promise<factory_t> promise;
+    std::shared_future<factory_t> factory = promise.get_future().share();
+    libraries[name] = factory;
+    std::thread(
+        [blockLength, frozenBits, options](std::promise<factory_t> result) {
+            result.set_value(build(blockLength, frozenBits, options));
+        },
+        std::move(promise))
+        .detach();
+    return factory;
+}
+
+} // namespace Jit
+
+namespace {
+
+/*
+ * Check that a compiled decoder decides like Fast-SSC. Half of the probe
+ * frames are the all-zero code word, which belongs to every code, at an SNR
+ * where decoding often fails, the other half are pure noise.
+ */
+bool decidesLikeFastSsc(Decoder* compiled,
+                        size_t blockLength,
+                        const std::vector<unsigned>& frozenBits)
+{
+    const unsigned frames = 16;
+    const float sigma = 0.8f;
+    const size_t infoBytes = (blockLength - frozenBits.size() + 7) / 8;
+
+    FastSscAvxFloat reference(blockLength, frozenBits);
+    reference.setSystematic(false);
+    compiled->setSystematic(false);
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, sigma);
+    std::vector<float> llr(blockLength);
+    std::vector<unsigned char> expected(infoBytes), output(infoBytes);
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        const float signal = frame % 2 ? 0.0f : 1.0f;
+        for (float& value : llr) {
+            value = 2.0f * (signal + noise(generator)) / (sigma * sigma);
+        }
+        reference.decode_vector(llr.data(), expected.data());
+        compiled->decode_vector(llr.data(), output.data());
+        if (expected != output) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+JitDecoder::JitDecoder(size_t blockLength,
+                       const std::vector<unsigned>& frozenBits,
+                       const Jit::Options& options)
+    : mOptions(options), mActive(nullptr)
+{
+    mExternalContainers = true;
+    initialize(blockLength, frozenBits);
+}
+
+JitDecoder::~JitDecoder() {}
+
+void JitDecoder::initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    std::vector<unsigned> sortedBits(frozenBits.begin(), frozenBits.end());
+    std::sort(sortedBits.begin(), sortedBits.end());
+    if (mActive != nullptr && blockLength == mBlockLength && sortedBits == mFrozenBits) {
+        return;
+    }
+
+    mBlockLength = blockLength;
+    mFrozenBits = sortedBits;
+    mFallback = std::make_unique<FastSscAvxFloat>(mBlockLength, mFrozenBits);
+    mCompiled.reset();
+    useDecoder(mFallback.get());
+    mFactory = Jit::compile(mBlockLength, mFrozenBits, mOptions);
+}
+
+void JitDecoder::useDecoder(Decoder* decoder)
+{
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    mActive = decoder;
+    mLlrContainer = decoder->inputContainer();
+    mBitContainer = decoder->outputContainer();
+    mOutputContainer = decoder->packedOutput();
+}
+
+void JitDecoder::switchToCompiled()
+{
+    // Either way, there is nothing more to wait for
+    Jit::factory_t factory = mFactory.get();
+    mFactory = std::shared_future<Jit::factory_t>();
+    if (factory == nullptr) {
+        return;
+    }
+    mCompiled.reset(factory(mBlockLength, mFrozenBits.data(), mFrozenBits.size()));
+    if (!mCompiled || !decidesLikeFastSsc(mCompiled.get(), mBlockLength, mFrozenBits)) {
+        // Switching must not change the decisions within a stream
+        mCompiled.reset();
+        return;
+    }
+
+    // The current frame has already been handed to the fallback decoder
+    mCompiled->setSignal(dynamic_cast<FloatContainer*>(mLlrContainer)->data());
+    useDecoder(mCompiled.get());
+}
+
+bool JitDecoder::waitForCompilation()
+{
+    if (mFactory.valid()) {
+        switchToCompiled();
+    }
+    return isCompiled();
+}
+
+bool JitDecoder::decode()
+{
+    if (mFactory.valid() &&
+        mFactory.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        switchToCompiled();
+    }
+    bool result = mActive->decode();
+    mBitContainer = mActive->outputContainer();
+    mOutputContainer = mActive->packedOutput();
+    return result;
+}
+
+Decoder* JitDecoder::clone() const
+{
+    // The clone shares the compilation of this decoder
+    JitDecoder* decoder = new JitDecoder(mBlockLength, mFrozenBits, mOptions);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void JitDecoder::setSystematic(bool sys)
+{
+    mSystematic = sys;
+    mActive->setSystematic(sys);
+}
+
+void JitDecoder::setErrorDetection(ErrorDetection::Detector* pDetector)
+{
+    mErrorDetector = pDetector;
+    mActive->setErrorDetection(pDetector);
+}
+
+} // namespace Decoding
+} // namespace PolarCode
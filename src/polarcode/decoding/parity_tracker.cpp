@@ -0,0 +1,208 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/avxconvenience.h>
+#include <polarcode/decoding/parity_tracker.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace PolarCode {
+namespace Decoding {
+
+ParityTracker::ParityTracker()
+    : mWordCount(0),
+      mPosition(0),
+      mLeafLength(0),
+      mCheckBegin(0),
+      mCheckEnd(0)
+{
+}
+
+void ParityTracker::configure(size_t blockLength,
+                              const std::vector<unsigned>& frozenBits,
+                              size_t listSize,
+                              const std::vector<ErrorDetection::ParityCheck>& checks)
+{
+    std::vector<bool> frozen(blockLength, false);
+    for (unsigned bit : frozenBits) {
+        frozen[bit] = true;
+    }
+    mInfoCount.assign(blockLength + 1, 0);
+    mInfoPositions.clear();
+    for (unsigned i = 0; i < blockLength; ++i) {
+        mInfoCount[i + 1] = mInfoCount[i] + !frozen[i];
+        if (!frozen[i]) {
+            mInfoPositions.push_back(i);
+        }
+    }
+
+    mWordCount = (mInfoCount[blockLength] + 63) / 64;
+    mCheckMasks.assign(checks.size() * mWordCount, 0);
+    mCheckEnds.resize(checks.size());
+    for (unsigned i = 0; i < checks.size(); ++i) {
+        uint64_t* mask = mCheckMasks.data() + i * mWordCount;
+        mask[checks[i].position / 64] |= uint64_t(1) << (checks[i].position % 64);
+        for (unsigned position : checks[i].dependencies) {
+            mask[position / 64] |= uint64_t(1) << (position % 64);
+        }
+        mCheckEnds[i] = checks[i].position + 1;
+    }
+
+    mBits.assign(listSize * mWordCount, 0);
+    mNextBits.assign(listSize * mWordCount, 0);
+    mLeafBits.resize((blockLength + 63) / 64);
+}
+
+void ParityTracker::disable() { mCheckEnds.clear(); }
+
+bool ParityTracker::enabled() const { return !mCheckEnds.empty(); }
+
+void ParityTracker::reset()
+{
+    mPosition = 0;
+    mLeafLength = 0;
+    mCheckBegin = mCheckEnd = 0;
+    std::fill(mBits.begin(), mBits.begin() + mWordCount, 0);
+}
+
+bool ParityTracker::advance(unsigned blockLength)
+{
+    mPosition += mLeafLength;
+    mLeafLength = blockLength;
+
+    const unsigned infoEnd = mInfoCount[mPosition + blockLength];
+    mCheckBegin = mCheckEnd;
+    if (mCheckBegin == mCheckEnds.size()) {
+        return false; // All checks are done
+    }
+    while (mCheckEnd < mCheckEnds.size() && mCheckEnds[mCheckEnd] <= infoEnd) {
+        ++mCheckEnd;
+    }
+    return infoEnd != mInfoCount[mPosition];
+}
+
+void ParityTracker::record(unsigned path)
+{
+    // The polar transform is its own inverse. Bit i of the leaf is stored in
+    // bit i % 64 of word i / 64.
+    static const uint64_t lowerHalf[] = {
+        0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+        0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL
+    };
+    uint64_t* u = mLeafBits.data();
+    const unsigned wordCount = (mLeafLength + 63) / 64;
+    for (unsigned half = 1, level = 0; half < std::min(mLeafLength, 64U); half *= 2) {
+        for (unsigned word = 0; word < wordCount; ++word) {
+            u[word] ^= (u[word] >> half) & lowerHalf[level];
+        }
+        ++level;
+    }
+    for (unsigned half = 1; half < wordCount; half *= 2) {
+        for (unsigned i = 0; i < wordCount; i += 2 * half) {
+            for (unsigned j = i; j < i + half; ++j) {
+                u[j] ^= u[j + half];
+            }
+        }
+    }
+
+    uint64_t* words = mBits.data() + path * mWordCount;
+    const unsigned infoEnd = mInfoCount[mPosition + mLeafLength];
+    for (unsigned index = mInfoCount[mPosition]; index < infoEnd; ++index) {
+        const unsigned bit = mInfoPositions[index] - mPosition;
+        const uint64_t mask = uint64_t(1) << (index % 64);
+        uint64_t& word = words[index / 64];
+        word = (u[bit / 64] >> (bit % 64) & 1) ? word | mask : word & ~mask;
+    }
+}
+
+void ParityTracker::insert(unsigned path, const float* bits)
+{
+    uint64_t* u = mLeafBits.data();
+    for (unsigned i = 0; i < mLeafLength; i += 8) {
+        const uint64_t signs = _mm256_movemask_ps(_mm256_load_ps(bits + i));
+        if (i % 64 == 0) {
+            u[i / 64] = 0;
+        }
+        u[i / 64] |= signs << (i % 64);
+    }
+    if (mLeafLength < 8) {
+        u[0] &= (uint64_t(1) << mLeafLength) - 1;
+    }
+    record(path);
+}
+
+void ParityTracker::insert(unsigned path, const char* bits)
+{
+    uint64_t* u = mLeafBits.data();
+    for (unsigned i = 0; i < mLeafLength; i += 32) {
+        const __m256i signBytes =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(bits + i));
+        const uint64_t signs = static_cast<uint32_t>(_mm256_movemask_epi8(signBytes));
+        if (i % 64 == 0) {
+            u[i / 64] = 0;
+        }
+        u[i / 64] |= signs << (i % 64);
+    }
+    if (mLeafLength < 32) {
+        u[0] &= (uint64_t(1) << mLeafLength) - 1;
+    }
+    record(path);
+}
+
+void ParityTracker::insertPacked(unsigned path, const uint8_t* bits)
+{
+    uint64_t* u = mLeafBits.data();
+    for (unsigned i = 0; i < mLeafLength; i += 8) {
+        if (i % 64 == 0) {
+            u[i / 64] = 0;
+        }
+        u[i / 64] |= uint64_t(bits[i / 8]) << (i % 64);
+    }
+    if (mLeafLength < 8) {
+        u[0] &= (uint64_t(1) << mLeafLength) - 1;
+    }
+    record(path);
+}
+
+bool ParityTracker::checksPending() const { return mCheckBegin != mCheckEnd; }
+
+bool ParityTracker::passes(unsigned path) const
+{
+    const uint64_t* words = mBits.data() + path * mWordCount;
+    for (unsigned check = mCheckBegin; check < mCheckEnd; ++check) {
+        const uint64_t* mask = mCheckMasks.data() + check * mWordCount;
+        unsigned parity = 0;
+        for (unsigned word = 0; word < mWordCount; ++word) {
+            parity ^= __builtin_popcountll(words[word] & mask[word]);
+        }
+        if (parity & 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ParityTracker::duplicatePath(unsigned destination, unsigned source)
+{
+    memcpy(mNextBits.data() + destination * mWordCount,
+           mBits.data() + source * mWordCount,
+           mWordCount * sizeof(uint64_t));
+}
+
+void ParityTracker::swapPaths(unsigned first, unsigned second)
+{
+    std::swap_ranges(mBits.begin() + first * mWordCount,
+                     mBits.begin() + (first + 1) * mWordCount,
+                     mBits.begin() + second * mWordCount);
+}
+
+void ParityTracker::switchToNext() { std::swap(mBits, mNextBits); }
+
+} // namespace Decoding
+} // namespace PolarCode
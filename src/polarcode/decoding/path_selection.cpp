@@ -0,0 +1,233 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/arrayfuncs.h>
+#include <polarcode/avxconvenience.h>
+#include <polarcode/decoding/path_selection.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace {
+
+/*!
+ * \brief Count the keys greater than _threshold_.
+ */
+unsigned countGreater(const int32_t* keys, unsigned paddedSize, int32_t threshold)
+{
+    const __m256i vThreshold = _mm256_set1_epi32(threshold);
+    unsigned count = 0;
+    for (unsigned i = 0; i < paddedSize; i += 8) {
+        __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i gt = _mm256_cmpgt_epi32(key, vThreshold);
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(gt)));
+    }
+    return count;
+}
+
+} // namespace
+
+PathSelector::PathSelector(PathSelectionMode mode) : mMode(mode) {}
+
+void PathSelector::setMode(PathSelectionMode mode) { mMode = mode; }
+
+PathSelectionMode PathSelector::mode() const { return mMode; }
+
+void PathSelector::prepare(unsigned size)
+{
+    const unsigned paddedSize = (size + 7) & ~7U;
+    if (mKeys.size() < paddedSize) {
+        mKeys.resize(paddedSize);
+        mSelectedKeys.resize(paddedSize);
+        mSelected.resize(paddedSize);
+        mOrder.resize(paddedSize);
+    }
+
+    // Padding is lower than any key and thus never selected
+    for (unsigned i = size; i < paddedSize; ++i) {
+        mKeys[i] = INT_MIN;
+    }
+}
+
+void PathSelector::selectKeys(unsigned n, unsigned size)
+{
+    const unsigned paddedSize = (size + 7) & ~7U;
+    const int32_t* keys = mKeys.data();
+
+    if (n < size) {
+        // Binary search for the key of the n-th best candidate
+        int64_t lo = *std::min_element(keys, keys + size);
+        int64_t hi = *std::max_element(keys, keys + size);
+        while (lo < hi) {
+            int64_t mid = lo + (hi - lo + 1) / 2;
+            unsigned count = countGreater(keys, paddedSize, mid - 1);
+            if (count >= n) {
+                lo = mid;
+                if (count == n) {
+                    break;
+                }
+            } else {
+                hi = mid - 1;
+            }
+        }
+        const int32_t threshold = lo;
+
+        // Take all keys above the threshold and the first ones equal to it
+        const __m256i vThreshold = _mm256_set1_epi32(threshold);
+        unsigned quota = n - countGreater(keys, paddedSize, threshold);
+        unsigned selected = 0;
+        for (unsigned i = 0; i < paddedSize; i += 8) {
+            __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+            unsigned gt = _mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpgt_epi32(key, vThreshold)));
+            unsigned eq = _mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpeq_epi32(key, vThreshold)));
+            unsigned mask = gt | eq;
+            while (mask) {
+                unsigned bit = __builtin_ctz(mask);
+                mask &= mask - 1;
+                if (!(gt >> bit & 1)) {
+                    if (quota == 0) {
+                        continue;
+                    }
+                    --quota;
+                }
+                mSelected[selected] = i + bit;
+                mSelectedKeys[selected] = keys[i + bit];
+                ++selected;
+            }
+        }
+    } else {
+        for (unsigned i = 0; i < size; ++i) {
+            mSelected[i] = i;
+            mSelectedKeys[i] = keys[i];
+        }
+    }
+
+    const unsigned paddedCount = (n + 7) & ~7U;
+    for (unsigned i = n; i < paddedCount; ++i) {
+        mSelectedKeys[i] = INT_MIN;
+    }
+
+    // Rank of a candidate: Number of better ones plus number of equal ones
+    // in front of it, which keeps the sort stable.
+    const int32_t* selectedKeys = mSelectedKeys.data();
+    for (unsigned i = 0; i < n; ++i) {
+        const __m256i key = _mm256_set1_epi32(selectedKeys[i]);
+        unsigned rank = 0;
+        for (unsigned j = 0; j < paddedCount; j += 8) {
+            __m256i other =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(selectedKeys + j));
+            unsigned gt = _mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpgt_epi32(other, key)));
+            unsigned eq = _mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpeq_epi32(other, key)));
+            if (j + 8 > i) {
+                eq &= j >= i ? 0 : (1U << (i - j)) - 1;
+            }
+            rank += __builtin_popcount(gt) + __builtin_popcount(eq);
+        }
+        mOrder[rank] = mSelected[i];
+    }
+}
+
+void PathSelector::select(std::vector<unsigned>& Indices,
+                          std::vector<float>& Values,
+                          unsigned n,
+                          unsigned size)
+{
+    select(Indices.data(), Values.data(), n, size);
+}
+
+void PathSelector::select(unsigned* Indices, float* Values, unsigned n, unsigned size)
+{
+    if (mMode == tSelectionSort || size < 2) {
+        for (unsigned i = 0; i < size; ++i) {
+            Indices[i] = i;
+        }
+        const unsigned lim = std::min(size - 1, n);
+        for (unsigned i = 0; i < lim; ++i) {
+            unsigned index = i;
+            for (unsigned j = i + 1; j < size; ++j) {
+                if (Values[j] > Values[index]) {
+                    index = j;
+                }
+            }
+            std::swap(Values[i], Values[index]);
+            std::swap(Indices[i], Indices[index]);
+        }
+        return;
+    }
+
+    n = std::min(n, size);
+    prepare(size);
+
+    // Flip the magnitude bits of negative floats for an integer ordering
+    const float* values = Values;
+    unsigned i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(values + i));
+        __m256i flip = _mm256_srli_epi32(_mm256_srai_epi32(bits, 31), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(mKeys.data() + i),
+                            _mm256_xor_si256(bits, flip));
+    }
+    for (; i < size; ++i) {
+        int32_t bits;
+        memcpy(&bits, values + i, sizeof(bits));
+        mKeys[i] = bits ^ ((bits >> 31) & INT_MAX);
+    }
+
+    selectKeys(n, size);
+
+    mFloatTemp.resize(n);
+    for (unsigned r = 0; r < n; ++r) {
+        mFloatTemp[r] = Values[mOrder[r]];
+    }
+    for (unsigned r = 0; r < n; ++r) {
+        Indices[r] = mOrder[r];
+        Values[r] = mFloatTemp[r];
+    }
+}
+
+void PathSelector::select(std::vector<unsigned>& Indices,
+                          std::vector<long>& Values,
+                          unsigned n,
+                          unsigned size)
+{
+    if (mMode == tSelectionSort || size < 2) {
+        simplePartialSortDescending(Indices, Values, n, size);
+        return;
+    }
+
+    n = std::min(n, size);
+    prepare(size);
+
+    // Distances to the best metric, saturated to the key range
+    const long best = *std::max_element(Values.begin(), Values.begin() + size);
+    for (unsigned i = 0; i < size; ++i) {
+        mKeys[i] = std::max(Values[i] - best, -long(INT_MAX));
+    }
+
+    selectKeys(n, size);
+
+    mLongTemp.resize(n);
+    for (unsigned r = 0; r < n; ++r) {
+        mLongTemp[r] = Values[mOrder[r]];
+    }
+    for (unsigned r = 0; r < n; ++r) {
+        Indices[r] = mOrder[r];
+        Values[r] = mLongTemp[r];
+    }
+}
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -8,23 +8,147 @@
 
 #include <polarcode/decoding/scan.h>
 #include <polarcode/decoding/templatized_float.h>
+#include <algorithm>
 #include <cmath>
-//#define SCAN_DEBUG_OUTPUT
+#include <cstring>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
 
+namespace {
+
+/*
+ * A node of size 2*M with the LLRs L passes on to its children:
+ *
+ *   left:  L_l[k] = f(L[k], L[k+M] + B_r[k])
+ *   right: L_r[k] = L[k+M] + f(L[k], B_l[k])
+ *
+ * and receives from them:
+ *
+ *   B[k]   = f(B_l[k], B_r[k] + L[k+M])
+ *   B[k+M] = B_r[k] + f(B_l[k], L[k])
+ *
+ * Groups of at least eight values are aligned to 32 bytes.
+ */
+
+// Scalar f for the short groups near the leaves, which keeps the sign bit of zero
+inline float minSum(float a, float b)
+{
+    float magnitude = std::min(std::fabs(a), std::fabs(b));
+    return std::signbit(a) != std::signbit(b) ? -magnitude : magnitude;
+}
+
+void calcLeftLlr(float* out, const float* llr, const float* odd, unsigned size)
+{
+    if (size < 8) {
+        for (unsigned k = 0; k < size; ++k) {
+            out[k] = minSum(llr[k], llr[k + size] + odd[k]);
+        }
+        return;
+    }
+    for (unsigned k = 0; k < size; k += 8) {
+        __m256 upper = _mm256_load_ps(llr + k);
+        __m256 lower =
+            _mm256_add_ps(_mm256_load_ps(llr + k + size), _mm256_load_ps(odd + k));
+        TemplatizedFloatCalc::F_function_calc(upper, lower, out + k);
+    }
+}
+
+void calcRightLlr(float* out, const float* llr, const float* even, unsigned size)
+{
+    if (size < 8) {
+        for (unsigned k = 0; k < size; ++k) {
+            out[k] = llr[k + size] + minSum(llr[k], even[k]);
+        }
+        return;
+    }
+    for (unsigned k = 0; k < size; k += 8) {
+        __m256 upper = _mm256_load_ps(llr + k);
+        __m256 bits = _mm256_load_ps(even + k);
+        TemplatizedFloatCalc::F_function_calc(upper, bits, out + k);
+        _mm256_store_ps(out + k,
+                        _mm256_add_ps(_mm256_load_ps(llr + k + size),
+                                      _mm256_load_ps(out + k)));
+    }
+}
+
+void calcBits(float* out,
+              const float* llr,
+              const float* even,
+              const float* odd,
+              unsigned size)
+{
+    if (size < 8) {
+        for (unsigned k = 0; k < size; ++k) {
+            out[k] = minSum(even[k], odd[k] + llr[k + size]);
+            out[k + size] = odd[k] + minSum(even[k], llr[k]);
+        }
+        return;
+    }
+    for (unsigned k = 0; k < size; k += 8) {
+        __m256 bits = _mm256_load_ps(even + k);
+        __m256 oddBits = _mm256_load_ps(odd + k);
+        __m256 lower = _mm256_add_ps(oddBits, _mm256_load_ps(llr + k + size));
+        __m256 upper = _mm256_load_ps(llr + k);
+        TemplatizedFloatCalc::F_function_calc(bits, lower, out + k);
+        TemplatizedFloatCalc::F_function_calc(bits, upper, out + k + size);
+        _mm256_store_ps(out + k + size,
+                        _mm256_add_ps(oddBits, _mm256_load_ps(out + k + size)));
+    }
+}
+
+inline unsigned trailingZeros(unsigned v)
+{
+    unsigned count = 0;
+    while ((v & 1) == 0) {
+        v >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
 Scan::Scan(size_t blockLength,
            unsigned iterationLimit,
            const std::vector<unsigned>& frozenBits)
+    : mDataPool(nullptr),
+      mLlr(nullptr),
+      mEven(nullptr),
+      mOdd(nullptr),
+      mInfoLlr(nullptr),
+      mIterationCount(0)
 {
     initialize(blockLength, iterationLimit, frozenBits);
 }
 
-Scan::~Scan() {}
+Scan::~Scan() { clear(); }
+
+void Scan::clear()
+{
+    if (mDataPool == nullptr) {
+        return;
+    }
+    mDataPool->release(mLlr);
+    mDataPool->release(mEven);
+    mDataPool->release(mOdd);
+    mDataPool->release(mInfoLlr);
+    delete mDataPool;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mDataPool = nullptr;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+}
 
 void Scan::setIterationLimit(unsigned iterationLimit)
 {
+    if (iterationLimit == 0) {
+        throw std::invalid_argument("Scan: At least one iteration is needed!");
+    }
     mIterationLimit = iterationLimit;
 }
 
@@ -32,275 +156,156 @@ void Scan::initialize(size_t blockLength,
                       unsigned iterationLimit,
                       const std::vector<unsigned>& frozenBits)
 {
+    setIterationLimit(iterationLimit);
+    if (mDataPool != nullptr && blockLength == mBlockLength &&
+        frozenBits == mFrozenBits) {
+        return;
+    }
+    if (blockLength < 2) {
+        throw std::invalid_argument("Scan: Minimum block length is 2!");
+    }
+    clear();
+
     mBlockLength = blockLength;
     mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
-    mIterationLimit = iterationLimit;
 
     mN = log2(blockLength);
     mLevelCount = mN + 1;
 
-    {
-        mBooleanFrozen.resize(mBlockLength);
-        unsigned idx = 0;
-        for (unsigned i = 0; i < mBlockLength; ++i) {
-            if (i == mFrozenBits[idx]) {
-                mBooleanFrozen[i] = true;
-                ++idx;
-            } else {
-                mBooleanFrozen[i] = false;
-            }
-        }
+    mBooleanFrozen.assign(mBlockLength, false);
+    for (unsigned bit : mFrozenBits) {
+        mBooleanFrozen[bit] = true;
+    }
+
+    mDataPool = new ScanObjects::datapool_t();
+    mLlr = mDataPool->allocate(2 * mBlockLength);
+    mEven = mDataPool->allocate(2 * mBlockLength);
+    mOdd = mDataPool->allocate(mN * mBlockLength / 2);
+    mInfoLlr = mDataPool->allocate(mBlockLength);
+
+    // The B messages of the odd leaves are fixed
+    float* oddLeaves = odd(mN, 1);
+    for (unsigned group = 1; group < mBlockLength; group += 2) {
+        oddLeaves[group / 2] = mBooleanFrozen[group] ? INFINITY : 0.0f;
     }
 
-    mLlrContainer = new FloatContainer(mBlockLength, mFrozenBits);
+    // The channel LLRs are the L messages of the root
+    mLlrContainer = new FloatContainer(llr(0), mBlockLength);
     mBitContainer = new FloatContainer(mBlockLength, mFrozenBits);
+    mLlrContainer->setFrozenBits(mFrozenBits);
     mOutputContainer = new unsigned char[(mBlockLength + 7) / 8];
-
-    mSystematicOutput.resize(mBlockLength);
-    mLlr.resize(2 * mBlockLength - 1);
-    mEven.resize(2 * mBlockLength - 1);
-    mOdd.resize(mLevelCount * mBlockLength / 2);
 }
 
-static inline unsigned evenIndex(unsigned n, unsigned level, unsigned bit)
+inline float* Scan::llr(unsigned level)
 {
-    return bit + (1 << (n + 1)) - (1 << (n + 1 - level));
+    return mLlr->data + 2 * mBlockLength - (2 << (mN - level));
 }
 
-static inline unsigned oddIndex(unsigned n, unsigned level, unsigned group, unsigned bit)
+inline float* Scan::even(unsigned level)
 {
-    if (level == n) {
-        // Left shift by -1 is invalid. Instead, do the correct right shift.
-        return bit + (group >> 1) + ((level - 1) << (n - 1));
-    } else {
-        return bit + ((group - 1) << (n - 1 - level)) + ((level - 1) << (n - 1));
-    }
+    return mEven->data + 2 * mBlockLength - (2 << (mN - level));
 }
 
-void Scan::updatellrmap(unsigned level, unsigned group)
+inline float* Scan::odd(unsigned level, unsigned group)
 {
-    if (level == 0)
-        return;
-    unsigned leftGroup = group / 2;
-    if ((group & 1) == 0) {
-        updatellrmap(level - 1, leftGroup);
-    }
-    unsigned groupSize = 1 << (mN - level);
-
-    if (group & 1) {
-        for (unsigned node = 0; node < groupSize; ++node) {
-            mLlr[evenIndex(mN, level, node)] =
-                mLlr[evenIndex(mN, level - 1, 2 * node + 1)] +
-                TemplatizedFloatCalc::F_function_calc(
-                    mLlr[evenIndex(mN, level - 1, 2 * node)],
-                    mEven[evenIndex(mN, level, node)]);
-#ifdef SCAN_DEBUG_OUTPUT
-            std::cout << "L(" << level << "," << node << ") = "
-                      << "L(" << (level - 1) << "," << (2 * node + 1) << ") + "
-                      << "L(" << (level - 1) << "," << (2 * node) << ") BP "
-                      << "E(" << level << "," << node
-                      << "): " << mLlr[evenIndex(mN, level, node)] << " = "
-                      << mLlr[evenIndex(mN, level - 1, 2 * node + 1)] << " + "
-                      << mLlr[evenIndex(mN, level - 1, 2 * node)] << " BP "
-                      << mEven[evenIndex(mN, level, node)] << std::endl;
-#endif
-        }
-    } else {
-        for (unsigned node = 0; node < groupSize; ++node) {
-            float t = mLlr[evenIndex(mN, level - 1, 2 * node + 1)] +
-                      mOdd[oddIndex(mN, level, group + 1, node)];
-            mLlr[evenIndex(mN, level, node)] = TemplatizedFloatCalc::F_function_calc(
-                mLlr[evenIndex(mN, level - 1, 2 * node)], t);
-#ifdef SCAN_DEBUG_OUTPUT
-            std::cout << "L(" << level << "," << node << ") = "
-                      << "L(" << (level - 1) << "," << (2 * node) << ") BP ["
-                      << "L(" << (level - 1) << "," << (2 * node + 1) << ") + "
-                      << "O(" << level << "," << (group + 1) << "," << node
-                      << ")]: " << mLlr[evenIndex(mN, level, node)] << " = "
-                      << mLlr[evenIndex(mN, level - 1, 2 * node)] << " BP ["
-                      << mLlr[evenIndex(mN, level - 1, 2 * node + 1)] << " + "
-                      << mOdd[oddIndex(mN, level, group + 1, node)] << "]" << std::endl;
-#endif
-        }
-    }
+    return mOdd->data + (level - 1) * mBlockLength / 2 + ((group / 2) << (mN - level));
 }
 
-void Scan::updatebitmap(unsigned level, unsigned group)
+void Scan::updatellrmap(unsigned group)
 {
-    if (group & 1) {
-        unsigned leftGroup = group / 2;
+    // Only the levels below the last right turn see new B messages
+    unsigned level = group == 0 ? 1 : mN - trailingZeros(group);
+    for (; level <= mN; ++level) {
+        unsigned node = group >> (mN - level);
         unsigned groupSize = 1 << (mN - level);
-        if (leftGroup & 1) {
-            for (unsigned node = 0; node < groupSize; ++node) {
-                float t = mOdd[oddIndex(mN, level, group, node)] +
-                          mLlr[evenIndex(mN, level - 1, 2 * node + 1)];
-                mOdd[oddIndex(mN, level - 1, leftGroup, 2 * node)] =
-                    TemplatizedFloatCalc::F_function_calc(
-                        mEven[evenIndex(mN, level, node)], t);
-#ifdef SCAN_DEBUG_OUTPUT
-                std::cout << "O(" << (level - 1) << "," << leftGroup << "," << (2 * node)
-                          << ") = "
-                          << "E(" << level << "," << node << ") BP ["
-                          << "O(" << level << "," << group << "," << node << ") + "
-                          << "L(" << (level - 1) << "," << (2 * node + 1)
-                          << ")]: " << mOdd[oddIndex(mN, level - 1, leftGroup, 2 * node)]
-                          << " = " << mEven[evenIndex(mN, level, node)] << " BP ["
-                          << mOdd[oddIndex(mN, level, group, node)] << " + "
-                          << mLlr[evenIndex(mN, level - 1, 2 * node + 1)] << "]"
-                          << std::endl;
-#endif
-
-                mOdd[oddIndex(mN, level - 1, leftGroup, 2 * node + 1)] =
-                    mOdd[oddIndex(mN, level, group, node)] +
-                    TemplatizedFloatCalc::F_function_calc(
-                        mEven[evenIndex(mN, level, node)],
-                        mLlr[evenIndex(mN, level - 1, 2 * node)]);
-#ifdef SCAN_DEBUG_OUTPUT
-                std::cout << "O(" << (level - 1) << "," << leftGroup << ","
-                          << (2 * node + 1) << ") = "
-                          << "O(" << level << "," << group << "," << node << ") + "
-                          << "E(" << level << "," << node << ") BP "
-                          << "L(" << (level - 1) << "," << (2 * node) << "): "
-                          << mOdd[oddIndex(mN, level - 1, leftGroup, 2 * node + 1)]
-                          << " = " << mOdd[oddIndex(mN, level, group, node)] << " + "
-                          << mEven[evenIndex(mN, level, node)] << " BP "
-                          << mLlr[evenIndex(mN, level - 1, 2 * node)] << std::endl;
-#endif
-            }
+        if (node & 1) {
+            calcRightLlr(llr(level), llr(level - 1), even(level), groupSize);
         } else {
-            for (unsigned node = 0; node < groupSize; ++node) {
-                float t = mOdd[oddIndex(mN, level, group, node)] +
-                          mLlr[evenIndex(mN, level - 1, 2 * node + 1)];
-                mEven[evenIndex(mN, level - 1, 2 * node)] =
-                    TemplatizedFloatCalc::F_function_calc(
-                        mEven[evenIndex(mN, level, node)], t);
-#ifdef SCAN_DEBUG_OUTPUT
-                std::cout << "E(" << (level - 1) << "," << (2 * node) << ") = "
-                          << "E(" << level << "," << node << ") BP ["
-                          << "O(" << level << "," << group << "," << node << ") + "
-                          << "L(" << (level - 1) << "," << (2 * node + 1)
-                          << ")]: " << mEven[evenIndex(mN, level - 1, 2 * node)] << " = "
-                          << mEven[evenIndex(mN, level, node)] << " BP ["
-                          << mOdd[oddIndex(mN, level, group, node)] << " + "
-                          << mLlr[evenIndex(mN, level - 1, 2 * node + 1)] << "]"
-                          << std::endl;
-#endif
-
-                mEven[evenIndex(mN, level - 1, 2 * node + 1)] =
-                    mOdd[oddIndex(mN, level, group, node)] +
-                    TemplatizedFloatCalc::F_function_calc(
-                        mEven[evenIndex(mN, level, node)],
-                        mLlr[evenIndex(mN, level - 1, 2 * node)]);
-#ifdef SCAN_DEBUG_OUTPUT
-                std::cout << "E(" << (level - 1) << "," << (2 * node + 1) << ") = "
-                          << "O(" << level << "," << group << "," << node << ") + "
-                          << "E(" << level << "," << node << ") BP "
-                          << "L(" << (level - 1) << "," << (2 * node)
-                          << "): " << mEven[evenIndex(mN, level - 1, 2 * node + 1)]
-                          << " = " << mOdd[oddIndex(mN, level, group, node)] << " + "
-                          << mEven[evenIndex(mN, level, node)] << " BP "
-                          << mLlr[evenIndex(mN, level - 1, 2 * node)] << std::endl;
-#endif
-            }
-        }
-        if (leftGroup & 1) {
-            updatebitmap(level - 1, leftGroup);
+            calcLeftLlr(llr(level), llr(level - 1), odd(level, node + 1), groupSize);
         }
     }
 }
 
-inline unsigned int bit_reverse(unsigned int v, unsigned int nbits)
+void Scan::updatebitmap(unsigned group)
 {
-    v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
-    v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
-    v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
-    v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
-    v = (v >> 16) | (v << 16);
-    v >>= (32 - nbits);
-    return v;
+    // Combine the B messages of all nodes completed by this odd leaf
+    for (unsigned level = mN; group & 1; --level) {
+        unsigned leftGroup = group / 2;
+        float* out = (leftGroup & 1) ? odd(level - 1, leftGroup) : even(level - 1);
+        calcBits(out,
+                 llr(level - 1),
+                 even(level),
+                 odd(level, group),
+                 1 << (mN - level));
+        group = leftGroup;
+    }
 }
 
-bool Scan::decode()
+void Scan::iterate()
 {
-    mLlr.assign(mLlr.size(), 0.0f);
-    mEven.assign(mEven.size(), 0.0f);
-    mOdd.assign(mOdd.size(), 0.0f);
-
-    float* channelLlr = dynamic_cast<FloatContainer*>(mLlrContainer)->data();
-    // L(0,0,i) LLRs from channel
-    for (unsigned i = 0; i < mBlockLength; ++i) {
-        mLlr[evenIndex(mN, 0, bit_reverse(i, mN))] = channelLlr[i];
-    }
-
-    for (unsigned i = 1; i < mBlockLength; i += 2) {
-        if (mBooleanFrozen[i]) {
-#ifdef SCAN_DEBUG_OUTPUT
-            std::cout << "O(" << mN << "," << i << ",0) = inf" << std::endl;
-#endif
-            mOdd[oddIndex(mN, mN, i, 0)] = INFINITY;
-        }
-    }
+    float* leaf = llr(mN);
+    float* evenLeaf = even(mN);
+    float* oddLeaves = odd(mN, 1);
+    float* infoLlr = mInfoLlr->data;
 
-    // Decoding
-    for (unsigned i = 0; i < mIterationLimit; ++i) {
-#ifdef SCAN_DEBUG_OUTPUT
-        std::cout << "Iteration " << i << std::endl;
-#endif
-        for (unsigned group = 0; group < mBlockLength; ++group) {
-#ifdef SCAN_DEBUG_OUTPUT
-            std::cout << "Group " << group << std::endl;
-#endif
-            updatellrmap(mN, group);
-            mSystematicOutput[group] = mLlr[evenIndex(mN, mN, 0)];
-            if (group & 1) {
-                mSystematicOutput[group] += mOdd[oddIndex(mN, mN, group, 0)];
-                updatebitmap(mN, group);
-            } else {
-                if (mBooleanFrozen[group]) {
-                    mEven[evenIndex(mN, mN, 0)] = INFINITY;
-#ifdef SCAN_DEBUG_OUTPUT
-                    std::cout << "E(" << mN << ",0) = inf" << std::endl;
-#endif
-                } else {
-                    mEven[evenIndex(mN, mN, 0)] = 0.0f;
-#ifdef SCAN_DEBUG_OUTPUT
-                    std::cout << "E(" << mN << ",0) = 0" << std::endl;
-#endif
-                }
-                mSystematicOutput[group] += mEven[evenIndex(mN, mN, 0)];
-            }
+    for (unsigned group = 0; group < mBlockLength; ++group) {
+        updatellrmap(group);
+        if (group & 1) {
+            infoLlr[group] = leaf[0] + oddLeaves[group / 2];
+            updatebitmap(group);
+        } else {
+            evenLeaf[0] = mBooleanFrozen[group] ? INFINITY : 0.0f;
+            infoLlr[group] = leaf[0] + evenLeaf[0];
         }
     }
+}
 
+bool Scan::evaluateOutput()
+{
     float* outputLlr = dynamic_cast<FloatContainer*>(mBitContainer)->data();
 
     if (mSystematic) {
         // apply extrinsic LLRs
+        const float* channelLlr = llr(0);
+        const float* extrinsicLlr = even(0);
         for (unsigned i = 0; i < mBlockLength; i++) {
-            unsigned idx = evenIndex(mN, 0, i);
-            mLlr[idx] += mEven[idx];
-        }
-
-        for (unsigned i = 0; i < mBlockLength; i++) {
-            outputLlr[i] = mLlr[evenIndex(mN, 0, bit_reverse(i, mN))];
+            outputLlr[i] = channelLlr[i] + extrinsicLlr[i];
         }
     } else {
-        for (unsigned i = 0; i < mBlockLength; i++) {
-            outputLlr[i] = mSystematicOutput[bit_reverse(i, mN)];
-        }
+        memcpy(outputLlr, mInfoLlr->data, mBlockLength * sizeof(float));
     }
 
     mBitContainer->getPackedInformationBits(mOutputContainer);
-    bool result = mErrorDetector->check(mOutputContainer,
-                                        (mBlockLength - mFrozenBits.size() + 7) / 8);
+    return mErrorDetector->check(mOutputContainer,
+                                 (mBlockLength - mFrozenBits.size() + 7) / 8);
+}
+
+bool Scan::decode()
+{
+    // The B messages of the inner odd nodes start unknown
+    memset(mOdd->data, 0, (mN - 1) * mBlockLength / 2 * sizeof(float));
+
+    // Without a real error detector, every output would pass the check
+    const bool earlyStopping = mErrorDetector->getCheckBitCount() > 0;
+    bool result = false;
+
+    mIterationCount = 0;
+    while (mIterationCount < mIterationLimit) {
+        iterate();
+        ++mIterationCount;
+        if (earlyStopping || mIterationCount == mIterationLimit) {
+            result = evaluateOutput();
+            if (result) {
+                break;
+            }
+        }
+    }
     return result;
 }
 
 void Scan::getExtrinsicChannelInformation(float* eLlr)
 {
-    for (unsigned i = 0; i < mBlockLength; i++) {
-        eLlr[i] = mEven[evenIndex(mN, 0, bit_reverse(i, mN))];
-    }
+    memcpy(eLlr, even(0), mBlockLength * sizeof(float));
 }
 
 } // namespace Decoding
@@ -9,30 +9,52 @@
 #include <polarcode/arrayfuncs.h>
 #include <polarcode/decoding/scl_avx_float.h>
 #include <polarcode/polarcode.h>
+#include <algorithm>
+#include <map>
 #include <cmath>
+#include <cstring>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
 
 namespace SclAvx {
 
-PathList::PathList() {}
+/*
+ * Gather the decisions of one path from the rows of an interleaved stage.
+ */
+inline unsigned packInterleaved(const float* rows,
+                                unsigned rowCount,
+                                unsigned laneCount,
+                                unsigned path)
+{
+    unsigned packed = 0;
+    for (unsigned i = 0; i < rowCount; ++i) {
+        packed |= std::signbit(rows[i * laneCount + path]) << i;
+    }
+    return packed;
+}
+
+PathList::PathList() : mPathCount(0), mInterleavedStages(0), xmTeam(nullptr) {}
 
 PathList::PathList(size_t listSize, size_t stageCount, datapool_t* dataPool)
     : mPathLimit(listSize),
       mPathCount(0),
       mNextPathCount(0),
       mStageCount(stageCount),
-      xmDataPool(dataPool)
+      xmDataPool(dataPool),
+      mInterleavedStages(std::min<unsigned>(3, stageCount - 1)),
+      mLaneCount(nBit2fCount(listSize)),
+      xmTeam(nullptr)
 {
     mLlrTree.resize(listSize);
     mBitTree.resize(listSize);
     mLeftBitTree.resize(listSize);
-    mMetric.assign(listSize, 0);
+    mMetric.assign(mLaneCount, 0);
     mNextLlrTree.resize(listSize);
     mNextBitTree.resize(listSize);
     mNextLeftBitTree.resize(listSize);
-    mNextMetric.assign(listSize, 0);
+    mNextMetric.assign(mLaneCount, 0);
     for (unsigned i = 0; i < mPathLimit; ++i) {
         mLlrTree[i].resize(stageCount);
         mBitTree[i].resize(stageCount);
@@ -41,27 +63,50 @@ PathList::PathList(size_t listSize, size_t stageCount, datapool_t* dataPool)
         mNextBitTree[i].resize(stageCount);
         mNextLeftBitTree[i].resize(stageCount);
     }
+
+    for (unsigned stage = 0; stage < mInterleavedStages; ++stage) {
+        for (auto* rows : { &mInterleavedLlr, &mInterleavedBit, &mInterleavedLeftBit }) {
+            block_t* block = xmDataPool->allocate(mLaneCount << stage);
+            mInterleavedBlocks.push_back(block);
+            rows->push_back(block->data);
+        }
+    }
+    mInterleavedBlocks.push_back(xmDataPool->allocate(mLaneCount));
+    mPermuted = mInterleavedBlocks.back()->data;
+    mSourcePath.assign(mLaneCount, 0);
+    mPermutationStage = mInterleavedStages;
 }
 
-PathList::~PathList() { clear(); }
+PathList::~PathList()
+{
+    clear();
+    for (block_t* block : mInterleavedBlocks) {
+        xmDataPool->release(block);
+    }
+}
 
 void PathList::clear()
 {
     for (unsigned path = 0; path < mPathCount; ++path) {
         xmDataPool->release(mLlrTree[path][mStageCount - 1]);
-        xmDataPool->release(mBitTree[path][mStageCount - 1]);
-        xmDataPool->release(mLeftBitTree[path][mStageCount - 1]);
+        mBitPool.release(mBitTree[path][mStageCount - 1]);
+        mBitPool.release(mLeftBitTree[path][mStageCount - 1]);
     }
     mPathCount = 0;
 }
 
 void PathList::duplicatePath(unsigned destination, unsigned source, unsigned stage)
 {
-    for (unsigned i = stage; i < mStageCount; ++i) {
+    mSourcePath[destination] = source;
+    mPermutationStage = stage;
+    for (unsigned i = std::max(stage, mInterleavedStages); i < mStageCount; ++i) {
         mNextLlrTree[destination][i] = xmDataPool->lazyDuplicate(mLlrTree[source][i]);
-        mNextBitTree[destination][i] = xmDataPool->lazyDuplicate(mBitTree[source][i]);
+        mNextBitTree[destination][i] = mBitPool.lazyDuplicate(mBitTree[source][i]);
         mNextLeftBitTree[destination][i] =
-            xmDataPool->lazyDuplicate(mLeftBitTree[source][i]);
+            mBitPool.lazyDuplicate(mLeftBitTree[source][i]);
+    }
+    if (mParity.enabled()) {
+        mParity.duplicatePath(destination, source);
     }
 }
 
@@ -72,58 +117,111 @@ void PathList::getWriteAccessToLlr(unsigned path, unsigned stage)
 
 void PathList::getWriteAccessToBit(unsigned path, unsigned stage)
 {
-    xmDataPool->prepareForWrite(mBitTree[path][stage]);
+    mBitPool.prepareForWrite(mBitTree[path][stage]);
 }
 
 void PathList::getWriteAccessToNextBit(unsigned path, unsigned stage)
 {
-    xmDataPool->prepareForWrite(mNextBitTree[path][stage]);
+    mBitPool.prepareForWrite(mNextBitTree[path][stage]);
 }
 
 void PathList::clearOldPaths(unsigned stage)
 {
     for (unsigned path = 0; path < mPathCount; ++path) {
-        for (unsigned i = stage; i < mStageCount; ++i) {
+        for (unsigned i = std::max(stage, mInterleavedStages); i < mStageCount; ++i) {
             xmDataPool->release(mLlrTree[path][i]);
-            xmDataPool->release(mBitTree[path][i]);
-            xmDataPool->release(mLeftBitTree[path][i]);
+            mBitPool.release(mBitTree[path][i]);
+            mBitPool.release(mLeftBitTree[path][i]);
         }
     }
 }
 
 void PathList::switchToNext()
 {
+    if (mPermutationStage < mInterleavedStages) {
+        permuteInterleaved(mPermutationStage, mNextPathCount);
+    }
+    mPermutationStage = mInterleavedStages;
     std::swap(mLlrTree, mNextLlrTree);
     std::swap(mBitTree, mNextBitTree);
     std::swap(mLeftBitTree, mNextLeftBitTree);
     std::swap(mMetric, mNextMetric);
+    mParity.switchToNext();
     mPathCount = mNextPathCount;
 }
 
 void PathList::setFirstPath(void* pLlr)
 {
     mPathCount = 1;
+    mMetric[0] = 0.0f;
+    mParity.reset();
     allocateStage(mStageCount - 1);
 
     memcpy(Llr(0, mStageCount-1), pLlr, 2<<mStageCount /* 4*bitCount = 4*(1<<stage) =  4*(1<<(stageCount-1)) = 2*(1<<stageCount) = 2<<stageCount */);
 }
 
+void PathList::permuteInterleaved(unsigned stage, unsigned pathCount)
+{
+    const unsigned usedLanes = nBit2fCount(pathCount);
+    for (unsigned i = stage; i < mInterleavedStages; ++i) {
+        for (float* rows :
+             { mInterleavedLlr[i], mInterleavedBit[i], mInterleavedLeftBit[i] }) {
+            for (unsigned row = 0; row < (1U << i); ++row) {
+                float* data = rows + row * mLaneCount;
+                for (unsigned path = 0; path < pathCount; path += 8) {
+                    const __m256i source = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(mSourcePath.data() + path));
+                    _mm256_store_ps(mPermuted + path,
+                                    _mm256_i32gather_ps(data, source, sizeof(float)));
+                }
+                memcpy(data, mPermuted, usedLanes * sizeof(float));
+            }
+        }
+    }
+}
+
 void PathList::allocateStage(unsigned stage)
 {
+    if (stage < mInterleavedStages) {
+        return; // Interleaved stages are allocated once
+    }
     unsigned expandedBitCount = nBit2fCount(1 << stage);
+    unsigned packedByteCount = nBit2fvecCount(1 << stage);
     for (unsigned path = 0; path < mPathCount; ++path) {
         mLlrTree[path][stage] = xmDataPool->allocate(expandedBitCount);
-        mBitTree[path][stage] = xmDataPool->allocate(expandedBitCount);
-        mLeftBitTree[path][stage] = xmDataPool->allocate(expandedBitCount);
+        mBitTree[path][stage] = mBitPool.allocate(packedByteCount);
+        mLeftBitTree[path][stage] = mBitPool.allocate(packedByteCount);
+    }
+}
+
+void PathList::reserve(const std::vector<bool>& stages)
+{
+    // Short stages share one block size
+    std::map<size_t, size_t> blockCount, bitBlockCount;
+    for (unsigned stage = mInterleavedStages; stage < mStageCount; ++stage) {
+        if (stages[stage]) {
+            blockCount[nBit2fCount(1 << stage)] += mPathLimit + 1;
+            bitBlockCount[std::max<size_t>(32, nBit2fvecCount(1 << stage))] +=
+                3 * mPathLimit;
+        }
+    }
+    for (auto& count : blockCount) {
+        xmDataPool->reserve(count.first, count.second);
+    }
+    for (auto& count : bitBlockCount) {
+        mBitPool.reserve(count.first, count.second);
     }
 }
 
 void PathList::clearStage(unsigned stage)
 {
+    if (stage < mInterleavedStages) {
+        return;
+    }
     for (unsigned path = 0; path < mPathCount; ++path) {
         xmDataPool->release(mLlrTree[path][stage]);
-        xmDataPool->release(mBitTree[path][stage]);
-        xmDataPool->release(mLeftBitTree[path][stage]);
+        mBitPool.release(mBitTree[path][stage]);
+        mBitPool.release(mLeftBitTree[path][stage]);
     }
 }
 
@@ -132,18 +230,36 @@ float* PathList::Llr(unsigned path, unsigned stage)
     return mLlrTree[path][stage]->data;
 }
 
-float* PathList::Bit(unsigned path, unsigned stage)
+uint8_t* PathList::Bit(unsigned path, unsigned stage)
 {
     return mBitTree[path][stage]->data;
 }
 
-float* PathList::LeftBit(unsigned path, unsigned stage)
+uint8_t* PathList::LeftBit(unsigned path, unsigned stage)
 {
     return mLeftBitTree[path][stage]->data;
 }
 
+void PathList::setTeam(ThreadTeam* team) { xmTeam = team; }
+
+unsigned PathList::TeamSize() { return xmTeam == nullptr ? 1 : xmTeam->size(); }
+
+bool PathList::interleaved(unsigned stage) { return stage < mInterleavedStages; }
+
+unsigned PathList::LaneCount() { return mLaneCount; }
+
+float* PathList::InterleavedLlr(unsigned stage) { return mInterleavedLlr[stage]; }
+
+float* PathList::InterleavedBit(unsigned stage) { return mInterleavedBit[stage]; }
+
+float* PathList::InterleavedLeftBit(unsigned stage) { return mInterleavedLeftBit[stage]; }
+
 void PathList::prepareRightDecoding(unsigned stage)
 {
+    if (stage < mInterleavedStages) {
+        std::swap(mInterleavedBit[stage], mInterleavedLeftBit[stage]);
+        return;
+    }
     for (unsigned path = 0; path < mPathCount; ++path) {
         std::swap(mBitTree[path][stage], mLeftBitTree[path][stage]);
         xmDataPool->prepareForWrite(mLlrTree[path][stage]);
@@ -155,7 +271,7 @@ float* PathList::NextLlr(unsigned path, unsigned stage)
     return mNextLlrTree[path][stage]->data;
 }
 
-float* PathList::NextBit(unsigned path, unsigned stage)
+uint8_t* PathList::NextBit(unsigned path, unsigned stage)
 {
     return mNextBitTree[path][stage]->data;
 }
@@ -170,6 +286,90 @@ unsigned PathList::PathLimit() { return mPathLimit; }
 
 void PathList::setNextPathCount(unsigned pc) { mNextPathCount = pc; }
 
+PathSelector& PathList::selector() { return mSelector; }
+
+ParityTracker& PathList::parity() { return mParity; }
+
+void PathList::checkParity(unsigned stage, unsigned blockLength)
+{
+    if (!mParity.enabled() || !mParity.advance(blockLength)) {
+        return;
+    }
+    const bool interleavedStage = interleaved(stage);
+    for (unsigned path = 0; path < mPathCount; ++path) {
+        if (interleavedStage) {
+            const uint8_t packed =
+                packInterleaved(mInterleavedBit[stage], blockLength, mLaneCount, path);
+            mParity.insertPacked(path, &packed);
+        } else {
+            mParity.insertPacked(path, Bit(path, stage));
+        }
+    }
+    if (!mParity.checksPending()) {
+        return;
+    }
+
+    unsigned survivors = 0;
+    for (unsigned path = 0; path < mPathCount; ++path) {
+        if (!mParity.passes(path)) {
+            for (unsigned i = std::max(stage, mInterleavedStages); i < mStageCount; ++i) {
+                xmDataPool->release(mLlrTree[path][i]);
+                mBitPool.release(mBitTree[path][i]);
+                mBitPool.release(mLeftBitTree[path][i]);
+            }
+            continue;
+        }
+        if (survivors != path) {
+            std::swap(mLlrTree[survivors], mLlrTree[path]);
+            std::swap(mBitTree[survivors], mBitTree[path]);
+            std::swap(mLeftBitTree[survivors], mLeftBitTree[path]);
+            std::swap(mMetric[survivors], mMetric[path]);
+            mParity.swapPaths(survivors, path);
+        }
+        mSourcePath[survivors] = path;
+        ++survivors;
+    }
+    if (interleavedStage) {
+        permuteInterleaved(stage, survivors);
+    }
+    mPathCount = survivors;
+}
+
+void PathList::softDecisions(unsigned reference,
+                             unsigned stage,
+                             float penalty,
+                             float* output)
+{
+    const __m256 sgnMask = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const unsigned bitCount = nBit2fCount(1 << stage);
+
+    float worstMetric = mMetric[0];
+    for (unsigned path = 1; path < mPathCount; ++path) {
+        worstMetric = std::min(worstMetric, mMetric[path]);
+    }
+    const __m256 referenceMetric = _mm256_set1_ps(mMetric[reference]);
+    const __m256 unseenMetric = _mm256_set1_ps(worstMetric - penalty);
+
+    for (unsigned bit = 0; bit < bitCount; bit += 8) {
+        const __m256 referenceBits =
+            FastSscAvx::unpackSigns(Bit(reference, stage)[bit / 8]);
+        __m256 competitor = unseenMetric;
+        for (unsigned path = reference + 1; path < mPathCount; ++path) {
+            const __m256 disagreement = _mm256_xor_ps(
+                referenceBits, FastSscAvx::unpackSigns(Bit(path, stage)[bit / 8]));
+            const __m256 metric =
+                _mm256_max_ps(competitor, _mm256_set1_ps(mMetric[path]));
+            competitor = _mm256_blendv_ps(competitor, metric, disagreement);
+        }
+        const __m256 reliability =
+            _mm256_max_ps(_mm256_sub_ps(referenceMetric, competitor), zero);
+        _mm256_storeu_ps(output + bit,
+                         _mm256_or_ps(reliability,
+                                      _mm256_and_ps(referenceBits, sgnMask)));
+    }
+}
+
 Node::Node() {}
 
 Node::Node(Node* other)
@@ -208,16 +408,14 @@ SclAvx::PathList* Node::pathList() { return xmPathList; }
 
 RateRNode::RateRNode() {}
 
-RateRNode::RateRNode(const std::vector<unsigned>& frozenBits, Node* parent) : Node(parent)
+RateRNode::RateRNode(const DecoderPlan& plan, const PlanNode& node, Node* parent)
+    : Node(parent)
 {
     mBlockLength /= 2;
     mStage -= 1;
 
-    std::vector<unsigned> leftFrozenBits, rightFrozenBits;
-    splitFrozenBits(frozenBits, mBlockLength, leftFrozenBits, rightFrozenBits);
-
-    mLeft = createDecoder(leftFrozenBits, this);
-    mRight = createDecoder(rightFrozenBits, this);
+    mLeft = createDecoder(plan, node.left, this);
+    mRight = createDecoder(plan, node.right, this);
 }
 
 RateRNode::~RateRNode()
@@ -231,79 +429,393 @@ void RateRNode::decode()
     xmPathList->allocateStage(mStage);
 
     unsigned pathCount = xmPathList->PathCount();
-    for (unsigned path = 0; path < pathCount; ++path) {
-        FastSscAvx::F_function(xmPathList->Llr(path, mStage + 1),
-                               xmPathList->Llr(path, mStage),
-                               mBlockLength);
-    }
+    xmPathList->forEachPath(
+        pathCount, 3 * mBlockLength, [&](unsigned, unsigned begin, unsigned end) {
+            for (unsigned path = begin; path < end; ++path) {
+                FastSscAvx::F_function(xmPathList->Llr(path, mStage + 1),
+                                       xmPathList->Llr(path, mStage),
+                                       mBlockLength);
+            }
+        });
 
     mLeft->decode();
+    if (xmPathList->PathCount() == 0) {
+        return; // All paths failed a parity check
+    }
 
     xmPathList->prepareRightDecoding(mStage);
     pathCount = xmPathList->PathCount();
-    for (unsigned path = 0; path < pathCount; ++path) {
-        FastSscAvx::G_function(xmPathList->Llr(path, mStage + 1),
-                               xmPathList->Llr(path, mStage),
-                               xmPathList->LeftBit(path, mStage),
-                               mBlockLength);
-    }
+    xmPathList->forEachPath(
+        pathCount, 3 * mBlockLength, [&](unsigned, unsigned begin, unsigned end) {
+            for (unsigned path = begin; path < end; ++path) {
+                FastSscAvx::G_function_packed(xmPathList->Llr(path, mStage + 1),
+                                              xmPathList->Llr(path, mStage),
+                                              xmPathList->LeftBit(path, mStage),
+                                              mBlockLength);
+            }
+        });
 
     mRight->decode();
 
     pathCount = xmPathList->PathCount();
     for (unsigned path = 0; path < pathCount; ++path) {
         xmPathList->getWriteAccessToBit(path, mStage + 1);
-        FastSscAvx::CombineBitsLong(xmPathList->LeftBit(path, mStage),
-                                    xmPathList->Bit(path, mStage),
-                                    xmPathList->Bit(path, mStage + 1),
-                                    mBlockLength);
     }
+    // Packed bits take an eighth of the memory bandwidth of LLRs
+    xmPathList->forEachPath(
+        pathCount, mBlockLength / 2, [&](unsigned, unsigned begin, unsigned end) {
+            for (unsigned path = begin; path < end; ++path) {
+                FastSscAvx::CombineBitsPacked(xmPathList->LeftBit(path, mStage),
+                                              xmPathList->Bit(path, mStage),
+                                              xmPathList->Bit(path, mStage + 1),
+                                              mBlockLength);
+            }
+        });
 
     xmPathList->clearStage(mStage);
 }
 
-ShortRateRNode::ShortRateRNode(const std::vector<unsigned>& frozenBits, Node* parent)
-    : RateRNode(frozenBits, parent)
+/*
+ * Transpose the first eight LLRs of eight paths, such that vector i holds the
+ * i-th LLR of each path.
+ */
+inline void transposeBlocks(float* const* blocks, __m256* out)
 {
+    __m256 row[8], pair[8], quad[8];
+    for (unsigned i = 0; i < 8; ++i) {
+        row[i] = _mm256_load_ps(blocks[i]);
+    }
+    for (unsigned i = 0; i < 8; i += 2) {
+        pair[i] = _mm256_unpacklo_ps(row[i], row[i + 1]);
+        pair[i + 1] = _mm256_unpackhi_ps(row[i], row[i + 1]);
+    }
+    for (unsigned i = 0; i < 8; i += 4) {
+        quad[i] = _mm256_shuffle_ps(pair[i], pair[i + 2], 0x44);
+        quad[i + 1] = _mm256_shuffle_ps(pair[i], pair[i + 2], 0xEE);
+        quad[i + 2] = _mm256_shuffle_ps(pair[i + 1], pair[i + 3], 0x44);
+        quad[i + 3] = _mm256_shuffle_ps(pair[i + 1], pair[i + 3], 0xEE);
+    }
+    for (unsigned i = 0; i < 4; ++i) {
+        out[i] = _mm256_permute2f128_ps(quad[i], quad[i + 4], 0x20);
+        out[i + 4] = _mm256_permute2f128_ps(quad[i], quad[i + 4], 0x31);
+    }
 }
 
-ShortRateRNode::~ShortRateRNode() {}
+ShortRateRNode::ShortRateRNode(const DecoderPlan& plan,
+                               const PlanNode& node,
+                               Node* parent)
+    : RateRNode(plan, node, parent)
+{
+}
 
+ShortRateRNode::~ShortRateRNode() {}
 
 void ShortRateRNode::decode()
 {
-    xmPathList->allocateStage(mStage);
+    const unsigned laneCount = xmPathList->LaneCount();
+    const unsigned parentStage = mStage + 1;
+    const bool interleavedParent = xmPathList->interleaved(parentStage);
+    float* const childLlr = xmPathList->InterleavedLlr(mStage);
+    float* blocks[8];
+    __m256 llr[8];
+
+    // Fetch the parent's LLRs i and i + mBlockLength of eight paths
+    auto loadParent = [&](unsigned path) {
+        if (interleavedParent) {
+            const float* parentLlr = xmPathList->InterleavedLlr(parentStage);
+            for (unsigned i = 0; i < 2 * mBlockLength; ++i) {
+                llr[i] = _mm256_load_ps(parentLlr + i * laneCount + path);
+            }
+        } else {
+            const unsigned pathCount = xmPathList->PathCount();
+            for (unsigned lane = 0; lane < 8; ++lane) {
+                const unsigned source = path + lane < pathCount ? path + lane : path;
+                blocks[lane] = xmPathList->Llr(source, parentStage);
+            }
+            transposeBlocks(blocks, llr);
+        }
+    };
 
     unsigned pathCount = xmPathList->PathCount();
-    for (unsigned path = 0; path < pathCount; ++path) {
-        FastSscAvx::F_function(xmPathList->Llr(path, mStage + 1),
-                               xmPathList->Llr(path, mStage),
-                               mBlockLength);
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        loadParent(path);
+        for (unsigned i = 0; i < mBlockLength; ++i) {
+            _mm256_store_ps(childLlr + i * laneCount + path,
+                            FastSscAvx::_mm256_polarf_ps(llr[i], llr[i + mBlockLength]));
+        }
     }
 
     mLeft->decode();
+    if (xmPathList->PathCount() == 0) {
+        return; // All paths failed a parity check
+    }
 
     xmPathList->prepareRightDecoding(mStage);
+    const float* leftBits = xmPathList->InterleavedLeftBit(mStage);
     pathCount = xmPathList->PathCount();
-    for (unsigned path = 0; path < pathCount; ++path) {
-        FastSscAvx::G_function(xmPathList->Llr(path, mStage + 1),
-                               xmPathList->Llr(path, mStage),
-                               xmPathList->LeftBit(path, mStage),
-                               mBlockLength);
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        loadParent(path);
+        for (unsigned i = 0; i < mBlockLength; ++i) {
+            const __m256 bits = _mm256_load_ps(leftBits + i * laneCount + path);
+            _mm256_store_ps(
+                childLlr + i * laneCount + path,
+                FastSscAvx::_mm256_polarg_ps(llr[i], llr[i + mBlockLength], bits));
+        }
     }
 
     mRight->decode();
 
+    leftBits = xmPathList->InterleavedLeftBit(mStage);
+    const float* rightBits = xmPathList->InterleavedBit(mStage);
     pathCount = xmPathList->PathCount();
-    for (unsigned path = 0; path < pathCount; ++path) {
-        xmPathList->getWriteAccessToBit(path, mStage + 1);
-        FastSscAvx::CombineBitsShort(xmPathList->LeftBit(path, mStage),
-                                     xmPathList->Bit(path, mStage),
-                                     xmPathList->Bit(path, mStage + 1),
-                                     mBlockLength);
+    if (interleavedParent) {
+        float* parentBits = xmPathList->InterleavedBit(parentStage);
+        for (unsigned i = 0; i < mBlockLength; ++i) {
+            for (unsigned path = 0; path < pathCount; path += 8) {
+                const __m256 left = _mm256_load_ps(leftBits + i * laneCount + path);
+                const __m256 right = _mm256_load_ps(rightBits + i * laneCount + path);
+                _mm256_store_ps(parentBits + i * laneCount + path,
+                                _mm256_xor_ps(left, right));
+                _mm256_store_ps(parentBits + (i + mBlockLength) * laneCount + path,
+                                right);
+            }
+        }
+    } else {
+        for (unsigned path = 0; path < pathCount; ++path) {
+            const unsigned left =
+                packInterleaved(leftBits, mBlockLength, laneCount, path);
+            const unsigned right =
+                packInterleaved(rightBits, mBlockLength, laneCount, path);
+            xmPathList->getWriteAccessToBit(path, parentStage);
+            xmPathList->Bit(path, parentStage)[0] =
+                (left ^ right) | (right << mBlockLength);
+        }
     }
+}
 
-    xmPathList->clearStage(mStage);
+/*
+ * Partially sort the absolute LLRs of eight interleaved paths, exactly like
+ * findWeakLlrs() does for each of them. Ties resolve to the lower index.
+ */
+inline void findWeakLlrsInterleaved(__m256* values,
+                                    __m256* indices,
+                                    const unsigned size,
+                                    const unsigned n)
+{
+    for (unsigned i = 0; i < size; ++i) {
+        indices[i] = _mm256_set1_ps(i);
+    }
+
+    const unsigned lim = std::min(size - 1, n);
+
+    for (unsigned i = 0; i < lim; ++i) {
+        __m256 minimum = values[i], position = _mm256_set1_ps(i);
+        for (unsigned j = i + 1; j < size; ++j) {
+            const __m256 less = _mm256_cmp_ps(values[j], minimum, _CMP_LT_OQ);
+            minimum = _mm256_blendv_ps(minimum, values[j], less);
+            position = _mm256_blendv_ps(position, _mm256_set1_ps(j), less);
+        }
+        __m256 index = indices[i];
+        for (unsigned j = i + 1; j < size; ++j) {
+            const __m256 swap = _mm256_cmp_ps(position, _mm256_set1_ps(j), _CMP_EQ_OQ);
+            index = _mm256_blendv_ps(index, indices[j], swap);
+            values[j] = _mm256_blendv_ps(values[j], values[i], swap);
+            indices[j] = _mm256_blendv_ps(indices[j], indices[i], swap);
+        }
+        values[i] = minimum;
+        indices[i] = index;
+    }
+}
+
+/*
+ * Find the _n_ weakest LLRs of a single path, exactly like findWeakLlrs(), but
+ * search each pass with vector instructions. The values of a passed position
+ * are replaced by infinity. _values_ must be padded to a multiple of eight.
+ */
+template <unsigned n>
+inline void findWeakLlrsAvx(float* values,
+                            const unsigned size,
+                            float* weakValues,
+                            unsigned* weakIndices)
+{
+    static_assert(n <= 4, "findWeakLlrsAvx: Too many weak LLRs!");
+    const unsigned lim = std::min(size - 1, n);
+    const unsigned vectorSize = nBit2fCount(size);
+    unsigned movedTo[n] = {}, movedIndex[n] = {};
+
+    // Index of the value at a position, after _moves_ swaps
+    auto indexAt = [&](unsigned position, unsigned moves) {
+        for (unsigned k = moves; k-- > 0;) {
+            if (movedTo[k] == position) {
+                return movedIndex[k];
+            }
+        }
+        return position;
+    };
+
+    for (unsigned i = 0; i < lim; ++i) {
+        const unsigned first = i & ~7U;
+        __m256 minimum = _mm256_load_ps(values + first);
+        for (unsigned j = first + 8; j < vectorSize; j += 8) {
+            minimum = _mm256_min_ps(minimum, _mm256_load_ps(values + j));
+        }
+        minimum = _mm256_min_ps(minimum, _mm256_permute2f128_ps(minimum, minimum, 1));
+        minimum = _mm256_min_ps(minimum, _mm256_permute_ps(minimum, 0x4E));
+        minimum = _mm256_min_ps(minimum, _mm256_permute_ps(minimum, 0xB1));
+
+        unsigned position = first;
+        unsigned equal = _mm256_movemask_ps(_mm256_cmp_ps(
+                             _mm256_load_ps(values + first), minimum, _CMP_EQ_OQ)) &
+                         (0xFF << (i & 7));
+        while (equal == 0 && position + 8 < vectorSize) {
+            position += 8;
+            equal = _mm256_movemask_ps(_mm256_cmp_ps(
+                _mm256_load_ps(values + position), minimum, _CMP_EQ_OQ));
+        }
+        // A NaN minimum equals nothing, keep the current position then
+        position = equal ? position + __builtin_ctz(equal) : i;
+
+        weakValues[i] = values[position];
+        weakIndices[i] = indexAt(position, i);
+        movedTo[i] = position;
+        movedIndex[i] = indexAt(i, i);
+        values[position] = values[i];
+        values[i] = INFINITY;
+    }
+    for (unsigned i = lim; i < n; ++i) {
+        weakValues[i] = values[i];
+        weakIndices[i] = indexAt(i, lim);
+    }
+}
+
+/*
+ * Candidate metrics of rate-1 nodes of eight paths, given their two weakest
+ * LLRs. Candidate c flips the weak bits which are set in c.
+ */
+inline void rateOneCandidates(const __m256 metric, const __m256* weak, __m256* candidates)
+{
+    candidates[0] = metric;
+    candidates[1] = _mm256_sub_ps(metric, weak[0]);
+    candidates[2] = _mm256_sub_ps(metric, weak[1]);
+    candidates[3] = _mm256_sub_ps(candidates[1], weak[1]);
+}
+
+/*
+ * Weak bits flipped by the candidates of an SPC node, for even and odd parity.
+ */
+static constexpr uint8_t SPC_FLIPS[2][8] = {
+    { 0x0, 0x3, 0x5, 0x9, 0x6, 0xA, 0xC, 0xF },
+    { 0x1, 0x2, 0x4, 0x8, 0x7, 0xB, 0xD, 0xE }
+};
+
+/*
+ * Candidate metrics of SPC nodes of eight paths, given their four weakest LLRs.
+ * The parity is odd in the lanes which have their sign bit set.
+ */
+inline void spcCandidates(__m256 metric,
+                          const __m256 parity,
+                          const __m256* weak,
+                          __m256* candidates)
+{
+    // On odd parity, the weakest bit is flipped by default
+    metric = _mm256_blendv_ps(metric, _mm256_sub_ps(metric, weak[0]), parity);
+    const __m256 base =
+        _mm256_sub_ps(metric, _mm256_blendv_ps(weak[0], _mm256_setzero_ps(), parity));
+
+    candidates[0] = metric;
+    candidates[1] = _mm256_sub_ps(base, weak[1]);
+    candidates[2] = _mm256_sub_ps(base, weak[2]);
+    candidates[3] = _mm256_sub_ps(base, weak[3]);
+    candidates[4] = _mm256_sub_ps(_mm256_sub_ps(metric, weak[1]), weak[2]);
+    candidates[5] = _mm256_sub_ps(_mm256_sub_ps(metric, weak[1]), weak[3]);
+    candidates[6] = _mm256_sub_ps(_mm256_sub_ps(metric, weak[2]), weak[3]);
+    candidates[7] = _mm256_sub_ps(_mm256_sub_ps(candidates[1], weak[2]), weak[3]);
+}
+
+/*
+ * Store the candidate metrics of eight paths in path-major order.
+ */
+inline void storeCandidates(const __m256* candidates,
+                            const unsigned candidateCount,
+                            std::vector<float>& metrics,
+                            const unsigned path,
+                            const unsigned pathCount)
+{
+    alignas(32) float values[8][8];
+    for (unsigned candidate = 0; candidate < candidateCount; ++candidate) {
+        _mm256_store_ps(values[candidate], candidates[candidate]);
+    }
+    const unsigned laneEnd = std::min(8U, pathCount - path);
+    for (unsigned lane = 0; lane < laneEnd; ++lane) {
+        for (unsigned candidate = 0; candidate < candidateCount; ++candidate) {
+            metrics[(path + lane) * candidateCount + candidate] = values[candidate][lane];
+        }
+    }
+}
+
+/*
+ * Store the weak bit indices of eight interleaved paths in path-major order.
+ */
+inline void storeWeakIndices(const __m256* indices,
+                             const unsigned weakCount,
+                             std::vector<unsigned>& weakIndices,
+                             const unsigned path,
+                             const unsigned pathCount)
+{
+    alignas(32) int values[4][8];
+    for (unsigned k = 0; k < weakCount; ++k) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values[k]),
+                           _mm256_cvtps_epi32(indices[k]));
+    }
+    const unsigned laneEnd = std::min(8U, pathCount - path);
+    for (unsigned lane = 0; lane < laneEnd; ++lane) {
+        for (unsigned k = 0; k < weakCount; ++k) {
+            weakIndices[(path + lane) * weakCount + k] = values[k][lane];
+        }
+    }
+}
+
+/*
+ * Mask of the bits of an interleaved leaf, which are flipped by the weak
+ * bits _flips_ of a path.
+ */
+inline uint8_t interleavedFlips(const unsigned* weakIndices,
+                                const unsigned weakCount,
+                                const unsigned flips)
+{
+    unsigned mask = 0;
+    for (unsigned k = 0; k < weakCount; ++k) {
+        mask ^= ((flips >> k) & 1) << weakIndices[k];
+    }
+    return mask;
+}
+
+/*
+ * Write the decisions of an interleaved leaf. The bits of each path are the
+ * signs of its LLRs, or zero without LLRs, flipped at the ones of its mask.
+ */
+inline void decideInterleaved(const float* llr,
+                              float* bits,
+                              const uint8_t* masks,
+                              unsigned rowCount,
+                              unsigned laneCount,
+                              unsigned pathCount)
+{
+    const __m256 sgnMask = _mm256_set1_ps(-0.0f);
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        const __m256i mask = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(masks + path)));
+        for (unsigned i = 0; i < rowCount; ++i) {
+            const __m256 flip = _mm256_and_ps(
+                sgnMask,
+                _mm256_castsi256_ps(_mm256_sllv_epi32(mask, _mm256_set1_epi32(31 - i))));
+            const __m256 decision =
+                llr == nullptr
+                    ? flip
+                    : _mm256_xor_ps(flip, _mm256_load_ps(llr + i * laneCount + path));
+            _mm256_store_ps(bits + i * laneCount + path, decision);
+        }
+    }
 }
 
 /*************
@@ -315,25 +827,54 @@ RateZeroDecoder::~RateZeroDecoder() {}
 
 void RateZeroDecoder::decode()
 {
+    if (xmPathList->interleaved(mStage)) {
+        decodeInterleaved();
+        return;
+    }
+
     const __m256 zero = _mm256_setzero_ps();
-    const __m256 inf = _mm256_set1_ps(INFINITY);
     unsigned pathCount = xmPathList->PathCount();
-    float *fBits, *LlrSource;
 
-    for (unsigned path = 0; path < pathCount; ++path) {
-        __m256 punishment = _mm256_setzero_ps();
-        fBits = xmPathList->Bit(path, mStage);
-        LlrSource = xmPathList->Llr(path, mStage);
-        for (unsigned i = mBlockLength; i < 8; ++i) {
-            LlrSource[i] = 0.0;
+    xmPathList->forEachPath(
+        pathCount, mBlockLength, [&](unsigned, unsigned begin, unsigned end) {
+            for (unsigned path = begin; path < end; ++path) {
+                __m256 punishment = _mm256_setzero_ps();
+                memset(xmPathList->Bit(path, mStage), 0, nBit2fvecCount(mBlockLength));
+                float* LlrSource = xmPathList->Llr(path, mStage);
+                for (unsigned i = mBlockLength; i < 8; ++i) {
+                    LlrSource[i] = 0.0;
+                }
+                for (unsigned bit = 0; bit < mBlockLength; bit += 8) {
+                    __m256 LlrIn = _mm256_load_ps(LlrSource + bit);
+                    punishment = _mm256_add_ps(punishment, _mm256_min_ps(LlrIn, zero));
+                }
+                xmPathList->Metric(path) += reduce_add_ps(punishment);
+            }
+        });
+    xmPathList->checkParity(mStage, mBlockLength);
+}
+
+void RateZeroDecoder::decodeInterleaved()
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const unsigned laneCount = xmPathList->LaneCount();
+    const unsigned pathCount = xmPathList->PathCount();
+    const float* llr = xmPathList->InterleavedLlr(mStage);
+    float* bits = xmPathList->InterleavedBit(mStage);
+
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        __m256 punishment = _mm256_min_ps(_mm256_load_ps(llr + path), zero);
+        for (unsigned i = 1; i < mBlockLength; ++i) {
+            const __m256 Llr = _mm256_load_ps(llr + i * laneCount + path);
+            punishment = _mm256_add_ps(punishment, _mm256_min_ps(Llr, zero));
         }
-        for (unsigned bit = 0; bit < mBlockLength; bit += 8) {
-            _mm256_store_ps(fBits + bit, inf);
-            __m256 LlrIn = _mm256_load_ps(LlrSource + bit);
-            punishment = _mm256_add_ps(punishment, _mm256_min_ps(LlrIn, zero));
+        float* metric = &xmPathList->Metric(path);
+        _mm256_storeu_ps(metric, _mm256_add_ps(_mm256_loadu_ps(metric), punishment));
+        for (unsigned i = 0; i < mBlockLength; ++i) {
+            _mm256_store_ps(bits + i * laneCount + path, zero);
         }
-        xmPathList->Metric(path) += reduce_add_ps(punishment);
     }
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 /*************
@@ -341,47 +882,65 @@ void RateZeroDecoder::decode()
  * ***********/
 RateOneDecoder::RateOneDecoder(Node* parent) : Node(parent)
 {
-    mIndices.resize(std::max(mBlockLength, mListSize * 4));
+    mIndices.resize(mListSize * 4);
     mMetrics.resize(mListSize * 4);
-    mBitFlipHints.resize(mListSize * 4);
-    mTempBlock = xmDataPool->allocate(mBlockLength);
-    mTemp = mTempBlock->data;
+    mWeakLlrs.resize(2 * xmPathList->LaneCount());
+    mWeakIndices.resize(mListSize * 2);
+    mPathMasks.resize(xmPathList->LaneCount());
+    for (unsigned member = 0; member < xmPathList->TeamSize(); ++member) {
+        mTempBlocks.push_back(xmDataPool->allocate(mBlockLength));
+    }
 }
 
-RateOneDecoder::~RateOneDecoder() { xmDataPool->release(mTempBlock); }
+RateOneDecoder::~RateOneDecoder()
+{
+    for (block_t* block : mTempBlocks) {
+        xmDataPool->release(block);
+    }
+}
 
 void RateOneDecoder::decode()
 {
+    if (xmPathList->interleaved(mStage)) {
+        decodeInterleaved();
+        return;
+    }
+
     const __m256 sgnMask = _mm256_set1_ps(-0.0);
+    const unsigned laneCount = xmPathList->LaneCount();
     unsigned pathCount = xmPathList->PathCount();
 
-    for (unsigned path = 0; path < pathCount; ++path) {
-        float metric = xmPathList->Metric(path);
-        float* LlrSource = xmPathList->Llr(path, mStage);
-        for (unsigned i = mBlockLength; i < 8; ++i) {
-            LlrSource[i] = INFINITY;
-        }
-        for (unsigned i = 0; i < mBlockLength; i += 8) {
-            __m256 Llr = _mm256_load_ps(LlrSource + i);
-            Llr = _mm256_andnot_ps(sgnMask, Llr);
-            _mm256_store_ps(mTemp + i, Llr);
-        }
-        findWeakLlrs(mIndices, mTemp, mBlockLength, 2);
-        mMetrics[path * 4] = metric;
-        mMetrics[path * 4 + 1] = metric - mTemp[0];
-        mMetrics[path * 4 + 2] = metric - mTemp[1];
-        mMetrics[path * 4 + 3] = metric - mTemp[0] - mTemp[1];
-
-        mBitFlipHints[path * 4] = {};
-        mBitFlipHints[path * 4 + 1] = { mIndices[0] };
-        mBitFlipHints[path * 4 + 2] = { mIndices[1] };
-        mBitFlipHints[path * 4 + 3] = { mIndices[0], mIndices[1] };
+    xmPathList->forEachPath(
+        pathCount, 3 * mBlockLength, [&](unsigned member, unsigned begin, unsigned end) {
+            float* temp = mTempBlocks[member]->data;
+            for (unsigned path = begin; path < end; ++path) {
+                float* LlrSource = xmPathList->Llr(path, mStage);
+                for (unsigned i = mBlockLength; i < 8; ++i) {
+                    LlrSource[i] = INFINITY;
+                }
+                for (unsigned i = 0; i < mBlockLength; i += 8) {
+                    __m256 Llr = _mm256_load_ps(LlrSource + i);
+                    Llr = _mm256_andnot_ps(sgnMask, Llr);
+                    _mm256_store_ps(temp + i, Llr);
+                }
+                float weak[2];
+                findWeakLlrsAvx<2>(temp, mBlockLength, weak, &mWeakIndices[path * 2]);
+                mWeakLlrs[path] = weak[0];
+                mWeakLlrs[laneCount + path] = weak[1];
+            }
+        });
+
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        const __m256 weak[2] = { _mm256_loadu_ps(&mWeakLlrs[path]),
+                                 _mm256_loadu_ps(&mWeakLlrs[laneCount + path]) };
+        __m256 candidates[4];
+        rateOneCandidates(_mm256_loadu_ps(&xmPathList->Metric(path)), weak, candidates);
+        storeCandidates(candidates, 4, mMetrics, path, pathCount);
     }
 
     unsigned newPathCount = std::min(pathCount * 4, (unsigned)mListSize);
     xmPathList->setNextPathCount(newPathCount);
-    simplePartialSortDescending<unsigned, float>(
-        mIndices, mMetrics, newPathCount, pathCount * 4);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 4);
 
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->duplicatePath(path, mIndices[path] / 4, mStage);
@@ -389,30 +948,83 @@ void RateOneDecoder::decode()
 
     xmPathList->clearOldPaths(mStage);
 
-    union {
-        float* fBitDestination;
-        unsigned int* iBitDestination;
-    };
-
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->getWriteAccessToNextBit(path, mStage);
         xmPathList->NextMetric(path) = mMetrics[path];
-        float* LlrSource = xmPathList->NextLlr(path, mStage);
-        fBitDestination = xmPathList->NextBit(path, mStage);
-        for (unsigned i = 0; i < mBlockLength; i += 8) {
-            __m256 Llr = _mm256_load_ps(LlrSource + i);
-            _mm256_store_ps(fBitDestination + i, Llr);
-        }
+    }
+    xmPathList->forEachPath(
+        newPathCount, mBlockLength, [&](unsigned, unsigned begin, unsigned end) {
+            for (unsigned path = begin; path < end; ++path) {
+                uint8_t* bitDestination = xmPathList->NextBit(path, mStage);
+                FastSscAvx::packSigns(
+                    xmPathList->NextLlr(path, mStage), bitDestination, mBlockLength);
+
+                const unsigned source = mIndices[path] / 4, flips = mIndices[path] % 4;
+                for (unsigned k = 0; k < 2; ++k) {
+                    if ((flips >> k) & 1) {
+                        FastSscAvx::flipBit(bitDestination,
+                                            mWeakIndices[source * 2 + k]);
+                    }
+                }
+            }
+        });
+
+    xmPathList->switchToNext();
+    xmPathList->checkParity(mStage, mBlockLength);
+}
 
-        for (unsigned index : mBitFlipHints[mIndices[path]]) {
-            iBitDestination[index] ^= 0x80000000U;
+void RateOneDecoder::decodeInterleaved()
+{
+    const unsigned laneCount = xmPathList->LaneCount();
+    const unsigned pathCount = xmPathList->PathCount();
+    const float* llr = xmPathList->InterleavedLlr(mStage);
+
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        // Rows beyond the block length are never chosen, as in decode()
+        __m256 values[4], indices[4];
+        for (unsigned i = 0; i < 4; ++i) {
+            values[i] = _mm256_set1_ps(INFINITY);
+            indices[i] = _mm256_set1_ps(i);
         }
+        for (unsigned i = 0; i < mBlockLength; ++i) {
+            const __m256 Llr = _mm256_load_ps(llr + i * laneCount + path);
+            values[i] = FastSscAvx::_mm256_abs_ps(Llr);
+        }
+        findWeakLlrsInterleaved(values, indices, mBlockLength, 2);
+
+        __m256 candidates[4];
+        rateOneCandidates(_mm256_loadu_ps(&xmPathList->Metric(path)), values, candidates);
+        storeCandidates(candidates, 4, mMetrics, path, pathCount);
+        storeWeakIndices(indices, 2, mWeakIndices, path, pathCount);
+    }
+
+    unsigned newPathCount = std::min(pathCount * 4, (unsigned)mListSize);
+    xmPathList->setNextPathCount(newPathCount);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 4);
+
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        xmPathList->duplicatePath(path, mIndices[path] / 4, mStage);
+    }
+
+    xmPathList->clearOldPaths(mStage);
+
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        const unsigned source = mIndices[path] / 4;
+        xmPathList->NextMetric(path) = mMetrics[path];
+        mPathMasks[path] =
+            interleavedFlips(&mWeakIndices[source * 2], 2, mIndices[path] % 4);
     }
 
     xmPathList->switchToNext();
+    decideInterleaved(xmPathList->InterleavedLlr(mStage),
+                      xmPathList->InterleavedBit(mStage),
+                      mPathMasks.data(),
+                      mBlockLength,
+                      laneCount,
+                      newPathCount);
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
-
 /*************
  * RepetitionDecoder
  * ***********/
@@ -421,12 +1033,18 @@ RepetitionDecoder::RepetitionDecoder(Node* parent) : Node(parent)
     mIndices.resize(mListSize * 2);
     mMetrics.resize(mListSize * 2);
     mResults.resize(mListSize * 2);
+    mPathMasks.resize(xmPathList->LaneCount());
 }
 
 RepetitionDecoder::~RepetitionDecoder() {}
 
 void RepetitionDecoder::decode()
 {
+    if (xmPathList->interleaved(mStage)) {
+        decodeInterleaved();
+        return;
+    }
+
     const __m256 zero = _mm256_setzero_ps();
     unsigned pathCount = xmPathList->PathCount();
 
@@ -457,7 +1075,7 @@ void RepetitionDecoder::decode()
 
     unsigned newPathCount = std::min(pathCount * 2, mListSize);
     xmPathList->setNextPathCount(newPathCount);
-    simplePartialSortDescending(mIndices, mMetrics, newPathCount, pathCount * 2);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 2);
 
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->duplicatePath(path, mIndices[path] / 2, mStage);
@@ -469,15 +1087,72 @@ void RepetitionDecoder::decode()
         xmPathList->getWriteAccessToNextBit(path, mStage);
         xmPathList->NextMetric(path) = mMetrics[path];
 
-        __m256 output = _mm256_set1_ps(mResults[mIndices[path]]);
-        float* bitDestination = xmPathList->NextBit(path, mStage);
+        const int output = std::signbit(mResults[mIndices[path]]) ? 0xFF : 0;
+        uint8_t* bitDestination = xmPathList->NextBit(path, mStage);
+        if (mBlockLength < 8) {
+            bitDestination[0] = output & ((1 << mBlockLength) - 1);
+        } else {
+            memset(bitDestination, output, mBlockLength / 8);
+        }
+    }
 
-        for (unsigned i = 0; i < mBlockLength; i += 8) {
-            _mm256_store_ps(bitDestination + i, output);
+    xmPathList->switchToNext();
+    xmPathList->checkParity(mStage, mBlockLength);
+}
+
+void RepetitionDecoder::decodeInterleaved()
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const unsigned laneCount = xmPathList->LaneCount();
+    const unsigned pathCount = xmPathList->PathCount();
+    const float* llr = xmPathList->InterleavedLlr(mStage);
+    alignas(32) float zeroMetrics[8], oneMetrics[8];
+
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        const __m256 first = _mm256_load_ps(llr + path);
+        __m256 vZero = _mm256_min_ps(first, zero); // metric for '0' decision
+        __m256 vOne = _mm256_max_ps(first, zero);  // metric for '1' decision
+        for (unsigned i = 1; i < mBlockLength; ++i) {
+            const __m256 Llr = _mm256_load_ps(llr + i * laneCount + path);
+            vZero = _mm256_add_ps(vZero, _mm256_min_ps(Llr, zero));
+            vOne = _mm256_add_ps(vOne, _mm256_max_ps(Llr, zero));
+        }
+
+        const __m256 metric = _mm256_loadu_ps(&xmPathList->Metric(path));
+        _mm256_store_ps(zeroMetrics, _mm256_add_ps(metric, vZero));
+        _mm256_store_ps(oneMetrics, _mm256_sub_ps(metric, vOne));
+
+        const unsigned laneEnd = std::min(8U, pathCount - path);
+        for (unsigned lane = 0; lane < laneEnd; ++lane) {
+            mMetrics[(path + lane) * 2] = zeroMetrics[lane];
+            mMetrics[(path + lane) * 2 + 1] = oneMetrics[lane];
         }
     }
 
+    unsigned newPathCount = std::min(pathCount * 2, mListSize);
+    xmPathList->setNextPathCount(newPathCount);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 2);
+
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        xmPathList->duplicatePath(path, mIndices[path] / 2, mStage);
+    }
+
+    xmPathList->clearOldPaths(mStage);
+
+    // The odd candidates decided for ones
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        xmPathList->NextMetric(path) = mMetrics[path];
+        mPathMasks[path] = mIndices[path] % 2 ? 0xFF : 0;
+    }
+
     xmPathList->switchToNext();
+    decideInterleaved(nullptr,
+                      xmPathList->InterleavedBit(mStage),
+                      mPathMasks.data(),
+                      mBlockLength,
+                      laneCount,
+                      newPathCount);
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 /*************
@@ -485,110 +1160,146 @@ void RepetitionDecoder::decode()
  * ***********/
 SpcDecoder::SpcDecoder(Node* parent) : Node(parent)
 {
-    mIndices.resize(std::max(mBlockLength, mListSize * 8));
+    mIndices.resize(mListSize * 8);
     mMetrics.resize(mListSize * 8);
-    mBitFlipHints.resize(mListSize * 8);
-    mBitFlipCount.resize(mListSize * 8);
-    mTempBlock = xmDataPool->allocate(mBlockLength);
-    mTemp = mTempBlock->data;
+    mWeakLlrs.resize(5 * xmPathList->LaneCount());
+    mWeakIndices.resize(mListSize * 4);
+    mPathMasks.resize(xmPathList->LaneCount());
+    for (unsigned member = 0; member < xmPathList->TeamSize(); ++member) {
+        mTempBlocks.push_back(xmDataPool->allocate(mBlockLength));
+    }
 }
 
-SpcDecoder::~SpcDecoder() { xmDataPool->release(mTempBlock); }
+SpcDecoder::~SpcDecoder()
+{
+    for (block_t* block : mTempBlocks) {
+        xmDataPool->release(block);
+    }
+}
 
 void SpcDecoder::decode()
 {
+    if (xmPathList->interleaved(mStage)) {
+        decodeInterleaved();
+        return;
+    }
+
     const __m256 sgnMask = _mm256_set1_ps(-0.0);
+    const unsigned laneCount = xmPathList->LaneCount();
     unsigned pathCount = xmPathList->PathCount();
+    float* parities = &mWeakLlrs[4 * laneCount];
+
+    xmPathList->forEachPath(
+        pathCount, 5 * mBlockLength, [&](unsigned member, unsigned begin, unsigned end) {
+            float* temp = mTempBlocks[member]->data;
+            for (unsigned path = begin; path < end; ++path) {
+                float* LlrSource = xmPathList->Llr(path, mStage);
+                __m256 vParity = _mm256_set1_ps(0.0f);
+
+                // For short SPC codes (N<8), neutralize unused vector elements
+                for (unsigned i = mBlockLength; i < 8; ++i) {
+                    LlrSource[i] = INFINITY;
+                }
+
+                // Calculate parity and save absolute values
+                for (unsigned i = 0; i < mBlockLength; i += 8) {
+                    __m256 Llr = _mm256_load_ps(LlrSource + i);
+                    vParity = _mm256_xor_ps(vParity, Llr);
+                    Llr = _mm256_andnot_ps(sgnMask, Llr);
+                    _mm256_store_ps(temp + i, Llr);
+                }
+                parities[path] = reduce_xor_ps(vParity);
+
+                float weak[4];
+                findWeakLlrsAvx<4>(temp, mBlockLength, weak, &mWeakIndices[path * 4]);
+                for (unsigned k = 0; k < 4; ++k) {
+                    mWeakLlrs[k * laneCount + path] = weak[k];
+                }
+            }
+        });
 
-    __m256 vParity;
-    float fParityInv;
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        __m256 weak[4], candidates[8];
+        for (unsigned k = 0; k < 4; ++k) {
+            weak[k] = _mm256_loadu_ps(&mWeakLlrs[k * laneCount + path]);
+        }
+        spcCandidates(_mm256_loadu_ps(&xmPathList->Metric(path)),
+                      _mm256_loadu_ps(parities + path),
+                      weak,
+                      candidates);
+        storeCandidates(candidates, 8, mMetrics, path, pathCount);
+    }
 
-    union {
-        float uFloat;
-        unsigned int uInt;
-    };
+    unsigned newPathCount = std::min(pathCount * 8, (unsigned)mListSize);
+    xmPathList->setNextPathCount(newPathCount);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 8);
 
-    for (unsigned path = 0; path < pathCount; ++path) {
-        float metric = xmPathList->Metric(path);
-        float* LlrSource = xmPathList->Llr(path, mStage);
-        vParity = _mm256_set1_ps(0.0f);
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        xmPathList->duplicatePath(path, mIndices[path] / 8, mStage);
+    }
 
-        // For short SPC codes (N<8), neutralize unused vector elements
-        for (unsigned i = mBlockLength; i < 8; ++i) {
-            LlrSource[i] = INFINITY;
-        }
+    xmPathList->clearOldPaths(mStage);
 
-        // Calculate parity and save absolute values
-        for (unsigned i = 0; i < mBlockLength; i += 8) {
-            __m256 Llr = _mm256_load_ps(LlrSource + i);
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        xmPathList->getWriteAccessToNextBit(path, mStage);
+        xmPathList->NextMetric(path) = mMetrics[path];
+    }
+    xmPathList->forEachPath(
+        newPathCount, mBlockLength, [&](unsigned, unsigned begin, unsigned end) {
+            for (unsigned path = begin; path < end; ++path) {
+                uint8_t* bitDestination = xmPathList->NextBit(path, mStage);
+                FastSscAvx::packSigns(
+                    xmPathList->NextLlr(path, mStage), bitDestination, mBlockLength);
+
+                const unsigned source = mIndices[path] / 8;
+                const unsigned flips =
+                    SPC_FLIPS[std::signbit(parities[source])][mIndices[path] % 8];
+                for (unsigned k = 0; k < 4; ++k) {
+                    if ((flips >> k) & 1) {
+                        FastSscAvx::flipBit(bitDestination,
+                                            mWeakIndices[source * 4 + k]);
+                    }
+                }
+            }
+        });
+
+    xmPathList->switchToNext();
+    xmPathList->checkParity(mStage, mBlockLength);
+}
+
+void SpcDecoder::decodeInterleaved()
+{
+    const unsigned laneCount = xmPathList->LaneCount();
+    const unsigned pathCount = xmPathList->PathCount();
+    const float* llr = xmPathList->InterleavedLlr(mStage);
+    float* parities = &mWeakLlrs[4 * laneCount];
+
+    for (unsigned path = 0; path < pathCount; path += 8) {
+        // Calculate parity and sort the absolute values
+        __m256 values[4], indices[4];
+        __m256 vParity = _mm256_setzero_ps();
+        for (unsigned i = 0; i < 4; ++i) {
+            values[i] = _mm256_set1_ps(INFINITY);
+            indices[i] = _mm256_set1_ps(i);
+        }
+        for (unsigned i = 0; i < mBlockLength; ++i) {
+            const __m256 Llr = _mm256_load_ps(llr + i * laneCount + path);
             vParity = _mm256_xor_ps(vParity, Llr);
-            Llr = _mm256_andnot_ps(sgnMask, Llr);
-            _mm256_store_ps(mTemp + i, Llr);
-        }
-
-        findWeakLlrs(mIndices, mTemp, mBlockLength, 4);
-
-        // Create candidates
-        uFloat = reduce_xor_ps(vParity);
-        if (uInt & 0x80000000) {
-            fParityInv = 0.0;
-            metric -= mTemp[0];
-            mBitFlipCount[path * 8] = 1;
-            mBitFlipHints[path * 8][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 1] = 0;
-            mBitFlipCount[path * 8 + 2] = 0;
-            mBitFlipCount[path * 8 + 3] = 0;
-            mBitFlipCount[path * 8 + 4] = 1;
-            mBitFlipHints[path * 8 + 4][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 5] = 1;
-            mBitFlipHints[path * 8 + 5][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 6] = 1;
-            mBitFlipHints[path * 8 + 6][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 7] = 0;
-        } else {
-            fParityInv = 1.0;
-            mBitFlipCount[path * 8] = 0;
-            mBitFlipCount[path * 8 + 1] = 1;
-            mBitFlipHints[path * 8 + 1][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 2] = 1;
-            mBitFlipHints[path * 8 + 2][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 3] = 1;
-            mBitFlipHints[path * 8 + 3][0] = mIndices[0];
-            mBitFlipCount[path * 8 + 4] = 0;
-            mBitFlipCount[path * 8 + 5] = 0;
-            mBitFlipCount[path * 8 + 6] = 0;
-            mBitFlipCount[path * 8 + 7] = 1;
-            mBitFlipHints[path * 8 + 7][0] = mIndices[0];
-        }
-
-        mMetrics[path * 8] = metric;
-        mMetrics[path * 8 + 1] = metric - fParityInv * mTemp[0] - mTemp[1];
-        mMetrics[path * 8 + 2] = metric - fParityInv * mTemp[0] - mTemp[2];
-        mMetrics[path * 8 + 3] = metric - fParityInv * mTemp[0] - mTemp[3];
-        mMetrics[path * 8 + 4] = metric - mTemp[1] - mTemp[2];
-        mMetrics[path * 8 + 5] = metric - mTemp[1] - mTemp[3];
-        mMetrics[path * 8 + 6] = metric - mTemp[2] - mTemp[3];
-        mMetrics[path * 8 + 7] =
-            metric - fParityInv * mTemp[0] - mTemp[1] - mTemp[2] - mTemp[3];
-
-        mBitFlipHints[path * 8 + 1][mBitFlipCount[path * 8 + 1]++] = mIndices[1];
-        mBitFlipHints[path * 8 + 2][mBitFlipCount[path * 8 + 2]++] = mIndices[2];
-        mBitFlipHints[path * 8 + 3][mBitFlipCount[path * 8 + 3]++] = mIndices[3];
-        mBitFlipHints[path * 8 + 4][mBitFlipCount[path * 8 + 4]++] = mIndices[1];
-        mBitFlipHints[path * 8 + 4][mBitFlipCount[path * 8 + 4]++] = mIndices[2];
-        mBitFlipHints[path * 8 + 5][mBitFlipCount[path * 8 + 5]++] = mIndices[1];
-        mBitFlipHints[path * 8 + 5][mBitFlipCount[path * 8 + 5]++] = mIndices[3];
-        mBitFlipHints[path * 8 + 6][mBitFlipCount[path * 8 + 6]++] = mIndices[2];
-        mBitFlipHints[path * 8 + 6][mBitFlipCount[path * 8 + 6]++] = mIndices[3];
-        mBitFlipHints[path * 8 + 7][mBitFlipCount[path * 8 + 7]++] = mIndices[1];
-        mBitFlipHints[path * 8 + 7][mBitFlipCount[path * 8 + 7]++] = mIndices[2];
-        mBitFlipHints[path * 8 + 7][mBitFlipCount[path * 8 + 7]++] = mIndices[3];
+            values[i] = FastSscAvx::_mm256_abs_ps(Llr);
+        }
+        _mm256_storeu_ps(parities + path, vParity);
+        findWeakLlrsInterleaved(values, indices, mBlockLength, 4);
+
+        __m256 candidates[8];
+        spcCandidates(
+            _mm256_loadu_ps(&xmPathList->Metric(path)), vParity, values, candidates);
+        storeCandidates(candidates, 8, mMetrics, path, pathCount);
+        storeWeakIndices(indices, 4, mWeakIndices, path, pathCount);
     }
 
     unsigned newPathCount = std::min(pathCount * 8, (unsigned)mListSize);
     xmPathList->setNextPathCount(newPathCount);
-    simplePartialSortDescending<unsigned, float>(
-        mIndices, mMetrics, newPathCount, pathCount * 8);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 8);
 
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->duplicatePath(path, mIndices[path] / 8, mStage);
@@ -596,57 +1307,74 @@ void SpcDecoder::decode()
 
     xmPathList->clearOldPaths(mStage);
 
-    union {
-        float* fBitDestination;
-        unsigned int* iBitDestination;
-    };
-
     for (unsigned path = 0; path < newPathCount; ++path) {
-        xmPathList->getWriteAccessToNextBit(path, mStage);
+        const unsigned source = mIndices[path] / 8;
+        const unsigned flips =
+            SPC_FLIPS[std::signbit(parities[source])][mIndices[path] % 8];
         xmPathList->NextMetric(path) = mMetrics[path];
-        float* LlrSource = xmPathList->NextLlr(path, mStage);
-        fBitDestination = xmPathList->NextBit(path, mStage);
-        for (unsigned i = 0; i < mBlockLength; i += 8) {
-            __m256 Llr = _mm256_load_ps(LlrSource + i);
-            _mm256_store_ps(fBitDestination + i, Llr);
-        }
-
-        unsigned source = mIndices[path], max = mBitFlipCount[source];
-        for (unsigned i = 0; i < max; ++i) {
-            iBitDestination[mBitFlipHints[source][i]] ^= 0x80000000;
-        }
+        mPathMasks[path] = interleavedFlips(&mWeakIndices[source * 4], 4, flips);
     }
 
     xmPathList->switchToNext();
+    decideInterleaved(xmPathList->InterleavedLlr(mStage),
+                      xmPathList->InterleavedBit(mStage),
+                      mPathMasks.data(),
+                      mBlockLength,
+                      laneCount,
+                      newPathCount);
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 
-Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
+unsigned classifyNode(const std::vector<unsigned>& frozenBits,
+                      size_t blockLength,
+                      bool& split,
+                      size_t& sourceLength)
 {
-    size_t blockLength = parent->blockLength();
     size_t frozenBitCount = frozenBits.size();
+    split = false;
 
     if (frozenBitCount == 0) {
-        return new RateOneDecoder(parent);
+        return tRateOne;
     }
 
     if (frozenBitCount == blockLength) {
-        return new RateZeroDecoder(parent);
+        return tRateZero;
     }
 
     if (frozenBitCount == blockLength - 1 && blockLength < 8) {
-        return new RepetitionDecoder(parent);
+        return tRepetition;
     }
 
     if (frozenBitCount == 1) {
-        return new SpcDecoder(parent);
+        return tSpc;
     }
 
-
+    split = true;
     if (blockLength <= 8) {
-        return new ShortRateRNode(frozenBits, parent);
+        return tShortRateR;
     } else {
-        return new RateRNode(frozenBits, parent);
+        return tRateR;
+    }
+}
+
+Node* createDecoder(const DecoderPlan& plan, int index, Node* parent)
+{
+    const PlanNode& node = plan.node(index);
+
+    switch (node.type) {
+    case tRateOne:
+        return new RateOneDecoder(parent);
+    case tRateZero:
+        return new RateZeroDecoder(parent);
+    case tRepetition:
+        return new RepetitionDecoder(parent);
+    case tSpc:
+        return new SpcDecoder(parent);
+    case tShortRateR:
+        return new ShortRateRNode(plan, node, parent);
+    default:
+        return new RateRNode(plan, node, parent);
     }
 }
 
@@ -655,11 +1383,24 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
 SclAvxFloat::SclAvxFloat(size_t blockLength,
                          size_t listSize,
                          const std::vector<unsigned>& frozenBits)
-    : mListSize(listSize)
+    : mListSize(listSize),
+      mPathSelection(tThresholdSelect),
+      mThreadCount(1),
+      mTeam(nullptr)
 {
     initialize(blockLength, frozenBits);
 }
 
+SclAvxFloat::SclAvxFloat(plan_t plan, size_t listSize)
+    : mListSize(listSize),
+      mPathSelection(tThresholdSelect),
+      mThreadCount(1),
+      mTeam(nullptr),
+      mPlan(plan)
+{
+    initializeContext();
+}
+
 SclAvxFloat::~SclAvxFloat() { clear(); }
 
 void SclAvxFloat::clear()
@@ -669,6 +1410,20 @@ void SclAvxFloat::clear()
     delete mNodeBase;
     delete mPathList;
     delete mDataPool;
+    delete mTeam;
+    delete mLlrContainer;
+    delete mBitContainer;
+    delete[] mOutputContainer;
+    mLlrContainer = nullptr;
+    mBitContainer = nullptr;
+    mOutputContainer = nullptr;
+    mTeam = nullptr;
+}
+
+plan_t SclAvxFloat::makePlan(size_t blockLength, const std::vector<unsigned>& frozenBits)
+{
+    return std::make_shared<const DecoderPlan>(
+        blockLength, frozenBits, SclAvx::classifyNode);
 }
 
 void SclAvxFloat::initialize(size_t blockLength, const std::vector<unsigned>& frozenBits)
@@ -679,18 +1434,110 @@ void SclAvxFloat::initialize(size_t blockLength, const std::vector<unsigned>& fr
     if (mBlockLength != 0) {
         clear();
     }
-    mBlockLength = blockLength;
-    mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
+    mPlan = makePlan(blockLength, frozenBits);
+    initializeContext();
+}
+
+void SclAvxFloat::initializeContext()
+{
+    mBlockLength = mPlan->blockLength();
+    mFrozenBits = mPlan->frozenBits();
     mEncoder = new PolarCode::Encoding::ButterflyFipPacked(mBlockLength, mFrozenBits);
     mEncoder->setSystematic(false);
     mDataPool = new SclAvx::datapool_t();
     mPathList =
         new SclAvx::PathList(mListSize, __builtin_ctz(mBlockLength) + 1, mDataPool);
+    mPathList->selector().setMode(mPathSelection);
+    if (mThreadCount > 1) {
+        mTeam = new ThreadTeam(mThreadCount);
+        mPathList->setTeam(mTeam);
+    }
     mNodeBase = new SclAvx::Node(mBlockLength, mListSize, mDataPool, mPathList);
-    mRootNode = SclAvx::createDecoder(mFrozenBits, mNodeBase);
+    mRootNode = SclAvx::createDecoder(*mPlan, 0, mNodeBase);
+
+    // Reserve the pool for every stage the decoding tree visits
+    std::vector<bool> stages(__builtin_ctz(mBlockLength) + 1, false);
+    stages.back() = true;
+    for (size_t i = 0; i < mPlan->nodeCount(); ++i) {
+        const PlanNode& node = mPlan->node(i);
+        if (node.left >= 0) {
+            stages[__builtin_ctz(node.blockLength) - 1] = true;
+        }
+    }
+    mPathList->reserve(stages);
+
     mLlrContainer = new FloatContainer(mBlockLength);
     mBitContainer = new FloatContainer(mBlockLength, mFrozenBits);
     mOutputContainer = new unsigned char[(mBlockLength - mFrozenBits.size() + 7) / 8];
+
+    configureParityChecks();
+}
+
+void SclAvxFloat::setListSize(size_t newListSize)
+{
+    if (newListSize == mListSize) {
+        return;
+    }
+    clear();
+    mListSize = newListSize;
+    initializeContext();
+}
+
+void SclAvxFloat::setPathSelection(PathSelectionMode mode)
+{
+    mPathSelection = mode;
+    mPathList->selector().setMode(mode);
+}
+
+void SclAvxFloat::setThreadCount(size_t threadCount)
+{
+    if (threadCount == 0) {
+        throw std::invalid_argument("SclAvxFloat: At least one thread is needed!");
+    }
+    if (threadCount == mThreadCount) {
+        return;
+    }
+    clear();
+    mThreadCount = threadCount;
+    initializeContext();
+}
+
+Decoder* SclAvxFloat::clone() const
+{
+    SclAvxFloat* decoder = new SclAvxFloat(mPlan, mListSize);
+    decoder->setPathSelection(mPathSelection);
+    decoder->setThreadCount(mThreadCount);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void SclAvxFloat::setErrorDetection(ErrorDetection::Detector* pDetector)
+{
+    mErrorDetector = pDetector;
+    configureParityChecks();
+}
+
+void SclAvxFloat::setSystematic(bool sys)
+{
+    mSystematic = sys;
+    configureParityChecks();
+}
+
+void SclAvxFloat::configureParityChecks()
+{
+    auto* crc = dynamic_cast<ErrorDetection::DistributedCrc*>(mErrorDetector);
+    if (crc == nullptr || mSystematic) {
+        mPathList->parity().disable();
+        return;
+    }
+    if (crc->messageBits() + crc->getCheckBitCount() !=
+        mBlockLength - mFrozenBits.size()) {
+        throw std::invalid_argument(
+            "SclAvxFloat: Distributed CRC does not match the information length!");
+    }
+    mPathList->parity().configure(
+        mBlockLength, mFrozenBits, mListSize, crc->parityChecks());
 }
 
 bool SclAvxFloat::decode()
@@ -699,52 +1546,70 @@ bool SclAvxFloat::decode()
 
     mRootNode->decode();
 
+    if (mPathList->PathCount() == 0) {
+        // Terminated early, all paths failed a parity check
+        return rejectFrame();
+    }
+
     return extractBestPath();
 }
 
+bool SclAvxFloat::rejectFrame()
+{
+    memset(mOutputContainer, 0, (mBlockLength - mFrozenBits.size() + 7) / 8);
+    return false;
+}
+
 void SclAvxFloat::makeInitialPathList()
 {
     mPathList->clear();
     mPathList->setFirstPath(dynamic_cast<FloatContainer*>(mLlrContainer)->data());
 }
 
-bool SclAvxFloat::extractBestPath()
+bool SclAvxFloat::selectPath(unsigned& path)
 {
     unsigned dataStage = __builtin_ctz(mBlockLength);
     unsigned byteLength = (mBlockLength - mFrozenBits.size() + 7) / 8;
     unsigned pathCount = mPathList->PathCount();
-    bool decoderSuccess = false;
+    float* codeword = dynamic_cast<FloatContainer*>(mBitContainer)->data();
     if (mSystematic) {
-        for (unsigned path = 0; path < pathCount; ++path) {
-            mBitContainer->insertLlr(mPathList->Bit(path, dataStage));
+        for (path = 0; path < pathCount; ++path) {
+            FastSscAvx::unpackBits(
+                mPathList->Bit(path, dataStage), codeword, mBlockLength);
             mBitContainer->getPackedInformationBits(mOutputContainer);
             if (mErrorDetector->check(mOutputContainer, byteLength)) {
-                decoderSuccess = true;
-                break;
+                return true;
             }
         }
         // Fall back to ML path, if none of the candidates was free of errors
-        if (!decoderSuccess) {
-            mBitContainer->insertLlr(mPathList->Bit(0, dataStage));
-            mBitContainer->getPackedInformationBits(mOutputContainer);
-        }
+        path = 0;
+        FastSscAvx::unpackBits(mPathList->Bit(0, dataStage), codeword, mBlockLength);
+        mBitContainer->getPackedInformationBits(mOutputContainer);
     } else { // non-systematic
-        for (unsigned path = 0; path < pathCount; ++path) {
-            mEncoder->setFloatCodeword(mPathList->Bit(path, dataStage));
+        for (path = 0; path < pathCount; ++path) {
+            FastSscAvx::unpackBits(
+                mPathList->Bit(path, dataStage), codeword, mBlockLength);
+            mEncoder->setFloatCodeword(codeword);
             mEncoder->encode();
             mEncoder->getInformation(mOutputContainer);
             if (mErrorDetector->check(mOutputContainer, byteLength)) {
-                decoderSuccess = true;
-                break;
+                return true;
             }
         }
         // Fall back to ML path, if none of the candidates was free of errors
-        if (!decoderSuccess) {
-            mEncoder->setFloatCodeword(mPathList->Bit(0, dataStage));
-            mEncoder->encode();
-            mEncoder->getInformation(mOutputContainer);
-        }
+        path = 0;
+        FastSscAvx::unpackBits(mPathList->Bit(0, dataStage), codeword, mBlockLength);
+        mEncoder->setFloatCodeword(codeword);
+        mEncoder->encode();
+        mEncoder->getInformation(mOutputContainer);
     }
+    return false;
+}
+
+bool SclAvxFloat::extractBestPath()
+{
+    unsigned path;
+    bool decoderSuccess = selectPath(path);
     mPathList->clear(); // Clean up
     return decoderSuccess;
 }
@@ -10,6 +10,9 @@
 #include <polarcode/decoding/scl_fip_char.h>
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <polarcode/polarcode.h>
+#include <cstring>
+#include <map>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Decoding {
@@ -60,6 +63,9 @@ void PathList::duplicatePath(unsigned destination, unsigned source, unsigned sta
         mNextLeftBitTree[destination][i] =
             xmDataPool->lazyDuplicate(mLeftBitTree[source][i]);
     }
+    if (mParity.enabled()) {
+        mParity.duplicatePath(destination, source);
+    }
 }
 
 void PathList::getWriteAccessToLlr(unsigned path, unsigned stage)
@@ -94,12 +100,14 @@ void PathList::switchToNext()
     std::swap(mBitTree, mNextBitTree);
     std::swap(mLeftBitTree, mNextLeftBitTree);
     std::swap(mMetric, mNextMetric);
+    mParity.switchToNext();
     mPathCount = mNextPathCount;
 }
 
 void PathList::setFirstPath(void* pLlr)
 {
     mPathCount = 1;
+    mParity.reset();
     unsigned stage = mStageCount - 1;
     allocateStage(stage);
 
@@ -116,6 +124,20 @@ void PathList::allocateStage(unsigned stage)
     }
 }
 
+void PathList::reserve(const std::vector<bool>& stages)
+{
+    // Stages shorter than a vector share one block size
+    std::map<size_t, size_t> blockCount;
+    for (unsigned stage = 0; stage < mStageCount; ++stage) {
+        if (stages[stage]) {
+            blockCount[nBit2cvecCount(1 << stage)] += 4 * mPathLimit + 1;
+        }
+    }
+    for (auto& count : blockCount) {
+        xmDataPool->reserve(count.first, count.second);
+    }
+}
+
 void PathList::clearStage(unsigned stage)
 {
     for (unsigned path = 0; path < mPathCount; ++path) {
@@ -162,6 +184,44 @@ unsigned PathList::PathLimit() { return mPathLimit; }
 
 void PathList::setNextPathCount(unsigned pc) { mNextPathCount = pc; }
 
+PathSelector& PathList::selector() { return mSelector; }
+
+ParityTracker& PathList::parity() { return mParity; }
+
+void PathList::checkParity(unsigned stage, unsigned blockLength)
+{
+    if (!mParity.enabled() || !mParity.advance(blockLength)) {
+        return;
+    }
+    for (unsigned path = 0; path < mPathCount; ++path) {
+        mParity.insert(path, reinterpret_cast<char*>(Bit(path, stage)));
+    }
+    if (!mParity.checksPending()) {
+        return;
+    }
+
+    unsigned survivors = 0;
+    for (unsigned path = 0; path < mPathCount; ++path) {
+        if (!mParity.passes(path)) {
+            for (unsigned i = stage; i < mStageCount; ++i) {
+                xmDataPool->release(mLlrTree[path][i]);
+                xmDataPool->release(mBitTree[path][i]);
+                xmDataPool->release(mLeftBitTree[path][i]);
+            }
+            continue;
+        }
+        if (survivors != path) {
+            std::swap(mLlrTree[survivors], mLlrTree[path]);
+            std::swap(mBitTree[survivors], mBitTree[path]);
+            std::swap(mLeftBitTree[survivors], mLeftBitTree[path]);
+            std::swap(mMetric[survivors], mMetric[path]);
+            mParity.swapPaths(survivors, path);
+        }
+        ++survivors;
+    }
+    mPathCount = survivors;
+}
+
 Node::Node() {}
 
 Node::Node(Node* other)
@@ -324,6 +384,9 @@ void RateRNode::decode()
     }
 
     mLeft->decode();
+    if (xmPathList->PathCount() == 0) {
+        return; // All paths failed a parity check
+    }
 
     xmPathList->prepareRightDecoding(mStage);
     pathCount = xmPathList->PathCount();
@@ -360,6 +423,9 @@ void ShortRateRNode::decode()
     }
 
     mLeft->decode();
+    if (xmPathList->PathCount() == 0) {
+        return; // All paths failed a parity check
+    }
 
     xmPathList->prepareRightDecoding(mStage);
     pathCount = xmPathList->PathCount();
@@ -418,6 +484,7 @@ void RateZeroDecoder::decode()
         }
         xmPathList->Metric(path) += reduce_add_epi64(punishment);
     }
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 void RateOneDecoder::decode()
@@ -474,7 +541,7 @@ void RateOneDecoder::decode()
 
     unsigned newPathCount = std::min(pathCount * 4, xmPathList->PathLimit());
     xmPathList->setNextPathCount(newPathCount);
-    simplePartialSortDescending(mIndices, mMetrics, newPathCount, pathCount * 4);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 4);
 
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->duplicatePath(path, mIndices[path] / 4, mStage);
@@ -502,6 +569,7 @@ void RateOneDecoder::decode()
     }
 
     xmPathList->switchToNext();
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 
@@ -559,7 +627,7 @@ void RepetitionDecoder::decode()
     }
     unsigned newPathCount = std::min(pathCount * 2, xmPathList->PathLimit());
     xmPathList->setNextPathCount(newPathCount);
-    simplePartialSortDescending(mIndices, mMetrics, newPathCount, pathCount * 2);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 2);
 
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->duplicatePath(path, mIndices[path] / 2, mStage);
@@ -578,6 +646,7 @@ void RepetitionDecoder::decode()
     }
 
     xmPathList->switchToNext();
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 void SpcDecoder::decode()
@@ -695,7 +764,7 @@ void SpcDecoder::decode()
 
     unsigned newPathCount = std::min(pathCount * 8, xmPathList->PathLimit());
     xmPathList->setNextPathCount(newPathCount);
-    simplePartialSortDescending(mIndices, mMetrics, newPathCount, pathCount * 8);
+    xmPathList->selector().select(mIndices, mMetrics, newPathCount, pathCount * 8);
 
     for (unsigned path = 0; path < newPathCount; ++path) {
         xmPathList->duplicatePath(path, mIndices[path] / 8, mStage);
@@ -723,6 +792,7 @@ void SpcDecoder::decode()
     }
 
     xmPathList->switchToNext();
+    xmPathList->checkParity(mStage, mBlockLength);
 }
 
 
@@ -759,7 +829,7 @@ Node* createDecoder(const std::vector<unsigned>& frozenBits, Node* parent)
 SclFipChar::SclFipChar(size_t blockLength,
                        size_t listSize,
                        const std::vector<unsigned>& frozenBits)
-    : mListSize(listSize)
+    : mListSize(listSize), mPathSelection(tThresholdSelect)
 {
     initialize(blockLength, frozenBits);
 }
@@ -791,11 +861,49 @@ void SclFipChar::initialize(size_t blockLength, const std::vector<unsigned>& fro
     mDataPool = new SclFip::datapool_t();
     mPathList =
         new SclFip::PathList(mListSize, __builtin_ctz(mBlockLength) + 1, mDataPool);
+    mPathList->selector().setMode(mPathSelection);
     mNodeBase = new SclFip::Node(mBlockLength, mListSize, mDataPool, mPathList);
     mRootNode = SclFip::createDecoder(frozenBits, mNodeBase);
+    mPathList->reserve(std::vector<bool>(__builtin_ctz(mBlockLength) + 1, true));
     mLlrContainer = new CharContainer(mBlockLength);
     mBitContainer = new CharContainer(mBlockLength, frozenBits);
     mOutputContainer = new unsigned char[(mBlockLength - frozenBits.size() + 7) / 8];
+
+    configureParityChecks();
+}
+
+void SclFipChar::setPathSelection(PathSelectionMode mode)
+{
+    mPathSelection = mode;
+    mPathList->selector().setMode(mode);
+}
+
+void SclFipChar::setErrorDetection(ErrorDetection::Detector* pDetector)
+{
+    mErrorDetector = pDetector;
+    configureParityChecks();
+}
+
+void SclFipChar::setSystematic(bool sys)
+{
+    mSystematic = sys;
+    configureParityChecks();
+}
+
+void SclFipChar::configureParityChecks()
+{
+    auto* crc = dynamic_cast<ErrorDetection::DistributedCrc*>(mErrorDetector);
+    if (crc == nullptr || mSystematic) {
+        mPathList->parity().disable();
+        return;
+    }
+    if (crc->messageBits() + crc->getCheckBitCount() !=
+        mBlockLength - mFrozenBits.size()) {
+        throw std::invalid_argument(
+            "SclFipChar: Distributed CRC does not match the information length!");
+    }
+    mPathList->parity().configure(
+        mBlockLength, mFrozenBits, mListSize, crc->parityChecks());
 }
 
 bool SclFipChar::decode()
@@ -804,6 +912,12 @@ bool SclFipChar::decode()
 
     mRootNode->decode();
 
+    if (mPathList->PathCount() == 0) {
+        // Terminated early, all paths failed a parity check
+        memset(mOutputContainer, 0, (mBlockLength - mFrozenBits.size() + 7) / 8);
+        return false;
+    }
+
     return extractBestPath();
 }
 
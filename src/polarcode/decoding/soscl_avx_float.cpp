@@ -0,0 +1,119 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/arrayfuncs.h>
+#include <polarcode/decoding/soscl_avx_float.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace {
+const float DEFAULT_PENALTY = 4.0f;
+}
+
+SoSclAvxFloat::SoSclAvxFloat(size_t blockLength,
+                             size_t listSize,
+                             const std::vector<unsigned>& frozenBits)
+    : SclAvxFloat(blockLength, listSize, frozenBits), mPenalty(DEFAULT_PENALTY)
+{
+    allocateOutput();
+}
+
+SoSclAvxFloat::SoSclAvxFloat(plan_t plan, size_t listSize)
+    : SclAvxFloat(plan, listSize), mPenalty(DEFAULT_PENALTY)
+{
+    allocateOutput();
+}
+
+SoSclAvxFloat::~SoSclAvxFloat() {}
+
+void SoSclAvxFloat::allocateOutput()
+{
+    // The path list writes whole vectors
+    mPosterior.assign(nBit2fCount(mBlockLength), 0.0f);
+    mExtrinsic.assign(mBlockLength, 0.0f);
+}
+
+void SoSclAvxFloat::initialize(size_t blockLength,
+                               const std::vector<unsigned>& frozenBits)
+{
+    SclAvxFloat::initialize(blockLength, frozenBits);
+    allocateOutput();
+}
+
+Decoder* SoSclAvxFloat::clone() const
+{
+    SoSclAvxFloat* decoder = new SoSclAvxFloat(plan(), mPathList->PathLimit());
+    decoder->setPathSelection(mPathList->selector().mode());
+    decoder->setPenalty(mPenalty);
+    decoder->setSystematic(mSystematic);
+    decoder->setErrorDetection(mErrorDetector);
+    return decoder;
+}
+
+void SoSclAvxFloat::setPenalty(float penalty)
+{
+    if (!(penalty >= 0.0f)) {
+        throw std::invalid_argument("SoSclAvxFloat: The penalty must not be negative!");
+    }
+    mPenalty = penalty;
+}
+
+bool SoSclAvxFloat::extractBestPath()
+{
+    unsigned path;
+    bool decoderSuccess = selectPath(path);
+
+    const float* channel = dynamic_cast<FloatContainer*>(mLlrContainer)->data();
+    float* extrinsic = mExtrinsic.data();
+
+    if (!decoderSuccess && mErrorDetector->getCheckBitCount() > 0) {
+        // All paths are known to be wrong, their metrics do not tell anything
+        memset(extrinsic, 0, mBlockLength * sizeof(float));
+        mBitContainer->insertLlr(channel);
+        mPathList->clear();
+        return false;
+    }
+
+    mPathList->softDecisions(
+        path, __builtin_ctz(mBlockLength), mPenalty, mPosterior.data());
+
+    const float* posterior = mPosterior.data();
+    unsigned bit = 0;
+    for (; bit + 8 <= mBlockLength; bit += 8) {
+        _mm256_storeu_ps(extrinsic + bit,
+                         _mm256_sub_ps(_mm256_loadu_ps(posterior + bit),
+                                       _mm256_load_ps(channel + bit)));
+    }
+    for (; bit < mBlockLength; ++bit) {
+        extrinsic[bit] = posterior[bit] - channel[bit];
+    }
+    mBitContainer->insertLlr(posterior);
+
+    mPathList->clear(); // Clean up
+    return decoderSuccess;
+}
+
+bool SoSclAvxFloat::rejectFrame()
+{
+    // No path survived the parity checks, so there is nothing to add
+    memset(mExtrinsic.data(), 0, mBlockLength * sizeof(float));
+    mBitContainer->insertLlr(dynamic_cast<FloatContainer*>(mLlrContainer)->data());
+    return SclAvxFloat::rejectFrame();
+}
+
+void SoSclAvxFloat::getExtrinsicChannelInformation(float* eLlr)
+{
+    memcpy(eLlr, mExtrinsic.data(), mBlockLength * sizeof(float));
+}
+
+} // namespace Decoding
+} // namespace PolarCode
@@ -0,0 +1,127 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/decoding/thread_team.h>
+
+#include <immintrin.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace Decoding {
+
+namespace {
+
+// Rounds a member polls for the next job before it sleeps
+constexpr unsigned SPIN_LIMIT = 1 << 12;
+
+// Rounds of busy waiting before a waiting thread yields its core
+constexpr unsigned PAUSE_LIMIT = 1 << 6;
+
+// Back off in a wait loop, so that other members can run on a busy core
+inline void relax(unsigned round)
+{
+    if (round < PAUSE_LIMIT) {
+        _mm_pause();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+ThreadTeam::ThreadTeam(size_t size)
+    : mJob(nullptr), mGeneration(0), mPending(0), mStop(false)
+{
+    if (size == 0) {
+        throw std::invalid_argument("ThreadTeam: A team needs at least one member!");
+    }
+    for (unsigned member = 1; member < size; ++member) {
+        mThreads.emplace_back(&ThreadTeam::work, this, member);
+    }
+}
+
+ThreadTeam::~ThreadTeam()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+        mGeneration.fetch_add(1, std::memory_order_release);
+    }
+    mWakeup.notify_all();
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+size_t ThreadTeam::size() const { return mThreads.size() + 1; }
+
+void ThreadTeam::run(const job_t& job)
+{
+    if (mThreads.empty()) {
+        job(0);
+        return;
+    }
+
+    mJob = &job;
+    mPending.store(mThreads.size(), std::memory_order_relaxed);
+    {
+        // Sleeping members check the generation under the lock
+        std::lock_guard<std::mutex> lock(mMutex);
+        mGeneration.fetch_add(1, std::memory_order_release);
+    }
+    mWakeup.notify_all();
+
+    job(0);
+    for (unsigned round = 0; mPending.load(std::memory_order_acquire) != 0; ++round) {
+        relax(round);
+    }
+}
+
+void ThreadTeam::split(unsigned count, unsigned granularity, const range_t& body)
+{
+    const unsigned chunks = (count + granularity - 1) / granularity;
+    const unsigned members = size();
+    run([&](unsigned member) {
+        const unsigned begin = chunks * member / members * granularity;
+        const unsigned end =
+            std::min(count, chunks * (member + 1) / members * granularity);
+        if (begin < end) {
+            body(member, begin, end);
+        }
+    });
+}
+
+void ThreadTeam::work(unsigned member)
+{
+    unsigned seen = 0;
+    while (true) {
+        unsigned generation = mGeneration.load(std::memory_order_acquire);
+        for (unsigned round = 0; generation == seen && round < SPIN_LIMIT; ++round) {
+            relax(round);
+            generation = mGeneration.load(std::memory_order_acquire);
+        }
+        if (generation == seen) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWakeup.wait(lock, [&]() {
+                return mGeneration.load(std::memory_order_acquire) != seen;
+            });
+            generation = mGeneration.load(std::memory_order_acquire);
+        }
+        seen = generation;
+        if (mStop) {
+            return;
+        }
+
+        (*mJob)(member);
+        mPending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+} // namespace Decoding
+} // namespace PolarCode
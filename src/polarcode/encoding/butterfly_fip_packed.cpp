@@ -9,6 +9,7 @@
 #include <polarcode/encoding/butterfly_fip.h>
 #include <polarcode/encoding/butterfly_fip_packed.h>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 
 
@@ -16,20 +17,21 @@ namespace PolarCode {
 namespace Encoding {
 
 
-ButterflyFipPacked::ButterflyFipPacked() {}
+ButterflyFipPacked::ButterflyFipPacked() : mExternalContainer(nullptr) {}
 
-ButterflyFipPacked::ButterflyFipPacked(size_t blockLength)
+ButterflyFipPacked::ButterflyFipPacked(size_t blockLength) : mExternalContainer(nullptr)
 {
     initialize(blockLength, {});
 }
 
 ButterflyFipPacked::ButterflyFipPacked(size_t blockLength,
                                        const std::vector<unsigned>& frozenBits)
+    : mExternalContainer(nullptr)
 {
     initialize(blockLength, frozenBits);
 }
 
-ButterflyFipPacked::~ButterflyFipPacked() {}
+ButterflyFipPacked::~ButterflyFipPacked() { delete mExternalContainer; }
 
 void ButterflyFipPacked::initialize(size_t blockLength,
                                     const std::vector<unsigned>& frozenBits)
@@ -40,6 +42,9 @@ void ButterflyFipPacked::initialize(size_t blockLength,
     if (mBitContainer != nullptr)
         delete mBitContainer;
     mBitContainer = new PackedContainer(mBlockLength, mFrozenBits);
+
+    delete mExternalContainer;
+    mExternalContainer = new PackedContainer(nullptr, mBlockLength, mFrozenBits);
 }
 
 void ButterflyFipPacked::encode()
@@ -49,19 +54,41 @@ void ButterflyFipPacked::encode()
         mBitContainer->insertPackedInformationBits(xmInputData);
     }
 
-    transform();
+    fipv* vBit =
+        reinterpret_cast<fipv*>(dynamic_cast<PackedContainer*>(mBitContainer)->data());
+    transform(vBit);
 
     if (mSystematic) {
         mBitContainer->resetFrozenBits();
-        transform();
+        transform(vBit);
     }
     mCodewordReady = false;
 }
 
-void ButterflyFipPacked::transform()
+void ButterflyFipPacked::encodeExternal(unsigned char* pInfo, unsigned char* pCode)
+{
+    // Short codes are padded to a full vector, which the caller does not provide
+    if (mBlockLength < BITSPERVECTOR ||
+        reinterpret_cast<uintptr_t>(pCode) % BYTESPERVECTOR != 0) {
+        Encoder::encodeExternal(pInfo, pCode);
+        return;
+    }
+
+    mExternalContainer->setData(reinterpret_cast<char*>(pCode));
+    mErrorDetector->generate(pInfo, (mBlockLength - mFrozenBits.size()) / 8);
+    mExternalContainer->insertPackedInformationBits(pInfo);
+
+    fipv* vBit = reinterpret_cast<fipv*>(pCode);
+    transform(vBit);
+
+    if (mSystematic) {
+        mExternalContainer->resetFrozenBits();
+        transform(vBit);
+    }
+}
+
+void ButterflyFipPacked::transform(fipv* vBit)
 {
-    fipv* vBit =
-        reinterpret_cast<fipv*>(dynamic_cast<PackedContainer*>(mBitContainer)->data());
     int n = __builtin_ctz(mBlockLength); // log2() on powers of 2
 
     for (int stage = 0; stage < n; ++stage) {
@@ -10,6 +10,7 @@
 #include <polarcode/errordetection/dummy.h>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 
 namespace PolarCode {
 namespace Encoding {
@@ -89,6 +90,20 @@ void Encoder::encode_vector(void* pInfo, void* pCode)
     //     std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
 }
 
+void Encoder::encode_vector(void* pInfo, size_t infoSize, void* pCode, size_t codeSize)
+{
+    if (infoSize < (infoLength() + 7) / 8 || codeSize < mBlockLength / 8) {
+        throw std::invalid_argument("Encoder: Buffer too short for this code!");
+    }
+    encodeExternal(static_cast<unsigned char*>(pInfo),
+                   static_cast<unsigned char*>(pCode));
+}
+
+void Encoder::encodeExternal(unsigned char* pInfo, unsigned char* pCode)
+{
+    encode_vector(pInfo, pCode);
+}
+
 UndefinedEncoder::UndefinedEncoder() {}
 
 UndefinedEncoder::~UndefinedEncoder() {}
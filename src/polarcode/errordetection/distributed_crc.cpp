@@ -0,0 +1,175 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018 Florian Lotze
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <polarcode/errordetection/distributed_crc.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace PolarCode {
+namespace ErrorDetection {
+
+namespace {
+
+inline bool getBit(const unsigned char* data, unsigned position)
+{
+    return (data[position / 8] >> (7 - position % 8)) & 1;
+}
+
+inline void setBit(unsigned char* data, unsigned position, bool bit)
+{
+    const unsigned char mask = 0x80 >> (position % 8);
+    data[position / 8] = bit ? data[position / 8] | mask : data[position / 8] & ~mask;
+}
+
+} // namespace
+
+DistributedCrc::DistributedCrc(unsigned messageBits, unsigned width, uint32_t polynomial)
+    : mMessageBits(messageBits), mWidth(width)
+{
+    if (width == 0 || width > 32 || messageBits == 0) {
+        throw std::invalid_argument("DistributedCrc: Invalid message or CRC size!");
+    }
+
+    // Column i holds the contribution of message bit i, x^(width+K-1-i) mod g
+    const uint64_t generator = (uint64_t(1) << width) | polynomial;
+    std::vector<uint64_t> columns(messageBits);
+    uint64_t column = polynomial & ((uint64_t(1) << width) - 1);
+    for (unsigned i = messageBits; i-- > 0;) {
+        columns[i] = column;
+        column <<= 1;
+        if (column >> width & 1) {
+            column ^= generator;
+        }
+    }
+
+    std::vector<bool> placed(messageBits, false), done(width, false);
+    mMessagePositions.resize(messageBits);
+    unsigned position = 0;
+    for (unsigned step = 0; step < width; ++step) {
+        // Place the CRC bit with the fewest outstanding message bits next
+        unsigned best = width, bestCount = messageBits + 1;
+        for (unsigned j = 0; j < width; ++j) {
+            if (done[j]) {
+                continue;
+            }
+            unsigned count = 0;
+            for (unsigned i = 0; i < messageBits; ++i) {
+                count += !placed[i] && (columns[i] >> (width - 1 - j) & 1);
+            }
+            if (count < bestCount) {
+                best = j;
+                bestCount = count;
+            }
+        }
+
+        ParityCheck check;
+        for (unsigned i = 0; i < messageBits; ++i) {
+            if (columns[i] >> (width - 1 - best) & 1) {
+                if (!placed[i]) {
+                    placed[i] = true;
+                    mMessagePositions[i] = position++;
+                }
+                check.dependencies.push_back(mMessagePositions[i]);
+            }
+        }
+        check.position = position++;
+        mChecks.push_back(check);
+        done[best] = true;
+    }
+
+    // Message bits which no CRC bit covers
+    for (unsigned i = 0; i < messageBits; ++i) {
+        if (!placed[i]) {
+            mMessagePositions[i] = position++;
+        }
+    }
+}
+
+DistributedCrc::~DistributedCrc() {}
+
+bool DistributedCrc::passes(const unsigned char* data, const ParityCheck& check) const
+{
+    bool parity = getBit(data, check.position);
+    for (unsigned position : check.dependencies) {
+        parity ^= getBit(data, position);
+    }
+    return !parity;
+}
+
+void DistributedCrc::checkLength(int bytes) const
+{
+    if (bytes < 0 || static_cast<unsigned>(bytes) < (mMessageBits + mWidth + 7) / 8) {
+        throw std::invalid_argument(
+            "DistributedCrc: Data is shorter than the message and its CRC!");
+    }
+}
+
+void DistributedCrc::generate(void* pData, int bytes)
+{
+    checkLength(bytes);
+    unsigned char* data = reinterpret_cast<unsigned char*>(pData);
+    for (const ParityCheck& check : mChecks) {
+        bool parity = false;
+        for (unsigned position : check.dependencies) {
+            parity ^= getBit(data, position);
+        }
+        setBit(data, check.position, parity);
+    }
+}
+
+bool DistributedCrc::check(void* pData, int bytes)
+{
+    checkLength(bytes);
+    const unsigned char* data = reinterpret_cast<unsigned char*>(pData);
+    for (const ParityCheck& check : mChecks) {
+        if (!passes(data, check)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int DistributedCrc::multiCheck(void** pData, int nArrays, int nBytes)
+{
+    for (int array = 0; array < nArrays; ++array) {
+        if (check(pData[array], nBytes)) {
+            return array;
+        }
+    }
+    return -1;
+}
+
+unsigned DistributedCrc::messageBits() const { return mMessageBits; }
+
+const std::vector<ParityCheck>& DistributedCrc::parityChecks() const { return mChecks; }
+
+void DistributedCrc::interleave(const void* pMessage, void* pData)
+{
+    const unsigned char* message = reinterpret_cast<const unsigned char*>(pMessage);
+    unsigned char* data = reinterpret_cast<unsigned char*>(pData);
+    const unsigned bytes = (mMessageBits + mWidth + 7) / 8;
+    memset(data, 0, bytes);
+    for (unsigned i = 0; i < mMessageBits; ++i) {
+        setBit(data, mMessagePositions[i], getBit(message, i));
+    }
+    generate(data, bytes);
+}
+
+void DistributedCrc::deinterleave(const void* pData, void* pMessage)
+{
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(pData);
+    unsigned char* message = reinterpret_cast<unsigned char*>(pMessage);
+    memset(message, 0, (mMessageBits + 7) / 8);
+    for (unsigned i = 0; i < mMessageBits; ++i) {
+        setBit(message, i, getBit(data, mMessagePositions[i]));
+    }
+}
+
+} // namespace ErrorDetection
+} // namespace PolarCode
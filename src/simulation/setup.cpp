@@ -76,9 +76,9 @@ void Configurator::setupArgumentSimType()
 {
     vector<string> SimTypesVector = { "single",     "codelength", "designsnr",
                                       "listlength", "rate",       "amplification",
-                                      "fixed",      "depthfirst", "scan",
-                                      "fastsscan",  "ask",        "compareall",
-                                      "getcode" };
+                                      "fixed",      "depthfirst", "dscf",
+                                      "scan",       "fastsscan",  "bp",
+                                      "ask",        "compareall", "getcode" };
     availableSimTypes = new ValuesConstraint<string>(SimTypesVector);
 
     auto SimType = new UnlabeledValueArg<string>(
@@ -20,7 +20,9 @@
 #include <polarcode/decoding/adaptive_char.h>
 #include <polarcode/decoding/adaptive_float.h>
 #include <polarcode/decoding/adaptive_mixed.h>
+#include <polarcode/decoding/bp_avx_float.h>
 #include <polarcode/decoding/depth_first.h>
+#include <polarcode/decoding/dscf_avx_float.h>
 #include <polarcode/decoding/fastssc_avx_float.h>
 #include <polarcode/decoding/fastssc_fip_char.h>
 #include <polarcode/decoding/fastsscan_float.h>
@@ -34,8 +36,6 @@
 #include <polarcode/errordetection/crc8.h>
 #include <polarcode/errordetection/dummy.h>
 
-#include "fixedfrozenbits.h"
-
 namespace Simulation {
 
 Simulator::Simulator(Setup::Configurator* config) : mConfiguration(config), mNextJob(0)
@@ -59,10 +59,14 @@ Simulator::Simulator(Setup::Configurator* config) : mConfiguration(config), mNex
         configureFixedSim();
     } else if (simType == "depthfirst") {
         configureDepthFirstSim();
+    } else if (simType == "dscf") {
+        configureDscfSim();
     } else if (simType == "scan") {
         configureScanSim(false);
     } else if (simType == "fastsscan") {
         configureScanSim(true);
+    } else if (simType == "bp") {
+        configureBpSim();
     } else if (simType == "ask") {
         configureAskSim();
     } else if (simType == "compareall") {
@@ -270,34 +274,28 @@ void Simulator::configureAmplificationSim()
 
 void Simulator::configureFixedSim()
 {
-    /*	using scheme_t = PolarCode::Decoding::CodingScheme;
-            DataPoint* jobTemplate = getDefaultDataPoint();
-
-            std::vector<scheme_t> &registry = PolarCode::Decoding::codeRegistry;
-
-            for(unsigned i = 0; i < registry.size(); ++i) {
-                    DataPoint* job = new DataPoint(*jobTemplate);
+    using scheme_t = PolarCode::Decoding::CodingScheme;
+    DataPoint* jobTemplate = getDefaultDataPoint();
 
-                    scheme_t &scheme = registry[i];
+    std::vector<scheme_t>& registry = PolarCode::Decoding::codeRegistry;
 
-                    job->N = scheme.blockLength;
-                    job->K = scheme.infoLength;
-                    job->designSNR = scheme.designSnr;
-                    job->systematic = scheme.systematic;
-                    job->decoderType = PolarCode::Decoding::DecoderType::tFixed;
-                    job->codingScheme = i;
-                    job->BlocksToSimulate = mConfiguration->getLongInt("workload") /
-       job->N;
+    for (unsigned i = 0; i < registry.size(); ++i) {
+        DataPoint* job = new DataPoint(*jobTemplate);
 
-                    mJobList.push_back(job);
-            }
+        scheme_t& scheme = registry[i];
 
-            delete jobTemplate;*/
+        job->N = scheme.blockLength;
+        job->K = scheme.infoLength;
+        job->designSNR = scheme.designSnr;
+        job->systematic = scheme.systematic;
+        job->decoderType = PolarCode::Decoding::DecoderType::tFixed;
+        job->codingScheme = i;
+        job->BlocksToSimulate = mConfiguration->getLongInt("workload") / job->N;
 
+        mJobList.push_back(job);
+    }
 
-    DataPoint* config = getDefaultDataPoint();
-    config->decoderType = PolarCode::Decoding::DecoderType::tFixed;
-    mJobList.push_back(config);
+    delete jobTemplate;
 }
 
 void Simulator::configureDepthFirstSim()
@@ -320,6 +318,25 @@ void Simulator::configureDepthFirstSim()
     delete jobTemplate;
 }
 
+void Simulator::configureDscfSim()
+{
+    DataPoint* jobTemplate = getDefaultDataPoint();
+    unsigned lMin = mConfiguration->getInt("l-min");
+    unsigned lMax = mConfiguration->getInt("l-max");
+
+    // The list size is used as the trial limit
+    for (unsigned l = lMin; l <= lMax; l *= 2) {
+        DataPoint* job = new DataPoint(*jobTemplate);
+
+        job->L = l;
+        job->decoderType = PolarCode::Decoding::DecoderType::tDscf;
+
+        mJobList.push_back(job);
+    }
+
+    delete jobTemplate;
+}
+
 void Simulator::configureScanSim(bool fastSimplified)
 {
     DataPoint* jobTemplate = getDefaultDataPoint();
@@ -339,6 +356,25 @@ void Simulator::configureScanSim(bool fastSimplified)
     delete jobTemplate;
 }
 
+void Simulator::configureBpSim()
+{
+    DataPoint* jobTemplate = getDefaultDataPoint();
+    unsigned lMin = mConfiguration->getInt("l-min");
+    unsigned lMax = mConfiguration->getInt("l-max");
+
+    // The list size is used as the iteration limit
+    for (unsigned l = lMin; l <= lMax; l *= 2) {
+        DataPoint* job = new DataPoint(*jobTemplate);
+
+        job->L = l;
+        job->decoderType = PolarCode::Decoding::DecoderType::tBp;
+
+        mJobList.push_back(job);
+    }
+
+    delete jobTemplate;
+}
+
 void Simulator::configureAskSim()
 {
     DataPoint* jobTemplate = getDefaultDataPoint();
@@ -480,12 +516,24 @@ void Simulator::configureComparisonSim()
         delete highRateTemplate;
     }
 
-    // And add the fixed/templatized decoder
-    job = new DataPoint(*jobTemplate);
-    job->name = "FFSSC";
-    job->decoderType = PolarCode::Decoding::DecoderType::tFixed;
-    job->amplification = ampFloat;
-    mJobList.push_back(job);
+    // And add the fixed/templatized decoder, if the code is registered
+    std::vector<PolarCode::Decoding::CodingScheme>& registry =
+        PolarCode::Decoding::codeRegistry;
+    for (unsigned i = 0; i < registry.size(); ++i) {
+        if (registry[i].blockLength != (unsigned)jobTemplate->N ||
+            registry[i].infoLength != (unsigned)jobTemplate->K) {
+            continue;
+        }
+        job = new DataPoint(*jobTemplate);
+        job->name = "FFSSC";
+        job->designSNR = registry[i].designSnr;
+        job->systematic = registry[i].systematic;
+        job->decoderType = PolarCode::Decoding::DecoderType::tFixed;
+        job->codingScheme = i;
+        job->amplification = ampFloat;
+        mJobList.push_back(job);
+        break;
+    }
 
     delete jobTemplate;
 }
@@ -691,33 +739,32 @@ void SimulationWorker::selectFrozenBits()
         mFrozenBits = mConstructor->construct();
     } else {
         mConstructor = nullptr;
-        //		std::vector<PolarCode::Decoding::CodingScheme> &registry =
-        // PolarCode::Decoding::codeRegistry; 		std::vector<unsigned> &frozenBits
-        // = registry[mJob->codingScheme].frozenBits;
-        // mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
-        mFrozenBits.assign(fixed1024FrozenIdx.begin(), fixed1024FrozenIdx.end());
+        std::vector<unsigned>& frozenBits =
+            PolarCode::Decoding::codeRegistry[mJob->codingScheme].frozenBits;
+        mFrozenBits.assign(frozenBits.begin(), frozenBits.end());
     }
 }
 
-
 void SimulationWorker::setCoders()
 {
     mEncoder = new PolarCode::Encoding::ButterflyFipPacked(mJob->N, mFrozenBits);
-#if __GNUC__ < 6
     if (mJob->decoderType == PolarCode::Decoding::DecoderType::tFixed) {
-        mDecoder = new PolarCode::Decoding::FastSscFipChar(mJob->N, mFrozenBits);
-#else
-    if (mJob->decoderType == PolarCode::Decoding::DecoderType::tFixed) {
-        // mDecoder = new PolarCode::Decoding::FixedChar(mJob->codingScheme);
-        mDecoder = new PolarCode::Decoding::TemplatizedFloat<1024, fixed1024FrozenSet>(
-            fixed1024FrozenIdx);
-#endif
+        if (mJob->precision == 32) {
+            mDecoder =
+                PolarCode::Decoding::FixedDecoding::createFixedFloat(mJob->codingScheme);
+        } else {
+            mDecoder = new PolarCode::Decoding::FixedChar(mJob->codingScheme);
+        }
     } else if (mJob->decoderType == PolarCode::Decoding::DecoderType::tDepthFirst) {
         mDecoder = new PolarCode::Decoding::DepthFirst(mJob->N, mJob->L, mFrozenBits);
+    } else if (mJob->decoderType == PolarCode::Decoding::DecoderType::tDscf) {
+        mDecoder = new PolarCode::Decoding::DscfAvxFloat(mJob->N, mJob->L, mFrozenBits);
     } else if (mJob->decoderType == PolarCode::Decoding::DecoderType::tScan) {
         mDecoder = new PolarCode::Decoding::Scan(mJob->N, mJob->L, mFrozenBits);
     } else if (mJob->decoderType == PolarCode::Decoding::DecoderType::tFastSscan) {
         mDecoder = new PolarCode::Decoding::FastSscanFloat(mJob->N, mJob->L, mFrozenBits);
+    } else if (mJob->decoderType == PolarCode::Decoding::DecoderType::tBp) {
+        mDecoder = new PolarCode::Decoding::BpAvxFloat(mJob->N, mJob->L, mFrozenBits);
     } else {
         if (mJob->L > 1) {
             switch (mJob->precision) {
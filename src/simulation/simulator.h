@@ -139,7 +139,9 @@ class Simulator
     void configureAmplificationSim();
     void configureFixedSim();
     void configureDepthFirstSim();
+    void configureDscfSim();
     void configureScanSim(bool fastSimplified);
+    void configureBpSim();
     void configureAskSim();
     void snrInflateJobList();
     void configureComparisonSim();
@@ -11,18 +11,44 @@
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
+#include <polarcode/arrayfuncs.h>
 #include <polarcode/construction/bhattacharrya.h>
+#include <polarcode/decoding/adaptive_char.h>
+#include <polarcode/decoding/adaptive_float.h>
+#include <polarcode/decoding/bp_avx_float.h>
+#include <polarcode/decoding/decode_service.h>
+#include <polarcode/decoding/depth_first.h>
+#include <polarcode/decoding/dscf_avx_float.h>
 #include <polarcode/decoding/fastssc_avx_float.h>
 #include <polarcode/decoding/fastssc_fip_char.h>
+#include <polarcode/decoding/fastssc_schedule.h>
 #include <polarcode/decoding/fastsscan_float.h>
 #include <polarcode/decoding/fip_templates.txx>
+#include <polarcode/decoding/fixed_fip_char.h>
+#include <polarcode/decoding/jit_decoder.h>
+#include <polarcode/decoding/path_selection.h>
 #include <polarcode/decoding/scan.h>
 #include <polarcode/decoding/scl_avx_float.h>
 #include <polarcode/decoding/scl_fip_char.h>
+#include <polarcode/decoding/soscl_avx_float.h>
 #include <polarcode/decoding/templatized_float.h>
+#include <polarcode/decoding/templatized_scl.h>
+#include <polarcode/decoding/thread_team.h>
+#include <polarcode/encoding/butterfly_fip_packed.h>
+#include <polarcode/errordetection/crc8.h>
+#include <polarcode/errordetection/distributed_crc.h>
+#include <polarcode/errordetection/dummy.h>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <numeric>
 #include <random>
+#include <thread>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DecodingTest);
 
@@ -491,6 +517,33 @@ void DecodingTest::testGeneralDecodingFunctionsAvx()
     PolarCode::Decoding::FastSscAvx::CombineBitsShort(
         &llr[0].f[0], &llr[1].f[0], &bits.f[0], 4);
     CPPUNIT_ASSERT(testBitVectors(bits.v, expected.v));
+
+    // Packed bits, lowest bit first
+    alignas(32) uint8_t packed[64], leftBits[32], rightBits[32];
+    PolarCode::Decoding::FastSscAvx::packSigns(&bits.f[0], packed, 8);
+    CPPUNIT_ASSERT(packed[0] == 0xFF);
+    leftBits[0] = 0x00;
+    rightBits[0] = 0x0F;
+    PolarCode::Decoding::FastSscAvx::CombineBitsPacked(leftBits, rightBits, packed, 4);
+    CPPUNIT_ASSERT(packed[0] == 0xFF);
+
+    llr[1].v = _mm256_set_ps(-1, 2, 3, -4, 5, 6, -7, 8);
+    llr[0].v = _mm256_set_ps(0, 1, 2, 3, 4, 5, 6, -7);
+    packed[0] = 0x13;
+    expected.v = _mm256_set_ps(-1, 3, 5, -7, 9, 11, -13, 15);
+    PolarCode::Decoding::FastSscAvx::G_function_packed(
+        &llr[0].f[0], &child.f[0], packed, 8);
+    CPPUNIT_ASSERT(testVectors(child.v, expected.v));
+
+    for (unsigned i = 0; i < 32; ++i) {
+        leftBits[i] = 37 * i;
+        rightBits[i] = 101 * i + 3;
+    }
+    PolarCode::Decoding::FastSscAvx::CombineBitsPacked(leftBits, rightBits, packed, 256);
+    for (unsigned i = 0; i < 32; ++i) {
+        CPPUNIT_ASSERT(packed[i] == (leftBits[i] ^ rightBits[i]));
+        CPPUNIT_ASSERT(packed[i + 32] == rightBits[i]);
+    }
 }
 
 #ifdef __AVX2__
@@ -1050,6 +1103,41 @@ void DecodingTest::testFipShort()
 }
 
 
+// Average decoding time per frame, after a first frame has warmed up caches and threads
+static float secondsPerFrame(PolarCode::Decoding::Decoder* decoder,
+                             const std::vector<float>& signal,
+                             const unsigned frames)
+{
+    using namespace std::chrono;
+    decoder->setSignal(signal.data());
+    decoder->decode();
+
+    high_resolution_clock::time_point TimeStart = high_resolution_clock::now();
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        decoder->setSignal(signal.data());
+        decoder->decode();
+    }
+    high_resolution_clock::time_point TimeEnd = high_resolution_clock::now();
+    return duration_cast<duration<float>>(TimeEnd - TimeStart).count() / frames;
+}
+
+// Throughput of a decoder with one to four threads
+static void benchmarkThreads(const std::string& name,
+                             const std::function<void(unsigned)>& setThreadCount,
+                             PolarCode::Decoding::Decoder* decoder,
+                             const std::vector<float>& signal,
+                             const unsigned frames)
+{
+    std::cout << name << ":";
+    for (unsigned threads = 1; threads <= 4; threads *= 2) {
+        setThreadCount(threads);
+        const float TimeUsed = secondsPerFrame(decoder, signal, frames);
+        std::cout << " " << threads << " thread(s) " << siFormat(signal.size() / TimeUsed)
+                  << "bps";
+    }
+    std::cout << std::endl;
+}
+
 void DecodingTest::testPerformance()
 {
     using namespace std::chrono;
@@ -1123,6 +1211,57 @@ void DecodingTest::testPerformance()
               << "s/block]" << std::endl;
 
     delete decoder;
+
+    /*
+     * Threads only pay off, if the kernels they split are long enough, see
+     * SclAvx::PathList::PARALLEL_WORKLOAD and FastSscAvx::PARALLEL_LENGTH.
+     * List decoders reach the workload with long codes or large lists, Fast-SSC
+     * only with codes of at least twice the parallel length.
+     */
+    std::cout << "Thread benchmarks on " << std::thread::hardware_concurrency()
+              << " hardware threads" << std::endl;
+    std::mt19937_64 generator;
+    std::normal_distribution<float> dist(0, 20);
+    for (size_t length : { 1 << 12, 1 << 14, 1 << 16 }) {
+        for (size_t listSize : { 4, 32 }) {
+            PolarCode::Construction::Bhattacharrya constructor(length, length / 2);
+            std::vector<float> llr(length);
+            for (float& value : llr) {
+                value = dist(generator);
+            }
+            PolarCode::Decoding::SclAvxFloat listDecoder(
+                length, listSize, constructor.construct());
+            benchmarkThreads(fmt::format("Threaded list decoder, N={}, L={}, "
+                                         "N*L/PARALLEL_WORKLOAD={:.3g}",
+                                         length,
+                                         listSize,
+                                         float(length * listSize) /
+                                             PolarCode::Decoding::SclAvx::PathList::
+                                                 PARALLEL_WORKLOAD),
+                             [&](unsigned threads) {
+                                 listDecoder.setThreadCount(threads);
+                             },
+                             &listDecoder,
+                             llr,
+                             2);
+        }
+    }
+    for (size_t length : { 1 << 14, 1 << 16, 1 << 18 }) {
+        PolarCode::Construction::Bhattacharrya constructor(length, length / 2);
+        std::vector<float> llr(length);
+        for (float& value : llr) {
+            value = dist(generator);
+        }
+        PolarCode::Decoding::FastSscAvxFloat sscDecoder(length, constructor.construct());
+        benchmarkThreads(
+            fmt::format("Threaded Fast-SSC decoder, N={}, N/PARALLEL_LENGTH={:.3g}",
+                        length,
+                        float(length) / PolarCode::Decoding::FastSscAvx::PARALLEL_LENGTH),
+            [&](unsigned threads) { sscDecoder.setThreadCount(threads); },
+            &sscDecoder,
+            llr,
+            8);
+    }
 }
 
 void DecodingTest::testListDecoder()
@@ -1174,6 +1313,38 @@ void DecodingTest::testListDecoder()
               << "s per block)" << std::endl;
 
     delete decoder;
+
+    // Short stages interleave the paths, duplication permutes their lanes
+    PolarCode::Decoding::SclAvx::datapool_t pool;
+    PolarCode::Decoding::SclAvx::PathList paths(10, 4, &pool);
+    const unsigned lanes = paths.LaneCount();
+    CPPUNIT_ASSERT_EQUAL(16U, lanes);
+    CPPUNIT_ASSERT(paths.interleaved(2) && !paths.interleaved(3));
+
+    paths.setFirstPath(signal);
+    paths.setNextPathCount(3);
+    for (unsigned path = 0; path < 3; ++path) {
+        paths.duplicatePath(path, 0, 1);
+    }
+    paths.clearOldPaths(1);
+    paths.switchToNext();
+    for (unsigned path = 0; path < 3; ++path) {
+        paths.InterleavedLlr(2)[3 * lanes + path] = path;
+    }
+
+    const unsigned sources[] = { 2, 2, 0, 1 };
+    paths.setNextPathCount(4);
+    for (unsigned path = 0; path < 4; ++path) {
+        paths.duplicatePath(path, sources[path], 1);
+    }
+    paths.clearOldPaths(1);
+    paths.switchToNext();
+    CPPUNIT_ASSERT_EQUAL(4U, paths.PathCount());
+    for (unsigned path = 0; path < 4; ++path) {
+        CPPUNIT_ASSERT_EQUAL(float(sources[path]),
+                             paths.InterleavedLlr(2)[3 * lanes + path]);
+        CPPUNIT_ASSERT_EQUAL(signal[7], paths.Llr(path, 3)[7]);
+    }
 }
 
 
@@ -1273,3 +1444,1733 @@ void DecodingTest::testScan()
 
     delete decoder;
 }
+
+/*!
+ * \brief Create BPSK-modulated, noisy LLRs of random codewords.
+ */
+static std::vector<float> makeNoisyFrames(const size_t frames,
+                                          const size_t block_length,
+                                          const std::vector<unsigned>& frozenBits,
+                                          const bool systematic)
+{
+    const size_t info_bytes = (block_length - frozenBits.size() + 7) / 8;
+
+    std::vector<float> llrs(frames * block_length);
+    std::vector<unsigned char> info(info_bytes);
+    std::vector<unsigned char> codeword(block_length / 8);
+
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    encoder.setSystematic(systematic);
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 0.8f);
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (unsigned i = 0; i < info_bytes; ++i) {
+            info[i] = generator();
+        }
+        encoder.setInformation(info.data());
+        encoder.encode();
+        encoder.getEncodedData(codeword.data());
+        for (unsigned i = 0; i < block_length; ++i) {
+            const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+            llrs[frame * block_length + i] = (bit ? -2.0f : 2.0f) + noise(generator);
+        }
+    }
+    return llrs;
+}
+
+void DecodingTest::runBatchDecoding(PolarCode::Decoding::Decoder* decoder,
+                                    const size_t block_length,
+                                    const std::vector<unsigned>& frozenBits)
+{
+    // Odd frame count to cover a partially filled batch
+    const size_t frames = 37;
+    const size_t info_bytes = (block_length - frozenBits.size() + 7) / 8;
+
+    std::vector<float> llrs =
+        makeNoisyFrames(frames, block_length, frozenBits, decoder->isSystematic());
+    // The all-zero code word passes the error detector, random messages do not
+    for (unsigned frame = 0; frame < frames; frame += 3) {
+        std::fill_n(llrs.begin() + frame * block_length, block_length, 2.0f);
+    }
+    std::vector<unsigned char> single(frames * info_bytes, 0);
+    std::vector<unsigned char> batch(frames * info_bytes, 0);
+    bool singleResults[frames], batchResults[frames];
+
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        singleResults[frame] = decoder->decode_vector(
+            llrs.data() + frame * block_length, single.data() + frame * info_bytes);
+    }
+    const bool result =
+        decoder->decode_batch(llrs.data(), frames, batch.data(), batchResults);
+
+    CPPUNIT_ASSERT(single == batch);
+    CPPUNIT_ASSERT(std::equal(singleResults, singleResults + frames, batchResults));
+    CPPUNIT_ASSERT(result == std::all_of(singleResults,
+                                         singleResults + frames,
+                                         [](bool success) { return success; }));
+}
+
+void DecodingTest::testBatchDecoding()
+{
+    PolarCode::ErrorDetection::CRC8 crc;
+    for (size_t block_length = 16; block_length <= 1024; block_length *= 4) {
+        PolarCode::Construction::Bhattacharrya constructor(block_length,
+                                                           block_length / 2);
+        std::vector<unsigned> frozenBits = constructor.construct();
+
+        PolarCode::Decoding::FastSscAvxFloat decoder(block_length, frozenBits);
+        decoder.setErrorDetection(&crc);
+        runBatchDecoding(&decoder, block_length, frozenBits);
+        decoder.setSystematic(false);
+        runBatchDecoding(&decoder, block_length, frozenBits);
+
+        PolarCode::Decoding::FastSscFipChar charDecoder(block_length, frozenBits);
+        charDecoder.setErrorDetection(&crc);
+        runBatchDecoding(&charDecoder, block_length, frozenBits);
+        charDecoder.setSystematic(false);
+        runBatchDecoding(&charDecoder, block_length, frozenBits);
+    }
+}
+
+void DecodingTest::runCloneDecoding(PolarCode::Decoding::Decoder* decoder,
+                                    const size_t block_length,
+                                    const std::vector<unsigned>& frozenBits)
+{
+    const size_t frames = 16;
+    const size_t info_bytes = (block_length - frozenBits.size() + 7) / 8;
+
+    std::vector<float> llrs =
+        makeNoisyFrames(frames, block_length, frozenBits, decoder->isSystematic());
+    std::vector<unsigned char> original(frames * info_bytes, 0);
+    std::vector<unsigned char> cloned(frames * info_bytes, 0);
+
+    std::unique_ptr<PolarCode::Decoding::Decoder> clone(decoder->clone());
+    CPPUNIT_ASSERT(clone != nullptr);
+    CPPUNIT_ASSERT(clone->isSystematic() == decoder->isSystematic());
+    CPPUNIT_ASSERT(clone->frozenBits() == frozenBits);
+
+    // Both decoders work on the same plan at the same time
+    std::thread worker([&]() {
+        clone->decode_batch(llrs.data(), frames, cloned.data());
+    });
+    decoder->decode_batch(llrs.data(), frames, original.data());
+    worker.join();
+
+    CPPUNIT_ASSERT(original == cloned);
+}
+
+void DecodingTest::testPlanSharing()
+{
+    for (size_t block_length = 16; block_length <= 1024; block_length *= 4) {
+        PolarCode::Construction::Bhattacharrya constructor(block_length,
+                                                           block_length / 2);
+        std::vector<unsigned> frozenBits = constructor.construct();
+
+        PolarCode::Decoding::FastSscAvxFloat decoder(block_length, frozenBits);
+        runCloneDecoding(&decoder, block_length, frozenBits);
+        decoder.setSystematic(false);
+        runCloneDecoding(&decoder, block_length, frozenBits);
+
+        PolarCode::Decoding::FastSscFipChar charDecoder(block_length, frozenBits);
+        runCloneDecoding(&charDecoder, block_length, frozenBits);
+
+        PolarCode::Decoding::SclAvxFloat listDecoder(block_length, 4, frozenBits);
+        runCloneDecoding(&listDecoder, block_length, frozenBits);
+
+        // Decoders instantiated from one plan share it instead of a copy
+        PolarCode::Decoding::plan_t plan = listDecoder.plan();
+        PolarCode::Decoding::SclAvxFloat second(plan, 8);
+        CPPUNIT_ASSERT(second.plan() == plan);
+        CPPUNIT_ASSERT(plan->blockLength() == block_length);
+        CPPUNIT_ASSERT(plan->node(0).blockLength == block_length);
+
+        // Changing the list size keeps the plan
+        listDecoder.setListSize(8);
+        CPPUNIT_ASSERT(listDecoder.getListSize() == 8);
+        CPPUNIT_ASSERT(listDecoder.plan() == plan);
+        runCloneDecoding(&listDecoder, block_length, frozenBits);
+    }
+}
+
+void DecodingTest::testDecodeService()
+{
+    const size_t block_length = 256;
+    const size_t frames = 64;
+    const size_t info_bytes = (block_length / 2 + 7) / 8;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, block_length / 2);
+    std::vector<unsigned> frozenBits = constructor.construct();
+    std::vector<float> llrs = makeNoisyFrames(frames, block_length, frozenBits, true);
+
+    PolarCode::Decoding::FastSscAvxFloat fastDecoder(block_length, frozenBits);
+    PolarCode::Decoding::AdaptiveFloat adaptiveDecoder(block_length, 4, frozenBits);
+
+    PolarCode::Decoding::DecodeService service(4);
+    CPPUNIT_ASSERT(service.threadCount() == 4);
+    unsigned fastId = service.registerCode(fastDecoder);
+    unsigned adaptiveId = service.registerCode(adaptiveDecoder);
+    unsigned charId = service.registerCode([&]() {
+        return new PolarCode::Decoding::FastSscFipChar(block_length, frozenBits);
+    });
+
+    auto fastResults = service.submit(llrs.data(), frames, fastId);
+    auto adaptiveResults = service.submit(llrs.data(), frames, adaptiveId);
+    auto charResult = service.submit(llrs.data(), charId);
+
+    std::vector<unsigned char> expected(info_bytes);
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        const float* llr = llrs.data() + frame * block_length;
+
+        bool success = fastDecoder.decode_vector(llr, expected.data());
+        PolarCode::Decoding::DecodeResult result = fastResults[frame].get();
+        CPPUNIT_ASSERT(result.success == success);
+        CPPUNIT_ASSERT(result.information == expected);
+
+        success = adaptiveDecoder.decode_vector(llr, expected.data());
+        result = adaptiveResults[frame].get();
+        CPPUNIT_ASSERT(result.success == success);
+        CPPUNIT_ASSERT(result.information == expected);
+    }
+    CPPUNIT_ASSERT(charResult.get().information.size() == info_bytes);
+
+    PolarCode::Decoding::DecodeServiceStatistics stats = service.statistics();
+    CPPUNIT_ASSERT(stats.completed == 2 * frames + 1);
+    CPPUNIT_ASSERT(stats.queueDepth == 0);
+    CPPUNIT_ASSERT(stats.maxQueueDepth > 0);
+    CPPUNIT_ASSERT(stats.maxLatency >= stats.meanLatency);
+
+    bool rejected = false;
+    try {
+        service.submit(llrs.data(), 42);
+    } catch (std::invalid_argument&) {
+        rejected = true;
+    }
+    CPPUNIT_ASSERT(rejected);
+}
+
+void DecodingTest::testZeroCopy()
+{
+    for (size_t block_length = 16; block_length <= 1024; block_length *= 4) {
+        PolarCode::Construction::Bhattacharrya constructor(block_length,
+                                                           block_length / 2);
+        std::vector<unsigned> frozenBits = constructor.construct();
+        const size_t info_bytes = (block_length / 2 + 7) / 8;
+        std::vector<unsigned char> expected(info_bytes), direct(info_bytes);
+
+        // One spare vector allows a misaligned copy behind the aligned one.
+        // aligned_alloc() needs sizes in multiples of the alignment.
+        float* signal =
+            (float*)std::aligned_alloc(32, (block_length + 8) * sizeof(float));
+        char* charSignal =
+            (char*)std::aligned_alloc(32, (block_length + 63) / 32 * 32);
+
+        PolarCode::Decoding::FastSscAvxFloat decoder(block_length, frozenBits);
+        for (bool systematic : { true, false }) {
+            decoder.setSystematic(systematic);
+            std::vector<float> llrs =
+                makeNoisyFrames(1, block_length, frozenBits, systematic);
+
+            for (unsigned offset : { 0, 1 }) {
+                memcpy(signal + offset, llrs.data(), block_length * sizeof(float));
+                bool success = decoder.decode_vector(
+                    signal + offset, block_length, direct.data(), info_bytes);
+                CPPUNIT_ASSERT(decoder.decode_vector(llrs.data(), expected.data()) ==
+                               success);
+                CPPUNIT_ASSERT(direct == expected);
+            }
+        }
+
+        PolarCode::Decoding::FastSscFipChar charDecoder(block_length, frozenBits);
+        std::vector<float> llrs = makeNoisyFrames(1, block_length, frozenBits, true);
+        std::vector<char> charLlrs(block_length);
+        for (unsigned i = 0; i < block_length; ++i) {
+            charLlrs[i] = std::max(-127.0f, std::min(127.0f, llrs[i] * 20.0f));
+        }
+        for (unsigned offset : { 0, 1 }) {
+            memcpy(charSignal + offset, charLlrs.data(), block_length);
+            bool success = charDecoder.decode_vector(
+                charSignal + offset, block_length, direct.data(), info_bytes);
+            CPPUNIT_ASSERT(charDecoder.decode_vector(charLlrs.data(), expected.data()) ==
+                           success);
+            CPPUNIT_ASSERT(direct == expected);
+        }
+
+        bool rejected = false;
+        try {
+            decoder.decode_vector(signal, block_length - 1, direct.data(), info_bytes);
+        } catch (std::invalid_argument&) {
+            rejected = true;
+        }
+        CPPUNIT_ASSERT(rejected);
+
+        free(signal);
+        free(charSignal);
+    }
+}
+
+void DecodingTest::testDataPool()
+{
+    PolarCode::DataPool<float, 32> pool;
+    pool.reserve(64, 4);
+    pool.reserve(8, 2);
+    const size_t reserved = pool.heapAllocations();
+
+    // Reserved blocks are handed out without further heap allocations
+    std::vector<PolarCode::Block<float>*> blocks;
+    for (unsigned i = 0; i < 4; ++i) {
+        blocks.push_back(pool.allocate(64));
+        CPPUNIT_ASSERT(reinterpret_cast<uintptr_t>(blocks.back()->data) % 32 == 0);
+    }
+    PolarCode::Block<float>* shortBlock = pool.allocate(3);
+    CPPUNIT_ASSERT(shortBlock->size == 8);
+    CPPUNIT_ASSERT(pool.heapAllocations() == reserved);
+
+    // Sizes are rounded up to the next size class
+    PolarCode::Block<float>* oddBlock = pool.allocate(40);
+    CPPUNIT_ASSERT(pool.heapAllocations() == reserved + 1);
+    pool.release(oddBlock);
+    CPPUNIT_ASSERT(oddBlock == nullptr);
+
+    // Lazy copies keep the block until the last reference is gone
+    for (unsigned i = 0; i < 64; ++i) {
+        blocks[0]->data[i] = i;
+    }
+    PolarCode::Block<float>* copy = pool.lazyDuplicate(blocks[0]);
+    pool.prepareForWrite(copy);
+    CPPUNIT_ASSERT(copy != blocks[0]);
+    CPPUNIT_ASSERT(copy->data[63] == 63.0f);
+    CPPUNIT_ASSERT(blocks[0]->useCount == 1);
+
+    for (auto& block : blocks) {
+        pool.release(block);
+    }
+    pool.release(copy);
+    pool.release(shortBlock);
+
+    // Released blocks are recycled
+    for (unsigned i = 0; i < 5; ++i) {
+        blocks.push_back(pool.allocate(64));
+    }
+    CPPUNIT_ASSERT(pool.heapAllocations() == reserved + 1);
+    CPPUNIT_ASSERT(pool.outstandingBlocks() == 5);
+
+    // The pool must not be destroyed while blocks are in use
+    for (auto& block : blocks) {
+        pool.release(block);
+    }
+    CPPUNIT_ASSERT(pool.outstandingBlocks() == 0);
+}
+
+template <typename T>
+static void checkPathSelection(PolarCode::Decoding::PathSelector& selector,
+                               std::vector<T> values,
+                               const unsigned n)
+{
+    const unsigned size = values.size();
+    std::vector<T> expected(values);
+    std::sort(expected.begin(), expected.end(), std::greater<T>());
+
+    std::vector<T> original(values);
+    std::vector<unsigned> indices(size);
+    selector.select(indices, values, n, size);
+    for (unsigned i = 0; i < n; ++i) {
+        CPPUNIT_ASSERT(values[i] == expected[i]);
+        CPPUNIT_ASSERT(original[indices[i]] == expected[i]);
+    }
+}
+
+void DecodingTest::testPathSelection()
+{
+    using PolarCode::Decoding::PathSelector;
+    PathSelector selector(PolarCode::Decoding::tThresholdSelect);
+
+    // Candidate counts of the list decoders' branching nodes, with many ties
+    std::mt19937 generator;
+    std::uniform_int_distribution<int> metric(-20, 20);
+    for (unsigned listSize : { 1, 2, 4, 8, 16, 32 }) {
+        for (unsigned factor : { 2, 4, 8 }) {
+            for (unsigned pathCount = 1; pathCount <= listSize; pathCount *= 2) {
+                const unsigned size = pathCount * factor;
+                const unsigned n = std::min(size, listSize);
+                std::vector<float> floats(size);
+                std::vector<long> longs(size);
+                for (unsigned i = 0; i < size; ++i) {
+                    floats[i] = metric(generator) * 0.5f;
+                    longs[i] = metric(generator);
+                }
+                // Negative infinity and the char decoder's rate-one sentinel
+                floats[size - 1] = -INFINITY;
+                longs[0] = -0x100000000000LL;
+                checkPathSelection(selector, floats, n);
+                checkPathSelection(selector, longs, n);
+            }
+        }
+    }
+
+    // Both algorithms decode noisy frames alike
+    const size_t block_length = 1024;
+    const size_t frames = 8;
+    PolarCode::Construction::Bhattacharrya constructor(block_length, block_length / 2);
+    std::vector<unsigned> frozenBits = constructor.construct();
+    std::vector<float> llrs = makeNoisyFrames(frames, block_length, frozenBits, true);
+
+    PolarCode::Decoding::FastSscAvxFloat reference(block_length, frozenBits);
+    PolarCode::Decoding::SclAvxFloat floatDecoder(block_length, 32, frozenBits);
+    PolarCode::Decoding::SclFipChar charDecoder(block_length, 32, frozenBits);
+    const size_t info_bytes = (block_length - frozenBits.size() + 7) / 8;
+    std::vector<unsigned char> expected(frames * info_bytes);
+    reference.decode_batch(llrs.data(), frames, expected.data());
+
+    for (auto mode :
+         { PolarCode::Decoding::tSelectionSort, PolarCode::Decoding::tThresholdSelect }) {
+        floatDecoder.setPathSelection(mode);
+        charDecoder.setPathSelection(mode);
+        std::vector<unsigned char> floatOutput(frames * info_bytes);
+        std::vector<unsigned char> charOutput(frames * info_bytes);
+        floatDecoder.decode_batch(llrs.data(), frames, floatOutput.data());
+        charDecoder.decode_batch(llrs.data(), frames, charOutput.data());
+        CPPUNIT_ASSERT(floatOutput == expected);
+        CPPUNIT_ASSERT(charOutput == expected);
+    }
+}
+
+void DecodingTest::testDistributedCrc()
+{
+    const size_t block_length = 512;
+    const size_t frames = 16;
+
+    // 140 message bits and the 24-bit CRC of 5G downlink control information
+    PolarCode::ErrorDetection::DistributedCrc crc(140, 24, 0xB2B117);
+    PolarCode::Construction::Bhattacharrya constructor(block_length, 164);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    encoder.setSystematic(false);
+
+    PolarCode::Decoding::SclAvxFloat floatDecoder(block_length, 8, frozenBits);
+    PolarCode::Decoding::SclFipChar charDecoder(block_length, 8, frozenBits);
+    PolarCode::Decoding::SoSclAvxFloat softDecoder(block_length, 8, frozenBits);
+    std::vector<PolarCode::Decoding::Decoder*> decoders = { &floatDecoder,
+                                                            &charDecoder,
+                                                            &softDecoder };
+    for (auto decoder : decoders) {
+        decoder->setSystematic(false);
+        decoder->setErrorDetection(&crc);
+    }
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 0.8f);
+    unsigned char message[18], info[21], output[21], decoded[18];
+    std::vector<unsigned char> codeword(block_length / 8);
+    std::vector<float> llr(block_length), soft(block_length);
+
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (unsigned i = 0; i < sizeof(message); ++i) {
+            message[i] = generator();
+        }
+        message[17] &= 0xF0;
+        crc.interleave(message, info);
+        encoder.setInformation(info);
+        encoder.encode();
+        encoder.getEncodedData(codeword.data());
+        for (unsigned i = 0; i < block_length; ++i) {
+            const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+            llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+        }
+
+        for (auto decoder : decoders) {
+            CPPUNIT_ASSERT(decoder->decode_vector(llr.data(), output));
+            crc.deinterleave(output, decoded);
+            CPPUNIT_ASSERT(memcmp(message, decoded, sizeof(message)) == 0);
+        }
+    }
+
+    // Pure noise is rejected, usually long before the last leaf
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (unsigned i = 0; i < block_length; ++i) {
+            llr[i] = 2.0f * noise(generator);
+        }
+        for (auto decoder : decoders) {
+            CPPUNIT_ASSERT(!decoder->decode_vector(llr.data(), output));
+        }
+
+        // No soft output of the previous frame must remain
+        softDecoder.getExtrinsicChannelInformation(soft.data());
+        CPPUNIT_ASSERT(std::all_of(
+            soft.begin(), soft.end(), [](float e) { return e == 0.0f; }));
+        softDecoder.getSoftCodeword(soft.data());
+        CPPUNIT_ASSERT(soft == llr);
+    }
+}
+
+void DecodingTest::runGeneralizedRepetition(const size_t block_length,
+                                            const size_t source_length,
+                                            const bool spc)
+{
+    std::vector<unsigned> frozen_bit_positions(block_length - source_length + spc);
+    std::iota(frozen_bit_positions.begin(), frozen_bit_positions.end(), 0);
+    auto decoder = std::make_unique<PolarCode::Decoding::FastSscAvxFloat>(
+        block_length, frozen_bit_positions);
+    decoder->setSystematic(false);
+    CPPUNIT_ASSERT(decoder->plan()->node(0).type ==
+                   PolarCode::Decoding::FastSscAvx::tGRepetition);
+
+    float* signal = (float*)std::aligned_alloc(32, block_length * sizeof(float));
+    float* output = (float*)std::aligned_alloc(32, block_length * sizeof(float));
+
+    fillRandom(signal, block_length);
+
+    std::vector<float> expected(block_length);
+    PolarCode::Decoding::FastSscAvx::decode_generalized_repetition_generic(
+        expected.data(), signal, block_length, source_length, spc);
+
+    decoder->setSignal(signal);
+    decoder->decode();
+    decoder->getSoftCodeword(output);
+
+    for (unsigned i = 0; i < block_length; i++) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], output[i], 1e-3);
+    }
+
+    free(signal);
+    free(output);
+
+    runBatchDecoding(decoder.get(), block_length, frozen_bit_positions);
+}
+
+void DecodingTest::runGeneralizedSpc(const size_t block_length, const size_t zero_length)
+{
+    std::vector<unsigned> frozen_bit_positions(zero_length);
+    std::iota(frozen_bit_positions.begin(), frozen_bit_positions.end(), 0);
+    auto decoder = std::make_unique<PolarCode::Decoding::FastSscAvxFloat>(
+        block_length, frozen_bit_positions);
+    decoder->setSystematic(false);
+    CPPUNIT_ASSERT(decoder->plan()->node(0).type ==
+                   PolarCode::Decoding::FastSscAvx::tGParityCheck);
+
+    float* signal = (float*)std::aligned_alloc(32, block_length * sizeof(float));
+    float* output = (float*)std::aligned_alloc(32, block_length * sizeof(float));
+
+    fillRandom(signal, block_length);
+
+    std::vector<float> expected(block_length);
+    PolarCode::Decoding::FastSscAvx::decode_generalized_spc_generic(
+        expected.data(), signal, block_length, zero_length);
+
+    decoder->setSignal(signal);
+    decoder->decode();
+    decoder->getSoftCodeword(output);
+
+    for (unsigned i = 0; i < block_length; i++) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], output[i], 1e-7);
+    }
+
+    free(signal);
+    free(output);
+
+    runBatchDecoding(decoder.get(), block_length, frozen_bit_positions);
+}
+
+void DecodingTest::testGeneralizedNodes()
+{
+    runGeneralizedRepetition(64, 4, false);
+    runGeneralizedRepetition(64, 8, false);
+    runGeneralizedRepetition(256, 32, false);
+    runGeneralizedRepetition(64, 8, true);
+    runGeneralizedRepetition(256, 16, true);
+    runGeneralizedSpc(32, 4);
+    runGeneralizedSpc(64, 8);
+    runGeneralizedSpc(256, 32);
+    runGeneralizedSpc(16, 4);
+
+    size_t generalized = 0;
+    for (size_t block_length = 1024; block_length <= 4096; block_length *= 4) {
+        for (size_t info_length = block_length / 4; info_length < block_length;
+             info_length += block_length / 4) {
+            PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+            std::vector<unsigned> frozenBits = constructor.construct();
+
+            PolarCode::Decoding::FastSscAvxFloat decoder(block_length, frozenBits);
+            PolarCode::Decoding::plan_t plan = decoder.plan();
+            const size_t count =
+                plan->nodeCount(PolarCode::Decoding::FastSscAvx::tGRepetition) +
+                plan->nodeCount(PolarCode::Decoding::FastSscAvx::tGParityCheck);
+            fmt::print("testGeneralizedNodes: N={}, K={}, nodes={}, leaves={}, "
+                       "depth={}, generalized={}\n",
+                       block_length,
+                       info_length,
+                       plan->nodeCount(),
+                       plan->leafCount(),
+                       plan->depth(),
+                       count);
+            generalized += count;
+
+            // The frame-interleaved batch decoder follows the same plan
+            runBatchDecoding(&decoder, block_length, frozenBits);
+            decoder.setSystematic(false);
+            runBatchDecoding(&decoder, block_length, frozenBits);
+        }
+    }
+    CPPUNIT_ASSERT(generalized > 0);
+}
+
+void DecodingTest::testDscf()
+{
+    const size_t block_length = 1024;
+    const size_t info_length = 512;
+    const size_t info_bytes = info_length / 8;
+    const size_t frames = 200;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    encoder.setSystematic(false);
+
+    PolarCode::Decoding::FastSscAvxFloat scDecoder(block_length, frozenBits);
+    PolarCode::Decoding::DscfAvxFloat flipDecoder(block_length, 16, frozenBits);
+    for (PolarCode::Decoding::Decoder* decoder :
+         std::vector<PolarCode::Decoding::Decoder*>{ &scDecoder, &flipDecoder }) {
+        decoder->setSystematic(false);
+        decoder->setErrorDetection(&crc);
+    }
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.6f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> codeword(block_length / 8);
+    std::vector<float> llr(block_length);
+
+    unsigned scSuccess = 0, flipSuccess = 0, trials = 0;
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (auto& byte : message) {
+            byte = generator();
+        }
+        crc.generate(message.data(), info_bytes);
+        encoder.setInformation(message.data());
+        encoder.encode();
+        encoder.getEncodedData(codeword.data());
+        for (unsigned i = 0; i < block_length; ++i) {
+            const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+            llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+        }
+
+        const bool scResult = scDecoder.decode_vector(llr.data(), output.data());
+        const bool scCorrect = memcmp(message.data(), output.data(), info_bytes) == 0;
+        const bool flipResult = flipDecoder.decode_vector(llr.data(), output.data());
+        const bool flipCorrect = memcmp(message.data(), output.data(), info_bytes) == 0;
+        trials += flipDecoder.trialCount();
+
+        // The first run is a Fast-SSC decoding, and trials only follow a failure
+        if (scResult) {
+            CPPUNIT_ASSERT(flipResult);
+            CPPUNIT_ASSERT(flipDecoder.trialCount() == 0);
+            CPPUNIT_ASSERT(scCorrect == flipCorrect);
+        }
+        scSuccess += scCorrect;
+        flipSuccess += flipCorrect;
+    }
+    fmt::print("testDscf: {} of {} frames correct with Fast-SSC, {} with DSCF-16, "
+               "{} trials\n",
+               scSuccess,
+               frames,
+               flipSuccess,
+               trials);
+    CPPUNIT_ASSERT(flipSuccess > scSuccess);
+
+    // Without any valid trial, the result of the first run is kept
+    std::vector<unsigned char> scOutput(info_bytes);
+    for (unsigned frame = 0; frame < 16; ++frame) {
+        for (unsigned i = 0; i < block_length; ++i) {
+            llr[i] = 2.0f * noise(generator);
+        }
+        scDecoder.decode_vector(llr.data(), scOutput.data());
+        flipDecoder.setTrialLimit(frame % 2 ? 4 : 0);
+        if (!flipDecoder.decode_vector(llr.data(), output.data())) {
+            CPPUNIT_ASSERT(memcmp(scOutput.data(), output.data(), info_bytes) == 0);
+        }
+    }
+
+    flipDecoder.setSystematic(true);
+    runBatchDecoding(&flipDecoder, block_length, frozenBits);
+
+    std::unique_ptr<PolarCode::Decoding::Decoder> created(
+        PolarCode::Decoding::create(block_length, 8, frozenBits, "DSCF"));
+    CPPUNIT_ASSERT(dynamic_cast<PolarCode::Decoding::DscfAvxFloat*>(created.get()));
+    CPPUNIT_ASSERT(created->getListSize() == 8);
+}
+
+void DecodingTest::testAdaptiveListSizes()
+{
+    const size_t block_length = 1024;
+    const size_t info_length = 512;
+    const size_t info_bytes = info_length / 8;
+    const size_t frames = 100;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    encoder.setSystematic(false);
+
+    PolarCode::Decoding::AdaptiveFloat floatDecoder(block_length, 8, frozenBits);
+    PolarCode::Decoding::AdaptiveChar charDecoder(block_length, 8, frozenBits);
+    const std::vector<size_t> ladder = { 2, 4, 8 };
+    CPPUNIT_ASSERT(floatDecoder.listSizes() == ladder);
+    CPPUNIT_ASSERT(charDecoder.listSizes() == ladder);
+    CPPUNIT_ASSERT(floatDecoder.getListSize() == 8);
+    const std::vector<size_t> decreasing = { 4, 2 }, single = { 1, 4 };
+    CPPUNIT_ASSERT_THROW(floatDecoder.setListSizes(decreasing), std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(charDecoder.setListSizes(single), std::invalid_argument);
+
+    // Reference: every stage decodes the full frame
+    PolarCode::Decoding::FastSscAvxFloat fastDecoder(block_length, frozenBits);
+    std::vector<std::unique_ptr<PolarCode::Decoding::SclAvxFloat>> listDecoders;
+    for (size_t listSize : ladder) {
+        listDecoders.push_back(std::make_unique<PolarCode::Decoding::SclAvxFloat>(
+            block_length, listSize, frozenBits));
+    }
+
+    std::vector<PolarCode::Decoding::Decoder*> decoders = { &floatDecoder,
+                                                            &charDecoder,
+                                                            &fastDecoder };
+    for (auto& decoder : listDecoders) {
+        decoders.push_back(decoder.get());
+    }
+    for (auto decoder : decoders) {
+        decoder->setSystematic(false);
+        decoder->setErrorDetection(&crc);
+    }
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.7f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> expected(info_bytes), codeword(block_length / 8);
+    std::vector<float> llr(block_length);
+
+    std::vector<unsigned> stages(ladder.back() + 1, 0);
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (auto& byte : message) {
+            byte = generator();
+        }
+        crc.generate(message.data(), info_bytes);
+        encoder.setInformation(message.data());
+        encoder.encode();
+        encoder.getEncodedData(codeword.data());
+        for (unsigned i = 0; i < block_length; ++i) {
+            const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+            llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+        }
+
+        size_t listSize = 1;
+        bool success = fastDecoder.decode_vector(llr.data(), expected.data());
+        for (unsigned i = 0; !success && i < ladder.size(); ++i) {
+            success = listDecoders[i]->decode_vector(llr.data(), expected.data());
+            listSize = ladder[i];
+        }
+
+        CPPUNIT_ASSERT(floatDecoder.decode_vector(llr.data(), output.data()) == success);
+        CPPUNIT_ASSERT(floatDecoder.lastListSize() == listSize);
+        CPPUNIT_ASSERT(output == expected);
+        stages[listSize]++;
+
+        if (charDecoder.decode_vector(llr.data(), output.data())) {
+            CPPUNIT_ASSERT(crc.check(output.data(), info_bytes));
+        }
+        CPPUNIT_ASSERT(charDecoder.lastListSize() <= ladder.back());
+    }
+    fmt::print("testAdaptiveListSizes: {} frames, list sizes used {}\n", frames, stages);
+    CPPUNIT_ASSERT(stages[1] > 0);
+    CPPUNIT_ASSERT(stages[2] + stages[4] + stages[8] > 0);
+
+    floatDecoder.setListSizes({ 4, 32 });
+    CPPUNIT_ASSERT(floatDecoder.getListSize() == 32);
+    runCloneDecoding(&floatDecoder, block_length, frozenBits);
+}
+
+void DecodingTest::testBeliefPropagation()
+{
+    // Vectorized stage updates against the message passing rules
+    const size_t short_length = 64;
+    float* in = (float*)std::aligned_alloc(32, short_length * sizeof(float));
+    float* prior = (float*)std::aligned_alloc(32, short_length * sizeof(float));
+    float* out = (float*)std::aligned_alloc(32, short_length * sizeof(float));
+    fillRandom(in, short_length);
+    fillRandom(prior, short_length);
+    prior[5] = INFINITY;
+    auto boxplus = [](float a, float b) {
+        return std::copysign(0.9375f * std::min(std::fabs(a), std::fabs(b)), a * b);
+    };
+    for (unsigned distance = 1; distance < short_length; distance *= 2) {
+        PolarCode::Decoding::BpAvx::updateStage(out, in, prior, distance, short_length);
+        for (unsigned a = 0; a < short_length; ++a) {
+            if (a & distance) {
+                continue;
+            }
+            const unsigned b = a + distance;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(boxplus(in[a], in[b] + prior[b]), out[a], 1e-5);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(boxplus(in[a], prior[a]) + in[b], out[b], 1e-5);
+        }
+    }
+    free(in);
+    free(prior);
+    free(out);
+
+    const size_t block_length = 1024;
+    const size_t info_length = 512;
+    const size_t info_bytes = info_length / 8;
+    const size_t frames = 100;
+    const unsigned iteration_limit = 50;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    PolarCode::Decoding::BpAvxFloat decoder(block_length, iteration_limit, frozenBits);
+    decoder.setErrorDetection(&crc);
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> codeword(block_length / 8);
+    std::vector<float> llr(block_length), extrinsic(block_length);
+
+    for (bool systematic : { true, false }) {
+        encoder.setSystematic(systematic);
+        decoder.setSystematic(systematic);
+        unsigned correct = 0, iterations = 0;
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            for (auto& byte : message) {
+                byte = generator();
+            }
+            crc.generate(message.data(), info_bytes);
+            encoder.setInformation(message.data());
+            encoder.encode();
+            encoder.getEncodedData(codeword.data());
+            for (unsigned i = 0; i < block_length; ++i) {
+                const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+                llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+            }
+
+            const bool success = decoder.decode_vector(llr.data(), output.data());
+            const bool match = memcmp(message.data(), output.data(), info_bytes) == 0;
+            CPPUNIT_ASSERT(!match || success);
+            correct += match;
+            iterations += decoder.iterationCount();
+            CPPUNIT_ASSERT(decoder.iterationCount() <= iteration_limit);
+        }
+        fmt::print("testBeliefPropagation: systematic={}, {} of {} frames correct, "
+                   "{:.1f} iterations on average\n",
+                   systematic,
+                   correct,
+                   frames,
+                   static_cast<float>(iterations) / frames);
+
+        // Early stopping ends most frames long before the limit
+        CPPUNIT_ASSERT(correct >= frames * 9 / 10);
+        CPPUNIT_ASSERT(iterations < frames * iteration_limit / 2);
+    }
+
+    // The extrinsic information agrees with the corrected code word
+    decoder.getExtrinsicChannelInformation(extrinsic.data());
+    unsigned agreements = 0;
+    for (unsigned i = 0; i < block_length; ++i) {
+        const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+        agreements += std::signbit(extrinsic[i]) == bit;
+    }
+    CPPUNIT_ASSERT(agreements > block_length * 9 / 10);
+
+    std::unique_ptr<PolarCode::Decoding::Decoder> created(
+        PolarCode::Decoding::create(block_length, 20, frozenBits, "BP"));
+    CPPUNIT_ASSERT(dynamic_cast<PolarCode::Decoding::BpAvxFloat*>(created.get()));
+    CPPUNIT_ASSERT(created->getListSize() == 20);
+    runCloneDecoding(created.get(), block_length, frozenBits);
+}
+
+void DecodingTest::testScanEarlyStopping()
+{
+    const size_t block_length = 1024;
+    const size_t info_length = 512;
+    const size_t info_bytes = info_length / 8;
+    const size_t frames = 100;
+    const unsigned iteration_limit = 4;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    PolarCode::Decoding::Scan decoder(block_length, iteration_limit, frozenBits);
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> codeword(block_length / 8);
+    std::vector<float> llr(block_length);
+
+    for (bool systematic : { true, false }) {
+        encoder.setSystematic(systematic);
+        decoder.setSystematic(systematic);
+        decoder.setErrorDetection(&crc);
+        unsigned correct = 0, iterations = 0;
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            for (auto& byte : message) {
+                byte = generator();
+            }
+            crc.generate(message.data(), info_bytes);
+            encoder.setInformation(message.data());
+            encoder.encode();
+            encoder.getEncodedData(codeword.data());
+            for (unsigned i = 0; i < block_length; ++i) {
+                const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+                llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+            }
+
+            const bool success = decoder.decode_vector(llr.data(), output.data());
+            const bool match = memcmp(message.data(), output.data(), info_bytes) == 0;
+            CPPUNIT_ASSERT(!match || success);
+            correct += match;
+            iterations += decoder.iterationCount();
+        }
+        fmt::print("testScanEarlyStopping: systematic={}, {} of {} frames correct, "
+                   "{:.2f} iterations on average\n",
+                   systematic,
+                   correct,
+                   frames,
+                   static_cast<float>(iterations) / frames);
+
+        CPPUNIT_ASSERT(correct >= frames * 9 / 10);
+        CPPUNIT_ASSERT(iterations < frames * iteration_limit / 2);
+
+        // A detector which accepts everything must not stop the iterations
+        decoder.setErrorDetection(&PolarCode::ErrorDetection::globalDummyDetector);
+        decoder.decode_vector(llr.data(), output.data());
+        CPPUNIT_ASSERT(decoder.iterationCount() == iteration_limit);
+    }
+
+    CPPUNIT_ASSERT_THROW(decoder.setIterationLimit(0), std::invalid_argument);
+}
+
+void DecodingTest::testSoftOutputList()
+{
+    const size_t block_length = 1024;
+    const size_t info_length = 512;
+    const size_t info_bytes = info_length / 8;
+    const size_t list_size = 8;
+    const size_t frames = 50;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    PolarCode::Decoding::SclAvxFloat reference(block_length, list_size, frozenBits);
+    PolarCode::Decoding::SoSclAvxFloat decoder(block_length, list_size, frozenBits);
+    reference.setErrorDetection(&crc);
+    decoder.setErrorDetection(&crc);
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.5f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> expected(info_bytes), codeword(block_length / 8);
+    std::vector<float> llr(block_length), posterior(block_length);
+    std::vector<float> extrinsic(block_length);
+
+    for (bool systematic : { true, false }) {
+        encoder.setSystematic(systematic);
+        reference.setSystematic(systematic);
+        decoder.setSystematic(systematic);
+        unsigned channelErrors = 0, posteriorErrors = 0, extrinsicErrors = 0;
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            for (auto& byte : message) {
+                byte = generator();
+            }
+            crc.generate(message.data(), info_bytes);
+            encoder.setInformation(message.data());
+            encoder.encode();
+            encoder.getEncodedData(codeword.data());
+            for (unsigned i = 0; i < block_length; ++i) {
+                const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+                llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+            }
+
+            // The hard decisions are those of the plain list decoder
+            const bool success = decoder.decode_vector(llr.data(), output.data());
+            CPPUNIT_ASSERT(success ==
+                           reference.decode_vector(llr.data(), expected.data()));
+            CPPUNIT_ASSERT(output == expected);
+
+            decoder.getSoftCodeword(posterior.data());
+            decoder.getExtrinsicChannelInformation(extrinsic.data());
+            for (unsigned i = 0; i < block_length; ++i) {
+                const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(posterior[i] - llr[i], extrinsic[i], 1e-4);
+                channelErrors += std::signbit(llr[i]) != bit;
+                posteriorErrors += std::signbit(posterior[i]) != bit;
+                extrinsicErrors += std::signbit(extrinsic[i]) != bit;
+            }
+        }
+        fmt::print("testSoftOutputList: systematic={}, bit errors of channel {}, "
+                   "a-posteriori {}, extrinsic {}\n",
+                   systematic,
+                   channelErrors,
+                   posteriorErrors,
+                   extrinsicErrors);
+        CPPUNIT_ASSERT(posteriorErrors < channelErrors / 10);
+        CPPUNIT_ASSERT(extrinsicErrors < channelErrors / 2);
+    }
+
+    // Without a valid path, the decoder has nothing to add to the channel
+    for (auto& value : llr) {
+        value = noise(generator);
+    }
+    if (!decoder.decode_vector(llr.data(), output.data())) {
+        decoder.getExtrinsicChannelInformation(extrinsic.data());
+        CPPUNIT_ASSERT(std::all_of(
+            extrinsic.begin(), extrinsic.end(), [](float e) { return e == 0.0f; }));
+    }
+
+    CPPUNIT_ASSERT_THROW(decoder.setPenalty(-1.0f), std::invalid_argument);
+    runCloneDecoding(&decoder, block_length, frozenBits);
+}
+
+void DecodingTest::testDepthFirst()
+{
+    const size_t block_length = 1024;
+    const size_t info_length = 512;
+    const size_t info_bytes = info_length / 8;
+    const size_t frames = 100;
+
+    PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+    std::vector<unsigned> frozenBits = constructor.construct();
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    encoder.setSystematic(false);
+
+    PolarCode::Decoding::FastSscAvxFloat scDecoder(block_length, frozenBits);
+    PolarCode::Decoding::DepthFirst depthFirstDecoder(block_length, 256, frozenBits);
+    for (PolarCode::Decoding::Decoder* decoder :
+         std::vector<PolarCode::Decoding::Decoder*>{ &scDecoder, &depthFirstDecoder }) {
+        decoder->setSystematic(false);
+        decoder->setErrorDetection(&crc);
+    }
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.6f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> repeatedOutput(info_bytes);
+    std::vector<unsigned char> codeword(block_length / 8);
+    std::vector<float> llr(block_length);
+
+    unsigned scSuccess = 0, depthFirstSuccess = 0;
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (auto& byte : message) {
+            byte = generator();
+        }
+        crc.generate(message.data(), info_bytes);
+        encoder.setInformation(message.data());
+        encoder.encode();
+        encoder.getEncodedData(codeword.data());
+        for (unsigned i = 0; i < block_length; ++i) {
+            const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+            llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+        }
+
+        const bool scResult = scDecoder.decode_vector(llr.data(), output.data());
+        const bool scCorrect = memcmp(message.data(), output.data(), info_bytes) == 0;
+        const bool result = depthFirstDecoder.decode_vector(llr.data(), output.data());
+        const bool correct = memcmp(message.data(), output.data(), info_bytes) == 0;
+
+        // The first run is an SC decoding
+        if (scResult) {
+            CPPUNIT_ASSERT(result);
+            CPPUNIT_ASSERT(scCorrect == correct);
+        }
+
+        // Trials of the previous frame must not leak into the next one
+        const bool repeatedResult =
+            depthFirstDecoder.decode_vector(llr.data(), repeatedOutput.data());
+        CPPUNIT_ASSERT(result == repeatedResult);
+        CPPUNIT_ASSERT(memcmp(output.data(), repeatedOutput.data(), info_bytes) == 0);
+
+        scSuccess += scCorrect;
+        depthFirstSuccess += correct;
+    }
+    fmt::print("testDepthFirst: {} of {} frames correct with Fast-SSC, {} with "
+               "depth-first decoding\n",
+               scSuccess,
+               frames,
+               depthFirstSuccess);
+    CPPUNIT_ASSERT(depthFirstSuccess > scSuccess);
+}
+
+void DecodingTest::testFixedDecoders()
+{
+    const size_t frames = 200;
+    const float sigma = 0.8f;
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, sigma);
+
+    const std::vector<PolarCode::Decoding::CodingScheme>& registry =
+        PolarCode::Decoding::codeRegistry;
+
+    for (unsigned scheme = 0; scheme < registry.size(); ++scheme) {
+        const PolarCode::Decoding::CodingScheme& code = registry[scheme];
+        const size_t info_bytes = (code.infoLength + 7) / 8;
+        CPPUNIT_ASSERT(PolarCode::Decoding::findCodingScheme(
+                           code.blockLength, code.frozenBits) == (int)scheme);
+
+        // Unrolled decoders are opt-in, the default types stay with Fast-SSC
+        std::unique_ptr<PolarCode::Decoding::Decoder> fixedFloat(
+            PolarCode::Decoding::create(code.blockLength, 1, code.frozenBits, "fixed"));
+        std::unique_ptr<PolarCode::Decoding::Decoder> fixedChar(
+            PolarCode::Decoding::create(
+                code.blockLength, 1, code.frozenBits, "fixed char"));
+        std::unique_ptr<PolarCode::Decoding::Decoder> defaultFloat(
+            PolarCode::Decoding::create(code.blockLength, 1, code.frozenBits, "float"));
+        std::unique_ptr<PolarCode::Decoding::Decoder> defaultChar(
+            PolarCode::Decoding::create(code.blockLength, 1, code.frozenBits, "char"));
+        CPPUNIT_ASSERT(dynamic_cast<PolarCode::Decoding::FixedChar*>(fixedChar.get()));
+        CPPUNIT_ASSERT(dynamic_cast<PolarCode::Decoding::FastSscAvxFloat*>(
+                           fixedFloat.get()) == nullptr);
+        CPPUNIT_ASSERT(
+            dynamic_cast<PolarCode::Decoding::FastSscAvxFloat*>(defaultFloat.get()));
+        CPPUNIT_ASSERT(
+            dynamic_cast<PolarCode::Decoding::FastSscFipChar*>(defaultChar.get()));
+
+        PolarCode::Decoding::FastSscAvxFloat floatDecoder(code.blockLength,
+                                                          code.frozenBits);
+        PolarCode::Decoding::FastSscFipChar charDecoder(code.blockLength,
+                                                        code.frozenBits);
+        PolarCode::Encoding::ButterflyFipPacked encoder(code.blockLength,
+                                                        code.frozenBits);
+        for (PolarCode::Decoding::Decoder* decoder :
+             std::vector<PolarCode::Decoding::Decoder*>{
+                 fixedFloat.get(), fixedChar.get(), &floatDecoder, &charDecoder }) {
+            decoder->setSystematic(code.systematic);
+        }
+        encoder.setSystematic(code.systematic);
+
+        std::vector<unsigned char> message(info_bytes), output(info_bytes);
+        std::vector<unsigned char> reference(info_bytes);
+        std::vector<unsigned char> codeword(code.blockLength / 8);
+        std::vector<float> llr(code.blockLength);
+        unsigned floatSuccess = 0, charSuccess = 0, fixedCharSuccess = 0;
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            for (auto& byte : message) {
+                byte = generator();
+            }
+            encoder.setInformation(message.data());
+            encoder.encode();
+            encoder.getEncodedData(codeword.data());
+            for (unsigned i = 0; i < code.blockLength; ++i) {
+                const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+                const float y = (bit ? -1.0f : 1.0f) + noise(generator);
+                llr[i] = 2.0f * y / (sigma * sigma);
+            }
+
+            // Unrolling the float decoder must not change any decision
+            floatDecoder.decode_vector(llr.data(), reference.data());
+            fixedFloat->decode_vector(llr.data(), output.data());
+            CPPUNIT_ASSERT(memcmp(reference.data(), output.data(), info_bytes) == 0);
+            floatSuccess += memcmp(message.data(), reference.data(), info_bytes) == 0;
+
+            charDecoder.decode_vector(llr.data(), reference.data());
+            charSuccess += memcmp(message.data(), reference.data(), info_bytes) == 0;
+            fixedChar->decode_vector(llr.data(), output.data());
+            fixedCharSuccess += memcmp(message.data(), output.data(), info_bytes) == 0;
+        }
+        fmt::print("testFixedDecoders: {} of {} frames correct with Fast-SSC float, {} "
+                   "with Fast-SSC char, {} with the unrolled char decoder\n",
+                   floatSuccess,
+                   frames,
+                   charSuccess,
+                   fixedCharSuccess);
+        // The noise has to be strong enough for decoding failures
+        CPPUNIT_ASSERT(floatSuccess < frames);
+        CPPUNIT_ASSERT(fixedCharSuccess >= charSuccess);
+
+        std::vector<unsigned> otherCode(code.frozenBits.begin() + 1,
+                                        code.frozenBits.end());
+        CPPUNIT_ASSERT(PolarCode::Decoding::findCodingScheme(code.blockLength,
+                                                             otherCode) == -1);
+        CPPUNIT_ASSERT_THROW(fixedChar->initialize(code.blockLength, otherCode),
+                             std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(fixedFloat->initialize(code.blockLength, otherCode),
+                             std::invalid_argument);
+        runCloneDecoding(fixedFloat.get(), code.blockLength, code.frozenBits);
+        runCloneDecoding(fixedChar.get(), code.blockLength, code.frozenBits);
+    }
+}
+
+void DecodingTest::testJitDecoder()
+{
+    const size_t block_length = 128;
+    const size_t frames = 50;
+    PolarCode::Construction::Bhattacharrya constructor(block_length, block_length / 2);
+    std::vector<unsigned> frozen_bits = constructor.construct();
+    const size_t info_bytes = (block_length - frozen_bits.size() + 7) / 8;
+
+    // Compile into an empty cache
+    char cacheDir[] = "/tmp/polarcode_jit_XXXXXX";
+    CPPUNIT_ASSERT(mkdtemp(cacheDir) != nullptr);
+    PolarCode::Decoding::Jit::Options options =
+        PolarCode::Decoding::Jit::defaultOptions();
+    options.cacheDir = cacheDir;
+
+    PolarCode::Decoding::FastSscAvxFloat reference(block_length, frozen_bits);
+    PolarCode::Decoding::JitDecoder decoder(block_length, frozen_bits, options);
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozen_bits);
+
+    // A compiler which always fails leaves the decoder on Fast-SSC
+    PolarCode::Decoding::Jit::Options broken = options;
+    broken.compiler = "false";
+    broken.cacheDir = std::string(cacheDir) + "/broken";
+    PolarCode::Decoding::JitDecoder fallback(block_length, frozen_bits, broken);
+
+    // Decoding fails on many frames, so that differences of the decoders show
+    const float sigma = 0.8f;
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, sigma);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> expected(info_bytes);
+    std::vector<unsigned char> codeword(block_length / 8);
+    std::vector<float> llr(block_length);
+    unsigned errors = 0;
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        for (auto& byte : message) {
+            byte = generator();
+        }
+        encoder.setInformation(message.data());
+        encoder.encode();
+        encoder.getEncodedData(codeword.data());
+        for (unsigned i = 0; i < block_length; ++i) {
+            const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+            const float y = (bit ? -1.0f : 1.0f) + noise(generator);
+            llr[i] = 2.0f * y / (sigma * sigma);
+        }
+        reference.decode_vector(llr.data(), expected.data());
+        errors += memcmp(message.data(), expected.data(), info_bytes) != 0;
+
+        // Switch decoders in the middle of the test, the decisions must not change
+        if (frame == frames / 2) {
+            CPPUNIT_ASSERT(decoder.waitForCompilation());
+            CPPUNIT_ASSERT(!fallback.waitForCompilation());
+        }
+        decoder.decode_vector(llr.data(), output.data());
+        CPPUNIT_ASSERT(memcmp(expected.data(), output.data(), info_bytes) == 0);
+        fallback.decode_vector(llr.data(), output.data());
+        CPPUNIT_ASSERT(memcmp(expected.data(), output.data(), info_bytes) == 0);
+    }
+    CPPUNIT_ASSERT(decoder.isCompiled());
+    CPPUNIT_ASSERT(!fallback.isCompiled());
+    CPPUNIT_ASSERT(errors > 0);
+
+    // A new decoder for the same code loads the cached library
+    std::unique_ptr<PolarCode::Decoding::JitDecoder> cached(
+        dynamic_cast<PolarCode::Decoding::JitDecoder*>(decoder.clone()));
+    CPPUNIT_ASSERT(cached->waitForCompilation());
+    runCloneDecoding(&decoder, block_length, frozen_bits);
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+// Reed-Muller frozen set: Every bit index with a weight of at most _weight_ is frozen
+template <unsigned N>
+constexpr std::array<int, N> reedMullerFrozenSet(const unsigned weight)
+{
+    std::array<int, N> frozenSet = {};
+    for (unsigned i = 0; i < N; ++i) {
+        unsigned ones = 0;
+        for (unsigned bits = i; bits != 0; bits >>= 1) {
+            ones += bits & 1;
+        }
+        frozenSet[i] = ones <= weight;
+    }
+    return frozenSet;
+}
+
+constexpr std::array<int, 128> frozenReedMuller = reedMullerFrozenSet<128>(3);
+
+void DecodingTest::testTemplatizedScl()
+{
+    const size_t block_length = 128;
+    const size_t list_size = 4;
+    const size_t frames = 100;
+
+    std::vector<unsigned> frozenBits;
+    for (unsigned i = 0; i < block_length; ++i) {
+        if (frozenReedMuller[i]) {
+            frozenBits.push_back(i);
+        }
+    }
+    const size_t info_bytes = (block_length - frozenBits.size()) / 8;
+
+    PolarCode::ErrorDetection::CRC8 crc;
+    PolarCode::Encoding::ButterflyFipPacked encoder(block_length, frozenBits);
+    PolarCode::Decoding::SclAvxFloat reference(block_length, list_size, frozenBits);
+    PolarCode::Decoding::TemplatizedScl<block_length, frozenReedMuller, list_size>
+        decoder(frozenBits);
+    reference.setErrorDetection(&crc);
+    decoder.setErrorDetection(&crc);
+    CPPUNIT_ASSERT_EQUAL(list_size, decoder.getListSize());
+    CPPUNIT_ASSERT_THROW(decoder.initialize(block_length, { 0, 1, 2 }),
+                         std::invalid_argument);
+
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 1.5f);
+    std::vector<unsigned char> message(info_bytes), output(info_bytes);
+    std::vector<unsigned char> expected(info_bytes), codeword(block_length / 8);
+    std::vector<float> llr(block_length);
+
+    for (bool systematic : { true, false }) {
+        encoder.setSystematic(systematic);
+        reference.setSystematic(systematic);
+        decoder.setSystematic(systematic);
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            for (auto& byte : message) {
+                byte = generator();
+            }
+            crc.generate(message.data(), info_bytes);
+            encoder.setInformation(message.data());
+            encoder.encode();
+            encoder.getEncodedData(codeword.data());
+            for (unsigned i = 0; i < block_length; ++i) {
+                const bool bit = (codeword[i / 8] >> (7 - i % 8)) & 1;
+                llr[i] = (bit ? -2.0f : 2.0f) + noise(generator);
+            }
+
+            // Both decoders take the same decisions
+            const bool expectedResult =
+                reference.decode_vector(llr.data(), expected.data());
+            const bool result = decoder.decode_vector(llr.data(), output.data());
+            CPPUNIT_ASSERT_EQUAL(expectedResult, result);
+            CPPUNIT_ASSERT(memcmp(expected.data(), output.data(), info_bytes) == 0);
+        }
+        runCloneDecoding(&decoder, block_length, frozenBits);
+    }
+}
+
+void DecodingTest::testSchedule()
+{
+    using PolarCode::Decoding::FastSscAvx::Schedule;
+    const size_t frames = 16;
+
+    for (size_t block_length = 16; block_length <= 4096; block_length *= 4) {
+        for (size_t info_length = block_length / 4; info_length < block_length;
+             info_length += block_length / 4) {
+            PolarCode::Construction::Bhattacharrya constructor(block_length, info_length);
+            std::vector<unsigned> frozenBits = constructor.construct();
+            const size_t info_bytes = (info_length + 7) / 8;
+
+            PolarCode::Decoding::FastSscAvxFloat reference(block_length, frozenBits);
+            PolarCode::Decoding::FastSscScheduleFloat decoder(block_length, frozenBits);
+            PolarCode::Decoding::FastSscAvx::schedule_t schedule = decoder.schedule();
+
+            // Both decoders use the same arena, with about 2N floats of LLRs
+            PolarCode::Decoding::FastSscAvx::MemoryLayout layout(*reference.plan());
+            CPPUNIT_ASSERT(layout.size() == schedule->arenaLength());
+            CPPUNIT_ASSERT(layout.output() <= 2 * block_length + 24);
+
+            // A stored schedule is loaded unchanged
+            std::vector<uint32_t> words = schedule->serialize();
+            auto loaded = std::make_shared<const Schedule>(words);
+            CPPUNIT_ASSERT(loaded->instructions() == schedule->instructions());
+            CPPUNIT_ASSERT(loaded->frozenBits() == frozenBits);
+            PolarCode::Decoding::FastSscScheduleFloat restored(loaded);
+
+            for (bool systematic : { true, false }) {
+                reference.setSystematic(systematic);
+                decoder.setSystematic(systematic);
+                restored.setSystematic(systematic);
+                std::vector<float> llrs =
+                    makeNoisyFrames(frames, block_length, frozenBits, systematic);
+                std::vector<float> expectedBits(block_length), bits(block_length);
+                std::vector<unsigned char> expected(info_bytes), output(info_bytes);
+                for (unsigned frame = 0; frame < frames; ++frame) {
+                    const float* llr = llrs.data() + frame * block_length;
+                    reference.decode_vector(llr, expected.data());
+                    reference.getSoftCodeword(expectedBits.data());
+
+                    decoder.decode_vector(llr, output.data());
+                    decoder.getSoftCodeword(bits.data());
+                    CPPUNIT_ASSERT(expected == output);
+                    CPPUNIT_ASSERT(memcmp(expectedBits.data(),
+                                          bits.data(),
+                                          block_length * sizeof(float)) == 0);
+
+                    restored.decode_vector(llr, output.data());
+                    CPPUNIT_ASSERT(expected == output);
+                }
+            }
+            runCloneDecoding(&decoder, block_length, frozenBits);
+        }
+    }
+
+    // Damaged schedules are rejected
+    PolarCode::Decoding::FastSscScheduleFloat decoder(16, { 0, 1, 2, 4, 8 });
+    std::vector<uint32_t> words = decoder.schedule()->serialize();
+    fmt::print("testSchedule:\n{}", decoder.schedule()->toString());
+    std::vector<uint32_t> truncated(words.begin(), words.end() - 1);
+    CPPUNIT_ASSERT_THROW(Schedule{ truncated }, std::invalid_argument);
+    std::vector<uint32_t> outOfRange = words;
+    outOfRange[outOfRange.size() - 3] = decoder.schedule()->arenaLength();
+    CPPUNIT_ASSERT_THROW(Schedule{ outOfRange }, std::invalid_argument);
+    std::vector<uint32_t> unknown = words;
+    unknown[unknown.size() - 6] = PolarCode::Decoding::FastSscAvx::opCount;
+    CPPUNIT_ASSERT_THROW(Schedule{ unknown }, std::invalid_argument);
+
+    // So are instructions in range, which their kernels cannot run
+    using PolarCode::Decoding::FastSscAvx::Instruction;
+    PolarCode::Construction::Bhattacharrya constructor(256, 128);
+    PolarCode::Decoding::FastSscScheduleFloat longDecoder(256, constructor.construct());
+    const Schedule& schedule = *longDecoder.schedule();
+    words = schedule.serialize();
+    const size_t firstInstruction = 8 + schedule.frozenBits().size();
+    // Replace a word of the first instruction of _opcode_ and _length_
+    auto damage = [&](unsigned opcode, unsigned length, size_t field, uint32_t value) {
+        const std::vector<Instruction>& ops = schedule.instructions();
+        auto op = std::find_if(ops.begin(), ops.end(), [&](const Instruction& op) {
+            return op.opcode == opcode && op.length == length;
+        });
+        CPPUNIT_ASSERT(op != ops.end());
+        std::vector<uint32_t> damaged = words;
+        damaged[firstInstruction + 6 * (op - ops.begin()) + field] = value;
+        return damaged;
+    };
+    using namespace PolarCode::Decoding::FastSscAvx;
+    CPPUNIT_ASSERT_THROW(Schedule{ damage(opRepetition, 8, 0, opZeroSpc) },
+                         std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(Schedule{ damage(opDoubleRepetition, 8, 0, opG0R) },
+                         std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(Schedule{ damage(opDecodeParityChecks, 64, 5, 9) },
+                         std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(Schedule{ damage(opDecodeParityChecks, 64, 5, 64) },
+                         std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(Schedule{ damage(opF, 16, 1, 1) }, std::invalid_argument);
+
+    // Counts beyond the data, and frozen sets with duplicates
+    std::vector<uint32_t> manyFrozenBits = words;
+    manyFrozenBits[3] = ~0U;
+    CPPUNIT_ASSERT_THROW(Schedule{ manyFrozenBits }, std::invalid_argument);
+    std::vector<uint32_t> manyInstructions = words;
+    manyInstructions[firstInstruction - 1] = 0x40000000;
+    CPPUNIT_ASSERT_THROW(Schedule{ manyInstructions }, std::invalid_argument);
+    std::vector<uint32_t> duplicate = words;
+    duplicate[5] = duplicate[4];
+    CPPUNIT_ASSERT_THROW(Schedule{ duplicate }, std::invalid_argument);
+}
+
+void DecodingTest::testMultiThreadedList()
+{
+    // A team covers each index of a loop exactly once
+    PolarCode::Decoding::ThreadTeam team(3);
+    std::vector<unsigned> visits(100, 0);
+    team.split(100, 8, [&](unsigned member, unsigned begin, unsigned end) {
+        CPPUNIT_ASSERT(member < team.size() && begin % 8 == 0);
+        for (unsigned i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+    CPPUNIT_ASSERT(std::count(visits.begin(), visits.end(), 1) == 100);
+    CPPUNIT_ASSERT_THROW(PolarCode::Decoding::ThreadTeam(0), std::invalid_argument);
+
+    // Decisions do not depend on the thread count
+    const size_t block_length = 1024;
+    const size_t list_size = 128;
+    const size_t frames = 4;
+    PolarCode::Construction::Bhattacharrya constructor(block_length, block_length / 2);
+    std::vector<unsigned> frozenBits = constructor.construct();
+    std::vector<float> llrs = makeNoisyFrames(frames, block_length, frozenBits, true);
+    const size_t info_bytes = (block_length - frozenBits.size() + 7) / 8;
+
+    PolarCode::Decoding::SclAvxFloat reference(block_length, list_size, frozenBits);
+    std::vector<unsigned char> expected(frames * info_bytes);
+    reference.decode_batch(llrs.data(), frames, expected.data());
+
+    PolarCode::Decoding::SclAvxFloat decoder(block_length, list_size, frozenBits);
+    CPPUNIT_ASSERT_THROW(decoder.setThreadCount(0), std::invalid_argument);
+    for (size_t threads : { 2, 4 }) {
+        decoder.setThreadCount(threads);
+        std::vector<unsigned char> output(frames * info_bytes);
+        decoder.decode_batch(llrs.data(), frames, output.data());
+        CPPUNIT_ASSERT(output == expected);
+    }
+    std::unique_ptr<PolarCode::Decoding::Decoder> clone(decoder.clone());
+    auto* listClone = dynamic_cast<PolarCode::Decoding::SclAvxFloat*>(clone.get());
+    CPPUNIT_ASSERT(listClone->getThreadCount() == 4);
+    runCloneDecoding(&decoder, block_length, frozenBits);
+}
+
+void DecodingTest::testMultiThreadedFastSsc()
+{
+    // Quickly constructed codes, which freeze the bits of least weight. The
+    // roots are a rate-R, a left rate-0 and a right rate-1 node, whose children
+    // are long enough to be split across the team.
+    const size_t block_length = 4 * PolarCode::Decoding::FastSscAvx::PARALLEL_LENGTH;
+    const size_t frames = 2;
+    auto construct = [&](size_t info_length, unsigned rightWeight) {
+        std::vector<unsigned> order(block_length);
+        std::iota(order.begin(), order.end(), 0);
+        auto weight = [&](unsigned i) {
+            return __builtin_popcount(i) + (i < block_length / 2 ? 0 : rightWeight);
+        };
+        std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+            return weight(a) < weight(b);
+        });
+        std::vector<unsigned> frozenBits(order.begin(), order.end() - info_length);
+        std::sort(frozenBits.begin(), frozenBits.end());
+        return frozenBits;
+    };
+    std::vector<std::vector<unsigned>> codes;
+    codes.push_back(construct(block_length / 2, 0));
+    codes.push_back(construct(block_length / 4, 32));
+    codes.push_back(construct(3 * block_length / 4, 32));
+
+    for (const auto& frozenBits : codes) {
+        std::vector<float> llrs = makeNoisyFrames(frames, block_length, frozenBits, true);
+        const size_t info_bytes = (block_length - frozenBits.size() + 7) / 8;
+        PolarCode::Decoding::FastSscAvxFloat reference(block_length, frozenBits);
+        PolarCode::Decoding::FastSscAvxFloat decoder(block_length, frozenBits);
+        decoder.setThreadCount(3);
+        std::vector<float> expectedBits(block_length), bits(block_length);
+        std::vector<unsigned char> expected(info_bytes), output(info_bytes);
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            const float* llr = llrs.data() + frame * block_length;
+            reference.decode_vector(llr, expected.data());
+            reference.getSoftCodeword(expectedBits.data());
+            decoder.decode_vector(llr, output.data());
+            decoder.getSoftCodeword(bits.data());
+            CPPUNIT_ASSERT(expected == output);
+            CPPUNIT_ASSERT(
+                memcmp(expectedBits.data(), bits.data(), block_length * sizeof(float)) ==
+                0);
+        }
+    }
+
+    PolarCode::Decoding::FastSscAvxFloat decoder(block_length, codes[0]);
+    CPPUNIT_ASSERT_THROW(decoder.setThreadCount(0), std::invalid_argument);
+    decoder.setThreadCount(2);
+    std::unique_ptr<PolarCode::Decoding::Decoder> clone(decoder.clone());
+    auto* sscClone = dynamic_cast<PolarCode::Decoding::FastSscAvxFloat*>(clone.get());
+    CPPUNIT_ASSERT(sscClone->getThreadCount() == 2);
+}
+
+// Surviving paths of a list decoder's leaf node
+struct LeafPaths {
+    std::vector<float> metrics;
+    std::vector<std::vector<bool>> bits;
+};
+
+// The rate-1 and SPC candidates of SclAvxFloat, as computed by its scalar code
+// before the candidate search was vectorised
+static LeafPaths scalarLeafCandidates(const std::vector<std::vector<float>>& llrs,
+                                      const std::vector<float>& metrics,
+                                      const unsigned listSize,
+                                      const bool spc)
+{
+    const unsigned blockLength = llrs[0].size();
+    const unsigned pathCount = llrs.size();
+    const unsigned weakCount = spc ? 4 : 2;
+    const unsigned candidateCount = spc ? 8 : 4;
+    std::vector<float> candidates(pathCount * candidateCount);
+    std::vector<std::vector<unsigned>> flips(pathCount * candidateCount);
+
+    for (unsigned path = 0; path < pathCount; ++path) {
+        // Short blocks are padded, as by the decoder
+        std::vector<float> temp(std::max(8U, blockLength), INFINITY);
+        std::vector<unsigned> indices(temp.size());
+        bool odd = false;
+        for (unsigned i = 0; i < blockLength; ++i) {
+            temp[i] = std::fabs(llrs[path][i]);
+            odd ^= std::signbit(llrs[path][i]);
+        }
+        findWeakLlrs(indices, temp.data(), blockLength, weakCount);
+
+        float metric = metrics[path];
+        float* c = &candidates[path * candidateCount];
+        std::vector<unsigned>* f = &flips[path * candidateCount];
+        if (!spc) {
+            c[0] = metric;
+            c[1] = metric - temp[0];
+            c[2] = metric - temp[1];
+            c[3] = metric - temp[0] - temp[1];
+            f[1] = { indices[0] };
+            f[2] = { indices[1] };
+            f[3] = { indices[0], indices[1] };
+            continue;
+        }
+
+        // Odd parity flips the weakest bit, unless an odd number of others is
+        const float parityInv = odd ? 0.0f : 1.0f;
+        if (odd) {
+            metric -= temp[0];
+        }
+        c[0] = metric;
+        c[1] = metric - parityInv * temp[0] - temp[1];
+        c[2] = metric - parityInv * temp[0] - temp[2];
+        c[3] = metric - parityInv * temp[0] - temp[3];
+        c[4] = metric - temp[1] - temp[2];
+        c[5] = metric - temp[1] - temp[3];
+        c[6] = metric - temp[2] - temp[3];
+        c[7] = metric - parityInv * temp[0] - temp[1] - temp[2] - temp[3];
+        const bool weakest[2][8] = { { 0, 1, 1, 1, 0, 0, 0, 1 },
+                                     { 1, 0, 0, 0, 1, 1, 1, 0 } };
+        const unsigned others[8] = { 0x0, 0x2, 0x4, 0x8, 0x6, 0xA, 0xC, 0xE };
+        for (unsigned candidate = 0; candidate < 8; ++candidate) {
+            if (weakest[odd][candidate]) {
+                f[candidate].push_back(indices[0]);
+            }
+            for (unsigned k = 1; k < 4; ++k) {
+                if ((others[candidate] >> k) & 1) {
+                    f[candidate].push_back(indices[k]);
+                }
+            }
+        }
+    }
+
+    const unsigned newPathCount = std::min(pathCount * candidateCount, listSize);
+    std::vector<unsigned> order(candidates.size());
+    PolarCode::Decoding::PathSelector selector;
+    selector.select(order, candidates, newPathCount, candidates.size());
+
+    LeafPaths result;
+    for (unsigned path = 0; path < newPathCount; ++path) {
+        const unsigned source = order[path] / candidateCount;
+        std::vector<bool> bits(blockLength);
+        for (unsigned i = 0; i < blockLength; ++i) {
+            bits[i] = std::signbit(llrs[source][i]);
+        }
+        for (unsigned index : flips[order[path]]) {
+            if (index < blockLength) {
+                bits[index] = !bits[index];
+            }
+        }
+        result.metrics.push_back(candidates[path]);
+        result.bits.push_back(bits);
+    }
+    return result;
+}
+
+// Decode a single leaf of SclAvxFloat, which is path-interleaved below the
+// code's own stage
+static LeafPaths decodeLeaf(const std::vector<std::vector<float>>& llrs,
+                            const std::vector<float>& metrics,
+                            const unsigned listSize,
+                            const bool spc,
+                            const bool interleaved)
+{
+    namespace SclAvx = PolarCode::Decoding::SclAvx;
+    const unsigned blockLength = llrs[0].size();
+    const unsigned pathCount = llrs.size();
+    const unsigned stage = __builtin_ctz(blockLength);
+    const unsigned stageCount = interleaved ? 4 : stage + 1;
+
+    SclAvx::datapool_t pool;
+    SclAvx::PathList paths(listSize, stageCount, &pool);
+    CPPUNIT_ASSERT(paths.interleaved(stage) == interleaved);
+    std::vector<float> signal(1 << (stageCount - 1), 1.0f);
+    paths.setFirstPath(signal.data());
+    paths.setNextPathCount(pathCount);
+    for (unsigned path = 0; path < pathCount; ++path) {
+        paths.duplicatePath(path, 0, stage);
+    }
+    paths.clearOldPaths(stage);
+    paths.switchToNext();
+
+    const unsigned lanes = paths.LaneCount();
+    for (unsigned path = 0; path < pathCount; ++path) {
+        paths.Metric(path) = metrics[path];
+        if (!interleaved) {
+            paths.getWriteAccessToLlr(path, stage);
+        }
+        for (unsigned i = 0; i < blockLength; ++i) {
+            if (interleaved) {
+                paths.InterleavedLlr(stage)[i * lanes + path] = llrs[path][i];
+            } else {
+                paths.Llr(path, stage)[i] = llrs[path][i];
+            }
+        }
+    }
+
+    SclAvx::Node base(blockLength, listSize, &pool, &paths);
+    std::unique_ptr<SclAvx::Node> leaf;
+    if (spc) {
+        leaf = std::make_unique<SclAvx::SpcDecoder>(&base);
+    } else {
+        leaf = std::make_unique<SclAvx::RateOneDecoder>(&base);
+    }
+    leaf->decode();
+
+    LeafPaths result;
+    for (unsigned path = 0; path < paths.PathCount(); ++path) {
+        std::vector<bool> bits(blockLength);
+        for (unsigned i = 0; i < blockLength; ++i) {
+            bits[i] = interleaved
+                          ? std::signbit(paths.InterleavedBit(stage)[i * lanes + path])
+                          : (paths.Bit(path, stage)[i / 8] >> (i % 8)) & 1;
+        }
+        result.metrics.push_back(paths.Metric(path));
+        result.bits.push_back(bits);
+    }
+    return result;
+}
+
+void DecodingTest::testListCandidates()
+{
+    std::mt19937 generator;
+    std::uniform_int_distribution<int> smallInteger(-4, 4);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+
+    for (unsigned listSize : { 1, 4, 32 }) {
+        for (bool spc : { false, true }) {
+            for (unsigned blockLength : { 2, 4, 8, 16, 64 }) {
+                if (spc && blockLength < 4) {
+                    continue;
+                }
+                for (unsigned pathCount : { 1U, std::min(listSize, 3U), listSize }) {
+                    for (unsigned trial = 0; trial < 20; ++trial) {
+                        // Integers make ties of LLR magnitudes and of path metrics
+                        const bool ties = trial % 2 == 0;
+                        std::vector<std::vector<float>> llrs(
+                            pathCount, std::vector<float>(blockLength));
+                        std::vector<float> metrics(pathCount);
+                        for (unsigned path = 0; path < pathCount; ++path) {
+                            for (float& llr : llrs[path]) {
+                                do {
+                                    llr = ties ? smallInteger(generator)
+                                               : noise(generator);
+                                } while (llr == 0.0f);
+                            }
+                            metrics[path] = ties ? -std::abs(smallInteger(generator))
+                                                 : -std::fabs(noise(generator));
+                        }
+
+                        const LeafPaths expected =
+                            scalarLeafCandidates(llrs, metrics, listSize, spc);
+                        const LeafPaths result =
+                            decodeLeaf(llrs, metrics, listSize, spc, blockLength < 8);
+                        CPPUNIT_ASSERT(result.metrics == expected.metrics);
+                        CPPUNIT_ASSERT(result.bits == expected.bits);
+                    }
+                }
+            }
+        }
+    }
+
+    // A NaN minimum must not make the search for weak LLRs leave the node
+    const size_t block_length = 1024;
+    PolarCode::Construction::Bhattacharrya constructor(block_length, 512);
+    std::vector<unsigned> frozenBits = constructor.construct();
+    std::vector<float> llr(block_length, NAN);
+    std::vector<unsigned char> output(512 / 8);
+    for (unsigned listSize : { 2, 4, 8 }) {
+        PolarCode::Decoding::SclAvxFloat decoder(block_length, listSize, frozenBits);
+        decoder.decode_vector(llr.data(), output.data());
+    }
+}
@@ -35,6 +35,27 @@ class DecodingTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testDoubleSPCCodeFloat);
     CPPUNIT_TEST(testTypeFiveDecoder);
     CPPUNIT_TEST(testRepRateOneDecoderShort8);
+    CPPUNIT_TEST(testBatchDecoding);
+    CPPUNIT_TEST(testPlanSharing);
+    CPPUNIT_TEST(testDecodeService);
+    CPPUNIT_TEST(testZeroCopy);
+    CPPUNIT_TEST(testDataPool);
+    CPPUNIT_TEST(testPathSelection);
+    CPPUNIT_TEST(testDistributedCrc);
+    CPPUNIT_TEST(testGeneralizedNodes);
+    CPPUNIT_TEST(testDscf);
+    CPPUNIT_TEST(testAdaptiveListSizes);
+    CPPUNIT_TEST(testBeliefPropagation);
+    CPPUNIT_TEST(testScanEarlyStopping);
+    CPPUNIT_TEST(testSoftOutputList);
+    CPPUNIT_TEST(testDepthFirst);
+    CPPUNIT_TEST(testFixedDecoders);
+    CPPUNIT_TEST(testJitDecoder);
+    CPPUNIT_TEST(testTemplatizedScl);
+    CPPUNIT_TEST(testSchedule);
+    CPPUNIT_TEST(testMultiThreadedList);
+    CPPUNIT_TEST(testMultiThreadedFastSsc);
+    CPPUNIT_TEST(testListCandidates);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -76,6 +97,40 @@ public:
 
     void testRepRateOneDecoderShort8();
 
+    void testBatchDecoding();
+
+    void testPlanSharing();
+    void runCloneDecoding(PolarCode::Decoding::Decoder* decoder,
+                          const size_t block_length,
+                          const std::vector<unsigned>& frozenBits);
+
+    void testDecodeService();
+    void testZeroCopy();
+    void testDataPool();
+    void testPathSelection();
+    void testDistributedCrc();
+    void testGeneralizedNodes();
+    void testDscf();
+    void testAdaptiveListSizes();
+    void testBeliefPropagation();
+    void testScanEarlyStopping();
+    void testSoftOutputList();
+    void testDepthFirst();
+    void testFixedDecoders();
+    void testJitDecoder();
+    void testTemplatizedScl();
+    void testSchedule();
+    void testMultiThreadedList();
+    void testMultiThreadedFastSsc();
+    void testListCandidates();
+    void runGeneralizedRepetition(const size_t block_length,
+                                  const size_t source_length,
+                                  const bool spc);
+    void runGeneralizedSpc(const size_t block_length, const size_t zero_length);
+    void runBatchDecoding(PolarCode::Decoding::Decoder* decoder,
+                          const size_t block_length,
+                          const std::vector<unsigned>& frozenBits);
+
 private:
     void showScanTestOutput(unsigned, float*);
     void fillRandom(float* vec, const unsigned length);
@@ -16,6 +16,7 @@
 #include <cstring>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(EncodingTest);
 
@@ -161,6 +162,52 @@ void EncodingTest::fipRecursiveTest()
     delete[] butterflyOutput;
 }
 
+void EncodingTest::zeroCopyTest()
+{
+    using namespace PolarCode::Encoding;
+
+    for (size_t blockLength = 16; blockLength <= 4096; blockLength *= 4) {
+        const size_t infoLength = blockLength / 2;
+        PolarCode::Construction::Bhattacharrya constructor(blockLength, infoLength);
+        frozenBits = constructor.construct();
+
+        ButterflyFipPacked encoder(blockLength, frozenBits);
+        std::vector<unsigned char> input(infoLength / 8);
+        std::vector<unsigned char> expected(blockLength / 8);
+        getRandomData(input.data(), infoLength / 8);
+
+        // One spare vector allows a misaligned destination behind the aligned one.
+        // aligned_alloc() needs sizes in multiples of the alignment.
+        const size_t outputSize = (blockLength / 8 + 63) / 32 * 32;
+        unsigned char* output =
+            static_cast<unsigned char*>(std::aligned_alloc(32, outputSize));
+
+        for (bool systematic : { true, false }) {
+            encoder.setSystematic(systematic);
+            encoder.encode_vector(input.data(), expected.data());
+
+            for (unsigned offset : { 0, 1 }) {
+                memset(output, 0, outputSize);
+                encoder.encode_vector(
+                    input.data(), input.size(), output + offset, blockLength / 8);
+                CPPUNIT_ASSERT(0 ==
+                               memcmp(output + offset, expected.data(), blockLength / 8));
+            }
+        }
+
+        bool rejected = false;
+        try {
+            encoder.encode_vector(
+                input.data(), input.size(), output, blockLength / 8 - 1);
+        } catch (std::invalid_argument&) {
+            rejected = true;
+        }
+        CPPUNIT_ASSERT(rejected);
+
+        free(output);
+    }
+}
+
 void EncodingTest::performanceComparison()
 {
     using namespace std::chrono;
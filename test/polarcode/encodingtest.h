@@ -18,6 +18,7 @@ class EncodingTest : public CppUnit::TestFixture
     CPPUNIT_TEST(fipPackedTest);
     CPPUNIT_TEST(fipPackedTestShort);
     CPPUNIT_TEST(fipRecursiveTest);
+    CPPUNIT_TEST(zeroCopyTest);
     CPPUNIT_TEST(performanceComparison);
     CPPUNIT_TEST_SUITE_END();
 
@@ -31,6 +32,7 @@ public:
     void fipPackedTest();
     void fipPackedTestShort();
     void fipRecursiveTest();
+    void zeroCopyTest();
     void performanceComparison();
 };
 
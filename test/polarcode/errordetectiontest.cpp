@@ -9,6 +9,7 @@
 #include "errordetectiontest.h"
 
 #include <cstring>
+#include <stdexcept>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ErrorDetectionTest);
 
@@ -103,3 +104,42 @@ void ErrorDetectionTest::testCmac()
     //	mTestInput[0] ^= 0xFF;
     //	CPPUNIT_ASSERT_EQUAL(false, mCrc32->check(mTestInput, mDataLength));
 }
+
+void ErrorDetectionTest::testDistributedCrc()
+{
+    // 24-bit CRC of 5G downlink control information
+    PolarCode::ErrorDetection::DistributedCrc crc(140, 24, 0xB2B117);
+    CPPUNIT_ASSERT(crc.getCheckBitCount() == 24);
+    CPPUNIT_ASSERT(crc.parityChecks().size() == 24);
+
+    // Every check bit follows the message bits it covers
+    unsigned lastPosition = 0;
+    for (auto& check : crc.parityChecks()) {
+        CPPUNIT_ASSERT(check.position >= lastPosition);
+        for (unsigned position : check.dependencies) {
+            CPPUNIT_ASSERT(position < check.position);
+        }
+        lastPosition = check.position;
+    }
+    // The first check does not have to wait for the whole message
+    CPPUNIT_ASSERT(crc.parityChecks().front().position < 140);
+
+    unsigned char message[18], data[21], output[18];
+    memcpy(message, mData, sizeof(message));
+    message[17] &= 0xF0;
+    crc.interleave(message, data);
+    CPPUNIT_ASSERT_EQUAL(true, crc.check(data, sizeof(data)));
+    crc.deinterleave(data, output);
+    CPPUNIT_ASSERT(memcmp(message, output, sizeof(message)) == 0);
+
+    // Any single bit error is detected
+    for (unsigned bit = 0; bit < 164; ++bit) {
+        data[bit / 8] ^= 0x80 >> (bit % 8);
+        CPPUNIT_ASSERT_EQUAL(false, crc.check(data, sizeof(data)));
+        data[bit / 8] ^= 0x80 >> (bit % 8);
+    }
+
+    // The buffer has to hold the message and the CRC
+    CPPUNIT_ASSERT_THROW(crc.check(data, sizeof(data) - 1), std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(crc.generate(data, sizeof(data) - 1), std::invalid_argument);
+}
@@ -14,6 +14,7 @@
 #include <polarcode/errordetection/cmac.h>
 #include <polarcode/errordetection/crc32.h>
 #include <polarcode/errordetection/crc8.h>
+#include <polarcode/errordetection/distributed_crc.h>
 #include <polarcode/errordetection/dummy.h>
 
 class ErrorDetectionTest : public CppUnit::TestFixture
@@ -23,6 +24,7 @@ class ErrorDetectionTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testCrc8);
     CPPUNIT_TEST(testCrc32);
     CPPUNIT_TEST(testCmac);
+    CPPUNIT_TEST(testDistributedCrc);
     CPPUNIT_TEST_SUITE_END();
 
     PolarCode::ErrorDetection::Detector *mDummy, *mCrc8, *mCrc32, *mCmac;
@@ -41,6 +43,7 @@ public:
     void testCrc8();
     void testCrc32();
     void testCmac();
+    void testDistributedCrc();
 };
 
 #endif // PC_TEST_ERRORDETECTION_H